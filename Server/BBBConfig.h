@@ -36,11 +36,37 @@
 /* the logging mechanism. Further the log messages are grouped in different   */
 /* levels. Just set a log level to zero and all messages of this level will   */
 /* not appear.                                                                */
-#define CONFIG_LOG_CONSOLE                  ( 1 )
+#define CONFIG_LOG_CONSOLE                  ( 0 )
 #define CONFIG_LOG_LEVEL_DEBUG              ( 1 )
 #define CONFIG_LOG_LEVEL_INFO               ( 1 )
 #define CONFIG_LOG_LEVEL_WARNING            ( 1 )
 #define CONFIG_LOG_LEVEL_ERROR              ( 1 )
+/* Lowest level of the messages of every module compiled in (LOG_LEVEL_DEBUG, */
+/* LOG_LEVEL_INFO, LOG_LEVEL_WARNING, LOG_LEVEL_ERROR or LOG_LEVEL_NONE), the  */
+/* messages below are removed by the compiler. The messages compiled in are   */
+/* filtered at runtime from CONFIG_LOG_RUNTIME_LEVEL upwards, setLogLevel()   */
+/* (and the option -l of the server) change this level.                       */
+#define CONFIG_LOG_MODULE_MAIN              LOG_LEVEL_DEBUG
+#define CONFIG_LOG_MODULE_APP               LOG_LEVEL_DEBUG
+#define CONFIG_LOG_MODULE_NET               LOG_LEVEL_DEBUG
+#define CONFIG_LOG_MODULE_JSON              LOG_LEVEL_DEBUG
+#define CONFIG_LOG_MODULE_SYS               LOG_LEVEL_DEBUG
+#define CONFIG_LOG_MODULE_HW                LOG_LEVEL_DEBUG
+#define CONFIG_LOG_RUNTIME_LEVEL            LOG_LEVEL_DEBUG
+/* Set CONFIG_LOG_ASYNC to one to write the log messages to the stdout in the */
+/* background instead (see LogAsync.h). Every thread formats its messages     */
+/* into a ring of CONFIG_LOG_ASYNC_RING_SIZE (power of two) entries of        */
+/* CONFIG_LOG_ASYNC_ENTRY_SIZE bytes. The writer thread empties all rings     */
+/* every CONFIG_LOG_ASYNC_PERIOD_MS milliseconds.                             */
+#define CONFIG_LOG_ASYNC                    ( 1 )
+#define CONFIG_LOG_ASYNC_RING_SIZE          ( 64 )
+#define CONFIG_LOG_ASYNC_ENTRY_SIZE         ( 256 )
+#define CONFIG_LOG_ASYNC_PERIOD_MS          ( 10 )
+/* Set CONFIG_LOG_ASYNC_BINARY to one to record the raw arguments instead of  */
+/* formatting the messages. The records are written to the file               */
+/* CONFIG_LOG_ASYNC_BINARY_FILE, use tools/LogDecode.py to read it.           */
+#define CONFIG_LOG_ASYNC_BINARY             ( 0 )
+#define CONFIG_LOG_ASYNC_BINARY_FILE        "webhouse.blog"
 
 /*******************************************************************************
  *  Socket interface configuration
@@ -48,7 +74,94 @@
 /* Socket communication interface constants. You can set the socket port you  */
 /* wan't to listen at and the buffer size for incoming data                   */
 #define CONFIG_SOCKET_PORT                  ( 5000 )
-#define CONFIG_SOCKET_INPUT_BUFFER          ( 128 )
+#define CONFIG_SOCKET_INPUT_BUFFER          ( 2048 )
+#define CONFIG_SOCKET_OUTPUT_BUFFER         ( 512 )
+/* Number of messages the transmit buffer of a connection keeps, further      */
+/* messages are dropped until the client catches up                           */
+#define CONFIG_SOCKET_TX_QUEUE              ( 16 )
+/* Number of broadcast frames which can be queued by reference; if all are   */
+/* in use, a broadcast is copied into the transmit buffer of each client      */
+#define CONFIG_SOCKET_TX_SHARED             ( 32 )
+/* Largest (reassembled) WebSocket message accepted from a client             */
+#define CONFIG_SOCKET_MESSAGE_BUFFER        ( 512 )
+/* Number of clients which are served concurrently and the length of the     */
+/* queue of pending connection attempts (listen(2) backlog). The number of    */
+/* clients can be overridden at compile time (bench/BenchBroadcast.c).        */
+#ifndef CONFIG_SOCKET_MAX_CLIENTS
+#define CONFIG_SOCKET_MAX_CLIENTS           ( 256 )
+#endif
+#define CONFIG_SOCKET_BACKLOG               ( 64 )
+/* Message delimitation of raw TCP clients: FRAMER_JSON (JSON objects) or    */
+/* FRAMER_NEWLINE (one message per line)                                      */
+#define CONFIG_SOCKET_RAW_FRAMING           FRAMER_JSON
+/* Subprotocol selected if offered by a WebSocket client                      */
+#define CONFIG_WEBSOCKET_PROTOCOL           "webhuesli-protocol"
+
+/*******************************************************************************
+ *  Event loop configuration
+ ******************************************************************************/
+/* The main thread dispatches all socket events with the help of epoll(7).    */
+/* CONFIG_REACTOR_MAX_FD is the highest file descriptor number (exclusive)    */
+/* which can be registered. CONFIG_REACTOR_MAX_EVENTS is the number of events */
+/* fetched by a single epoll_wait(2) call. CONFIG_REACTOR_MAX_FD can be      */
+/* overridden at compile time, like CONFIG_SOCKET_MAX_CLIENTS.                */
+#ifndef CONFIG_REACTOR_MAX_FD
+#define CONFIG_REACTOR_MAX_FD               ( 1024 )
+#endif
+#define CONFIG_REACTOR_MAX_EVENTS           ( 64 )
+
+/*******************************************************************************
+ *  Scheduler configuration
+ ******************************************************************************/
+/* All periodic work of the main thread is done by timer driven tasks. The    */
+/* heater control runs every CONFIG_CONTROL_PERIOD_MS, the changed values are */
+/* sent to the clients every CONFIG_TELEMETRY_PERIOD_MS. Both periods are in  */
+/* milliseconds.                                                              */
+#define CONFIG_SCHEDULER_MAX_TASKS          ( 8 )
+#define CONFIG_CONTROL_PERIOD_MS            ( 1000 )
+#define CONFIG_TELEMETRY_PERIOD_MS          ( 100 )
+/* The actuator values are kept in memory (shadow state). Every               */
+/* CONFIG_SHADOW_SYNC_PERIOD_MS they are read back from the hardware and      */
+/* corrected if they were changed by someone else. 0 disables the readback.   */
+#define CONFIG_SHADOW_SYNC_PERIOD_MS        ( 10000 )
+/* Commands for the TV, the LED and the heater only queue the latest value,   */
+/* all queued values are written every CONFIG_ACTUATOR_FLUSH_PERIOD_MS.       */
+#define CONFIG_ACTUATOR_FLUSH_PERIOD_MS     ( 50 )
+/* The lamps fade to a new dim level within CONFIG_FADE_RAMP_MS, the level is */
+/* written every CONFIG_FADE_PERIOD_MS at most (see Fade.h). Both periods    */
+/* are in milliseconds, a ramp of 0 dims without fading.                      */
+#define CONFIG_FADE_PERIOD_MS               ( 20 )
+#define CONFIG_FADE_RAMP_MS                 ( 300 )
+
+/*******************************************************************************
+ *  Heater control configuration
+ ******************************************************************************/
+/* The heater is driven by a PI controller (see Pid.h) every                  */
+/* CONFIG_CONTROL_PERIOD_MS. The gains are per degree of error and per        */
+/* control period, the output is the heater duty in percent. While the       */
+/* temperature is invalid or older than CONFIG_HEATER_MAX_SAMPLE_AGE_MS, the  */
+/* heater duty is held and the controller does not integrate.                 */
+#define CONFIG_HEATER_KP                    ( 20.0 )
+#define CONFIG_HEATER_KI                    ( 0.5 )
+#define CONFIG_HEATER_KD                    ( 0.0 )
+#define CONFIG_HEATER_MAX_SAMPLE_AGE_MS     ( 3 * CONFIG_CONTROL_PERIOD_MS )
+
+/*******************************************************************************
+ *  Hardware backend configuration
+ ******************************************************************************/
+/* Backend used to access the hardware (see HwBackend.h): "sysfs" on the      */
+/* beaglebone ("chardev" and "mmap" as alternatives), "sim" to run without    */
+/* hardware. Can be overridden at startup with the option -b <backend>.       */
+#define CONFIG_HW_BACKEND                   "sysfs"
+/* Latency of every simulated gpio, pwm and temperature operation in          */
+/* microseconds (0 for no latency).                                           */
+#define CONFIG_SIM_LATENCY_GPIO_US          ( 0 )
+#define CONFIG_SIM_LATENCY_PWM_US           ( 0 )
+#define CONFIG_SIM_LATENCY_TEMP_US          ( 0 )
+/* Source of the gpio registers of the "mmap" backend: "/dev/mem" on the      */
+/* beaglebone, any other file is a register image. Can be overridden at       */
+/* startup with the option -m <file>.                                         */
+#define CONFIG_GPIOMMAP_DEVICE              "/dev/mem"
 
 //----- Data types -------------------------------------------------------------
 
@@ -2,7 +2,38 @@
 /** \file       TCPServer.c
  *******************************************************************************
  *
- *  \brief
+ *  \brief      Non-blocking multi client TCP server of the beaglebone black
+ *              webhouse.
+ *              <p>
+ *              The server listens on CONFIG_SOCKET_PORT and serves up to
+ *              CONFIG_SOCKET_MAX_CLIENTS clients concurrently out of the
+ *              main thread. All sockets are registered at the reactor
+ *              (Reactor.h), thus runReactor() must be called periodically.
+ *              <p>
+ *              Browsers connect with the WebSocket protocol (RFC 6455): the
+ *              server answers the HTTP upgrade request itself, negotiates
+ *              the subprotocol CONFIG_WEBSOCKET_PROTOCOL, reassembles
+ *              fragmented messages and answers ping and close frames.
+ *              Clients which do not start with a HTTP GET request are served
+ *              as raw TCP clients.
+ *              <p>
+ *              Both the payload of a WebSocket message and the byte stream of
+ *              a raw client are split into single messages by the framer
+ *              (Framer.h). Every message is handed to the receive handler
+ *              separately, even if several of them arrived within one
+ *              segment. A raw message split over several segments is kept
+ *              until it is complete.
+ *              <p>
+ *              Outgoing data is sent without blocking (as a text frame to
+ *              WebSocket clients); data the socket can not take at once is
+ *              kept in the transmit queue of the connection. A broadcast is
+ *              framed once into a reference counted buffer which is queued
+ *              by reference on every connection, other messages are copied
+ *              into the transmit buffer of the connection. The queue is sent
+ *              with a single sendmsg() (scatter/gather, like writev()). A
+ *              queued message can be replaced by a newer one with the same
+ *              keys (sendLatestTCP()). The first message is only replaced as
+ *              long as none of its bytes was sent.
  *
  *  \author     N00bs
  *
@@ -10,119 +41,1278 @@
  *
  ******************************************************************************/
 /*
- *  functions   blup
+ *  functions  global:
+ *              initTCPServer
+ *              finalizeTCPServer
+ *              sendDataTCP
+ *              sendLatestTCP
+ *              broadcastDataTCP
+ *              broadcastLatestTCP
+ *              getNumberOfConnections
+ *              getNumberOfClients
+ *              setConnectHandlerTCP
+ *  functions  local:
+ *              onListenSocket
+ *              onClientSocket
+ *              receiveDataTCP
+ *              processHandshake
+ *              processFrames
+ *              dispatchMessages
+ *              sendRawTCP
+ *              composeFrameTCP
+ *              sendFrameTCP
+ *              sendCloseTCP
+ *              allocTxShared
+ *              removeTxMessage
+ *              flushDataTCP
+ *              allocConnection
+ *              establishConnection
+ *              closeConnection
  *
  ******************************************************************************/
 
 //----- Header-Files -----------------------------------------------------------
+#define _GNU_SOURCE            /* accept4() */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
-#include <netdb.h>
+#include <netinet/tcp.h>
 
 #include "TCPServer.h"
-
-//#include <arpa/inet.h>
-//#include <time.h>
-
-//#include "Webhouse.h"
-//#include "Log.h"
-//#include "BBBConfig.h"
-//#include "BBBSignal.h"
-//#include "Json.h"
+#include "WebSocket.h"
+#include "Reactor.h"
+#define LOG_MODULE  NET
+#include "Log.h"
 
 //----- Macros -----------------------------------------------------------------
 
 //----- Data types -------------------------------------------------------------
 
-char rxBuf[RX_BUFFER_SIZE];
-char txBuf[TX_BUFFER_SIZE];   // Message hier rein
+/** Broadcast frame queued by reference on several connections */
+typedef struct _sTxShared {
+
+    uint32_t u32Refs;                            ///< number of queued messages
+    char     acData[WS_MAX_HEADER + TX_BUFFER_SIZE];///< frame (raw: payload)
+
+} sTxShared;
+
+//----- Function prototypes ----------------------------------------------------
+static void onListenSocket(int fd, uint32_t u32Events, void * pvData);
+static void onClientSocket(int fd, uint32_t u32Events, void * pvData);
+static void receiveDataTCP(sConnection * psConn);
+static void processHandshake(sConnection * psConn);
+static void processFrames(sConnection * psConn);
+static uint32_t dispatchMessages(sConnection * psConn,
+                                 sFramer * psFramer,
+                                 char * pcBuf,
+                                 uint32_t u32Length);
+static BBBError sendRawTCP(sConnection * psConn,
+                           const char * pcData,
+                           uint32_t u32Length,
+                           uint32_t u32Keys,
+                           sTxShared * psShared);
+static uint32_t composeFrameTCP(char * pcFrame,
+                                eWsOpcode eOpcode,
+                                const char * pcData,
+                                uint32_t u32Length);
+static BBBError sendFrameTCP(sConnection * psConn,
+                             eWsOpcode eOpcode,
+                             const char * pcData,
+                             uint32_t u32Length,
+                             uint32_t u32Keys);
+static void sendCloseTCP(sConnection * psConn, eWsCloseCode eCode);
+static sTxShared * allocTxShared(void);
+static void removeTxMessage(sConnection * psConn, uint32_t u32Msg);
+static BBBError flushDataTCP(sConnection * psConn);
+static sConnection * allocConnection(void);
+static void establishConnection(sConnection * psConn);
+static void closeConnection(sConnection * psConn);
 
-int sockfd = -1;
-int newsockfd = -1;
+//----- Data -------------------------------------------------------------------
+/** Listening server socket                                                   */
+static int          sockfd = -1;
+/** Handler of received data                                                  */
+static pfTCPReceive pfReceiveHandler = NULL;
+/** Handler of established connections, NULL if not set                       */
+static pfTCPConnect pfConnectHandler = NULL;
+/** Pool of client connections                                                */
+static sConnection  asConnection[CONFIG_SOCKET_MAX_CLIENTS];
+/** Number of open client connections                                         */
+static uint32_t     u32Connections = 0;
+/** Number of connections which receive messages (WebSocket or raw)          */
+static uint32_t     u32Clients = 0;
+/** Number of accepted connections since startup                              */
+static uint32_t     u32ConnectionId = 0;
+/** Broadcast frames, free if not referenced by a transmit queue             */
+static sTxShared    asTxShared[TX_SHARED_SIZE];
 
+//----- Implementation ---------------------------------------------------------
 
 /*******************************************************************************
- *  function :    receiveDataTCP
+ *  function :    initTCPServer
  ******************************************************************************/
-/** \brief
+/** \brief        Creates the non-blocking listening socket and registers it
+ *                at the reactor.
+ *                <p>
+ *                initReactor() must be called before this function.
+ *
+ *  \type         global
  *
- *  \type
+ *  \param[in]    u16Port    port to listen at
+ *  \param[in]    pfReceive  handler of received data
  *
- *  \return
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_ERR_PARAM      pfReceive is NULL
+ *                BBB_SOCKET_SOCKET  socket() failed
+ *                BBB_SOCKET_OPT     setsockopt() failed
+ *                BBB_SOCKET_BIND    bind() failed
+ *                BBB_SOCKET_LISTEN  listen() failed
+ *                BBB_EVENT_CTL      socket could not be registered
+ *                </pre>
  *
  ******************************************************************************/
-int receiveDataTCP()
-{
-	int rx_data_len;
-	int value = 0;
+BBBError initTCPServer(uint16_t u16Port, pfTCPReceive pfReceive) {
+
+    BBBError           error = BBB_SUCCESS;
+    struct sockaddr_in serv_addr;
+    int                s32Opt = 1;
+    uint32_t           i;
+
+    if(pfReceive == NULL) {
+        ERRORPRINT("parameter error");
+        return (BBB_ERR_PARAM);
+    }
+
+    pfReceiveHandler = pfReceive;
+    for(i = 0; i < CONFIG_SOCKET_MAX_CLIENTS; i++) {
+        asConnection[i].fd = -1;
+    }
 
-	rx_data_len = recv(newsockfd, &rxBuf[0], RX_BUFFER_SIZE, 0);
-	value = rx_data_len;
-	if(rx_data_len > 0)
-	{
-		if(rx_data_len == 1 && rxBuf[0] == 0x88)
-		{
-			// close condition sent from client
-			printf("client sent 0x88, closing connection\n");
-			close(newsockfd);
-			value = -2;
-		}
-		else
-		{
-			/* Process data received */
-			/*---------------------------------------------------------------------*/
+    sockfd = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    IPPROTO_TCP);
+    if(sockfd < 0) {
+        ERRORPRINT("socket() failed: %s", strerror(errno));
+        return (BBB_SOCKET_SOCKET);
+    }
 
-			printf("received:\n{\n%s\n}\n", rxBuf);
+    /* Allow a restart of the server while old connections are in TIME_WAIT */
+    if(setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR,
+                  &s32Opt, sizeof(s32Opt)) < 0) {
+        ERRORPRINT("setsockopt() failed: %s", strerror(errno));
+        error = BBB_SOCKET_OPT;
+    }
 
-			/*---------------------------------------------------------------------*/
-		}
-	}
-	else if(rx_data_len < 0)
-	{
-		/* Data not received */
-		printf("error reading\n");
-		value = -1;
-	}
+    memset(&serv_addr, 0, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    serv_addr.sin_port = htons(u16Port);
 
-	// do nothing when rx_data_len = 0
+    if(error != BBB_SUCCESS) {
+        /* error already logged */
+    } else if(bind(sockfd, (struct sockaddr*) &serv_addr,
+                   sizeof(struct sockaddr_in)) < 0) {
+        ERRORPRINT("binding failed: %s", strerror(errno));
+        error = BBB_SOCKET_BIND;
+    } else if(listen(sockfd, CONFIG_SOCKET_BACKLOG) < 0) {
+        ERRORPRINT("listening failed: %s", strerror(errno));
+        error = BBB_SOCKET_LISTEN;
+    } else {
+        error = addReactorFd(sockfd, EPOLLIN, onListenSocket, NULL);
+    }
 
-	return value;
+    if(error != BBB_SUCCESS) {
+        close(sockfd);
+        sockfd = -1;
+    } else {
+        INFOPRINT("socket in listening state now (port %d)", u16Port);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    finalizeTCPServer
+ ******************************************************************************/
+/** \brief        Closes all client connections and the listening socket.
+ *
+ *  \type         global
+ *
+ *  \return       BBB_SUCCESS
+ *
+ ******************************************************************************/
+BBBError finalizeTCPServer(void) {
+
+    uint32_t i;
+
+    for(i = 0; i < CONFIG_SOCKET_MAX_CLIENTS; i++) {
+        if(asConnection[i].fd >= 0) {
+            /* Best effort, the server does not wait on the answer */
+            if(asConnection[i].eProto == CONN_PROTO_WEBSOCKET) {
+                sendCloseTCP(&asConnection[i], WS_CLOSE_GOING_AWAY);
+            }
+            if(asConnection[i].fd >= 0) {
+                closeConnection(&asConnection[i]);
+            }
+        }
+    }
+
+    if(sockfd >= 0) {
+        removeReactorFd(sockfd);
+        close(sockfd);
+        sockfd = -1;
+    }
+
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
  *  function :    sendDataTCP
  ******************************************************************************/
-/** \brief
- *
- *  \type
- *
- *  \return
- *
- ******************************************************************************/
-void sendDataTCP()
-{
-	int tx_msg_len;
-
-	tx_msg_len = send(newsockfd, &txBuf[0], TX_BUFFER_SIZE, 0);
-	if(tx_msg_len > 0)
-	{
-		/* Data was sent */
-		printf("data was sent\n");
-	}
-	else if(tx_msg_len == 0)
-	{
-		/* Connection was lost */
-		printf("connection lost\n");
-	}
-	else
-	{
-		/* Data not sent */
-		printf("data not sent\n");
-	}
+/** \brief        Sends a message to a single client without blocking.
+ *                <p>
+ *                WebSocket clients receive the message as a text frame. If the
+ *                socket can not take all data at once, the remaining bytes are
+ *                stored in the transmit buffer of the connection and sent as
+ *                soon as the socket is writable again. If the transmit buffer
+ *                is full, the message is dropped. Messages to clients which
+ *                did not finish the opening handshake yet are dropped as well.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    pcData     data to be sent
+ *  \param[in]    u32Length  number of bytes to be sent
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success (data sent or buffered)
+ *                BBB_ERR_PARAM      parameter error
+ *                BBB_SOCKET_SEND    message dropped
+ *                BBB_SOCKET_CLOSED  connection was closed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError sendDataTCP(sConnection * psConn,
+                     const char * pcData,
+                     uint32_t u32Length) {
+
+    return (sendLatestTCP(psConn, pcData, u32Length, 0));
+}
+
+/*******************************************************************************
+ *  function :    sendLatestTCP
+ ******************************************************************************/
+/** \brief        Sends a message with the latest values of some keys to a
+ *                single client without blocking.
+ *                <p>
+ *                Like sendDataTCP(), but every message still queued in the
+ *                transmit buffer whose keys are all contained in u32Keys is
+ *                outdated and removed before the message is queued.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    pcData     data to be sent
+ *  \param[in]    u32Length  number of bytes to be sent
+ *  \param[in]    u32Keys    mask of the keys the message contains, 0 if the
+ *                           message must neither replace nor be replaced
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success (data sent or buffered)
+ *                BBB_ERR_PARAM      parameter error
+ *                BBB_SOCKET_SEND    message dropped
+ *                BBB_SOCKET_CLOSED  connection was closed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError sendLatestTCP(sConnection * psConn,
+                       const char * pcData,
+                       uint32_t u32Length,
+                       uint32_t u32Keys) {
+
+    BBBError error = BBB_SOCKET_SEND;
+
+    if((psConn == NULL) || (psConn->fd < 0) || (pcData == NULL)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    if(psConn->bClosing == TRUE) {
+        /* drop, connection is going down */
+    } else if(psConn->eProto == CONN_PROTO_WEBSOCKET) {
+        error = sendFrameTCP(psConn, WS_OP_TEXT, pcData, u32Length, u32Keys);
+    } else if(psConn->eProto == CONN_PROTO_RAW) {
+        error = sendRawTCP(psConn, pcData, u32Length, u32Keys, NULL);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    broadcastDataTCP
+ ******************************************************************************/
+/** \brief        Sends data to all connected clients without blocking.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcData     data to be sent
+ *  \param[in]    u32Length  number of bytes to be sent
+ *
+ *  \return       BBB_SUCCESS or the last error of sendDataTCP()
+ *
+ ******************************************************************************/
+BBBError broadcastDataTCP(const char * pcData, uint32_t u32Length) {
+
+    return (broadcastLatestTCP(pcData, u32Length, 0));
+}
+
+/*******************************************************************************
+ *  function :    broadcastLatestTCP
+ ******************************************************************************/
+/** \brief        Sends a message with the latest values of some keys to all
+ *                connected clients without blocking (see sendLatestTCP()).
+ *                <p>
+ *                The message is framed once into a shared buffer. Each
+ *                WebSocket client gets the frame, each raw client its
+ *                payload; if the data has to be queued behind data still
+ *                pending on the connection, the buffer is queued by
+ *                reference. Only if all shared buffers are in use, the frame
+ *                is copied into the transmit buffer of each such client.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcData     data to be sent
+ *  \param[in]    u32Length  number of bytes to be sent
+ *  \param[in]    u32Keys    mask of the keys the message contains
+ *
+ *  \return       BBB_SUCCESS or the last error of a client, see
+ *                sendLatestTCP()
+ *
+ ******************************************************************************/
+BBBError broadcastLatestTCP(const char * pcData,
+                            uint32_t u32Length,
+                            uint32_t u32Keys) {
+
+    static char   acFrame[WS_MAX_HEADER + TX_BUFFER_SIZE];
+    char *        pcFrame = acFrame;
+    sTxShared *   psShared;
+    uint32_t      u32FrameLen;
+    uint32_t      u32HeaderLen;
+    BBBError      error = BBB_SUCCESS;
+    BBBError      errorConn;
+    sConnection * psConn;
+    uint32_t      i;
+
+    if(pcData == NULL) {
+        return (BBB_ERR_PARAM);
+    }
+    if(u32Length > TX_BUFFER_SIZE) {
+        WARNINGPRINT("message too big, dropped");
+        return (BBB_SOCKET_SEND);
+    }
+    if(u32Clients == 0) {
+        return (BBB_SUCCESS);
+    }
+
+    /* Without a free shared buffer the frame is copied when it is queued */
+    psShared = allocTxShared();
+    if(psShared != NULL) {
+        pcFrame = psShared->acData;
+    }
+    u32FrameLen = composeFrameTCP(pcFrame, WS_OP_TEXT, pcData, u32Length);
+    u32HeaderLen = u32FrameLen - u32Length;
+
+    for(i = 0; i < CONFIG_SOCKET_MAX_CLIENTS; i++) {
+        psConn = &asConnection[i];
+        if(psConn->fd < 0) {
+            continue;
+        }
+
+        errorConn = BBB_SOCKET_SEND;
+        if(psConn->bClosing == TRUE) {
+            /* drop, connection is going down */
+        } else if(psConn->eProto == CONN_PROTO_WEBSOCKET) {
+            errorConn = sendRawTCP(psConn, pcFrame, u32FrameLen, u32Keys,
+                                   psShared);
+        } else if(psConn->eProto == CONN_PROTO_RAW) {
+            errorConn = sendRawTCP(psConn, &pcFrame[u32HeaderLen], u32Length,
+                                   u32Keys, psShared);
+        }
+        if(errorConn != BBB_SUCCESS) {
+            error = errorConn;
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    getNumberOfConnections
+ ******************************************************************************/
+uint32_t getNumberOfConnections(void) {
+
+    return (u32Connections);
+}
+
+/*******************************************************************************
+ *  function :    getNumberOfClients
+ ******************************************************************************/
+/** \brief        Number of connections which receive messages, i.e. the
+ *                WebSocket clients which finished the opening handshake and
+ *                the raw clients which sent their first data.
+ *
+ *  \type         global
+ *
+ *  \return       number of clients
+ *
+ ******************************************************************************/
+uint32_t getNumberOfClients(void) {
+
+    return (u32Clients);
+}
+
+/*******************************************************************************
+ *  function :    setConnectHandlerTCP
+ ******************************************************************************/
+/** \brief        Sets the handler which is called as soon as a connection
+ *                receives messages (see getNumberOfClients()), e.g. to send
+ *                the current state to a new client.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pfConnect  handler, NULL for none
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void setConnectHandlerTCP(pfTCPConnect pfConnect) {
+
+    pfConnectHandler = pfConnect;
+}
+
+/*******************************************************************************
+ *  function :    onListenSocket
+ ******************************************************************************/
+/** \brief        Accepts all pending connection attempts.
+ *
+ *  \type         static
+ *
+ *  \param[in]    fd         listening socket
+ *  \param[in]    u32Events  pending epoll events
+ *  \param[in]    pvData     not used
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onListenSocket(int fd, uint32_t u32Events, void * pvData) {
+
+    int                newsockfd;
+    int                s32Opt = 1;
+    struct sockaddr_in cli_addr;
+    socklen_t          clilen;
+    sConnection *      psConn;
+
+    while(1) {
+
+        clilen = sizeof(cli_addr);
+        newsockfd = accept4(fd, (struct sockaddr*) &cli_addr, &clilen,
+                            SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(newsockfd < 0) {
+            if((errno != EAGAIN) && (errno != EWOULDBLOCK)
+                && (errno != EINTR)) {
+                WARNINGPRINT("accept() failed: %s", strerror(errno));
+            }
+            break;
+        }
+
+        psConn = allocConnection();
+        if(psConn == NULL) {
+            WARNINGPRINT("too many clients, connection refused");
+            close(newsockfd);
+            continue;
+        }
+
+        /* Small messages shall leave immediately */
+        setsockopt(newsockfd, IPPROTO_TCP, TCP_NODELAY,
+                   &s32Opt, sizeof(s32Opt));
+
+        psConn->fd = newsockfd;
+        psConn->u32Id = ++u32ConnectionId;
+        psConn->eProto = CONN_PROTO_UNKNOWN;
+        psConn->bClosing = FALSE;
+        psConn->u32RxLen = 0;
+        psConn->u32MsgLen = 0;
+        psConn->bFragmented = FALSE;
+        initFramer(&psConn->sRxFramer, CONFIG_SOCKET_RAW_FRAMING);
+        psConn->u32TxLen = 0;
+        psConn->u32TxMsgs = 0;
+        psConn->bTxStarted = FALSE;
+
+        if(addReactorFd(newsockfd, EPOLLIN, onClientSocket, psConn)
+            != BBB_SUCCESS) {
+            close(newsockfd);
+            psConn->fd = -1;
+        } else {
+            u32Connections++;
+            INFOPRINT("connection %u established (%s:%d), %u client(s)",
+                      psConn->u32Id, inet_ntoa(cli_addr.sin_addr),
+                      ntohs(cli_addr.sin_port), u32Connections);
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    onClientSocket
+ ******************************************************************************/
+/** \brief        Handles pending events of a client socket.
+ *
+ *  \type         static
+ *
+ *  \param[in]    fd         client socket
+ *  \param[in]    u32Events  pending epoll events
+ *  \param[in]    pvData     corresponding connection
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onClientSocket(int fd, uint32_t u32Events, void * pvData) {
+
+    sConnection * psConn = (sConnection *) pvData;
+
+    if((u32Events & EPOLLOUT) != 0) {
+        if(flushDataTCP(psConn) != BBB_SUCCESS) {
+            return;
+        }
+    }
+
+    if((u32Events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+        receiveDataTCP(psConn);
+    }
+}
+
+/*******************************************************************************
+ *  function :    receiveDataTCP
+ ******************************************************************************/
+/** \brief        Receives pending data of a client and processes it according
+ *                to the protocol of the connection.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void receiveDataTCP(sConnection * psConn) {
+
+    ssize_t rx_data_len;
+
+    if(psConn->u32RxLen >= RX_BUFFER_SIZE) {
+        /* A handshake or raw message which does not fit into the buffer */
+        WARNINGPRINT("connection %u: receive buffer overflow", psConn->u32Id);
+        closeConnection(psConn);
+        return;
+    }
+
+    rx_data_len = recv(psConn->fd, &psConn->acRxBuf[psConn->u32RxLen],
+                       RX_BUFFER_SIZE - psConn->u32RxLen, MSG_DONTWAIT);
+
+    if(rx_data_len == 0) {
+
+        INFOPRINT("connection %u closed by client", psConn->u32Id);
+        closeConnection(psConn);
+        return;
+
+    } else if(rx_data_len < 0) {
+
+        if((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+            INFOPRINT("connection %u: error reading: %s",
+                      psConn->u32Id, strerror(errno));
+            closeConnection(psConn);
+        }
+        return;
+    }
+
+    psConn->u32RxLen += (uint32_t) rx_data_len;
+    psConn->acRxBuf[psConn->u32RxLen] = '\0';
+
+    if(psConn->bClosing == TRUE) {
+        /* Nothing is processed anymore, wait until acTxBuf is sent */
+        psConn->u32RxLen = 0;
+        return;
+    }
+
+    if(psConn->eProto == CONN_PROTO_UNKNOWN) {
+        if(isWsHandshake(psConn->acRxBuf, psConn->u32RxLen) == FALSE) {
+            psConn->eProto = CONN_PROTO_RAW;
+            establishConnection(psConn);
+            if(psConn->fd < 0) {
+                return;
+            }
+        } else if(psConn->u32RxLen >= 4) {
+            psConn->eProto = CONN_PROTO_HANDSHAKE;
+        }
+    }
+
+    switch(psConn->eProto) {
+
+        case CONN_PROTO_HANDSHAKE:
+            processHandshake(psConn);
+            break;
+
+        case CONN_PROTO_WEBSOCKET:
+            processFrames(psConn);
+            break;
+
+        case CONN_PROTO_RAW:
+            psConn->u32RxLen = dispatchMessages(psConn, &psConn->sRxFramer,
+                                                psConn->acRxBuf,
+                                                psConn->u32RxLen);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+ *  function :    processHandshake
+ ******************************************************************************/
+/** \brief        Answers the opening handshake of a WebSocket client as soon
+ *                as the complete request was received.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void processHandshake(sConnection * psConn) {
+
+    BBBError error;
+    char     acResponse[256];
+    uint32_t u32ResponseLen = 0;
+    uint32_t u32RequestLen = 0;
+
+    error = parseWsHandshake(psConn->acRxBuf, psConn->u32RxLen, &u32RequestLen,
+                             acResponse, sizeof(acResponse), &u32ResponseLen);
+
+    if(error == BBB_WS_INCOMPLETE) {
+        return;
+    }
+
+    if(sendRawTCP(psConn, acResponse, u32ResponseLen, 0, NULL)
+        != BBB_SUCCESS) {
+        if(psConn->fd >= 0) {
+            closeConnection(psConn);
+        }
+        return;
+    }
+
+    if(error != BBB_SUCCESS) {
+        WARNINGPRINT("connection %u: invalid handshake", psConn->u32Id);
+        psConn->bClosing = TRUE;
+        if(psConn->u32TxMsgs == 0) {
+            closeConnection(psConn);
+        }
+        return;
+    }
+
+    INFOPRINT("connection %u: websocket established", psConn->u32Id);
+    psConn->eProto = CONN_PROTO_WEBSOCKET;
+    establishConnection(psConn);
+    if(psConn->fd < 0) {
+        return;
+    }
+
+    /* A client may send its first frames right behind the request */
+    psConn->u32RxLen -= u32RequestLen;
+    memmove(psConn->acRxBuf, &psConn->acRxBuf[u32RequestLen],
+            psConn->u32RxLen + 1);
+    if(psConn->u32RxLen > 0) {
+        processFrames(psConn);
+    }
+}
+
+/*******************************************************************************
+ *  function :    processFrames
+ ******************************************************************************/
+/** \brief        Processes all complete WebSocket frames within the receive
+ *                buffer of the connection.
+ *                <p>
+ *                Data frames are reassembled in the message buffer of the
+ *                connection, complete messages are handed to the receive
+ *                handler. Pings are answered with a pong, a close frame is
+ *                echoed before the connection is closed.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void processFrames(sConnection * psConn) {
+
+    BBBError error = BBB_SUCCESS;
+    sWsFrame sFrame;
+    uint32_t u32Offset = 0;
+    uint8_t *pu8Frame;
+    char *   pcPayload;
+    uint32_t u32Code;
+    sFramer  sMsgFramer;
+
+    while((psConn->fd >= 0) && (psConn->bClosing == FALSE)) {
+
+        pu8Frame = (uint8_t *) &psConn->acRxBuf[u32Offset];
+        error = parseWsFrame(pu8Frame, psConn->u32RxLen - u32Offset,
+                             MSG_BUFFER_SIZE, &sFrame);
+        if(error != BBB_SUCCESS) {
+            break;
+        }
+
+        pcPayload = (char *) &pu8Frame[sFrame.u32HeaderLen];
+        u32Offset += sFrame.u32HeaderLen + sFrame.u32PayloadLen;
+
+        switch(sFrame.eOpcode) {
+
+            case WS_OP_TEXT:
+            case WS_OP_BINARY:
+            case WS_OP_CONTINUATION:
+                /* A new message must not interrupt a fragmented one and a */
+                /* continuation needs a started message                    */
+                if((sFrame.eOpcode == WS_OP_CONTINUATION)
+                    != (psConn->bFragmented == TRUE)) {
+                    error = BBB_WS_PROTOCOL;
+                    break;
+                }
+                if((psConn->u32MsgLen + sFrame.u32PayloadLen)
+                    > MSG_BUFFER_SIZE) {
+                    error = BBB_WS_TOO_BIG;
+                    break;
+                }
+                memcpy(&psConn->acMsgBuf[psConn->u32MsgLen], pcPayload,
+                       sFrame.u32PayloadLen);
+                psConn->u32MsgLen += sFrame.u32PayloadLen;
+                psConn->bFragmented = (sFrame.bFin == TRUE) ? FALSE : TRUE;
+
+                if(sFrame.bFin == TRUE) {
+                    /* A message may hold several JSON objects */
+                    initFramer(&sMsgFramer, FRAMER_JSON);
+                    dispatchMessages(psConn, &sMsgFramer, psConn->acMsgBuf,
+                                     psConn->u32MsgLen);
+                    psConn->u32MsgLen = 0;
+                }
+                break;
+
+            case WS_OP_PING:
+                sendFrameTCP(psConn, WS_OP_PONG, pcPayload,
+                             sFrame.u32PayloadLen, 0);
+                break;
+
+            case WS_OP_PONG:
+                break;
+
+            case WS_OP_CLOSE:
+                u32Code = WS_CLOSE_NORMAL;
+                if(sFrame.u32PayloadLen >= 2) {
+                    u32Code = ((uint8_t) pcPayload[0] << 8)
+                              | (uint8_t) pcPayload[1];
+                }
+                INFOPRINT("connection %u closed by client (%u)",
+                          psConn->u32Id, u32Code);
+                sendCloseTCP(psConn, WS_CLOSE_NORMAL);
+                return;
+
+            default:
+                error = BBB_WS_PROTOCOL;
+                break;
+        }
+
+        if(error != BBB_SUCCESS) {
+            break;
+        }
+    }
+
+    if(psConn->fd < 0) {
+        return;
+    }
+
+    if(error == BBB_WS_PROTOCOL) {
+        WARNINGPRINT("connection %u: protocol error", psConn->u32Id);
+        sendCloseTCP(psConn, WS_CLOSE_PROTOCOL);
+    } else if(error == BBB_WS_TOO_BIG) {
+        WARNINGPRINT("connection %u: message too big", psConn->u32Id);
+        sendCloseTCP(psConn, WS_CLOSE_TOO_BIG);
+    } else if((psConn->fd >= 0) && (u32Offset > 0)) {
+        /* Keep the beginning of an incomplete frame */
+        psConn->u32RxLen -= u32Offset;
+        memmove(psConn->acRxBuf, &psConn->acRxBuf[u32Offset],
+                psConn->u32RxLen + 1);
+    }
+}
+
+/*******************************************************************************
+ *  function :    dispatchMessages
+ ******************************************************************************/
+/** \brief        Hands every complete message within the buffer to the
+ *                receive handler.
+ *                <p>
+ *                The messages are handed over in place. Afterwards the
+ *                processed bytes are removed from the buffer, the beginning
+ *                of an incomplete message is kept.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    psFramer   scan state of the buffer
+ *  \param[in]    pcBuf      buffer
+ *  \param[in]    u32Length  number of bytes within the buffer
+ *
+ *  \return       number of bytes remaining within the buffer
+ *
+ ******************************************************************************/
+static uint32_t dispatchMessages(sConnection * psConn,
+                                 sFramer * psFramer,
+                                 char * pcBuf,
+                                 uint32_t u32Length) {
+
+    char *   pcMsg;
+    uint32_t u32MsgLen;
+
+    while((psConn->fd >= 0)
+          && (nextFramerMessage(psFramer, pcBuf, u32Length,
+                                &pcMsg, &u32MsgLen) == TRUE)) {
+
+        pfReceiveHandler(psConn, pcMsg, u32MsgLen);
+    }
+
+    return (compactFramer(psFramer, pcBuf, u32Length));
+}
+
+/*******************************************************************************
+ *  function :    sendRawTCP
+ ******************************************************************************/
+/** \brief        Sends data without blocking, the remainder is queued on the
+ *                connection.
+ *                <p>
+ *                If data is pending, the queued messages outdated by u32Keys
+ *                are removed first and the data is appended as a new message:
+ *                by reference if it lies in a shared broadcast frame,
+ *                otherwise copied into the transmit buffer.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    pcData     data to be sent
+ *  \param[in]    u32Length  number of bytes to be sent
+ *  \param[in]    u32Keys    mask of the keys of the message (see
+ *                           sendLatestTCP())
+ *  \param[in]    psShared   shared frame containing pcData, NULL if the data
+ *                           has to be copied
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success (data sent or queued)
+ *                BBB_SOCKET_SEND    message dropped, transmit queue is full
+ *                BBB_SOCKET_CLOSED  connection was closed
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError sendRawTCP(sConnection * psConn,
+                           const char * pcData,
+                           uint32_t u32Length,
+                           uint32_t u32Keys,
+                           sTxShared * psShared) {
+
+    BBBError     error = BBB_SUCCESS;
+    ssize_t      tx_msg_len = 0;
+    uint32_t     u32Msg;
+    sTxMessage * psMsg;
+
+    /* Keep the order: only send directly if nothing is pending */
+    if(psConn->u32TxMsgs == 0) {
+
+        tx_msg_len = send(psConn->fd, pcData, u32Length,
+                          MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(tx_msg_len < 0) {
+            if((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                tx_msg_len = 0;
+            } else {
+                INFOPRINT("connection %u lost: %s",
+                          psConn->u32Id, strerror(errno));
+                closeConnection(psConn);
+                return (BBB_SOCKET_CLOSED);
+            }
+        }
+    }
+
+    pcData += tx_msg_len;
+    u32Length -= (uint32_t) tx_msg_len;
+
+    if((u32Length > 0) && (u32Keys != 0)) {
+        /* Remove the messages whose values are all outdated by this one */
+        u32Msg = psConn->u32TxMsgs;
+        while(u32Msg > ((psConn->bTxStarted == TRUE) ? 1 : 0)) {
+            u32Msg--;
+            if((psConn->asTxMsg[u32Msg].u32Keys != 0) &&
+               ((psConn->asTxMsg[u32Msg].u32Keys & ~u32Keys) == 0)) {
+                removeTxMessage(psConn, u32Msg);
+            }
+        }
+    }
+
+    if(u32Length > 0) {
+        if((psConn->u32TxMsgs >= TX_QUEUE_SIZE) ||
+           ((psShared == NULL) &&
+            (u32Length > (TX_BUFFER_SIZE - psConn->u32TxLen)))) {
+            WARNINGPRINT("connection %u: transmit buffer full, "
+                         "message dropped", psConn->u32Id);
+            error = BBB_SOCKET_SEND;
+        } else {
+            if(psConn->u32TxMsgs == 0) {
+                modifyReactorFd(psConn->fd, EPOLLIN | EPOLLOUT);
+                /* The rest of a partly sent message can not be replaced */
+                psConn->bTxStarted = (tx_msg_len > 0) ? TRUE : FALSE;
+            }
+            psMsg = &psConn->asTxMsg[psConn->u32TxMsgs];
+            psMsg->psShared = psShared;
+            psMsg->u32Length = u32Length;
+            psMsg->u32Keys = u32Keys;
+            psConn->u32TxMsgs++;
+            if(psShared != NULL) {
+                psMsg->u32Start = (uint32_t) (pcData - psShared->acData);
+                psShared->u32Refs++;
+            } else {
+                psMsg->u32Start = psConn->u32TxLen;
+                memcpy(&psConn->acTxBuf[psConn->u32TxLen], pcData, u32Length);
+                psConn->u32TxLen += u32Length;
+            }
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    composeFrameTCP
+ ******************************************************************************/
+/** \brief        Composes a WebSocket frame of a message
+ *
+ *  \type         static
+ *
+ *  \param[out]   pcFrame    frame, WS_MAX_HEADER + u32Length bytes
+ *  \param[in]    eOpcode    opcode of the frame
+ *  \param[in]    pcData     payload
+ *  \param[in]    u32Length  number of bytes of the payload
+ *
+ *  \return       length of the frame
+ *
+ ******************************************************************************/
+static uint32_t composeFrameTCP(char * pcFrame,
+                                eWsOpcode eOpcode,
+                                const char * pcData,
+                                uint32_t u32Length) {
+
+    uint32_t u32HeaderLen;
+
+    u32HeaderLen = composeWsHeader((uint8_t *) pcFrame, eOpcode, u32Length);
+    memcpy(&pcFrame[u32HeaderLen], pcData, u32Length);
+
+    return (u32HeaderLen + u32Length);
+}
+
+/*******************************************************************************
+ *  function :    sendFrameTCP
+ ******************************************************************************/
+static BBBError sendFrameTCP(sConnection * psConn,
+                             eWsOpcode eOpcode,
+                             const char * pcData,
+                             uint32_t u32Length,
+                             uint32_t u32Keys) {
+
+    static char acFrame[WS_MAX_HEADER + TX_BUFFER_SIZE];
+
+    if(u32Length > TX_BUFFER_SIZE) {
+        WARNINGPRINT("connection %u: message too big, dropped", psConn->u32Id);
+        return (BBB_SOCKET_SEND);
+    }
+
+    return (sendRawTCP(psConn, acFrame,
+                       composeFrameTCP(acFrame, eOpcode, pcData, u32Length),
+                       u32Keys, NULL));
+}
+
+/*******************************************************************************
+ *  function :    sendCloseTCP
+ ******************************************************************************/
+/** \brief        Sends a close frame and closes the connection as soon as the
+ *                transmit buffer is empty.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    eCode      status code of the close frame
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void sendCloseTCP(sConnection * psConn, eWsCloseCode eCode) {
+
+    char acCode[2];
+
+    acCode[0] = (char) ((uint32_t) eCode >> 8);
+    acCode[1] = (char) ((uint32_t) eCode & 0xff);
+
+    if(sendFrameTCP(psConn, WS_OP_CLOSE, acCode, sizeof(acCode), 0)
+        != BBB_SOCKET_CLOSED) {
+
+        psConn->bClosing = TRUE;
+        if(psConn->u32TxMsgs == 0) {
+            closeConnection(psConn);
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    allocTxShared
+ ******************************************************************************/
+/** \brief        Returns a shared frame which is not queued on any connection
+ *
+ *  \type         static
+ *
+ *  \return       shared frame, NULL if all are in use
+ *
+ ******************************************************************************/
+static sTxShared * allocTxShared(void) {
+
+    uint32_t i;
+
+    for(i = 0; i < TX_SHARED_SIZE; i++) {
+        if(asTxShared[i].u32Refs == 0) {
+            return (&asTxShared[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    removeTxMessage
+ ******************************************************************************/
+/** \brief        Removes a queued message from the transmit queue.
+ *                <p>
+ *                A shared frame is released, a message in the transmit buffer
+ *                is cut out of it.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    u32Msg     index of the message in asTxMsg
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void removeTxMessage(sConnection * psConn, uint32_t u32Msg) {
+
+    sTxMessage * psMsg = &psConn->asTxMsg[u32Msg];
+    uint32_t     u32End;
+    uint32_t     i;
+
+    if(psMsg->psShared != NULL) {
+        psMsg->psShared->u32Refs--;
+    } else {
+        u32End = psMsg->u32Start + psMsg->u32Length;
+        memmove(&psConn->acTxBuf[psMsg->u32Start], &psConn->acTxBuf[u32End],
+                psConn->u32TxLen - u32End);
+        psConn->u32TxLen -= psMsg->u32Length;
+        for(i = u32Msg + 1; i < psConn->u32TxMsgs; i++) {
+            if(psConn->asTxMsg[i].psShared == NULL) {
+                psConn->asTxMsg[i].u32Start -= psMsg->u32Length;
+            }
+        }
+    }
+
+    psConn->u32TxMsgs--;
+    memmove(psMsg, psMsg + 1, (psConn->u32TxMsgs - u32Msg) * sizeof(*psMsg));
+}
+
+/*******************************************************************************
+ *  function :    flushDataTCP
+ ******************************************************************************/
+/** \brief        Sends the transmit queue of a connection with one call of
+ *                sendmsg() and drops the messages sent completely.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success (data sent or still queued)
+ *                BBB_SOCKET_CLOSED  connection was closed
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError flushDataTCP(sConnection * psConn) {
+
+    struct iovec  asIov[TX_QUEUE_SIZE];
+    struct msghdr sMsgHdr;
+    sTxMessage *  psMsg;
+    ssize_t       tx_msg_len;
+    uint32_t      u32Sent;
+    uint32_t      u32Private = 0;
+    uint32_t      u32Done = 0;
+    uint32_t      u32Msg;
+
+    for(u32Msg = 0; u32Msg < psConn->u32TxMsgs; u32Msg++) {
+        psMsg = &psConn->asTxMsg[u32Msg];
+        asIov[u32Msg].iov_base = (psMsg->psShared != NULL) ?
+                                 &psMsg->psShared->acData[psMsg->u32Start] :
+                                 &psConn->acTxBuf[psMsg->u32Start];
+        asIov[u32Msg].iov_len = psMsg->u32Length;
+    }
+    memset(&sMsgHdr, 0, sizeof(sMsgHdr));
+    sMsgHdr.msg_iov = asIov;
+    sMsgHdr.msg_iovlen = psConn->u32TxMsgs;
+
+    /* sendmsg() instead of writev(): MSG_NOSIGNAL, no SIGPIPE */
+    tx_msg_len = sendmsg(psConn->fd, &sMsgHdr, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if(tx_msg_len < 0) {
+        if((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return (BBB_SUCCESS);
+        }
+        INFOPRINT("connection %u lost: %s", psConn->u32Id, strerror(errno));
+        closeConnection(psConn);
+        return (BBB_SOCKET_CLOSED);
+    }
+    u32Sent = (uint32_t) tx_msg_len;
+
+    /* Drop the messages sent completely, the rest of a partly sent one can */
+    /* not be replaced any more                                             */
+    while((u32Done < psConn->u32TxMsgs) &&
+          (psConn->asTxMsg[u32Done].u32Length <= u32Sent)) {
+        psMsg = &psConn->asTxMsg[u32Done];
+        u32Sent -= psMsg->u32Length;
+        if(psMsg->psShared != NULL) {
+            psMsg->psShared->u32Refs--;
+        } else {
+            u32Private += psMsg->u32Length;
+        }
+        u32Done++;
+    }
+    if(u32Sent > 0) {
+        psMsg = &psConn->asTxMsg[u32Done];
+        psMsg->u32Start += u32Sent;
+        psMsg->u32Length -= u32Sent;
+        if(psMsg->psShared == NULL) {
+            u32Private += u32Sent;
+        }
+        psConn->bTxStarted = TRUE;
+    } else if(u32Done > 0) {
+        psConn->bTxStarted = FALSE;
+    }
+
+    psConn->u32TxMsgs -= u32Done;
+    memmove(psConn->asTxMsg, &psConn->asTxMsg[u32Done],
+            psConn->u32TxMsgs * sizeof(sTxMessage));
+
+    /* The private data sent lies at the start of the transmit buffer */
+    if(u32Private > 0) {
+        psConn->u32TxLen -= u32Private;
+        memmove(psConn->acTxBuf, &psConn->acTxBuf[u32Private],
+                psConn->u32TxLen);
+        for(u32Msg = 0; u32Msg < psConn->u32TxMsgs; u32Msg++) {
+            if(psConn->asTxMsg[u32Msg].psShared == NULL) {
+                psConn->asTxMsg[u32Msg].u32Start -= u32Private;
+            }
+        }
+    }
+
+    if(psConn->u32TxMsgs > 0) {
+        /* wait for EPOLLOUT */
+    } else if(psConn->bClosing == TRUE) {
+        closeConnection(psConn);
+        return (BBB_SOCKET_CLOSED);
+    } else {
+        modifyReactorFd(psConn->fd, EPOLLIN);
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    allocConnection
+ ******************************************************************************/
+static sConnection * allocConnection(void) {
+
+    uint32_t i;
+
+    for(i = 0; i < CONFIG_SOCKET_MAX_CLIENTS; i++) {
+        if(asConnection[i].fd < 0) {
+            return (&asConnection[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    establishConnection
+ ******************************************************************************/
+/** \brief        Counts a connection which receives messages from now on and
+ *                calls the connect handler.
+ *                <p>
+ *                The handler may send data and thus close the connection,
+ *                the caller has to check psConn->fd afterwards.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection, eProto is CONN_PROTO_WEBSOCKET or
+ *                           CONN_PROTO_RAW
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void establishConnection(sConnection * psConn) {
+
+    u32Clients++;
+    if(pfConnectHandler != NULL) {
+        pfConnectHandler(psConn);
+    }
+}
+
+/*******************************************************************************
+ *  function :    closeConnection
+ ******************************************************************************/
+static void closeConnection(sConnection * psConn) {
+
+    uint32_t u32Msg;
+
+    if((psConn->eProto == CONN_PROTO_WEBSOCKET) ||
+       (psConn->eProto == CONN_PROTO_RAW)) {
+        u32Clients--;
+    }
+    psConn->eProto = CONN_PROTO_UNKNOWN;
+    removeReactorFd(psConn->fd);
+    close(psConn->fd);
+    psConn->fd = -1;
+    psConn->bClosing = FALSE;
+    psConn->u32RxLen = 0;
+    psConn->u32MsgLen = 0;
+    for(u32Msg = 0; u32Msg < psConn->u32TxMsgs; u32Msg++) {
+        if(psConn->asTxMsg[u32Msg].psShared != NULL) {
+            psConn->asTxMsg[u32Msg].psShared->u32Refs--;
+        }
+    }
+    psConn->u32TxLen = 0;
+    psConn->u32TxMsgs = 0;
+    psConn->bTxStarted = FALSE;
+    u32Connections--;
 }
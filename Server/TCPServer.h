@@ -4,7 +4,41 @@
 /** \file       TCPServer.h
  *******************************************************************************
  *
- *  \brief
+ *  \brief      Non-blocking multi client TCP server of the beaglebone black
+ *              webhouse.
+ *              <p>
+ *              The server listens on CONFIG_SOCKET_PORT and serves up to
+ *              CONFIG_SOCKET_MAX_CLIENTS clients concurrently out of the
+ *              main thread. All sockets are registered at the reactor
+ *              (Reactor.h), thus runReactor() must be called periodically.
+ *              <p>
+ *              Browsers connect with the WebSocket protocol (RFC 6455): the
+ *              server answers the HTTP upgrade request itself, negotiates
+ *              the subprotocol CONFIG_WEBSOCKET_PROTOCOL, reassembles
+ *              fragmented messages and answers ping and close frames.
+ *              Clients which do not start with a HTTP GET request are served
+ *              as raw TCP clients. The connect handler
+ *              (setConnectHandlerTCP()) is called as soon as a connection
+ *              receives messages: after the opening handshake, or with the
+ *              first data of a raw client.
+ *              <p>
+ *              Both the payload of a WebSocket message and the byte stream of
+ *              a raw client are split into single messages by the framer
+ *              (Framer.h). Every message is handed to the receive handler
+ *              separately, even if several of them arrived within one
+ *              segment. A raw message split over several segments is kept
+ *              until it is complete.
+ *              <p>
+ *              Outgoing data is sent without blocking (as a text frame to
+ *              WebSocket clients); data the socket can not take at once is
+ *              kept in the transmit buffer of the connection. The transmit
+ *              buffer keeps up to TX_QUEUE_SIZE messages. A message sent with
+ *              sendLatestTCP() carries a mask of the keys (values) it
+ *              contains. It replaces every queued message whose keys it
+ *              contains as well, thus a slow client gets the latest values
+ *              instead of a growing backlog of stale ones. A slow client never
+ *              blocks the server or the other clients, a message which does
+ *              not fit into the transmit buffer is dropped.
  *
  *  \author     N00bs
  *
@@ -12,25 +46,112 @@
  *
  ******************************************************************************/
 /*
- *  function    .
+ *  function    initTCPServer
+ *              finalizeTCPServer
+ *              sendDataTCP
+ *              sendLatestTCP
+ *              broadcastDataTCP
+ *              broadcastLatestTCP
+ *              getNumberOfConnections
+ *              getNumberOfClients
+ *              setConnectHandlerTCP
  *
  ******************************************************************************/
-#define SERVER_PORT_NBR 5000	//siehe Webhausdoku s.1
 
-#define BACKLOG 5
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
 
-#define RX_BUFFER_SIZE 500
-#define TX_BUFFER_SIZE 500
+#include "BBBTypes.h"
+#include "BBBConfig.h"
+#include "Framer.h"
 
-extern int sockfd;
-extern int newsockfd;
-extern char rxBuf[RX_BUFFER_SIZE];
-extern char txBuf[TX_BUFFER_SIZE];
-extern int sockfd;
-extern int newsockfd;
+//----- Macros -----------------------------------------------------------------
+#define RX_BUFFER_SIZE CONFIG_SOCKET_INPUT_BUFFER
+#define TX_BUFFER_SIZE CONFIG_SOCKET_OUTPUT_BUFFER
+#define MSG_BUFFER_SIZE CONFIG_SOCKET_MESSAGE_BUFFER
+#define TX_QUEUE_SIZE CONFIG_SOCKET_TX_QUEUE
+#define TX_SHARED_SIZE CONFIG_SOCKET_TX_SHARED
 
-/* prototypes */
-int receiveDataTCP();
-void sendDataTCP();
+//----- Data types -------------------------------------------------------------
+
+/** Protocol spoken on a connection */
+typedef enum _eConnProtocol {
+
+    CONN_PROTO_UNKNOWN   = 0,  ///< nothing received yet
+    CONN_PROTO_HANDSHAKE = 1,  ///< WebSocket opening handshake in progress
+    CONN_PROTO_WEBSOCKET = 2,  ///< WebSocket (RFC 6455)
+    CONN_PROTO_RAW       = 3   ///< raw TCP
+
+} eConnProtocol;
+
+/** Broadcast frame shared by the connections (TCPServer.c) */
+struct _sTxShared;
+
+/** Message in the transmit queue of a connection */
+typedef struct _sTxMessage {
+
+    struct _sTxShared * psShared;  ///< shared frame, NULL if in acTxBuf
+    uint32_t u32Start;  ///< offset of the message within acTxBuf or psShared
+    uint32_t u32Length; ///< number of bytes not yet sent
+    uint32_t u32Keys;   ///< keys of the message, 0 if it is never replaced
+
+} sTxMessage;
+
+/** State of a single client connection */
+typedef struct _sConnection {
+
+    int           fd;                        ///< socket, -1 if slot is unused
+    uint32_t      u32Id;                     ///< connection number (logging)
+    eConnProtocol eProto;                    ///< protocol of the connection
+    boolE         bClosing;                  ///< close once asTxMsg is sent
+    char          acRxBuf[RX_BUFFER_SIZE + 1];///< received, unprocessed data
+    uint32_t      u32RxLen;                  ///< number of bytes in acRxBuf
+    sFramer       sRxFramer;                 ///< message split of raw stream
+    char          acMsgBuf[MSG_BUFFER_SIZE + 1];///< reassembled message
+    uint32_t      u32MsgLen;                 ///< number of bytes in acMsgBuf
+    boolE         bFragmented;               ///< fragmented message pending
+    char          acTxBuf[TX_BUFFER_SIZE];   ///< queued data of this client
+    uint32_t      u32TxLen;                  ///< number of bytes in acTxBuf
+    sTxMessage    asTxMsg[TX_QUEUE_SIZE];    ///< data not yet taken by socket
+    uint32_t      u32TxMsgs;                 ///< number of messages in asTxMsg
+    boolE         bTxStarted;                ///< asTxMsg[0] is partly sent
+
+} sConnection;
+
+/** Handler of a single received message (not '\0' terminated) */
+typedef void (*pfTCPReceive)(sConnection * psConn,
+                             char * pcData,
+                             uint32_t u32Length);
+
+/** Handler of a connection which receives messages from now on */
+typedef void (*pfTCPConnect)(sConnection * psConn);
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError initTCPServer(uint16_t u16Port, pfTCPReceive pfReceive);
+
+extern BBBError finalizeTCPServer(void);
+
+extern BBBError sendDataTCP(sConnection * psConn,
+                            const char * pcData,
+                            uint32_t u32Length);
+
+extern BBBError sendLatestTCP(sConnection * psConn,
+                              const char * pcData,
+                              uint32_t u32Length,
+                              uint32_t u32Keys);
+
+extern BBBError broadcastDataTCP(const char * pcData, uint32_t u32Length);
+
+extern BBBError broadcastLatestTCP(const char * pcData,
+                                   uint32_t u32Length,
+                                   uint32_t u32Keys);
+
+extern uint32_t getNumberOfConnections(void);
+
+extern uint32_t getNumberOfClients(void);
+
+extern void     setConnectHandlerTCP(pfTCPConnect pfConnect);
+
+//----- Data -------------------------------------------------------------------
 
 #endif /* TCPSERVER_H_ */
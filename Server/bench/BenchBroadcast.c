@@ -0,0 +1,456 @@
+/******************************************************************************/
+/** \file       BenchBroadcast.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of the broadcast of telemetry to many WebSocket
+ *              clients.
+ *              <p>
+ *              The clients are connected over the loopback interface to the
+ *              server of TCPServer.c and complete the WebSocket handshake.
+ *              For every number of clients, BENCH_UPDATES messages are sent
+ *              to all of them, once with broadcastLatestTCP() (framed once
+ *              per update) and once with sendLatestTCP() per connection
+ *              (framed per client). Only the CPU time of the send calls is
+ *              measured, in two scenarios:
+ *              <ul>
+ *              <li> sent directly: the clients are drained in between, each
+ *              message is handed to send(2) at once
+ *              <li> queued: the clients do not read, the socket buffers of
+ *              the server are full, thus every message is queued on the
+ *              connection (broadcast by reference, otherwise copied) and
+ *              replaces the one queued before
+ *              </ul>
+ *              <p>
+ *              Build (from Server/). 1000 clients need more connections and
+ *              file descriptors than the server is configured for:
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw \
+ *                  -DCONFIG_SOCKET_MAX_CLIENTS=1024 \
+ *                  -DCONFIG_REACTOR_MAX_FD=4096 \
+ *                  bench/BenchBroadcast.c TCPServer.c sys/Reactor.c \
+ *                  comm/Framer.c comm/WebSocket.c sys/Log.c sys/LogAsync.c \
+ *                  sys/BBBSignal.c -lpthread -o BenchBroadcast
+ *              </pre>
+ *              Usage: BenchBroadcast [clients ...] (default 10 100 1000)
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *  functions  local:
+ *              onReceive
+ *              connectClient
+ *              drainClients
+ *              stallClients
+ *              releaseClients
+ *              measureUpdates
+ *              getCpuNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "BBBTypes.h"
+#include "BBBConfig.h"
+#include "TCPServer.h"
+#include "Reactor.h"
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+#define BENCH_PORT         ( 5099 )
+/** Number of messages sent per number of clients and method                 */
+#define BENCH_UPDATES      ( 2000 )
+/** Keys of the message (KEY_TEMPIST | KEY_HEIZUNG of RxTxJSON.h)             */
+#define BENCH_KEYS         ( 0x03 )
+/** Socket buffer size of a stalled connection, keeps the backlog small       */
+#define BENCH_SOCKET_BUFFER ( 4096 )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+static void     onReceive(sConnection * psConn,
+                          char * pcData,
+                          uint32_t u32Length);
+static BBBError connectClient(uint32_t u32Client);
+static void     drainClients(uint32_t u32Clients);
+static void     stallClients(uint32_t u32Clients);
+static void     releaseClients(uint32_t u32Clients);
+static uint64_t measureUpdates(uint32_t u32Clients,
+                               boolE bBroadcast,
+                               boolE bQueued);
+static uint64_t getCpuNs(void);
+
+//----- Data -------------------------------------------------------------------
+/** Client side sockets                                                       */
+static int           afdClient[CONFIG_SOCKET_MAX_CLIENTS];
+/** Server side connections, in the order of the clients                     */
+static sConnection * apsConn[CONFIG_SOCKET_MAX_CLIENTS];
+static uint32_t      u32Registered = 0;
+
+static const char    acRequest[] =
+    "GET / HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "Upgrade: websocket\r\n"
+    "Connection: Upgrade\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+    "Sec-WebSocket-Version: 13\r\n"
+    "\r\n";
+/** Masked text frame "{}" (mask 0), tells the server side connection        */
+static const uint8_t au8Hello[] = { 0x81, 0x82, 0, 0, 0, 0, '{', '}' };
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    static const uint32_t au32Default[] = { 10, 100, 1000 };
+    struct rlimit sLimit;
+    uint32_t      au32Clients[16];
+    uint32_t      u32Runs = 0;
+    uint32_t      u32Clients;
+    uint64_t      u64Once;
+    uint64_t      u64PerClient;
+    uint64_t      u64QueuedOnce;
+    uint64_t      u64QueuedPerClient;
+    uint32_t      i;
+    int           s32Arg;
+
+    for(s32Arg = 1; (s32Arg < argc) && (u32Runs < 16); s32Arg++) {
+        au32Clients[u32Runs++] = (uint32_t) atoi(argv[s32Arg]);
+    }
+    if(u32Runs == 0) {
+        memcpy(au32Clients, au32Default, sizeof(au32Default));
+        u32Runs = sizeof(au32Default) / sizeof(au32Default[0]);
+    }
+
+    /* Two sockets per client */
+    if(getrlimit(RLIMIT_NOFILE, &sLimit) == 0) {
+        sLimit.rlim_cur = sLimit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &sLimit);
+    }
+
+    /* Connections are logged as info */
+    for(i = 0; i < LOG_MODULES; i++) {
+        setLogLevel(i, LOG_LEVEL_WARNING);
+    }
+
+    if((initReactor() != BBB_SUCCESS) ||
+       (initTCPServer(BENCH_PORT, onReceive) != BBB_SUCCESS)) {
+        fprintf(stderr, "server could not be started\n");
+        return (EXIT_FAILURE);
+    }
+
+    printf("         sent directly [ns/client]       queued [ns/client]\n"
+           "clients  framed once  framed per client"
+           "  framed once  framed per client\n");
+
+    for(i = 0; i < u32Runs; i++) {
+
+        u32Clients = au32Clients[i];
+        if(u32Clients > CONFIG_SOCKET_MAX_CLIENTS) {
+            printf("%7u  more than CONFIG_SOCKET_MAX_CLIENTS (%u)\n",
+                   u32Clients, CONFIG_SOCKET_MAX_CLIENTS);
+            continue;
+        }
+        while(u32Registered < u32Clients) {
+            if(connectClient(u32Registered) != BBB_SUCCESS) {
+                fprintf(stderr, "client %u could not connect\n",
+                        u32Registered);
+                return (EXIT_FAILURE);
+            }
+        }
+        /* Clients beyond u32Clients would receive the broadcast as well */
+        if(getNumberOfConnections() != u32Clients) {
+            printf("%7u  skipped, %u clients are connected\n",
+                   u32Clients, getNumberOfConnections());
+            continue;
+        }
+
+        u64Once = measureUpdates(u32Clients, TRUE, FALSE);
+        u64PerClient = measureUpdates(u32Clients, FALSE, FALSE);
+        u64QueuedOnce = measureUpdates(u32Clients, TRUE, TRUE);
+        u64QueuedPerClient = measureUpdates(u32Clients, FALSE, TRUE);
+        printf("%7u  %11llu  %17llu  %11llu  %17llu\n", u32Clients,
+               (unsigned long long) (u64Once / u32Clients),
+               (unsigned long long) (u64PerClient / u32Clients),
+               (unsigned long long) (u64QueuedOnce / u32Clients),
+               (unsigned long long) (u64QueuedPerClient / u32Clients));
+    }
+
+    finalizeTCPServer();
+    finalizeReactor();
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    onReceive
+ ******************************************************************************/
+/** \brief        Remembers the server side connection of the client which
+ *                sent its hello message
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection
+ *  \param[in]    pcData     message
+ *  \param[in]    u32Length  length of the message
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onReceive(sConnection * psConn,
+                      char * pcData,
+                      uint32_t u32Length) {
+
+    if(u32Registered < CONFIG_SOCKET_MAX_CLIENTS) {
+        apsConn[u32Registered++] = psConn;
+    }
+}
+
+/*******************************************************************************
+ *  function :    connectClient
+ ******************************************************************************/
+/** \brief        Connects a client, completes the WebSocket handshake and
+ *                sends the hello message
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Client  index of the client
+ *
+ *  \return       BBB_SUCCESS on success, BBB_SOCKET_SOCKET otherwise
+ *
+ ******************************************************************************/
+static BBBError connectClient(uint32_t u32Client) {
+
+    struct sockaddr_in sAddr;
+    struct pollfd      sPoll;
+    char               acResponse[512];
+    uint32_t           u32Len = 0;
+    ssize_t            s32Read;
+    int                s32Opt = 1;
+    int                s32Size = BENCH_SOCKET_BUFFER;
+    int                fd;
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0) {
+        return (BBB_SOCKET_SOCKET);
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &s32Opt, sizeof(s32Opt));
+    /* Before connect(), the receive window is taken from it */
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &s32Size, sizeof(s32Size));
+
+    memset(&sAddr, 0, sizeof(sAddr));
+    sAddr.sin_family = AF_INET;
+    sAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sAddr.sin_port = htons(BENCH_PORT);
+    if((connect(fd, (struct sockaddr *) &sAddr, sizeof(sAddr)) < 0) ||
+       (write(fd, acRequest, sizeof(acRequest) - 1) < 0)) {
+        close(fd);
+        return (BBB_SOCKET_SOCKET);
+    }
+
+    /* The server answers from the reactor, thus it is run in between */
+    sPoll.fd = fd;
+    sPoll.events = POLLIN;
+    acResponse[0] = '\0';
+    while(strstr(acResponse, "\r\n\r\n") == NULL) {
+        runReactor(1);
+        if(poll(&sPoll, 1, 0) == 1) {
+            s32Read = read(fd, &acResponse[u32Len],
+                           sizeof(acResponse) - 1 - u32Len);
+            if(s32Read <= 0) {
+                close(fd);
+                return (BBB_SOCKET_SOCKET);
+            }
+            u32Len += (uint32_t) s32Read;
+            acResponse[u32Len] = '\0';
+        }
+    }
+    if(strncmp(acResponse, "HTTP/1.1 101", 12) != 0) {
+        close(fd);
+        return (BBB_SOCKET_SOCKET);
+    }
+
+    if(write(fd, au8Hello, sizeof(au8Hello)) < 0) {
+        close(fd);
+        return (BBB_SOCKET_SOCKET);
+    }
+    while(u32Registered <= u32Client) {
+        runReactor(1);
+    }
+
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    afdClient[u32Client] = fd;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    drainClients
+ ******************************************************************************/
+static void drainClients(uint32_t u32Clients) {
+
+    char     acBuf[4096];
+    uint32_t i;
+
+    for(i = 0; i < u32Clients; i++) {
+        while(read(afdClient[i], acBuf, sizeof(acBuf)) > 0) {
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    stallClients
+ ******************************************************************************/
+/** \brief        Fills the sockets of the clients (which do not read) until
+ *                data is queued on every server side connection
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Clients  number of connected clients
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void stallClients(uint32_t u32Clients) {
+
+    char     acFill[256];
+    int      s32Size = BENCH_SOCKET_BUFFER;
+    uint32_t i;
+
+    memset(acFill, ' ', sizeof(acFill));
+    for(i = 0; i < u32Clients; i++) {
+        setsockopt(apsConn[i]->fd, SOL_SOCKET, SO_SNDBUF,
+                   &s32Size, sizeof(s32Size));
+        while(apsConn[i]->u32TxMsgs == 0) {
+            if(sendDataTCP(apsConn[i], acFill, sizeof(acFill))
+                != BBB_SUCCESS) {
+                break;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    releaseClients
+ ******************************************************************************/
+/** \brief        Drains the clients until the server has sent everything
+ *                queued
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Clients  number of connected clients
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void releaseClients(uint32_t u32Clients) {
+
+    uint32_t u32Pending = u32Clients;
+    uint32_t i;
+
+    while(u32Pending > 0) {
+        drainClients(u32Clients);
+        runReactor(0);
+        u32Pending = 0;
+        for(i = 0; i < u32Clients; i++) {
+            if(apsConn[i]->u32TxMsgs > 0) {
+                u32Pending++;
+            }
+        }
+    }
+    drainClients(u32Clients);
+}
+
+/*******************************************************************************
+ *  function :    measureUpdates
+ ******************************************************************************/
+/** \brief        Sends BENCH_UPDATES messages to all clients
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Clients  number of connected clients
+ *  \param[in]    bBroadcast  TRUE: broadcastLatestTCP(), FALSE:
+ *                            sendLatestTCP() per connection
+ *  \param[in]    bQueued     TRUE: the clients are stalled, the messages
+ *                            are queued; FALSE: drained after each update
+ *
+ *  \return       CPU time of the send calls per update [ns]
+ *
+ ******************************************************************************/
+static uint64_t measureUpdates(uint32_t u32Clients,
+                               boolE bBroadcast,
+                               boolE bQueued) {
+
+    char     acMsg[64];
+    uint32_t u32Len;
+    uint64_t u64Start;
+    uint64_t u64Total = 0;
+    uint32_t u32Update;
+    uint32_t i;
+
+    if(bQueued == TRUE) {
+        stallClients(u32Clients);
+    }
+
+    for(u32Update = 0; u32Update < BENCH_UPDATES; u32Update++) {
+
+        u32Len = (uint32_t) snprintf(acMsg, sizeof(acMsg),
+                                     "{\"TempIst\":\"%u\",\"Heizung\":\"%u\"}",
+                                     20 + u32Update % 5, u32Update % 101);
+
+        u64Start = getCpuNs();
+        if(bBroadcast == TRUE) {
+            broadcastLatestTCP(acMsg, u32Len, BENCH_KEYS);
+        } else {
+            for(i = 0; i < u32Clients; i++) {
+                sendLatestTCP(apsConn[i], acMsg, u32Len, BENCH_KEYS);
+            }
+        }
+        u64Total += getCpuNs() - u64Start;
+
+        if(bQueued == FALSE) {
+            drainClients(u32Clients);
+        }
+    }
+
+    if(bQueued == TRUE) {
+        releaseClients(u32Clients);
+    }
+
+    return (u64Total / BENCH_UPDATES);
+}
+
+/*******************************************************************************
+ *  function :    getCpuNs
+ ******************************************************************************/
+static uint64_t getCpuNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
@@ -0,0 +1,393 @@
+/******************************************************************************/
+/** \file       BenchGpio.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of the gpio value access of the webhouse actuators.
+ *              <p>
+ *              Every iteration sets and reads the gpios of the TV (60) and the
+ *              LED (48), the time and the number of system calls per access
+ *              are reported for:
+ *              <ul>
+ *              <li> open per call: open, write/read and close of the value
+ *              file for every access (the former Gpio.c)
+ *              <li> cached fd: setGpioValue()/getGpioValue() of Gpio.c, a
+ *              single pwrite/pread on the value file opened at export
+ *              </ul>
+ *              <p>
+ *              On the beaglebone the real sysfs is used. Elsewhere Gpio.c is
+ *              built with GPIO_SYSFS_DIR set to a directory on a tmpfs, which
+ *              the benchmark fills with the files of the two gpios. The
+ *              system calls are counted by wrapping them at link time.
+ *              <p>
+ *              Build (from Server/), without the GPIO_SYSFS_DIR define on the
+ *              beaglebone:
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw \
+ *                  -DGPIO_SYSFS_DIR='"/dev/shm/webhouse-gpio"' \
+ *                  -Wl,--wrap=open,--wrap=close,--wrap=read,--wrap=write \
+ *                  -Wl,--wrap=pread,--wrap=pwrite \
+ *                  bench/BenchGpio.c hw/Gpio.c sys/Log.c sys/LogAsync.c \
+ *                  sys/BBBSignal.c -lpthread -o BenchGpio
+ *              </pre>
+ *              Usage: BenchGpio
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *              __wrap_open
+ *              __wrap_close
+ *              __wrap_read
+ *              __wrap_write
+ *              __wrap_pread
+ *              __wrap_pwrite
+ *  functions  local:
+ *              createStandIn
+ *              setValueOpen
+ *              getValueOpen
+ *              runOpen
+ *              runCached
+ *              printResult
+ *              getNowNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "BBBTypes.h"
+#include "Gpio.h"
+
+//----- Macros -----------------------------------------------------------------
+#ifndef GPIO_SYSFS_DIR
+#define GPIO_SYSFS_DIR     "/sys/class/gpio"
+#endif
+/** Gpios of the TV and the LED (see Webhouse.c)                             */
+#define BENCH_GPIO_TV      ( 60 )
+#define BENCH_GPIO_LED     ( 48 )
+/** Number of iterations, each with four accesses                            */
+#define BENCH_ITERATIONS   ( 100000 )
+#define BENCH_ACCESSES     ( 4 * BENCH_ITERATIONS )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+extern int     __real_open(const char * pcPath, int s32Flags, ...);
+extern int     __real_close(int fd);
+extern ssize_t __real_read(int fd, void * pvBuf, size_t count);
+extern ssize_t __real_write(int fd, const void * pvBuf, size_t count);
+extern ssize_t __real_pread(int fd, void * pvBuf, size_t count, off_t offset);
+extern ssize_t __real_pwrite(int fd, const void * pvBuf, size_t count,
+                             off_t offset);
+
+int            __wrap_open(const char * pcPath, int s32Flags, ...);
+int            __wrap_close(int fd);
+ssize_t        __wrap_read(int fd, void * pvBuf, size_t count);
+ssize_t        __wrap_write(int fd, const void * pvBuf, size_t count);
+ssize_t        __wrap_pread(int fd, void * pvBuf, size_t count, off_t offset);
+ssize_t        __wrap_pwrite(int fd, const void * pvBuf, size_t count,
+                             off_t offset);
+
+static BBBError createStandIn(void);
+static BBBError setValueOpen(uint32_t u32Gpio, eGpioValue eValue);
+static BBBError getValueOpen(uint32_t u32Gpio, eGpioValue * peValue);
+static void     runOpen(void);
+static void     runCached(void);
+static void     printResult(const char * pcName, void (*pfRun)(void));
+static uint64_t getNowNs(void);
+
+//----- Data -------------------------------------------------------------------
+/** Number of wrapped system calls                                            */
+static uint32_t u32Syscalls = 0;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    if(strcmp(GPIO_SYSFS_DIR, "/sys/class/gpio") != 0) {
+        if(createStandIn() != BBB_SUCCESS) {
+            fprintf(stderr, "stand-in " GPIO_SYSFS_DIR " not created\n");
+            return (EXIT_FAILURE);
+        }
+    }
+
+    /* Already exported gpios are not exported again */
+    if((exportGpio(BENCH_GPIO_TV) != BBB_SUCCESS) ||
+       (exportGpio(BENCH_GPIO_LED) != BBB_SUCCESS) ||
+       (setGpioDirection(BENCH_GPIO_TV, GPIO_DIR_OUT) != BBB_SUCCESS) ||
+       (setGpioDirection(BENCH_GPIO_LED, GPIO_DIR_OUT) != BBB_SUCCESS)) {
+        fprintf(stderr, "gpios could not be exported\n");
+        return (EXIT_FAILURE);
+    }
+
+    printf("gpio directory " GPIO_SYSFS_DIR "\n");
+    printf("%-16s  [ns/access]  [syscalls/access]\n", "");
+    printResult("open per call", runOpen);
+    printResult("cached fd", runCached);
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    __wrap_open
+ ******************************************************************************/
+/** \brief        Counting wrappers of the system calls (-Wl,--wrap=...)
+ *
+ *  \type         global
+ *
+ *  \return       see open(2), close(2), read(2), write(2), pread(2) and
+ *                pwrite(2)
+ *
+ ******************************************************************************/
+int __wrap_open(const char * pcPath, int s32Flags, ...) {
+
+    va_list args;
+    mode_t  mode = 0;
+
+    if(s32Flags & O_CREAT) {
+        va_start(args, s32Flags);
+        mode = (mode_t) va_arg(args, int);
+        va_end(args);
+    }
+    u32Syscalls++;
+
+    return (__real_open(pcPath, s32Flags, mode));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_close
+ ******************************************************************************/
+int __wrap_close(int fd) {
+
+    u32Syscalls++;
+
+    return (__real_close(fd));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_read
+ ******************************************************************************/
+ssize_t __wrap_read(int fd, void * pvBuf, size_t count) {
+
+    u32Syscalls++;
+
+    return (__real_read(fd, pvBuf, count));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_write
+ ******************************************************************************/
+ssize_t __wrap_write(int fd, const void * pvBuf, size_t count) {
+
+    u32Syscalls++;
+
+    return (__real_write(fd, pvBuf, count));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_pread
+ ******************************************************************************/
+ssize_t __wrap_pread(int fd, void * pvBuf, size_t count, off_t offset) {
+
+    u32Syscalls++;
+
+    return (__real_pread(fd, pvBuf, count, offset));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_pwrite
+ ******************************************************************************/
+ssize_t __wrap_pwrite(int fd, const void * pvBuf, size_t count, off_t offset) {
+
+    u32Syscalls++;
+
+    return (__real_pwrite(fd, pvBuf, count, offset));
+}
+
+/*******************************************************************************
+ *  function :    createStandIn
+ ******************************************************************************/
+/** \brief        Creates the files of the TV and LED gpios below
+ *                GPIO_SYSFS_DIR, as sysfs shows them after the export
+ *
+ *  \type         static
+ *
+ *  \return       BBB_SUCCESS on success, BBB_FILE_OPEN otherwise
+ *
+ ******************************************************************************/
+static BBBError createStandIn(void) {
+
+    static const uint32_t au32Gpio[] = { BENCH_GPIO_TV, BENCH_GPIO_LED };
+    static const char *   apcFile[] = { "value", "direction", "edge" };
+    static const char *   apcInit[] = { "0\n", "out\n", "none\n" };
+    char                  acPath[128];
+    FILE *                psFile;
+    uint32_t              i;
+    uint32_t              j;
+
+    mkdir(GPIO_SYSFS_DIR, 0755);
+
+    for(i = 0; i < sizeof(au32Gpio) / sizeof(au32Gpio[0]); i++) {
+
+        snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%u",
+                 au32Gpio[i]);
+        mkdir(acPath, 0755);
+
+        for(j = 0; j < sizeof(apcFile) / sizeof(apcFile[0]); j++) {
+            snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%u/%s",
+                     au32Gpio[i], apcFile[j]);
+            psFile = fopen(acPath, "w");
+            if(psFile == NULL) {
+                return (BBB_FILE_OPEN);
+            }
+            fputs(apcInit[j], psFile);
+            fclose(psFile);
+        }
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    setValueOpen
+ ******************************************************************************/
+/** \brief        Sets the value of a gpio as the former Gpio.c did: open,
+ *                write and close of the value file
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Gpio  gpio
+ *  \param[in]    eValue   GPIO_VALUE_LOW or GPIO_VALUE_HIGH
+ *
+ *  \return       BBB_SUCCESS on success, BBB_FILE_OPEN otherwise
+ *
+ ******************************************************************************/
+static BBBError setValueOpen(uint32_t u32Gpio, eGpioValue eValue) {
+
+    char acPath[64];
+    int  fd;
+
+    snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%u/value", u32Gpio);
+
+    fd = open(acPath, O_WRONLY);
+    if(fd < 0) {
+        return (BBB_FILE_OPEN);
+    }
+    write(fd, (eValue == GPIO_VALUE_HIGH) ? "1" : "0", 2);
+    close(fd);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    getValueOpen
+ ******************************************************************************/
+static BBBError getValueOpen(uint32_t u32Gpio, eGpioValue * peValue) {
+
+    char acPath[64];
+    char ch = '0';
+    int  fd;
+
+    snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%u/value", u32Gpio);
+
+    fd = open(acPath, O_RDONLY);
+    if(fd < 0) {
+        return (BBB_FILE_OPEN);
+    }
+    read(fd, &ch, 1);
+    close(fd);
+    *peValue = (ch == '1') ? GPIO_VALUE_HIGH : GPIO_VALUE_LOW;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    runOpen
+ ******************************************************************************/
+static void runOpen(void) {
+
+    eGpioValue eValue;
+    uint32_t   i;
+
+    for(i = 0; i < BENCH_ITERATIONS; i++) {
+        setValueOpen(BENCH_GPIO_TV, (i & 1) ? GPIO_VALUE_HIGH : GPIO_VALUE_LOW);
+        setValueOpen(BENCH_GPIO_LED, (i & 1) ? GPIO_VALUE_LOW : GPIO_VALUE_HIGH);
+        getValueOpen(BENCH_GPIO_TV, &eValue);
+        getValueOpen(BENCH_GPIO_LED, &eValue);
+    }
+}
+
+/*******************************************************************************
+ *  function :    runCached
+ ******************************************************************************/
+static void runCached(void) {
+
+    eGpioValue eValue;
+    uint32_t   i;
+
+    for(i = 0; i < BENCH_ITERATIONS; i++) {
+        setGpioValue(BENCH_GPIO_TV, (i & 1) ? GPIO_VALUE_HIGH : GPIO_VALUE_LOW);
+        setGpioValue(BENCH_GPIO_LED, (i & 1) ? GPIO_VALUE_LOW : GPIO_VALUE_HIGH);
+        getGpioValue(BENCH_GPIO_TV, &eValue);
+        getGpioValue(BENCH_GPIO_LED, &eValue);
+    }
+}
+
+/*******************************************************************************
+ *  function :    printResult
+ ******************************************************************************/
+/** \brief        Runs a variant and prints its time and system calls per
+ *                access
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcName  name of the variant
+ *  \param[in]    pfRun   runs BENCH_ITERATIONS iterations
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void printResult(const char * pcName, void (*pfRun)(void)) {
+
+    uint64_t u64Start;
+    uint64_t u64Duration;
+
+    u32Syscalls = 0;
+    u64Start = getNowNs();
+    pfRun();
+    u64Duration = getNowNs() - u64Start;
+
+    printf("%-16s  %11.0f  %17.2f\n", pcName,
+           (double) u64Duration / BENCH_ACCESSES,
+           (double) u32Syscalls / BENCH_ACCESSES);
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
@@ -0,0 +1,496 @@
+/******************************************************************************/
+/** \file       BenchGpioChip.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of the gpio character device backend against the
+ *              sysfs backend.
+ *              <p>
+ *              Every iteration sets the gpios of the TV (60) and the LED (48)
+ *              and reads them back, through the backend operations. The time
+ *              and the number of system calls per iteration are reported for:
+ *              <ul>
+ *              <li> sysfs: pfSetGpioValue()/pfGetGpioValue() of the sysfs
+ *              backend, one pwrite/pread per gpio
+ *              <li> chardev per gpio: the same calls on the chardev backend,
+ *              one ioctl per gpio
+ *              <li> chardev batched: pfSetGpioValues()/pfGetGpioValues() of
+ *              the chardev backend, one ioctl for both gpios (gpiochip1)
+ *              </ul>
+ *              <p>
+ *              On the beaglebone or against the gpio-sim kernel module the
+ *              ioctls go to the kernel, GPIOCHIP_DEVICE selects the chip (see
+ *              GpioChip.h). Without a gpio chip, BENCH_FAKE_GPIOCHIP builds a
+ *              fake ioctl shim: the chip is a file on a tmpfs, the line
+ *              request is a dup() of it and the values are kept in the shim.
+ *              Every faked ioctl still issues one real ioctl (FIONREAD on the
+ *              file), so the system call is paid, but not the work of the
+ *              gpio driver. The sysfs backend then runs on the tmpfs stand-in
+ *              of BenchGpio.c. The system calls are counted by wrapping them
+ *              at link time.
+ *              <p>
+ *              Build (from Server/), without the three defines on the
+ *              beaglebone:
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw -DBENCH_FAKE_GPIOCHIP \
+ *                  -DGPIO_SYSFS_DIR='"/dev/shm/webhouse-gpio"' \
+ *                  -DGPIOCHIP_DEVICE='"/dev/shm/webhouse-gpiochip%u"' \
+ *                  -Wl,--wrap=open,--wrap=close,--wrap=read,--wrap=write \
+ *                  -Wl,--wrap=pread,--wrap=pwrite,--wrap=ioctl \
+ *                  bench/BenchGpioChip.c hw/HwBackend.c hw/Gpio.c \
+ *                  hw/GpioEvent.c hw/GpioChip.c hw/GpioMmap.c hw/HwSim.c \
+ *                  hw/Pwm.c hw/Lm75.c sys/Log.c sys/LogAsync.c \
+ *                  sys/BBBSignal.c -lpthread -o BenchGpioChip
+ *              </pre>
+ *              Usage: BenchGpioChip
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *              __wrap_open
+ *              __wrap_close
+ *              __wrap_read
+ *              __wrap_write
+ *              __wrap_pread
+ *              __wrap_pwrite
+ *              __wrap_ioctl
+ *  functions  local:
+ *              fakeIoctl
+ *              createStandIn
+ *              setupBackend
+ *              runSingle
+ *              runBatched
+ *              printResult
+ *              getNowNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <linux/gpio.h>
+
+#include "BBBTypes.h"
+#include "HwBackend.h"
+#include "GpioChip.h"
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+#ifndef GPIO_SYSFS_DIR
+#define GPIO_SYSFS_DIR     "/sys/class/gpio"
+#endif
+/** Gpios of the TV and the LED (see Webhouse.c)                             */
+#define BENCH_GPIO_TV      ( 60 )
+#define BENCH_GPIO_LED     ( 48 )
+#define BENCH_GPIOS        ( 2 )
+/** Number of iterations, each sets and reads both gpios                     */
+#define BENCH_ITERATIONS   ( 100000 )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+extern int     __real_open(const char * pcPath, int s32Flags, ...);
+extern int     __real_close(int fd);
+extern ssize_t __real_read(int fd, void * pvBuf, size_t count);
+extern ssize_t __real_write(int fd, const void * pvBuf, size_t count);
+extern ssize_t __real_pread(int fd, void * pvBuf, size_t count, off_t offset);
+extern ssize_t __real_pwrite(int fd, const void * pvBuf, size_t count,
+                             off_t offset);
+extern int     __real_ioctl(int fd, unsigned long u64Request, ...);
+
+int            __wrap_open(const char * pcPath, int s32Flags, ...);
+int            __wrap_close(int fd);
+ssize_t        __wrap_read(int fd, void * pvBuf, size_t count);
+ssize_t        __wrap_write(int fd, const void * pvBuf, size_t count);
+ssize_t        __wrap_pread(int fd, void * pvBuf, size_t count, off_t offset);
+ssize_t        __wrap_pwrite(int fd, const void * pvBuf, size_t count,
+                             off_t offset);
+int            __wrap_ioctl(int fd, unsigned long u64Request, ...);
+
+#ifdef BENCH_FAKE_GPIOCHIP
+static int      fakeIoctl(int fd, unsigned long u64Request, void * pvArg);
+static BBBError createStandIn(void);
+#endif
+static BBBError setupBackend(const char * pcName);
+static void     runSingle(void);
+static void     runBatched(void);
+static void     printResult(const char * pcName, void (*pfRun)(void));
+static uint64_t getNowNs(void);
+
+//----- Data -------------------------------------------------------------------
+/** Gpios of every iteration                                                  */
+static const uint32_t au32Gpio[BENCH_GPIOS] = { BENCH_GPIO_TV, BENCH_GPIO_LED };
+/** Number of wrapped system calls                                            */
+static uint32_t u32Syscalls = 0;
+#ifdef BENCH_FAKE_GPIOCHIP
+/** Line values of the fake line requests                                     */
+static uint64_t u64FakeBits = 0;
+#endif
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    uint32_t i;
+
+    for(i = 0; i < LOG_MODULES; i++) {
+        setLogLevel(i, LOG_LEVEL_WARNING);
+    }
+
+#ifdef BENCH_FAKE_GPIOCHIP
+    if(createStandIn() != BBB_SUCCESS) {
+        fprintf(stderr, "stand-in of the gpios not created\n");
+        return (EXIT_FAILURE);
+    }
+    printf("fake gpio chip " GPIOCHIP_DEVICE ", sysfs " GPIO_SYSFS_DIR "\n",
+           BENCH_GPIO_TV / 32);
+#endif
+
+    printf("%-18s  [ns/iteration]  [syscalls/iteration]\n", "");
+
+    if(setupBackend("sysfs") != BBB_SUCCESS) {
+        return (EXIT_FAILURE);
+    }
+    printResult("sysfs", runSingle);
+
+    if(setupBackend("chardev") != BBB_SUCCESS) {
+        return (EXIT_FAILURE);
+    }
+    printResult("chardev per gpio", runSingle);
+    printResult("chardev batched", runBatched);
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    __wrap_open
+ ******************************************************************************/
+/** \brief        Counting wrappers of the system calls (-Wl,--wrap=...)
+ *
+ *  \type         global
+ *
+ *  \return       see open(2), close(2), read(2), write(2), pread(2),
+ *                pwrite(2) and ioctl(2)
+ *
+ ******************************************************************************/
+int __wrap_open(const char * pcPath, int s32Flags, ...) {
+
+    va_list args;
+    mode_t  mode = 0;
+
+    if(s32Flags & O_CREAT) {
+        va_start(args, s32Flags);
+        mode = (mode_t) va_arg(args, int);
+        va_end(args);
+    }
+    u32Syscalls++;
+
+    return (__real_open(pcPath, s32Flags, mode));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_close
+ ******************************************************************************/
+int __wrap_close(int fd) {
+
+    u32Syscalls++;
+
+    return (__real_close(fd));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_read
+ ******************************************************************************/
+ssize_t __wrap_read(int fd, void * pvBuf, size_t count) {
+
+    u32Syscalls++;
+
+    return (__real_read(fd, pvBuf, count));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_write
+ ******************************************************************************/
+ssize_t __wrap_write(int fd, const void * pvBuf, size_t count) {
+
+    u32Syscalls++;
+
+    return (__real_write(fd, pvBuf, count));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_pread
+ ******************************************************************************/
+ssize_t __wrap_pread(int fd, void * pvBuf, size_t count, off_t offset) {
+
+    u32Syscalls++;
+
+    return (__real_pread(fd, pvBuf, count, offset));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_pwrite
+ ******************************************************************************/
+ssize_t __wrap_pwrite(int fd, const void * pvBuf, size_t count, off_t offset) {
+
+    u32Syscalls++;
+
+    return (__real_pwrite(fd, pvBuf, count, offset));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_ioctl
+ ******************************************************************************/
+int __wrap_ioctl(int fd, unsigned long u64Request, ...) {
+
+    va_list args;
+    void *  pvArg;
+
+    va_start(args, u64Request);
+    pvArg = va_arg(args, void *);
+    va_end(args);
+    u32Syscalls++;
+
+#ifdef BENCH_FAKE_GPIOCHIP
+    return (fakeIoctl(fd, u64Request, pvArg));
+#else
+    return (__real_ioctl(fd, u64Request, pvArg));
+#endif
+}
+
+#ifdef BENCH_FAKE_GPIOCHIP
+/*******************************************************************************
+ *  function :    fakeIoctl
+ ******************************************************************************/
+/** \brief        Emulates the GPIO v2 ioctls used by GpioChip.c
+ *                <p>
+ *                A line request is a duplicate of the chip fd, the values of
+ *                all requests are kept in u64FakeBits. Every call issues one
+ *                real ioctl on fd to pay for the system call.
+ *
+ *  \type         static
+ *
+ *  \param[in]    fd          chip or line request fd
+ *  \param[in]    u64Request  ioctl request
+ *  \param[in]    pvArg       argument of the request
+ *
+ *  \return       0 on success, -1 otherwise
+ *
+ ******************************************************************************/
+static int fakeIoctl(int fd, unsigned long u64Request, void * pvArg) {
+
+    struct gpio_v2_line_request * psRequest;
+    struct gpio_v2_line_values *  psValues;
+    int                           s32Pending;
+
+    if(__real_ioctl(fd, FIONREAD, &s32Pending) < 0) {
+        return (-1);
+    }
+
+    switch(u64Request) {
+        case GPIO_V2_GET_LINE_IOCTL:
+            psRequest = (struct gpio_v2_line_request *) pvArg;
+            psRequest->fd = dup(fd);
+            return ((psRequest->fd < 0) ? -1 : 0);
+        case GPIO_V2_LINE_SET_CONFIG_IOCTL:
+            return (0);
+        case GPIO_V2_LINE_SET_VALUES_IOCTL:
+            psValues = (struct gpio_v2_line_values *) pvArg;
+            u64FakeBits = (u64FakeBits & ~psValues->mask) |
+                          (psValues->bits & psValues->mask);
+            return (0);
+        case GPIO_V2_LINE_GET_VALUES_IOCTL:
+            psValues = (struct gpio_v2_line_values *) pvArg;
+            psValues->bits = u64FakeBits & psValues->mask;
+            return (0);
+        default:
+            return (__real_ioctl(fd, u64Request, pvArg));
+    }
+}
+
+/*******************************************************************************
+ *  function :    createStandIn
+ ******************************************************************************/
+/** \brief        Creates the fake gpio chip of the TV and the LED and the
+ *                files of both gpios below GPIO_SYSFS_DIR, as sysfs shows
+ *                them after the export
+ *
+ *  \type         static
+ *
+ *  \return       BBB_SUCCESS on success, BBB_FILE_OPEN otherwise
+ *
+ ******************************************************************************/
+static BBBError createStandIn(void) {
+
+    static const char * apcFile[] = { "value", "direction", "edge" };
+    static const char * apcInit[] = { "0\n", "out\n", "none\n" };
+    char                acPath[128];
+    FILE *              psFile;
+    uint32_t            i;
+    uint32_t            j;
+
+    snprintf(acPath, sizeof(acPath), GPIOCHIP_DEVICE, BENCH_GPIO_TV / 32);
+    psFile = fopen(acPath, "w");
+    if(psFile == NULL) {
+        return (BBB_FILE_OPEN);
+    }
+    fclose(psFile);
+
+    mkdir(GPIO_SYSFS_DIR, 0755);
+
+    for(i = 0; i < BENCH_GPIOS; i++) {
+
+        snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%u",
+                 au32Gpio[i]);
+        mkdir(acPath, 0755);
+
+        for(j = 0; j < sizeof(apcFile) / sizeof(apcFile[0]); j++) {
+            snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%u/%s",
+                     au32Gpio[i], apcFile[j]);
+            psFile = fopen(acPath, "w");
+            if(psFile == NULL) {
+                return (BBB_FILE_OPEN);
+            }
+            fputs(apcInit[j], psFile);
+            fclose(psFile);
+        }
+    }
+
+    return (BBB_SUCCESS);
+}
+#endif
+
+/*******************************************************************************
+ *  function :    setupBackend
+ ******************************************************************************/
+/** \brief        Selects a backend and exports the TV and LED gpios as
+ *                outputs
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcName  name of the backend
+ *
+ *  \return       BBB_SUCCESS on success, the error of the backend otherwise
+ *
+ ******************************************************************************/
+static BBBError setupBackend(const char * pcName) {
+
+    const sHwBackend * psHw;
+    BBBError           error;
+    uint32_t           i;
+
+    error = selectHwBackend(pcName);
+    psHw = getHwBackend();
+
+    for(i = 0; (i < BENCH_GPIOS) && (error == BBB_SUCCESS); i++) {
+        error = psHw->pfExportGpio(au32Gpio[i]);
+        if(error == BBB_SUCCESS) {
+            error = psHw->pfSetGpioDirection(au32Gpio[i], GPIO_DIR_OUT);
+        }
+    }
+
+    if(error != BBB_SUCCESS) {
+        fprintf(stderr, "gpios of the %s backend not exported (%d)\n",
+                pcName, error);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    runSingle
+ ******************************************************************************/
+static void runSingle(void) {
+
+    const sHwBackend * psHw = getHwBackend();
+    eGpioValue         eValue;
+    uint32_t           i;
+
+    for(i = 0; i < BENCH_ITERATIONS; i++) {
+        psHw->pfSetGpioValue(BENCH_GPIO_TV,
+                             (i & 1) ? GPIO_VALUE_HIGH : GPIO_VALUE_LOW);
+        psHw->pfSetGpioValue(BENCH_GPIO_LED,
+                             (i & 1) ? GPIO_VALUE_LOW : GPIO_VALUE_HIGH);
+        psHw->pfGetGpioValue(BENCH_GPIO_TV, &eValue);
+        psHw->pfGetGpioValue(BENCH_GPIO_LED, &eValue);
+    }
+}
+
+/*******************************************************************************
+ *  function :    runBatched
+ ******************************************************************************/
+static void runBatched(void) {
+
+    const sHwBackend * psHw = getHwBackend();
+    eGpioValue         aeValue[BENCH_GPIOS];
+    uint32_t           i;
+
+    for(i = 0; i < BENCH_ITERATIONS; i++) {
+        aeValue[0] = (i & 1) ? GPIO_VALUE_HIGH : GPIO_VALUE_LOW;
+        aeValue[1] = (i & 1) ? GPIO_VALUE_LOW : GPIO_VALUE_HIGH;
+        psHw->pfSetGpioValues(au32Gpio, aeValue, BENCH_GPIOS);
+        psHw->pfGetGpioValues(au32Gpio, aeValue, BENCH_GPIOS);
+    }
+}
+
+/*******************************************************************************
+ *  function :    printResult
+ ******************************************************************************/
+/** \brief        Runs a variant and prints its time and system calls per
+ *                iteration
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcName  name of the variant
+ *  \param[in]    pfRun   runs BENCH_ITERATIONS iterations
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void printResult(const char * pcName, void (*pfRun)(void)) {
+
+    uint64_t u64Start;
+    uint64_t u64Duration;
+
+    /* Warm up, the chardev backend requests the lines on the first access */
+    pfRun();
+
+    u32Syscalls = 0;
+    u64Start = getNowNs();
+    pfRun();
+    u64Duration = getNowNs() - u64Start;
+
+    printf("%-18s  %14.0f  %19.2f\n", pcName,
+           (double) u64Duration / BENCH_ITERATIONS,
+           (double) u32Syscalls / BENCH_ITERATIONS);
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
@@ -0,0 +1,369 @@
+/******************************************************************************/
+/** \file       BenchJson.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of the parsing of the client commands.
+ *              <p>
+ *              The commands the web client sends ({"TV":"ON"},
+ *              {"Lampe":"42"}, ...) are received in turn by:
+ *              <ul>
+ *              <li> jansson: the former receiveAndSetValues(), json_loadb()
+ *              and a lookup of the four keys TV, Lampe, Leuchter and TempSoll
+ *              (strcmp, atoi), without its printf
+ *              <li> scan + hash: receiveAndSetValues() of RxTxJSON.c,
+ *              scanJsonObject() and the perfect hash of the command keys
+ *              </ul>
+ *              The messages per second and the heap allocations per message
+ *              are reported. The webhouse functions are replaced by stubs
+ *              which only count the commands, the log messages are disabled.
+ *              The allocations of jansson are counted with
+ *              json_set_alloc_funcs(), the ones of the tree by wrapping
+ *              malloc at link time.
+ *              <p>
+ *              Build (from Server/):
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw \
+ *                  -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free \
+ *                  bench/BenchJson.c comm/RxTxJSON.c comm/JsonScan.c \
+ *                  comm/Json.c sys/Pid.c sys/Log.c sys/LogAsync.c \
+ *                  sys/BBBSignal.c -ljansson -lpthread -o BenchJson
+ *              </pre>
+ *              Usage: BenchJson
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *              __wrap_malloc
+ *              __wrap_calloc
+ *              __wrap_realloc
+ *              __wrap_free
+ *              turnTVOn
+ *              turnTVOff
+ *              dimSLampe
+ *              dimDLampe
+ *              dimHeizung
+ *              getHeizungState
+ *              getTempIst
+ *              getTempIstHalfDeg
+ *              enableAlarm
+ *              disableAlarm
+ *              resetAlarm
+ *              readAlarmEvents
+ *  functions  local:
+ *              countMalloc
+ *              countFree
+ *              receiveJansson
+ *              runJansson
+ *              runScan
+ *              printResult
+ *              getNowNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "BBBTypes.h"
+#include "Json.h"
+#include "RxTxJSON.h"
+#include "Webhouse.h"
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of messages per measurement                                       */
+#define BENCH_MESSAGES     ( 1000000 )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+extern void * __real_malloc(size_t size);
+extern void * __real_calloc(size_t count, size_t size);
+extern void * __real_realloc(void * pvMem, size_t size);
+extern void   __real_free(void * pvMem);
+
+void *        __wrap_malloc(size_t size);
+void *        __wrap_calloc(size_t count, size_t size);
+void *        __wrap_realloc(void * pvMem, size_t size);
+void          __wrap_free(void * pvMem);
+
+static void * countMalloc(size_t size);
+static void   countFree(void * pvMem);
+static void   receiveJansson(char * pcMsg, int s32Length);
+static void   runJansson(void);
+static void   runScan(void);
+static void   printResult(const char * pcName, void (*pfRun)(void));
+static uint64_t getNowNs(void);
+
+//----- Data -------------------------------------------------------------------
+/** Commands of the web client                                                */
+static char * apcMsg[] = {
+    "{\"TV\":\"ON\"}",
+    "{\"Lampe\":\"42\"}",
+    "{\"Leuchter\":\"80\"}",
+    "{\"TempSoll\":\"22\"}",
+    "{\"TV\":\"OFF\"}",
+    "{\"TV\":\"ON\",\"Lampe\":\"10\",\"Leuchter\":\"20\",\"TempSoll\":\"21\"}"
+};
+#define BENCH_MSG_TYPES    ( sizeof(apcMsg) / sizeof(apcMsg[0]) )
+static int as32MsgLen[BENCH_MSG_TYPES];
+
+/** Number of heap allocations                                                */
+static uint32_t u32Allocs = 0;
+/** Number of commands passed to the stubs                                    */
+static uint32_t u32Commands = 0;
+
+/** Soll-Temperatur of the former receiveAndSetValues()                      */
+static char TemperaturSollFormer = 20;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    uint32_t i;
+
+    for(i = 0; i < LOG_MODULES; i++) {
+        setLogLevel(i, LOG_LEVEL_WARNING);
+    }
+    for(i = 0; i < BENCH_MSG_TYPES; i++) {
+        as32MsgLen[i] = strlen(apcMsg[i]);
+    }
+    json_set_alloc_funcs(countMalloc, countFree);
+
+    printf("%-14s  [messages/s]  [ns/message]  [allocations/message]\n", "");
+    printResult("jansson", runJansson);
+    printResult("scan + hash", runScan);
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    __wrap_malloc
+ ******************************************************************************/
+/** \brief        Counting wrappers of the heap functions of the tree
+ *                (-Wl,--wrap=...)
+ *
+ *  \type         global
+ *
+ *  \return       see malloc(3)
+ *
+ ******************************************************************************/
+void * __wrap_malloc(size_t size) {
+
+    u32Allocs++;
+
+    return (__real_malloc(size));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_calloc
+ ******************************************************************************/
+void * __wrap_calloc(size_t count, size_t size) {
+
+    u32Allocs++;
+
+    return (__real_calloc(count, size));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_realloc
+ ******************************************************************************/
+void * __wrap_realloc(void * pvMem, size_t size) {
+
+    u32Allocs++;
+
+    return (__real_realloc(pvMem, size));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_free
+ ******************************************************************************/
+void __wrap_free(void * pvMem) {
+
+    __real_free(pvMem);
+}
+
+/*******************************************************************************
+ *  function :    countMalloc
+ ******************************************************************************/
+/** \brief        Counting allocation functions of jansson
+ *                (json_set_alloc_funcs)
+ *
+ *  \type         static
+ *
+ ******************************************************************************/
+static void * countMalloc(size_t size) {
+
+    u32Allocs++;
+
+    return (__real_malloc(size));
+}
+
+/*******************************************************************************
+ *  function :    countFree
+ ******************************************************************************/
+static void countFree(void * pvMem) {
+
+    __real_free(pvMem);
+}
+
+/*******************************************************************************
+ *  Stubs of the webhouse, see Webhouse.h
+ ******************************************************************************/
+BBBError turnTVOn(void)                   { u32Commands++; return (BBB_SUCCESS); }
+BBBError turnTVOff(void)                  { u32Commands++; return (BBB_SUCCESS); }
+BBBError dimSLampe(uint8_t u8Duty)        { u32Commands++; return (BBB_SUCCESS); }
+BBBError dimDLampe(uint8_t u8Duty)        { u32Commands++; return (BBB_SUCCESS); }
+BBBError dimHeizung(uint8_t u8Duty)       { return (BBB_SUCCESS); }
+int32_t  getHeizungState(void)            { return (0); }
+BBBError enableAlarm(void)                { u32Commands++; return (BBB_SUCCESS); }
+BBBError disableAlarm(void)               { u32Commands++; return (BBB_SUCCESS); }
+void     resetAlarm(void)                 { u32Commands++; }
+
+BBBError getTempIst(int32_t * ps32Temp, uint32_t * pu32AgeMs) {
+
+    return (BBB_FILE_READ);
+}
+
+BBBError getTempIstHalfDeg(int32_t * ps32HalfDeg, uint32_t * pu32AgeMs) {
+
+    return (BBB_FILE_READ);
+}
+
+uint32_t readAlarmEvents(sInputEvent * asEvents, uint32_t u32MaxEvents) {
+
+    return (0);
+}
+
+/*******************************************************************************
+ *  function :    receiveJansson
+ ******************************************************************************/
+/** \brief        The former receiveAndSetValues(), without its printf
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcMsg      JSON message
+ *  \param[in]    s32Length  length of the message
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void receiveJansson(char * pcMsg, int s32Length) {
+
+    char *   pcValue = NULL;
+    json_t * jsonMsg = NULL;
+
+    jsonMsg = createJsonFromBuffer(pcMsg, s32Length);
+    if(jsonMsg != NULL) {
+        pcValue = getJsonStringValue(jsonMsg, "TV");
+        if(pcValue != NULL) {
+            if(strcmp(pcValue, "ON") == 0) {
+                turnTVOn();
+            } else {
+                turnTVOff();
+            }
+        }
+        pcValue = getJsonStringValue(jsonMsg, "Lampe");
+        if(pcValue != NULL) {
+            dimSLampe(atoi(pcValue));
+        }
+        pcValue = getJsonStringValue(jsonMsg, "Leuchter");
+        if(pcValue != NULL) {
+            dimDLampe(atoi(pcValue));
+        }
+        pcValue = getJsonStringValue(jsonMsg, "TempSoll");
+        if(pcValue != NULL) {
+            TemperaturSollFormer = atoi(pcValue);
+        }
+        cleanUpJson(jsonMsg);
+    }
+}
+
+/*******************************************************************************
+ *  function :    runJansson
+ ******************************************************************************/
+static void runJansson(void) {
+
+    uint32_t i;
+
+    for(i = 0; i < BENCH_MESSAGES; i++) {
+        receiveJansson(apcMsg[i % BENCH_MSG_TYPES],
+                       as32MsgLen[i % BENCH_MSG_TYPES]);
+    }
+}
+
+/*******************************************************************************
+ *  function :    runScan
+ ******************************************************************************/
+static void runScan(void) {
+
+    uint32_t i;
+
+    for(i = 0; i < BENCH_MESSAGES; i++) {
+        receiveAndSetValues(apcMsg[i % BENCH_MSG_TYPES],
+                            as32MsgLen[i % BENCH_MSG_TYPES]);
+    }
+}
+
+/*******************************************************************************
+ *  function :    printResult
+ ******************************************************************************/
+/** \brief        Runs a variant and prints its rate and heap allocations per
+ *                message
+ *                <p>
+ *                Both variants must pass the same number of commands to the
+ *                stubs, otherwise the result is marked.
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcName  name of the variant
+ *  \param[in]    pfRun   receives BENCH_MESSAGES messages
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void printResult(const char * pcName, void (*pfRun)(void)) {
+
+    static uint32_t u32Expected = 0;
+    uint64_t        u64Start;
+    uint64_t        u64Duration;
+
+    u32Allocs = 0;
+    u32Commands = 0;
+    u64Start = getNowNs();
+    pfRun();
+    u64Duration = getNowNs() - u64Start;
+
+    printf("%-14s  %12.0f  %12.0f  %21.2f%s\n", pcName,
+           BENCH_MESSAGES * 1e9 / u64Duration,
+           (double) u64Duration / BENCH_MESSAGES,
+           (double) u32Allocs / BENCH_MESSAGES,
+           ((u32Expected != 0) && (u32Commands != u32Expected)) ?
+           "  (commands differ)" : "");
+    u32Expected = u32Commands;
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
@@ -0,0 +1,138 @@
+/******************************************************************************/
+/** \file       BenchLog.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of a debug message which is compiled in but disabled
+ *              at runtime.
+ *              <p>
+ *              The debug level of the module MAIN is compiled in
+ *              (CONFIG_LOG_MODULE_MAIN) and switched off with setLogLevel().
+ *              A loop of BENCH_MESSAGES disabled DEBUGPRINT() calls is
+ *              compared with the same loop without the message.
+ *              <p>
+ *              Build (from Server/):
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw \
+ *                  bench/BenchLog.c sys/Log.c sys/LogAsync.c sys/BBBSignal.c \
+ *                  -lpthread -o BenchLog
+ *              </pre>
+ *              Usage: BenchLog
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *  functions  local:
+ *              runEmpty
+ *              runDisabled
+ *              getNowNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BBBTypes.h"
+#include "BBBConfig.h"
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of messages per measurement                                       */
+#define BENCH_MESSAGES     ( 200000000UL )
+
+#if CONFIG_LOG_MODULE_MAIN > LOG_LEVEL_DEBUG
+#error "the debug level of MAIN must be compiled in (CONFIG_LOG_MODULE_MAIN)"
+#endif
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+static uint64_t runEmpty(void);
+static uint64_t runDisabled(void);
+static uint64_t getNowNs(void);
+
+//----- Data -------------------------------------------------------------------
+/** Argument of the messages, never evaluated while the level is disabled    */
+static volatile uint32_t u32Value = 0;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    uint64_t u64Empty;
+    uint64_t u64Disabled;
+
+    setLogLevel(LOG_MODULE_MAIN, LOG_LEVEL_INFO);
+
+    /* Warm up */
+    runEmpty();
+    runDisabled();
+
+    u64Empty = runEmpty();
+    u64Disabled = runDisabled();
+
+    printf("loop without message  %6.2f ns/iteration\n",
+           (double) u64Empty / BENCH_MESSAGES);
+    printf("disabled DEBUGPRINT   %6.2f ns/message  (%.0f M messages/s)\n",
+           (double) u64Disabled / BENCH_MESSAGES,
+           BENCH_MESSAGES * 1000.0 / u64Disabled);
+    printf("cost of the message   %6.2f ns\n",
+           ((double) u64Disabled - (double) u64Empty) / BENCH_MESSAGES);
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    runEmpty
+ ******************************************************************************/
+static uint64_t runEmpty(void) {
+
+    uint64_t u64Start = getNowNs();
+    uint32_t i;
+
+    for(i = 0; i < BENCH_MESSAGES; i++) {
+        __asm__ __volatile__ ("" ::: "memory");
+    }
+
+    return (getNowNs() - u64Start);
+}
+
+/*******************************************************************************
+ *  function :    runDisabled
+ ******************************************************************************/
+static uint64_t runDisabled(void) {
+
+    uint64_t u64Start = getNowNs();
+    uint32_t i;
+
+    for(i = 0; i < BENCH_MESSAGES; i++) {
+        __asm__ __volatile__ ("" ::: "memory");
+        DEBUGPRINT("value %u", u32Value);
+    }
+
+    return (getNowNs() - u64Start);
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
@@ -0,0 +1,374 @@
+/******************************************************************************/
+/** \file       BenchServer.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of the throughput and the latency of the server with
+ *              a growing number of clients.
+ *              <p>
+ *              The server of TCPServer.c runs its reactor in a thread of its
+ *              own and echoes every message. Raw TCP clients are connected
+ *              over the loopback interface, each keeps one message in flight
+ *              (closed loop). For every number of clients the messages are
+ *              exchanged for BENCH_SECONDS, the throughput and the median and
+ *              99th percentile of the round trip time are reported.
+ *              <p>
+ *              Build (from Server/), add -DCONFIG_SOCKET_MAX_CLIENTS=1024
+ *              -DCONFIG_REACTOR_MAX_FD=4096 for more than 256 clients:
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw \
+ *                  bench/BenchServer.c TCPServer.c sys/Reactor.c \
+ *                  comm/Framer.c comm/WebSocket.c sys/Log.c sys/LogAsync.c \
+ *                  sys/BBBSignal.c -lpthread -o BenchServer
+ *              </pre>
+ *              Usage: BenchServer [clients ...] (default 1 10 100 250)
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *  functions  local:
+ *              onReceive
+ *              serverThread
+ *              connectClient
+ *              sendRequest
+ *              runClients
+ *              compareSamples
+ *              getNowNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "BBBTypes.h"
+#include "BBBConfig.h"
+#include "TCPServer.h"
+#include "Reactor.h"
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+#define BENCH_PORT         ( 5098 )
+/** Duration of the measurement per number of clients [s]                    */
+#define BENCH_SECONDS      ( 2 )
+/** Highest number of round trip times kept per measurement                  */
+#define BENCH_MAX_SAMPLES  ( 4 * 1024 * 1024 )
+/** Length of a request, e.g. {"Seq":"00000042"}                             */
+#define BENCH_MSG_LEN      ( 18 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Client side of a connection */
+typedef struct _sBenchClient {
+
+    int      fd;                       ///< socket
+    uint64_t u64SentNs;                ///< time the request was sent
+    uint32_t u32Seq;                   ///< number of the request
+    uint32_t u32RxLen;                 ///< bytes of the echo received
+    char     acRx[BENCH_MSG_LEN];      ///< echo received so far
+
+} sBenchClient;
+
+//----- Function prototypes ----------------------------------------------------
+static void     onReceive(sConnection * psConn,
+                          char * pcData,
+                          uint32_t u32Length);
+static void *   serverThread(void * pvData);
+static BBBError connectClient(sBenchClient * psClient);
+static BBBError sendRequest(sBenchClient * psClient);
+static uint64_t runClients(uint32_t u32Clients);
+static int      compareSamples(const void * pvA, const void * pvB);
+static uint64_t getNowNs(void);
+
+//----- Data -------------------------------------------------------------------
+static sBenchClient  asClient[CONFIG_SOCKET_MAX_CLIENTS];
+static uint32_t      au32Sample[BENCH_MAX_SAMPLES];
+static uint32_t      u32Samples = 0;
+/** Set to stop the server thread                                            */
+static volatile int  bStopServer = 0;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    static const uint32_t au32Default[] = { 1, 10, 100, 250 };
+    struct rlimit sLimit;
+    pthread_t     idServer;
+    uint32_t      au32Clients[16];
+    uint32_t      u32Runs = 0;
+    uint32_t      u32Clients;
+    uint32_t      u32Connected = 0;
+    uint64_t      u64Done;
+    uint32_t      i;
+    int           s32Arg;
+
+    for(s32Arg = 1; (s32Arg < argc) && (u32Runs < 16); s32Arg++) {
+        au32Clients[u32Runs++] = (uint32_t) atoi(argv[s32Arg]);
+    }
+    if(u32Runs == 0) {
+        memcpy(au32Clients, au32Default, sizeof(au32Default));
+        u32Runs = sizeof(au32Default) / sizeof(au32Default[0]);
+    }
+
+    /* Two sockets per client */
+    if(getrlimit(RLIMIT_NOFILE, &sLimit) == 0) {
+        sLimit.rlim_cur = sLimit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &sLimit);
+    }
+
+    /* Connections are logged as info */
+    for(i = 0; i < LOG_MODULES; i++) {
+        setLogLevel(i, LOG_LEVEL_WARNING);
+    }
+
+    if((initReactor() != BBB_SUCCESS) ||
+       (initTCPServer(BENCH_PORT, onReceive) != BBB_SUCCESS)) {
+        fprintf(stderr, "server could not be started\n");
+        return (EXIT_FAILURE);
+    }
+    if(pthread_create(&idServer, NULL, serverThread, NULL) != 0) {
+        fprintf(stderr, "can't create thread\n");
+        return (EXIT_FAILURE);
+    }
+
+    printf("clients  [msg/s]  p50 [us]  p99 [us]\n");
+
+    for(i = 0; i < u32Runs; i++) {
+
+        u32Clients = au32Clients[i];
+        if((u32Clients == 0) || (u32Clients > CONFIG_SOCKET_MAX_CLIENTS)) {
+            printf("%7u  not within 1..CONFIG_SOCKET_MAX_CLIENTS (%u)\n",
+                   u32Clients, CONFIG_SOCKET_MAX_CLIENTS);
+            continue;
+        }
+        while(u32Connected < u32Clients) {
+            if(connectClient(&asClient[u32Connected]) != BBB_SUCCESS) {
+                fprintf(stderr, "client %u could not connect\n", u32Connected);
+                return (EXIT_FAILURE);
+            }
+            u32Connected++;
+        }
+
+        u64Done = runClients(u32Clients);
+        if(u32Samples == 0) {
+            printf("%7u  no message echoed\n", u32Clients);
+            continue;
+        }
+        qsort(au32Sample, u32Samples, sizeof(au32Sample[0]), compareSamples);
+        printf("%7u  %7llu  %8.1f  %8.1f\n", u32Clients,
+               (unsigned long long) (u64Done / BENCH_SECONDS),
+               au32Sample[u32Samples / 2] / 1000.0,
+               au32Sample[(uint32_t) (u32Samples * 99ULL / 100)] / 1000.0);
+    }
+
+    bStopServer = 1;
+    pthread_join(idServer, NULL);
+    finalizeTCPServer();
+    finalizeReactor();
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    onReceive
+ ******************************************************************************/
+static void onReceive(sConnection * psConn,
+                      char * pcData,
+                      uint32_t u32Length) {
+
+    sendDataTCP(psConn, pcData, u32Length);
+}
+
+/*******************************************************************************
+ *  function :    serverThread
+ ******************************************************************************/
+/** \brief        Runs the reactor of the server until bStopServer is set
+ *
+ *  \type         static
+ *
+ *  \param[in]    pvData  not used
+ *
+ *  \return       not used
+ *
+ ******************************************************************************/
+static void * serverThread(void * pvData) {
+
+    while(bStopServer == 0) {
+        runReactor(100);
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    connectClient
+ ******************************************************************************/
+static BBBError connectClient(sBenchClient * psClient) {
+
+    struct sockaddr_in sAddr;
+    int                s32Opt = 1;
+
+    psClient->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(psClient->fd < 0) {
+        return (BBB_SOCKET_SOCKET);
+    }
+    setsockopt(psClient->fd, IPPROTO_TCP, TCP_NODELAY,
+               &s32Opt, sizeof(s32Opt));
+
+    memset(&sAddr, 0, sizeof(sAddr));
+    sAddr.sin_family = AF_INET;
+    sAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sAddr.sin_port = htons(BENCH_PORT);
+    if(connect(psClient->fd, (struct sockaddr *) &sAddr, sizeof(sAddr)) < 0) {
+        close(psClient->fd);
+        return (BBB_SOCKET_SOCKET);
+    }
+    fcntl(psClient->fd, F_SETFL, O_NONBLOCK);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    sendRequest
+ ******************************************************************************/
+static BBBError sendRequest(sBenchClient * psClient) {
+
+    char acMsg[BENCH_MSG_LEN + 1];
+
+    snprintf(acMsg, sizeof(acMsg), "{\"Seq\":\"%08u\"}", psClient->u32Seq++);
+    psClient->u32RxLen = 0;
+    psClient->u64SentNs = getNowNs();
+
+    /* A request is far smaller than the socket buffer */
+    if(write(psClient->fd, acMsg, BENCH_MSG_LEN) != BENCH_MSG_LEN) {
+        return (BBB_SOCKET_SEND);
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    runClients
+ ******************************************************************************/
+/** \brief        Exchanges messages with the first u32Clients clients for
+ *                BENCH_SECONDS, the round trip times are kept in au32Sample
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Clients  number of clients
+ *
+ *  \return       number of echoed messages
+ *
+ ******************************************************************************/
+static uint64_t runClients(uint32_t u32Clients) {
+
+    struct epoll_event sEvent;
+    struct epoll_event asEvents[64];
+    sBenchClient *     psClient;
+    uint64_t           u64End;
+    uint64_t           u64Now;
+    uint64_t           u64Done = 0;
+    ssize_t            s32Read;
+    int                epollFd;
+    int                nEvents;
+    int                j;
+    uint32_t           i;
+
+    u32Samples = 0;
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    for(i = 0; i < u32Clients; i++) {
+        sEvent.events = EPOLLIN;
+        sEvent.data.ptr = &asClient[i];
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, asClient[i].fd, &sEvent);
+        sendRequest(&asClient[i]);
+    }
+
+    u64End = getNowNs() + BENCH_SECONDS * 1000000000ULL;
+    do {
+        nEvents = epoll_wait(epollFd, asEvents, 64, 100);
+        for(j = 0; j < nEvents; j++) {
+
+            psClient = (sBenchClient *) asEvents[j].data.ptr;
+            s32Read = read(psClient->fd, &psClient->acRx[psClient->u32RxLen],
+                           BENCH_MSG_LEN - psClient->u32RxLen);
+            if(s32Read <= 0) {
+                continue;
+            }
+            psClient->u32RxLen += (uint32_t) s32Read;
+            if(psClient->u32RxLen < BENCH_MSG_LEN) {
+                continue;
+            }
+
+            u64Now = getNowNs();
+            if(u32Samples < BENCH_MAX_SAMPLES) {
+                au32Sample[u32Samples++] =
+                    (uint32_t) (u64Now - psClient->u64SentNs);
+            }
+            u64Done++;
+            sendRequest(psClient);
+        }
+    } while(getNowNs() < u64End);
+
+    /* Collect the messages still in flight */
+    for(i = 0; i < u32Clients; i++) {
+        fcntl(asClient[i].fd, F_SETFL, 0);
+        while(asClient[i].u32RxLen < BENCH_MSG_LEN) {
+            s32Read = read(asClient[i].fd,
+                           &asClient[i].acRx[asClient[i].u32RxLen],
+                           BENCH_MSG_LEN - asClient[i].u32RxLen);
+            if(s32Read <= 0) {
+                break;
+            }
+            asClient[i].u32RxLen += (uint32_t) s32Read;
+        }
+        fcntl(asClient[i].fd, F_SETFL, O_NONBLOCK);
+    }
+    close(epollFd);
+
+    return (u64Done);
+}
+
+/*******************************************************************************
+ *  function :    compareSamples
+ ******************************************************************************/
+static int compareSamples(const void * pvA, const void * pvB) {
+
+    uint32_t u32A = *(const uint32_t *) pvA;
+    uint32_t u32B = *(const uint32_t *) pvB;
+
+    return ((u32A > u32B) - (u32A < u32B));
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
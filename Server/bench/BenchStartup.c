@@ -0,0 +1,443 @@
+/******************************************************************************/
+/** \file       BenchStartup.c
+ *******************************************************************************
+ *
+ *  \brief      Benchmark of the cold and the warm start of the webhouse.
+ *              <p>
+ *              Every start runs in a new process, which calls startWebhouse()
+ *              and waits until the webhouse is ready. The process ends
+ *              without finalizeWebhouse(), as a server which was killed, so
+ *              the gpios stay exported and the pwm's keep running:
+ *              <ul>
+ *              <li> cold: the first start, no gpio is exported and all pwm's
+ *              are stopped
+ *              <li> warm: every further start, the configuration of the
+ *              previous run is still in place and is not written again
+ *              </ul>
+ *              The time until startWebhouse() returns (the server accepts
+ *              clients from then on), the time until the webhouse is ready
+ *              and the number of system calls are reported.
+ *              <p>
+ *              On the beaglebone the real sysfs is used and BENCH_RUNS starts
+ *              are made; unexport the gpios 30, 48 and 60 and stop the pwm's
+ *              before, for a cold first start. Elsewhere Gpio.c and Pwm.c are
+ *              built with GPIO_SYSFS_DIR and PWM_SYSFS_DIR set to directories
+ *              on a tmpfs. The benchmark fills them as the kernel would, an
+ *              export written to the stand-in creates the files of the gpio.
+ *              This only shows the work of the webhouse: the export by the
+ *              kernel (and udev) comes on top on the beaglebone. Without an
+ *              I2C bus the temperature sampler starts, but its reads fail.
+ *              <p>
+ *              Build (from Server/), without the two defines on the
+ *              beaglebone:
+ *              <pre>
+ *              gcc -std=gnu89 -O2 -I. -Isys -Icomm -Ihw \
+ *                  -DGPIO_SYSFS_DIR='"/dev/shm/webhouse-gpio"' \
+ *                  -DPWM_SYSFS_DIR='"/dev/shm/webhouse-pwm"' \
+ *                  -Wl,--wrap=open,--wrap=close,--wrap=read,--wrap=write \
+ *                  -Wl,--wrap=pread,--wrap=pwrite \
+ *                  bench/BenchStartup.c hw/Webhouse.c hw/Fade.c hw/Pir.c \
+ *                  hw/HwBackend.c hw/Gpio.c hw/GpioEvent.c hw/GpioChip.c \
+ *                  hw/GpioMmap.c hw/HwSim.c hw/Pwm.c hw/Lm75.c \
+ *                  sys/EventRing.c sys/Log.c sys/LogAsync.c sys/BBBSignal.c \
+ *                  -lpthread -o BenchStartup
+ *              </pre>
+ *              Usage: BenchStartup
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              main
+ *              __wrap_open
+ *              __wrap_close
+ *              __wrap_read
+ *              __wrap_write
+ *              __wrap_pread
+ *              __wrap_pwrite
+ *  functions  local:
+ *              onReady
+ *              runStart
+ *              createStandIn
+ *              createGpio
+ *              writeFile
+ *              getNowNs
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "BBBTypes.h"
+#include "Webhouse.h"
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+#ifndef GPIO_SYSFS_DIR
+#define GPIO_SYSFS_DIR     "/sys/class/gpio"
+#endif
+#ifndef PWM_SYSFS_DIR
+#define PWM_SYSFS_DIR      "/sys/devices/ocp.2"
+#endif
+/** Number of starts, the first one is cold                                  */
+#define BENCH_RUNS         ( 5 )
+#define BENCH_MAX_PATH     ( 128 )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+extern int     __real_open(const char * pcPath, int s32Flags, ...);
+extern int     __real_close(int fd);
+extern ssize_t __real_read(int fd, void * pvBuf, size_t count);
+extern ssize_t __real_write(int fd, const void * pvBuf, size_t count);
+extern ssize_t __real_pread(int fd, void * pvBuf, size_t count, off_t offset);
+extern ssize_t __real_pwrite(int fd, const void * pvBuf, size_t count,
+                             off_t offset);
+
+int            __wrap_open(const char * pcPath, int s32Flags, ...);
+int            __wrap_close(int fd);
+ssize_t        __wrap_read(int fd, void * pvBuf, size_t count);
+ssize_t        __wrap_write(int fd, const void * pvBuf, size_t count);
+ssize_t        __wrap_pread(int fd, void * pvBuf, size_t count, off_t offset);
+ssize_t        __wrap_pwrite(int fd, const void * pvBuf, size_t count,
+                             off_t offset);
+
+static void     onReady(BBBError error);
+static void     runStart(const char * pcName);
+static BBBError createStandIn(void);
+static void     createGpio(const char * pcGpio, size_t len);
+static BBBError writeFile(const char * pcPath, const char * pcValue);
+static uint64_t getNowNs(void);
+
+//----- Data -------------------------------------------------------------------
+/** Pwm devices of the webhouse (see Pwm.c)                                   */
+static const char * apcPwm[] = {
+    "pwm_test_P9_14.14",
+    "pwm_test_P9_22.15",
+    "pwm_test_P8_19.16"
+};
+/** Number of wrapped system calls, counted by all threads                    */
+static uint32_t u32Syscalls = 0;
+/** Export file of the stand-in, while it is open                             */
+static int      fdExport = -1;
+/** Time when the webhouse got ready                                          */
+static uint64_t u64ReadyNs = 0;
+static BBBError errorReady = BBB_SUCCESS;
+static pthread_mutex_t mutexReady = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  condReady = PTHREAD_COND_INITIALIZER;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    main
+ ******************************************************************************/
+int main(int argc, char * argv[]) {
+
+    pid_t    pid;
+    uint32_t i;
+
+    if(strcmp(GPIO_SYSFS_DIR, "/sys/class/gpio") != 0) {
+        if(createStandIn() != BBB_SUCCESS) {
+            fprintf(stderr, "stand-in " GPIO_SYSFS_DIR " not created\n");
+            return (EXIT_FAILURE);
+        }
+    }
+
+    printf("gpio directory " GPIO_SYSFS_DIR ", pwm directory "
+           PWM_SYSFS_DIR "\n");
+    printf("%-6s  [us until started]  [us until ready]  [syscalls]\n", "");
+    fflush(stdout);
+
+    for(i = 0; i < BENCH_RUNS; i++) {
+        pid = fork();
+        if(pid == 0) {
+            runStart((i == 0) ? "cold" : "warm");
+        } else if(pid > 0) {
+            waitpid(pid, NULL, 0);
+        } else {
+            return (EXIT_FAILURE);
+        }
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    __wrap_open
+ ******************************************************************************/
+/** \brief        Counting wrappers of the system calls (-Wl,--wrap=...)
+ *                <p>
+ *                A gpio written to the export file of the stand-in is
+ *                created, as the kernel does on the beaglebone.
+ *
+ *  \type         global
+ *
+ *  \return       see open(2), close(2), read(2), write(2), pread(2) and
+ *                pwrite(2)
+ *
+ ******************************************************************************/
+int __wrap_open(const char * pcPath, int s32Flags, ...) {
+
+    va_list args;
+    mode_t  mode = 0;
+    int     fd;
+
+    if(s32Flags & O_CREAT) {
+        va_start(args, s32Flags);
+        mode = (mode_t) va_arg(args, int);
+        va_end(args);
+    }
+    __atomic_fetch_add(&u32Syscalls, 1, __ATOMIC_RELAXED);
+
+    fd = __real_open(pcPath, s32Flags, mode);
+    if((fd >= 0) && (strcmp(GPIO_SYSFS_DIR, "/sys/class/gpio") != 0) &&
+       (strcmp(pcPath, GPIO_SYSFS_DIR "/export") == 0)) {
+        __atomic_store_n(&fdExport, fd, __ATOMIC_RELAXED);
+    }
+
+    return (fd);
+}
+
+/*******************************************************************************
+ *  function :    __wrap_close
+ ******************************************************************************/
+int __wrap_close(int fd) {
+
+    int fdExpected = fd;
+
+    __atomic_fetch_add(&u32Syscalls, 1, __ATOMIC_RELAXED);
+    __atomic_compare_exchange_n(&fdExport, &fdExpected, -1, FALSE,
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+    return (__real_close(fd));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_read
+ ******************************************************************************/
+ssize_t __wrap_read(int fd, void * pvBuf, size_t count) {
+
+    __atomic_fetch_add(&u32Syscalls, 1, __ATOMIC_RELAXED);
+
+    return (__real_read(fd, pvBuf, count));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_write
+ ******************************************************************************/
+ssize_t __wrap_write(int fd, const void * pvBuf, size_t count) {
+
+    __atomic_fetch_add(&u32Syscalls, 1, __ATOMIC_RELAXED);
+
+    if(fd == __atomic_load_n(&fdExport, __ATOMIC_RELAXED)) {
+        createGpio((const char *) pvBuf, count);
+    }
+
+    return (__real_write(fd, pvBuf, count));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_pread
+ ******************************************************************************/
+ssize_t __wrap_pread(int fd, void * pvBuf, size_t count, off_t offset) {
+
+    __atomic_fetch_add(&u32Syscalls, 1, __ATOMIC_RELAXED);
+
+    return (__real_pread(fd, pvBuf, count, offset));
+}
+
+/*******************************************************************************
+ *  function :    __wrap_pwrite
+ ******************************************************************************/
+ssize_t __wrap_pwrite(int fd, const void * pvBuf, size_t count, off_t offset) {
+
+    __atomic_fetch_add(&u32Syscalls, 1, __ATOMIC_RELAXED);
+
+    return (__real_pwrite(fd, pvBuf, count, offset));
+}
+
+/*******************************************************************************
+ *  function :    onReady
+ ******************************************************************************/
+/** \brief        Ready callback of the webhouse, wakes up runStart()
+ *
+ *  \type         static
+ *
+ *  \param[in]    error  result of the initialization
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onReady(BBBError error) {
+
+    pthread_mutex_lock(&mutexReady);
+    u64ReadyNs = getNowNs();
+    errorReady = error;
+    pthread_cond_signal(&condReady);
+    pthread_mutex_unlock(&mutexReady);
+}
+
+/*******************************************************************************
+ *  function :    runStart
+ ******************************************************************************/
+/** \brief        Starts the webhouse, prints the result and ends the process
+ *                without finalizing the webhouse
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcName  cold or warm
+ *
+ *  \return       does not return
+ *
+ ******************************************************************************/
+static void runStart(const char * pcName) {
+
+    uint64_t u64Start;
+    uint64_t u64Started;
+    uint32_t i;
+
+    for(i = 0; i < LOG_MODULES; i++) {
+        setLogLevel(i, LOG_LEVEL_ERROR);
+    }
+
+    u32Syscalls = 0;
+    u64Start = getNowNs();
+    if(startWebhouse(onReady) != BBB_SUCCESS) {
+        fprintf(stderr, "webhouse not started\n");
+        _exit(EXIT_FAILURE);
+    }
+    u64Started = getNowNs();
+
+    pthread_mutex_lock(&mutexReady);
+    while(u64ReadyNs == 0) {
+        pthread_cond_wait(&condReady, &mutexReady);
+    }
+    pthread_mutex_unlock(&mutexReady);
+
+    printf("%-6s  %18.0f  %16.0f  %10u%s\n", pcName,
+           (u64Started - u64Start) / 1000.0,
+           (u64ReadyNs - u64Start) / 1000.0,
+           __atomic_load_n(&u32Syscalls, __ATOMIC_RELAXED),
+           (errorReady == BBB_SUCCESS) ? "" : "  (devices failed)");
+    fflush(stdout);
+
+    _exit(EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    createStandIn
+ ******************************************************************************/
+/** \brief        Creates the stand-in directories as the beaglebone shows
+ *                them after a reboot: no gpio exported, all pwm's stopped
+ *
+ *  \type         static
+ *
+ *  \return       BBB_SUCCESS on success, BBB_FILE_OPEN otherwise
+ *
+ ******************************************************************************/
+static BBBError createStandIn(void) {
+
+    static const char * apcAttr[] = { "duty", "period", "run" };
+    char                acPath[BENCH_MAX_PATH];
+    BBBError            error = BBB_SUCCESS;
+    uint32_t            i;
+    uint32_t            j;
+
+    snprintf(acPath, sizeof(acPath), "rm -rf '%s' '%s'",
+             GPIO_SYSFS_DIR, PWM_SYSFS_DIR);
+    if(system(acPath) != 0) {
+        return (BBB_FILE_OPEN);
+    }
+
+    mkdir(GPIO_SYSFS_DIR, 0755);
+    error |= writeFile(GPIO_SYSFS_DIR "/export", "");
+    error |= writeFile(GPIO_SYSFS_DIR "/unexport", "");
+
+    mkdir(PWM_SYSFS_DIR, 0755);
+    for(i = 0; i < sizeof(apcPwm) / sizeof(apcPwm[0]); i++) {
+        snprintf(acPath, sizeof(acPath), PWM_SYSFS_DIR "/%s", apcPwm[i]);
+        mkdir(acPath, 0755);
+        for(j = 0; j < sizeof(apcAttr) / sizeof(apcAttr[0]); j++) {
+            snprintf(acPath, sizeof(acPath), PWM_SYSFS_DIR "/%s/%s",
+                     apcPwm[i], apcAttr[j]);
+            error |= writeFile(acPath, "0\n");
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    createGpio
+ ******************************************************************************/
+/** \brief        Creates the files of an exported gpio, as the kernel does
+ *
+ *  \type         static
+ *
+ *  \param[in]    pcGpio  number of the gpio (not '\0' terminated)
+ *  \param[in]    len     length of the number
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void createGpio(const char * pcGpio, size_t len) {
+
+    char acPath[BENCH_MAX_PATH];
+    int  s32Len;
+
+    s32Len = snprintf(acPath, sizeof(acPath), GPIO_SYSFS_DIR "/gpio%.*s",
+                      (int) len, pcGpio);
+    mkdir(acPath, 0755);
+
+    snprintf(acPath + s32Len, sizeof(acPath) - s32Len, "/value");
+    writeFile(acPath, "0\n");
+    snprintf(acPath + s32Len, sizeof(acPath) - s32Len, "/direction");
+    writeFile(acPath, "in\n");
+    snprintf(acPath + s32Len, sizeof(acPath) - s32Len, "/edge");
+    writeFile(acPath, "none\n");
+}
+
+/*******************************************************************************
+ *  function :    writeFile
+ ******************************************************************************/
+static BBBError writeFile(const char * pcPath, const char * pcValue) {
+
+    FILE * psFile;
+
+    psFile = fopen(pcPath, "w");
+    if(psFile == NULL) {
+        return (BBB_FILE_OPEN);
+    }
+    fputs(pcValue, psFile);
+    fclose(psFile);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec);
+}
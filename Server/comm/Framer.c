@@ -0,0 +1,245 @@
+/******************************************************************************/
+/** \file       Framer.c
+ *******************************************************************************
+ *
+ *  \brief      Incremental splitting of a byte stream into messages.
+ *              <p>
+ *              TCP does not preserve message boundaries: several JSON
+ *              messages may arrive within one recv() call and a single
+ *              message may be split over two calls. The framer scans a
+ *              growing receive buffer and returns every complete message as
+ *              a pointer into this buffer (nothing is copied). The scan is
+ *              resumable, bytes which were already scanned are not scanned
+ *              again when more data arrives.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              initFramer
+ *              nextFramerMessage
+ *              compactFramer
+ *  functions  local:
+ *              nextJsonMessage
+ *              nextLineMessage
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+
+#include "Framer.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+static boolE nextJsonMessage(sFramer * psFramer,
+                             char * pcBuf,
+                             uint32_t u32Length,
+                             char ** ppcMsg,
+                             uint32_t * pu32MsgLen);
+static boolE nextLineMessage(sFramer * psFramer,
+                             char * pcBuf,
+                             uint32_t u32Length,
+                             char ** ppcMsg,
+                             uint32_t * pu32MsgLen);
+
+//----- Data -------------------------------------------------------------------
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    initFramer
+ ******************************************************************************/
+/** \brief        Resets the scan state of a stream.
+ *
+ *  \type         global
+ *
+ *  \param[out]   psFramer  scan state
+ *  \param[in]    eMode     FRAMER_JSON or FRAMER_NEWLINE
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void initFramer(sFramer * psFramer, eFramerMode eMode) {
+
+    memset(psFramer, 0, sizeof(*psFramer));
+    psFramer->eMode = eMode;
+    psFramer->bInString = FALSE;
+    psFramer->bEscape = FALSE;
+}
+
+/*******************************************************************************
+ *  function :    nextFramerMessage
+ ******************************************************************************/
+/** \brief        Returns the next complete message within the buffer.
+ *                <p>
+ *                The buffer must always contain the same stream, new data is
+ *                appended at its end. The returned message points into the
+ *                buffer and is valid until compactFramer() is called.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psFramer    scan state
+ *  \param[in]    pcBuf       receive buffer
+ *  \param[in]    u32Length   number of bytes within the buffer
+ *  \param[out]   ppcMsg      begin of the message
+ *  \param[out]   pu32MsgLen  length of the message
+ *
+ *  \return       TRUE if a message was found, FALSE if more data is needed
+ *
+ ******************************************************************************/
+boolE nextFramerMessage(sFramer * psFramer,
+                        char * pcBuf,
+                        uint32_t u32Length,
+                        char ** ppcMsg,
+                        uint32_t * pu32MsgLen) {
+
+    boolE found;
+
+    if(psFramer->eMode == FRAMER_NEWLINE) {
+        found = nextLineMessage(psFramer, pcBuf, u32Length, ppcMsg, pu32MsgLen);
+    } else {
+        found = nextJsonMessage(psFramer, pcBuf, u32Length, ppcMsg, pu32MsgLen);
+    }
+
+    return (found);
+}
+
+/*******************************************************************************
+ *  function :    compactFramer
+ ******************************************************************************/
+/** \brief        Removes all processed bytes from the buffer.
+ *                <p>
+ *                Only the beginning of an incomplete message (if any) is
+ *                moved to the front of the buffer. Must be called after all
+ *                complete messages were fetched with nextFramerMessage().
+ *
+ *  \type         global
+ *
+ *  \param[in]    psFramer    scan state
+ *  \param[in]    pcBuf       receive buffer
+ *  \param[in]    u32Length   number of bytes within the buffer
+ *
+ *  \return       number of bytes remaining within the buffer
+ *
+ ******************************************************************************/
+uint32_t compactFramer(sFramer * psFramer,
+                       char * pcBuf,
+                       uint32_t u32Length) {
+
+    uint32_t u32Consumed;
+
+    /* Outside of a message everything scanned can be dropped */
+    if((psFramer->eMode == FRAMER_JSON) && (psFramer->u32Depth == 0)) {
+        u32Consumed = psFramer->u32Scan;
+    } else {
+        u32Consumed = psFramer->u32Start;
+    }
+
+    if(u32Consumed > 0) {
+        u32Length -= u32Consumed;
+        memmove(pcBuf, &pcBuf[u32Consumed], u32Length);
+        psFramer->u32Scan -= u32Consumed;
+        psFramer->u32Start = 0;
+    }
+
+    return (u32Length);
+}
+
+/*******************************************************************************
+ *  function :    nextJsonMessage
+ ******************************************************************************/
+static boolE nextJsonMessage(sFramer * psFramer,
+                             char * pcBuf,
+                             uint32_t u32Length,
+                             char ** ppcMsg,
+                             uint32_t * pu32MsgLen) {
+
+    uint32_t i;
+    char     c;
+
+    for(i = psFramer->u32Scan; i < u32Length; i++) {
+
+        c = pcBuf[i];
+
+        if(psFramer->u32Depth == 0) {
+            /* Skip everything until a new object starts */
+            if(c == '{') {
+                psFramer->u32Start = i;
+                psFramer->u32Depth = 1;
+            }
+        } else if(psFramer->bInString == TRUE) {
+            if(psFramer->bEscape == TRUE) {
+                psFramer->bEscape = FALSE;
+            } else if(c == '\\') {
+                psFramer->bEscape = TRUE;
+            } else if(c == '"') {
+                psFramer->bInString = FALSE;
+            }
+        } else if(c == '"') {
+            psFramer->bInString = TRUE;
+        } else if((c == '{') || (c == '[')) {
+            psFramer->u32Depth++;
+        } else if((c == '}') || (c == ']')) {
+            if(--psFramer->u32Depth == 0) {
+                *ppcMsg = &pcBuf[psFramer->u32Start];
+                *pu32MsgLen = i + 1 - psFramer->u32Start;
+                psFramer->u32Scan = i + 1;
+                psFramer->u32Start = i + 1;
+                return (TRUE);
+            }
+        }
+    }
+
+    psFramer->u32Scan = u32Length;
+
+    return (FALSE);
+}
+
+/*******************************************************************************
+ *  function :    nextLineMessage
+ ******************************************************************************/
+static boolE nextLineMessage(sFramer * psFramer,
+                             char * pcBuf,
+                             uint32_t u32Length,
+                             char ** ppcMsg,
+                             uint32_t * pu32MsgLen) {
+
+    char *   pcEol;
+    uint32_t u32Len;
+
+    while(psFramer->u32Scan < u32Length) {
+
+        pcEol = memchr(&pcBuf[psFramer->u32Scan], '\n',
+                       u32Length - psFramer->u32Scan);
+        if(pcEol == NULL) {
+            break;
+        }
+
+        u32Len = (uint32_t) (pcEol - &pcBuf[psFramer->u32Start]);
+        *ppcMsg = &pcBuf[psFramer->u32Start];
+        psFramer->u32Scan = (uint32_t) (pcEol - pcBuf) + 1;
+        psFramer->u32Start = psFramer->u32Scan;
+
+        if((u32Len > 0) && ((*ppcMsg)[u32Len - 1] == '\r')) {
+            u32Len--;
+        }
+        if(u32Len > 0) {
+            *pu32MsgLen = u32Len;
+            return (TRUE);
+        }
+    }
+
+    psFramer->u32Scan = u32Length;
+
+    return (FALSE);
+}
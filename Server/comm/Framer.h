@@ -0,0 +1,90 @@
+#ifndef FRAMER_H_
+#define FRAMER_H_
+/******************************************************************************/
+/** \file       Framer.h
+ *******************************************************************************
+ *
+ *  \brief      Incremental splitting of a byte stream into messages.
+ *              <p>
+ *              TCP does not preserve message boundaries: several JSON
+ *              messages may arrive within one recv() call and a single
+ *              message may be split over two calls. The framer scans a
+ *              growing receive buffer and returns every complete message as
+ *              a pointer into this buffer (nothing is copied). The scan is
+ *              resumable, bytes which were already scanned are not scanned
+ *              again when more data arrives.
+ *              <p>
+ *              Two modes are supported:
+ *              <ul>
+ *              <li> FRAMER_JSON: a message is a complete JSON object
+ *              {...}. Braces within strings (including escaped quotes) are
+ *              ignored. Anything between two objects is skipped.
+ *              <li> FRAMER_NEWLINE: a message is a line terminated by '\n'
+ *              (a trailing '\r' is removed). Empty lines are skipped.
+ *              </ul>
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              while(nextFramerMessage(&sFramer, acBuf, u32Len,
+ *                                      &pcMsg, &u32MsgLen) == TRUE) {
+ *                  // handle pcMsg[0..u32MsgLen-1]
+ *              }
+ *              // keep the incomplete message for the next recv()
+ *              u32Len = compactFramer(&sFramer, acBuf, u32Len);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    initFramer
+ *              nextFramerMessage
+ *              compactFramer
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+/** Message delimitation */
+typedef enum _eFramerMode {
+
+    FRAMER_JSON    = 0,  ///< messages are JSON objects
+    FRAMER_NEWLINE = 1   ///< messages are lines
+
+} eFramerMode;
+
+/** Resumable scan state of a stream */
+typedef struct _sFramer {
+
+    eFramerMode eMode;       ///< message delimitation
+    uint32_t    u32Scan;     ///< bytes of the buffer already scanned
+    uint32_t    u32Start;    ///< begin of the message currently scanned
+    uint32_t    u32Depth;    ///< nesting depth of {} and [] (FRAMER_JSON)
+    boolE       bInString;   ///< within a string (FRAMER_JSON)
+    boolE       bEscape;     ///< last character was '\' (FRAMER_JSON)
+
+} sFramer;
+
+//----- Function prototypes ----------------------------------------------------
+extern void     initFramer(sFramer * psFramer, eFramerMode eMode);
+
+extern boolE    nextFramerMessage(sFramer * psFramer,
+                                  char * pcBuf,
+                                  uint32_t u32Length,
+                                  char ** ppcMsg,
+                                  uint32_t * pu32MsgLen);
+
+extern uint32_t compactFramer(sFramer * psFramer,
+                              char * pcBuf,
+                              uint32_t u32Length);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* FRAMER_H_ */
@@ -68,6 +68,7 @@
  *              getStringRep
  *              cleanUpStringRep
  *              getJsonStringValue
+ *              getJsonScalarValue
  *              setJsonStringKeyValue
  *  functions  local:
  *              deleteJson
@@ -75,10 +76,12 @@
  ******************************************************************************/
 
 //----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
 #include "Json.h"
+#define LOG_MODULE  JSON
 #include "Log.h"
 
 //----- Macros -----------------------------------------------------------------
@@ -297,6 +300,58 @@ char * getJsonStringValue(json_t * pJson, char * pcKey) {
     return (pcValue);
 }
 
+/*******************************************************************************
+ *  function :    getJsonScalarValue
+ ******************************************************************************/
+/** \brief        Get the value of a key as text, whatever its scalar type.
+ *                <p>
+ *                A string value is returned as a borrowed reference (see
+ *                getJsonStringValue()). A number is written as decimal text
+ *                into pcBuf, a real is truncated to its integer part. The
+ *                literals true and false are returned as "true" and "false".
+ *
+ *  \type         global
+ *
+ *  \param[in]    pJson    json object
+ *  \param[in]    pcKey    key string (null terminated)
+ *  \param[out]   pcBuf    buffer for the text of a number
+ *  \param[in]    u32Size  size of pcBuf
+ *
+ *  \return       '\0' terminated value, NULL if the key is missing or its
+ *                value is null, an object or an array. You are not allowed
+ *                to change the value!
+ *
+ ******************************************************************************/
+char * getJsonScalarValue(json_t * pJson,
+                          char * pcKey,
+                          char * pcBuf,
+                          uint32_t u32Size) {
+
+    char   *pcValue = NULL;
+    json_t *pJsonTemp = NULL;
+
+    if((pJson != NULL) && (pcKey != NULL) && (pcBuf != NULL)) {
+
+        pJsonTemp = json_object_get(pJson, pcKey);
+        if(json_is_string(pJsonTemp)) {
+            pcValue = (char *) json_string_value(pJsonTemp);
+        } else if(json_is_integer(pJsonTemp)) {
+            snprintf(pcBuf, u32Size, "%" JSON_INTEGER_FORMAT,
+                     json_integer_value(pJsonTemp));
+            pcValue = pcBuf;
+        } else if(json_is_real(pJsonTemp)) {
+            snprintf(pcBuf, u32Size, "%" JSON_INTEGER_FORMAT,
+                     (json_int_t) json_real_value(pJsonTemp));
+            pcValue = pcBuf;
+        } else if(json_is_true(pJsonTemp)) {
+            pcValue = "true";
+        } else if(json_is_false(pJsonTemp)) {
+            pcValue = "false";
+        }
+    }
+    return (pcValue);
+}
+
 /*******************************************************************************
  *  function :    setJsonStringKeyValue
  ******************************************************************************/
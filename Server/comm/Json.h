@@ -65,6 +65,7 @@
  *              getStringRep
  *              cleanUpStringRep
  *              getJsonStringValue
+ *              getJsonScalarValue
  *              setJsonStringKeyValue
  *
  ******************************************************************************/
@@ -93,6 +94,11 @@ extern void     cleanUpStringRep(char * pcJsonMsg);
 
 extern char *   getJsonStringValue(json_t * pJson, char * pcKey);
 
+extern char *   getJsonScalarValue(json_t * pJson,
+                                   char * pcKey,
+                                   char * pcBuf,
+                                   uint32_t u32Size);
+
 extern BBBError setJsonStringKeyValue(json_t * pJson, char * pcKey, char * pcValue);
 
 //----- Data -------------------------------------------------------------------
@@ -0,0 +1,234 @@
+/******************************************************************************/
+/** \file       JsonScan.c
+ *******************************************************************************
+ *
+ *  \brief      Allocation free tokenizer of flat JSON messages.
+ *              <p>
+ *              The message is scanned once from the left to the right, every
+ *              key and value is returned as a pointer into the message.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              scanJsonObject
+ *  functions  local:
+ *              skipSpace
+ *              scanString
+ *              scanNumber
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+
+#include "JsonScan.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+static uint32_t skipSpace(const char * pcMsg, uint32_t u32Pos, uint32_t u32Length);
+static BBBError scanString(const char * pcMsg,
+                           uint32_t * pu32Pos,
+                           uint32_t u32Length,
+                           const char ** ppcString,
+                           uint32_t * pu32StringLen);
+static BBBError scanNumber(const char * pcMsg,
+                           uint32_t * pu32Pos,
+                           uint32_t u32Length,
+                           const char ** ppcNumber,
+                           uint32_t * pu32NumberLen);
+
+//----- Data -------------------------------------------------------------------
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    scanJsonObject
+ ******************************************************************************/
+/** \brief        Splits a flat JSON object into its key/value pairs.
+ *                <p>
+ *                The pairs point into pcMsg and are valid as long as the
+ *                message is. Keys and values are not '\0' terminated. Nothing
+ *                is written to asPairs beyond the returned number of pairs.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcMsg        JSON message (not '\0' terminated)
+ *  \param[in]    u32Length    length of the message
+ *  \param[out]   asPairs      key/value pairs
+ *  \param[in]    u32MaxPairs  number of elements of asPairs
+ *  \param[out]   pu32Pairs    number of pairs found
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS           on success
+ *                BBB_JSON_UNSUPPORTED  no flat object or too many pairs
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError scanJsonObject(const char * pcMsg,
+                        uint32_t u32Length,
+                        sJsonPair * asPairs,
+                        uint32_t u32MaxPairs,
+                        uint32_t * pu32Pairs) {
+
+    uint32_t  u32Pos = 0;
+    uint32_t  u32Pairs = 0;
+    sJsonPair sPair;
+
+    *pu32Pairs = 0;
+
+    u32Pos = skipSpace(pcMsg, u32Pos, u32Length);
+    if((u32Pos >= u32Length) || (pcMsg[u32Pos] != '{')) {
+        return (BBB_JSON_UNSUPPORTED);
+    }
+    u32Pos = skipSpace(pcMsg, u32Pos + 1, u32Length);
+
+    /* Empty object */
+    if((u32Pos < u32Length) && (pcMsg[u32Pos] == '}')) {
+        return (BBB_SUCCESS);
+    }
+
+    for(;;) {
+
+        /* "key" */
+        if(scanString(pcMsg, &u32Pos, u32Length,
+                      &sPair.pcKey, &sPair.u32KeyLen) != BBB_SUCCESS) {
+            return (BBB_JSON_UNSUPPORTED);
+        }
+
+        /* : */
+        u32Pos = skipSpace(pcMsg, u32Pos, u32Length);
+        if((u32Pos >= u32Length) || (pcMsg[u32Pos] != ':')) {
+            return (BBB_JSON_UNSUPPORTED);
+        }
+        u32Pos = skipSpace(pcMsg, u32Pos + 1, u32Length);
+
+        /* "value" or number */
+        if((u32Pos < u32Length) && (pcMsg[u32Pos] == '"')) {
+            if(scanString(pcMsg, &u32Pos, u32Length,
+                          &sPair.pcValue, &sPair.u32ValueLen) != BBB_SUCCESS) {
+                return (BBB_JSON_UNSUPPORTED);
+            }
+        } else if(scanNumber(pcMsg, &u32Pos, u32Length,
+                             &sPair.pcValue, &sPair.u32ValueLen) != BBB_SUCCESS) {
+            return (BBB_JSON_UNSUPPORTED);
+        }
+
+        if(u32Pairs >= u32MaxPairs) {
+            return (BBB_JSON_UNSUPPORTED);
+        }
+        asPairs[u32Pairs++] = sPair;
+
+        /* , or } */
+        u32Pos = skipSpace(pcMsg, u32Pos, u32Length);
+        if(u32Pos >= u32Length) {
+            return (BBB_JSON_UNSUPPORTED);
+        }
+        if(pcMsg[u32Pos] == '}') {
+            break;
+        }
+        if(pcMsg[u32Pos] != ',') {
+            return (BBB_JSON_UNSUPPORTED);
+        }
+        u32Pos = skipSpace(pcMsg, u32Pos + 1, u32Length);
+    }
+
+    /* Only whitespace may follow the object */
+    if(skipSpace(pcMsg, u32Pos + 1, u32Length) != u32Length) {
+        return (BBB_JSON_UNSUPPORTED);
+    }
+
+    *pu32Pairs = u32Pairs;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    skipSpace
+ ******************************************************************************/
+static uint32_t skipSpace(const char * pcMsg, uint32_t u32Pos, uint32_t u32Length) {
+
+    while((u32Pos < u32Length) &&
+          ((pcMsg[u32Pos] == ' ') || (pcMsg[u32Pos] == '\t') ||
+           (pcMsg[u32Pos] == '\r') || (pcMsg[u32Pos] == '\n'))) {
+        u32Pos++;
+    }
+
+    return (u32Pos);
+}
+
+/*******************************************************************************
+ *  function :    scanString
+ ******************************************************************************/
+static BBBError scanString(const char * pcMsg,
+                           uint32_t * pu32Pos,
+                           uint32_t u32Length,
+                           const char ** ppcString,
+                           uint32_t * pu32StringLen) {
+
+    uint32_t     u32Pos = *pu32Pos;
+    const char * pcEnd;
+
+    if((u32Pos >= u32Length) || (pcMsg[u32Pos] != '"')) {
+        return (BBB_JSON_UNSUPPORTED);
+    }
+    u32Pos++;
+
+    pcEnd = memchr(&pcMsg[u32Pos], '"', u32Length - u32Pos);
+    if(pcEnd == NULL) {
+        return (BBB_JSON_UNSUPPORTED);
+    }
+
+    *ppcString = &pcMsg[u32Pos];
+    *pu32StringLen = (uint32_t) (pcEnd - &pcMsg[u32Pos]);
+
+    /* Escaped characters would have to be decoded, leave them to jansson */
+    if(memchr(*ppcString, '\\', *pu32StringLen) != NULL) {
+        return (BBB_JSON_UNSUPPORTED);
+    }
+
+    *pu32Pos = u32Pos + *pu32StringLen + 1;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    scanNumber
+ ******************************************************************************/
+static BBBError scanNumber(const char * pcMsg,
+                           uint32_t * pu32Pos,
+                           uint32_t u32Length,
+                           const char ** ppcNumber,
+                           uint32_t * pu32NumberLen) {
+
+    uint32_t u32Pos = *pu32Pos;
+    char     c;
+
+    while(u32Pos < u32Length) {
+        c = pcMsg[u32Pos];
+        if(((c < '0') || (c > '9')) && (c != '-') && (c != '+') &&
+           (c != '.') && (c != 'e') && (c != 'E')) {
+            break;
+        }
+        u32Pos++;
+    }
+
+    if(u32Pos == *pu32Pos) {
+        return (BBB_JSON_UNSUPPORTED);
+    }
+
+    *ppcNumber = &pcMsg[*pu32Pos];
+    *pu32NumberLen = u32Pos - *pu32Pos;
+    *pu32Pos = u32Pos;
+
+    return (BBB_SUCCESS);
+}
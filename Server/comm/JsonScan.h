@@ -0,0 +1,70 @@
+#ifndef JSONSCAN_H_
+#define JSONSCAN_H_
+/******************************************************************************/
+/** \file       JsonScan.h
+ *******************************************************************************
+ *
+ *  \brief      Allocation free tokenizer of flat JSON messages.
+ *              <p>
+ *              The commands of the clients are flat JSON objects like
+ *              {"Lampe":"42"}. Building a jansson object for each of them
+ *              costs several heap allocations. This module scans such a
+ *              message in a single pass and returns all key/value pairs as
+ *              pointers into the message (nothing is copied or allocated).
+ *              <p>
+ *              Only the shape used by the clients is supported: one object
+ *              whose values are strings or numbers, strings without escape
+ *              sequences. Anything else (nested objects, arrays, literals,
+ *              escapes) is reported as BBB_JSON_UNSUPPORTED, the caller may
+ *              then fall back to the jansson parser (Json.h).
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              sJsonPair asPairs[JSON_SCAN_MAX_PAIRS];
+ *              uint32_t  u32Pairs;
+ *
+ *              if(scanJsonObject(pcMsg, u32Len, asPairs, JSON_SCAN_MAX_PAIRS,
+ *                                &u32Pairs) == BBB_SUCCESS) {
+ *                  // asPairs[0..u32Pairs-1], not '\0' terminated
+ *              }
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    scanJsonObject
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of pairs a client message may contain at most                      */
+#define JSON_SCAN_MAX_PAIRS     ( 8 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Key/value pair pointing into the scanned message */
+typedef struct _sJsonPair {
+
+    const char * pcKey;        ///< key without quotes
+    uint32_t     u32KeyLen;    ///< length of the key
+    const char * pcValue;      ///< value without quotes
+    uint32_t     u32ValueLen;  ///< length of the value
+
+} sJsonPair;
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError scanJsonObject(const char * pcMsg,
+                               uint32_t u32Length,
+                               sJsonPair * asPairs,
+                               uint32_t u32MaxPairs,
+                               uint32_t * pu32Pairs);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* JSONSCAN_H_ */
@@ -21,79 +21,242 @@
 #include <netdb.h>
 
 #include "Json.h"
+#include "JsonScan.h"
 #include "RxTxJSON.h"
 #include "Webhouse.h"
+#include "Pid.h"
+#include "BBBConfig.h"
+#define LOG_MODULE  APP
+#include "Log.h"
+
+/* Transmit message ----------------------------------------------------------*/
+
+/* Longest decimal value ("-2147483648") */
+#define TX_VALUE_MAX_LEN 11
+/* Longest message: {"TempIst":"v","Heizung":"v","Burglar":"v"} */
+#define TX_JSON_MAX_LEN (2 + 3 * (12 + TX_VALUE_MAX_LEN + 1))
+
+/* Alarm events ------------------------------------------------------------*/
+
+/* Number of alarm events read from the webhouse at once */
+#define ALARM_EVENT_BATCH 8
+
+/* Command table -------------------------------------------------------------*/
+
+/* Perfect hash of the command keys TV, Lampe, Leuchter, TempSoll, AlarmReset
+ * and Alarm: every key maps to a different slot of the table, thus a received
+ * key is identified with a single comparison. The hash must be adapted if a
+ * key is added (all keys are at least two characters long). */
+#define COMMAND_TABLE_SIZE 8
+#define COMMAND_HASH(key, len) \
+	((((uint8_t) (key)[1]) + 3 * (len) + ((uint8_t) (key)[(len) - 1])) \
+			& (COMMAND_TABLE_SIZE - 1))
+
+/* Handler of a received command, the value is not '\0' terminated */
+typedef void (*pfCommand)(const char * value, uint32_t len);
+
+typedef struct _sCommand {
+	const char * pcKey;
+	uint32_t u32KeyLen;
+	pfCommand pfHandler;
+} sCommand;
+
+static void commandTV(const char * value, uint32_t len);
+static void commandLampe(const char * value, uint32_t len);
+static void commandLeuchter(const char * value, uint32_t len);
+static void commandTempSoll(const char * value, uint32_t len);
+static void commandAlarmReset(const char * value, uint32_t len);
+static void commandAlarm(const char * value, uint32_t len);
+
+static const sCommand commandTable[COMMAND_TABLE_SIZE] = {
+	{ "Alarm",      5,  commandAlarm },      /* 0 */
+	{ "TempSoll",   8,  commandTempSoll },   /* 1 */
+	{ "TV",         2,  commandTV },         /* 2 */
+	{ NULL,         0,  NULL },              /* 3 */
+	{ NULL,         0,  NULL },              /* 4 */
+	{ "Lampe",      5,  commandLampe },      /* 5 */
+	{ "AlarmReset", 10, commandAlarmReset }, /* 6 */
+	{ "Leuchter",   8,  commandLeuchter }    /* 7 */
+};
 
 /* Implementation ------------------------------------------------------------*/
 
 char TemperaturSoll = 20;
+/* Set by controlHeizung(), the Heizung value must be sent to the clients */
+static boolE heizungPending = FALSE;
+/* An alarm was detected, kept until it is sent to the clients or reset */
+static boolE alarmLatched = FALSE;
+/* PI controller of the Heizung, output in percent. It runs on half degrees,
+ * the gains of BBBConfig.h are per degree. */
+static sPid heizungPid = PID_INITIALIZER(PID_GAIN(CONFIG_HEATER_KP / 2),
+		PID_GAIN(CONFIG_HEATER_KI / 2), PID_GAIN(CONFIG_HEATER_KD / 2), 0, 100);
+
+/*******************************************************************************
+ *  function :    parseValue
+ ******************************************************************************/
+/** \brief        Converts a decimal value to a number (like atoi, but the
+ *                value does not have to be '\0' terminated)
+ *
+ *  \param[in]    value  decimal value
+ *  \param[in]    len    length of the value
+ *
+ *  \return       number, 0 if the value does not start with a digit
+ *
+ ******************************************************************************/
+static int parseValue(const char * value, uint32_t len) {
+	uint32_t i = 0;
+	int sign = 1;
+	int number = 0;
+
+	if ((len > 0) && (value[0] == '-')) {
+		sign = -1;
+		i++;
+	}
+	for (; (i < len) && (value[i] >= '0') && (value[i] <= '9'); i++) {
+		number = number * 10 + (value[i] - '0');
+	}
+
+	return sign * number;
+}
+
+/*******************************************************************************
+ *  function :    dispatchCommand
+ ******************************************************************************/
+/** \brief        Calls the handler of a received key, unknown keys are
+ *                ignored
+ *
+ *  \param[in]    key     key (not '\0' terminated)
+ *  \param[in]    keyLen  length of the key
+ *  \param[in]    value   value (not '\0' terminated)
+ *  \param[in]    len     length of the value
+ *
+ *  \return       none
+ *
+ ******************************************************************************/
+static void dispatchCommand(const char * key, uint32_t keyLen,
+		const char * value, uint32_t len) {
+	const sCommand * command;
+
+	if (keyLen < 2) {
+		return;
+	}
+
+	command = &commandTable[COMMAND_HASH(key, keyLen)];
+	if ((command->u32KeyLen == keyLen)
+			&& (memcmp(command->pcKey, key, keyLen) == 0)) {
+		command->pfHandler(value, len);
+	}
+}
+
+/* Fernseher */
+static void commandTV(const char * value, uint32_t len) {
+	if ((len == 2) && (memcmp(value, "ON", 2) == 0)) {
+		/* value ist "ON" */
+		turnTVOn();
+		INFOPRINT("TV on");
+	} else {
+		/* value ist nicht "ON" */
+		turnTVOff();
+		INFOPRINT("TV off");
+	}
+}
+
+/* Stehlampe */
+static void commandLampe(const char * value, uint32_t len) {
+	char Stehlampe = parseValue(value, len);
+
+	dimSLampe(Stehlampe);
+	INFOPRINT("Stehlampe: %d", Stehlampe);
+}
+
+/* Kronleuchter */
+static void commandLeuchter(const char * value, uint32_t len) {
+	char Kronleuchter = parseValue(value, len);
+
+	dimDLampe(Kronleuchter);
+	INFOPRINT("Kronleuchter: %d", Kronleuchter);
+}
+
+/* Soll-Temperatur */
+static void commandTempSoll(const char * value, uint32_t len) {
+	TemperaturSoll = parseValue(value, len);
+	INFOPRINT("Temperatur: %d", TemperaturSoll);
+}
+
+/* Alarm quittieren */
+static void commandAlarmReset(const char * value, uint32_t len) {
+	resetAlarm();
+	alarmLatched = FALSE;
+	INFOPRINT("Alarm reset");
+}
+
+/* Alarm ein-/ausschalten */
+static void commandAlarm(const char * value, uint32_t len) {
+	if (((len == 2) && (memcmp(value, "ON", 2) == 0))
+			|| ((len == 4) && (memcmp(value, "true", 4) == 0))
+			|| (parseValue(value, len) != 0)) {
+		enableAlarm();
+		INFOPRINT("Alarm on");
+	} else {
+		disableAlarm();
+		INFOPRINT("Alarm off");
+	}
+}
 
 /*******************************************************************************
  *  function :    receiveAndSetValues
  ******************************************************************************/
 /** \brief        Receives values as JSON and sets them
+ *                <p>
+ *                The buffer holds exactly one JSON message (split by the
+ *                framer of the connection), it is not '\0' terminated.
+ *                Flat messages are tokenized in place (scanJsonObject) and
+ *                every key is dispatched through the command table, without
+ *                any heap allocation. Other message shapes (escapes,
+ *                true/false, nesting) are parsed by jansson. Either way,
+ *                string, number and true/false values reach the handlers as
+ *                text.
  *
- *  \param[in]    none
+ *  \param[in]    rxBuf        JSON message
+ *  \param[in]    rx_data_len  length of the message
  *
  *  \return       none
  *
  ******************************************************************************/
 void receiveAndSetValues(char * rxBuf, int rx_data_len) {
-	/* Webhuesli variables, initialised with default values */
-	char Stehlampe = 0;
-	char Kronleuchter = 0;
-	char * last_occurrence;
+	sJsonPair pairs[JSON_SCAN_MAX_PAIRS];
+	uint32_t numPairs = 0;
+	uint32_t i;
 
 	/* JSON variables */
-	// char * pcString = "{\"Hello\":\"World\"}";
 	char * pcValue = NULL;
+	char acNumber[24];
 	json_t *jsonMsg = NULL;
 
-	/* preprocess JSON msg: delete all {...} pairs except the last one */
-	last_occurrence = strrchr(rxBuf, '{');
-	rx_data_len = (rxBuf + rx_data_len) - last_occurrence;
-	//printf("DEBUG:\n%d, %d, %d:\n\"%s\"", (int)rxBuf, (int)last_occurrence, rx_data_len, last_occurrence);
-	rxBuf = last_occurrence;
+	/* Fast path: flat object with string or number values */
+	if (scanJsonObject(rxBuf, rx_data_len, pairs, JSON_SCAN_MAX_PAIRS,
+			&numPairs) == BBB_SUCCESS) {
+		for (i = 0; i < numPairs; i++) {
+			dispatchCommand(pairs[i].pcKey, pairs[i].u32KeyLen,
+					pairs[i].pcValue, pairs[i].u32ValueLen);
+		}
+		return;
+	}
 
-	/* Handle received JSON */
+	/* Fallback: handle received JSON with jansson */
 	jsonMsg = createJsonFromBuffer(rxBuf, rx_data_len);
 	if (jsonMsg != NULL) {
-		/* Fernseher */
-		pcValue = getJsonStringValue(jsonMsg, "TV");
-		if (pcValue != NULL) {
-			if (strcmp(pcValue, "ON") == 0) {
-				/* pcValue ist "ON" */
-				turnTVOn();
-				printf("\n TV on");
-			} else {
-				/* pcValue ist nicht "ON" */
-				turnTVOff();
-				printf("\n TV off");
+		for (i = 0; i < COMMAND_TABLE_SIZE; i++) {
+			if (commandTable[i].pcKey == NULL) {
+				continue;
+			}
+			/* Numbers and true/false like the fast path */
+			pcValue = getJsonScalarValue(jsonMsg,
+					(char *) commandTable[i].pcKey, acNumber,
+					sizeof(acNumber));
+			if (pcValue != NULL) {
+				commandTable[i].pfHandler(pcValue, strlen(pcValue));
 			}
-		}
-		/* Stehlampe */
-		pcValue = getJsonStringValue(jsonMsg, "Lampe");
-		if (pcValue != NULL) {
-			/* String zu Zahl konvertieren */
-			Stehlampe = atoi(pcValue);
-			dimSLampe(Stehlampe);
-			printf("\n Stehlampe: %d", Stehlampe);
-		}
-		/* Kronleuchter */
-		pcValue = getJsonStringValue(jsonMsg, "Leuchter");
-		if (pcValue != NULL) {
-			/* String zu Zahl konvertieren */
-			Kronleuchter = atoi(pcValue);
-			dimDLampe(Kronleuchter);
-			printf("\n Kronleuchter: %d", Kronleuchter);
-		}
-		/* Soll-Temperatur */
-		pcValue = getJsonStringValue(jsonMsg, "TempSoll");
-		if (pcValue != NULL) {
-			/* String zu Zahl konvertieren */
-			TemperaturSoll = atoi(pcValue);
-			//dimHeizung(TemperaturSoll);
-			printf("\n Temperatur: %d", TemperaturSoll);
 		}
 
 		/* Free ressources */
@@ -101,136 +264,294 @@ void receiveAndSetValues(char * rxBuf, int rx_data_len) {
 	}
 }
 
+/*******************************************************************************
+ *  function :    formatValue
+ ******************************************************************************/
+/** \brief        Writes a number as decimal digits (like sprintf "%d", but
+ *                without parsing a format string and without '\0')
+ *
+ *  \param[out]   dst    destination, at least TX_VALUE_MAX_LEN bytes
+ *  \param[in]    value  number
+ *
+ *  \return       number of characters written
+ *
+ ******************************************************************************/
+static int formatValue(char * dst, int value) {
+	char digits[TX_VALUE_MAX_LEN];
+	unsigned int u = value;
+	int n = 0;
+	int length = 0;
+
+	if (value < 0) {
+		dst[length++] = '-';
+		u = 0u - u;
+	}
+	do {
+		digits[n++] = '0' + (u % 10);
+		u /= 10;
+	} while (u != 0);
+	while (n > 0) {
+		dst[length++] = digits[--n];
+	}
+
+	return length;
+}
+
+/*******************************************************************************
+ *  function :    appendPair
+ ******************************************************************************/
+/** \brief        Appends "key":"value" to a message, preceded by a comma if it
+ *                is not the first pair
+ *
+ *  \param[out]   dst     end of the message
+ *  \param[in]    first   TRUE for the first pair of the message
+ *  \param[in]    key     precomputed fragment "key":"
+ *  \param[in]    keyLen  length of the fragment
+ *  \param[in]    value   value
+ *
+ *  \return       number of characters written
+ *
+ ******************************************************************************/
+static int appendPair(char * dst, boolE first, const char * key, int keyLen,
+		int value) {
+	int length = 0;
+
+	if (!first) {
+		dst[length++] = ',';
+	}
+	memcpy(&dst[length], key, keyLen);
+	length += keyLen;
+	length += formatValue(&dst[length], value);
+	dst[length++] = '"';
+
+	return length;
+}
+
 /*******************************************************************************
  *  function :    trasmitAndGetValues
  ******************************************************************************/
-/** \brief        Gets the values and transmits them as JSON
+/** \brief        Gets the values and writes them as JSON into txBuf
+ *                <p>
+ *                The message is composed out of precomputed key fragments
+ *                without any heap allocation, e.g.
+ *                {"TempIst":"21","Heizung":"100","Burglar":"1"}. It is '\0'
+ *                terminated if there is room left in txBuf.
  *
- *  \param[in]    mode = MODE_ITEMP : Only send Ist-Temperatur value                       
- *                mode = MODE_HEIZU : Only send Heizung value                              
- *                mode = MODE_LICHT : Only send Lichtschranke value                        
- *                mode = MODE_ALL   : Send Ist-Temperatur, Heizung und Lichtschranke values
+ *  \param[out]   txBuf         transmit buffer
+ *  \param[in]    txSize        size of the transmit buffer
+ *  \param[in]    isttempflag   send Ist-Temperatur value
+ *  \param[in]    heizungflag   send Heizung value
+ *  \param[in]    schrankeflag  send Lichtschranke value
  *
- *  \return       none
+ *  \return       exact length of the message, 0 if txBuf is too small
  *
  ******************************************************************************/
-int transmitAndGetValues(char * txBuf, boolE isttempflag, boolE heizungflag,
-		boolE schrankeflag) {
+int transmitAndGetValues(char * txBuf, int txSize, boolE isttempflag,
+		boolE heizungflag, boolE schrankeflag) {
+	/* Key fragments */
+	static const char keyTempIst[] = "\"TempIst\":\"";
+	static const char keyHeizung[] = "\"Heizung\":\"";
+	static const char keyBurglar[] = "\"Burglar\":\"";
+
 	/* Assign values */
-	char TemperaturIst = getTempIst();
+	int32_t TemperaturIst = 0;
 	char Heizung = getHeizungState();
-
-	/* JSON variables */
-	// char * pcString = "{\"Hello\":\"World\"}";
-	json_t *jsonMsg = NULL;
-	char * pcMsg = NULL;
 	int length = 0;
 
-	/* Handle JSON to transmit all values */
-	jsonMsg = createNewJsonMsg();
-	if (jsonMsg != NULL) {
-		/* Define key-value pairs */
-		char jsonBuffer[20];
-		/* Check mode */
-		if (isttempflag) {
-			/* Ist-Temperatur */
-			sprintf(jsonBuffer, "%d", TemperaturIst);
-			setJsonStringKeyValue(jsonMsg, "TempIst", jsonBuffer);
-		}
-		if (heizungflag) {
-			/* Heizung */
-			sprintf(jsonBuffer, "%d", Heizung);
-			setJsonStringKeyValue(jsonMsg, "Heizung", jsonBuffer);
-		}
-		if (schrankeflag) {
-			/* Lichtschranke */
-			sprintf(jsonBuffer, "%d", 1);
-			setJsonStringKeyValue(jsonMsg, "Burglar", jsonBuffer);
-		}
+	if (txSize < TX_JSON_MAX_LEN) {
+		return 0;
+	}
 
-		/* Create JSON string */
-		pcMsg = getStringRep(jsonMsg);
-		if (pcMsg != NULL) {
-			/* Write to transmit buffer */
-			printf("\n Theory SENT = \"%s\"", pcMsg);
-
-			while (pcMsg[length] != '\0')
-				length++;
-			printf(" length = %d", length);
-			strcpy(txBuf, pcMsg);
-			while (pcMsg[length] != '\0')
-				length++;
-			printf(" length = %d", length);
-
-			/* Free ressources */
-			cleanUpStringRep(pcMsg);
-		}
-		/* Free ressources */
-		cleanUpJson(jsonMsg);
+	/* No Ist-Temperatur is sent while there is no valid sample */
+	if (isttempflag && (getTempIst(&TemperaturIst, NULL) != BBB_SUCCESS)) {
+		isttempflag = FALSE;
+	}
+
+	txBuf[length++] = '{';
+	if (isttempflag) {
+		/* Ist-Temperatur */
+		length += appendPair(&txBuf[length], length == 1, keyTempIst,
+				sizeof(keyTempIst) - 1, TemperaturIst);
+	}
+	if (heizungflag) {
+		/* Heizung */
+		length += appendPair(&txBuf[length], length == 1, keyHeizung,
+				sizeof(keyHeizung) - 1, Heizung);
+	}
+	if (schrankeflag) {
+		/* Lichtschranke */
+		length += appendPair(&txBuf[length], length == 1, keyBurglar,
+				sizeof(keyBurglar) - 1, 1);
+	}
+	txBuf[length++] = '}';
+
+	if (length < txSize) {
+		txBuf[length] = '\0';
 	}
 
 	return length;
 }
 
 /*******************************************************************************
- *  function :    heizungControl
+ *  function :    controlHeizung
  ******************************************************************************/
 /** \brief        Controls the Heizung according to the Soll-Temperatur
+ *                (PI controller, see Pid.h)
+ *                <p>
+ *                Called periodically by the scheduler (every
+ *                CONFIG_CONTROL_PERIOD_MS) with the cached Ist-Temperatur,
+ *                in half degrees (the telemetry only shows whole degrees).
+ *                The Heizung is only written if its duty changes, a changed
+ *                Heizung value is sent with the next call of
+ *                controlWebhouseValues(). While the Ist-Temperatur is
+ *                invalid or older than CONFIG_HEATER_MAX_SAMPLE_AGE_MS, the
+ *                Heizung is held and the controller does not integrate.
  *
- *  \param[in]    TemperaturSoll Soll-Temperatur
+ *  \param[in]    periods  number of control periods elapsed since the last
+ *                         call
  *
  *  \return       none
  *
  ******************************************************************************/
-int controlWebhouseValues(char * txBuf) {
+void controlHeizung(uint64_t periods) {
+
+	/* Get Ist-Temperatur in half degrees */
+	int32_t TemperaturIst;
+	uint32_t age;
+	int Heizung;
+
+	/* Without a valid and recent Ist-Temperatur the Heizung is held */
+	if ((getTempIstHalfDeg(&TemperaturIst, &age) != BBB_SUCCESS)
+			|| (age > CONFIG_HEATER_MAX_SAMPLE_AGE_MS)) {
+		return;
+	}
+
+	Heizung = stepPid(&heizungPid, 2 * TemperaturSoll, TemperaturIst,
+			(uint32_t) periods);
+
+	/* Only a changed Heizung value is written and sent */
+	if (Heizung != getHeizungState()) {
+		dimHeizung(Heizung);
+		heizungPending = TRUE;
+	}
+}
+
+/*******************************************************************************
+ *  function :    latchWebhouseAlarms
+ ******************************************************************************/
+/** \brief        Drains all alarm events queued by the webhouse in batches
+ *                and latches the alarm
+ *                <p>
+ *                Called instead of controlWebhouseValues() while no client
+ *                receives messages, thus the event queue never overflows and
+ *                the alarm is sent as soon as a client is connected.
+ *
+ *  \return       none
+ *
+ ******************************************************************************/
+void latchWebhouseAlarms(void) {
+	sInputEvent alarmEvents[ALARM_EVENT_BATCH];
+	uint32_t alarmCount, i;
+
+	do {
+		alarmCount = readAlarmEvents(alarmEvents, ALARM_EVENT_BATCH);
+		for (i = 0; i < alarmCount; i++) {
+			INFOPRINT("Alarm #%llu at %llu ms",
+					(unsigned long long) alarmEvents[i].u64Seq,
+					(unsigned long long) (alarmEvents[i].u64StampNs / 1000000));
+			alarmLatched = TRUE;
+		}
+	} while (alarmCount == ALARM_EVENT_BATCH);
+}
+
+/*******************************************************************************
+ *  function :    currentWebhouseValues
+ ******************************************************************************/
+/** \brief        Writes the current values as JSON into txBuf
+ *                <p>
+ *                Sent to a client once its connection is established. The
+ *                message holds the Ist-Temperatur (if there is a valid
+ *                sample), the Heizung and a latched alarm. Nothing is marked
+ *                as sent, the other clients get a latched alarm with the next
+ *                call of controlWebhouseValues().
+ *
+ *  \param[out]   txBuf   transmit buffer
+ *  \param[in]    txSize  size of the transmit buffer
+ *  \param[out]   keys    keys contained in the message (KEY_TEMPIST, ...)
+ *
+ *  \return       length of the message in txBuf, 0 if txBuf is too small
+ *
+ ******************************************************************************/
+int currentWebhouseValues(char * txBuf, int txSize, uint32_t * keys) {
+	int32_t TemperaturIst;
+	boolE isttempflag;
+
+	isttempflag = (getTempIst(&TemperaturIst, NULL) == BBB_SUCCESS) ?
+			TRUE : FALSE;
+	*keys = (isttempflag ? KEY_TEMPIST : 0) | KEY_HEIZUNG
+			| (alarmLatched ? KEY_BURGLAR : 0);
+
+	return transmitAndGetValues(txBuf, txSize, isttempflag, TRUE,
+			alarmLatched);
+}
+
+/*******************************************************************************
+ *  function :    controlWebhouseValues
+ ******************************************************************************/
+/** \brief        Checks which values changed since the last call and writes
+ *                them as JSON into txBuf
+ *                <p>
+ *                Called periodically by the scheduler (every
+ *                CONFIG_TELEMETRY_PERIOD_MS) while clients receive messages,
+ *                the reported values count as sent. All alarm events queued
+ *                since the last call are drained (latchWebhouseAlarms()).
+ *
+ *  \param[out]   txBuf   transmit buffer
+ *  \param[in]    txSize  size of the transmit buffer
+ *  \param[out]   keys    keys contained in the message (KEY_TEMPIST, ...)
+ *
+ *  \return       length of the message in txBuf, 0 if nothing changed
+ *
+ ******************************************************************************/
+int controlWebhouseValues(char * txBuf, int txSize, uint32_t * keys) {
 	static int TemperaturIst_old = 0;
 	int length = 0;
-	static int temp_up_counter = 0;
-	static int temp_down_counter = 0;
 
 	boolE isttempflag = FALSE, heizungflag = FALSE, schrankeflag = FALSE;
 
-	/* Get Ist-Temperatur */
-	char TemperaturIst = getTempIst();
+	/* Get Ist-Temperatur, skipped while there is no valid sample */
+	int32_t TemperaturIst = TemperaturIst_old;
 
-	/* Zweipunkteregelung */
-	if (TemperaturIst < TemperaturSoll) {
-		if (++temp_up_counter >= 100) {
-			dimHeizung(100); /* 100% */
-			heizungflag = TRUE;
-			temp_up_counter = 0;
-		}
-	} else if (TemperaturIst > TemperaturSoll) {
-		if (++temp_down_counter >= 100) {
-			dimHeizung(0); /*   0% */
-			heizungflag = TRUE;
-			temp_down_counter = 0;
-		}
+	if (heizungPending) {
+		heizungflag = TRUE;
+		heizungPending = FALSE;
 	}
 
-	// delay 10ms
-	usleep(10000);
-
-	if (TemperaturIst_old != getTempIst()) {
+	if ((getTempIst(&TemperaturIst, NULL) == BBB_SUCCESS)
+			&& (TemperaturIst_old != TemperaturIst)) {
 		isttempflag = TRUE;
 	}
 
-	if (isAlarmSet()) {
+	latchWebhouseAlarms();
+	if (alarmLatched) {
 		schrankeflag = TRUE;
-		resetAlarm();
+		alarmLatched = FALSE;
 	}
 
-	TemperaturIst_old = getTempIst();
+	TemperaturIst_old = TemperaturIst;
 
 	if (!isttempflag && !heizungflag && !schrankeflag) {
 		length = 0;
+		*keys = 0;
 	} else {
-		printf("\nisttemp=%d solltemp=%d %s %s %s", TemperaturIst,
+		DEBUGPRINT("isttemp=%d solltemp=%d %s %s %s", TemperaturIst,
 				TemperaturSoll, isttempflag ? "isttempflag" : "",
 				heizungflag ? "heizungflag" : "",
 				schrankeflag ? "schrankeflag" : "");
-		length = transmitAndGetValues(txBuf, isttempflag, heizungflag,
-				schrankeflag);
+		length = transmitAndGetValues(txBuf, txSize, isttempflag,
+				heizungflag, schrankeflag);
+		*keys = (isttempflag ? KEY_TEMPIST : 0) | (heizungflag ? KEY_HEIZUNG : 0)
+				| (schrankeflag ? KEY_BURGLAR : 0);
 	}
 
 	return length;
@@ -20,9 +20,17 @@
 #define MODE_LICHT 3 /* Only send Lichtschranke value                         */
 #define MODE_ALL   4 /* Send Ist-Temperatur, Heizung und Lichtschranke values */
 
+/* Keys of a transmitted message (see sendLatestTCP()) */
+#define KEY_TEMPIST 0x01 /* Ist-Temperatur                                    */
+#define KEY_HEIZUNG 0x02 /* Heizung                                           */
+#define KEY_BURGLAR 0x04 /* Lichtschranke                                     */
+
 //----- Function prototypes ----------------------------------------------------
 extern void receiveAndSetValues(char * rxBuf, int rx_data_len);
-extern int transmitAndGetValues(char * txBuf, boolE isttempflag, boolE heizungflag, boolE schrankeflag);
-extern int controlWebhouseValues(char * txBuf);
+extern int transmitAndGetValues(char * txBuf, int txSize, boolE isttempflag, boolE heizungflag, boolE schrankeflag);
+extern void controlHeizung(uint64_t periods);
+extern void latchWebhouseAlarms(void);
+extern int currentWebhouseValues(char * txBuf, int txSize, uint32_t * keys);
+extern int controlWebhouseValues(char * txBuf, int txSize, uint32_t * keys);
 
 #endif /* RXTXJSON_H_ */
@@ -0,0 +1,539 @@
+/******************************************************************************/
+/** \file       WebSocket.c
+ *******************************************************************************
+ *
+ *  \brief      WebSocket protocol (RFC 6455) helpers of the beaglebone black
+ *              webhouse.
+ *              <p>
+ *              The module implements the opening handshake (HTTP upgrade
+ *              including subprotocol negotiation), the decoding of client
+ *              frames and the encoding of server frame headers. It works on
+ *              plain buffers only, the socket handling is done by the
+ *              TCPServer module.
+ *              <p>
+ *              The SHA-1 digest needed for the Sec-WebSocket-Accept header
+ *              is implemented within this module, thus no crypto library is
+ *              needed on the target.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              isWsHandshake
+ *              parseWsHandshake
+ *              parseWsFrame
+ *              composeWsHeader
+ *  functions  local:
+ *              findHeaderValue
+ *              hasToken
+ *              sha1
+ *              sha1Block
+ *              base64
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "WebSocket.h"
+#include "BBBConfig.h"
+#define LOG_MODULE  NET
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+#define WS_GUID              "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_MAX_KEY           ( 64 )
+#define WS_SHA1_LEN          ( 20 )
+
+#define ROL32(x, n)          ( ((x) << (n)) | ((x) >> (32 - (n))) )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+static const char * findHeaderValue(const char * pcHeaders,
+                                    const char * pcName,
+                                    uint32_t * pu32Len);
+static boolE hasToken(const char * pcValue, uint32_t u32Len,
+                      const char * pcToken);
+static void sha1(const uint8_t * pu8Data, uint32_t u32Len, uint8_t * pu8Digest);
+static void sha1Block(uint32_t * pu32State, const uint8_t * pu8Block);
+static uint32_t base64(const uint8_t * pu8Data, uint32_t u32Len, char * pcOut);
+
+//----- Data -------------------------------------------------------------------
+static const char acBase64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const char acBadRequest[] =
+        "HTTP/1.1 400 Bad Request\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+
+static const char acUpgradeRequired[] =
+        "HTTP/1.1 426 Upgrade Required\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    isWsHandshake
+ ******************************************************************************/
+/** \brief        Checks if the received data is (the beginning of) a HTTP GET
+ *                request and thus an opening handshake.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcData     received data
+ *  \param[in]    u32Length  number of received bytes
+ *
+ *  \return       TRUE if the data is or may become a GET request
+ *
+ ******************************************************************************/
+boolE isWsHandshake(const char * pcData, uint32_t u32Length) {
+
+    if(u32Length > 4) {
+        u32Length = 4;
+    }
+
+    return ((strncmp(pcData, "GET ", u32Length) == 0) ? TRUE : FALSE);
+}
+
+/*******************************************************************************
+ *  function :    parseWsHandshake
+ ******************************************************************************/
+/** \brief        Parses the opening handshake of a client and composes the
+ *                response.
+ *                <p>
+ *                The request must be '\0' terminated. If the client offers
+ *                the subprotocol CONFIG_WEBSOCKET_PROTOCOL, it is selected.
+ *                If the request is invalid, the response contains the HTTP
+ *                error which shall be sent before the connection is closed.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcRequest        received data ('\0' terminated)
+ *  \param[in]    u32Length        number of received bytes
+ *  \param[out]   pu32RequestLen   length of the request incl. empty line
+ *  \param[out]   pcResponse       buffer for the response
+ *  \param[in]    u32ResponseSize  size of pcResponse
+ *  \param[out]   pu32ResponseLen  length of the response
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        handshake complete, send response
+ *                BBB_WS_INCOMPLETE  request not yet complete
+ *                BBB_WS_HANDSHAKE   invalid request, send response and close
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError parseWsHandshake(char * pcRequest,
+                          uint32_t u32Length,
+                          uint32_t * pu32RequestLen,
+                          char * pcResponse,
+                          uint32_t u32ResponseSize,
+                          uint32_t * pu32ResponseLen) {
+
+    const char * pcEnd;
+    const char * pcValue;
+    uint32_t     u32ValueLen;
+    char         acKey[WS_MAX_KEY + sizeof(WS_GUID)];
+    uint8_t      au8Digest[WS_SHA1_LEN];
+    char         acAccept[32];
+    boolE        bProtocol = FALSE;
+    int          s32Len;
+
+    pcEnd = strstr(pcRequest, "\r\n\r\n");
+    if(pcEnd == NULL) {
+        return (BBB_WS_INCOMPLETE);
+    }
+    *pu32RequestLen = (uint32_t) (pcEnd - pcRequest) + 4;
+
+    /* Defaults to the error response */
+    strcpy(pcResponse, acBadRequest);
+    *pu32ResponseLen = sizeof(acBadRequest) - 1;
+
+    if(strncmp(pcRequest, "GET ", 4) != 0) {
+        return (BBB_WS_HANDSHAKE);
+    }
+
+    pcValue = findHeaderValue(pcRequest, "Upgrade", &u32ValueLen);
+    if((pcValue == NULL) || !hasToken(pcValue, u32ValueLen, "websocket")) {
+        DEBUGPRINT("no websocket upgrade request");
+        return (BBB_WS_HANDSHAKE);
+    }
+
+    pcValue = findHeaderValue(pcRequest, "Sec-WebSocket-Version", &u32ValueLen);
+    if((pcValue == NULL) || (u32ValueLen != 2)
+        || (strncmp(pcValue, "13", 2) != 0)) {
+        strcpy(pcResponse, acUpgradeRequired);
+        *pu32ResponseLen = sizeof(acUpgradeRequired) - 1;
+        return (BBB_WS_HANDSHAKE);
+    }
+
+    pcValue = findHeaderValue(pcRequest, "Sec-WebSocket-Key", &u32ValueLen);
+    if((pcValue == NULL) || (u32ValueLen == 0) || (u32ValueLen > WS_MAX_KEY)) {
+        return (BBB_WS_HANDSHAKE);
+    }
+    memcpy(acKey, pcValue, u32ValueLen);
+    memcpy(&acKey[u32ValueLen], WS_GUID, sizeof(WS_GUID) - 1);
+    sha1((uint8_t *) acKey, u32ValueLen + sizeof(WS_GUID) - 1, au8Digest);
+    acAccept[base64(au8Digest, WS_SHA1_LEN, acAccept)] = '\0';
+
+    pcValue = findHeaderValue(pcRequest, "Sec-WebSocket-Protocol",
+                              &u32ValueLen);
+    if(pcValue != NULL) {
+        bProtocol = hasToken(pcValue, u32ValueLen, CONFIG_WEBSOCKET_PROTOCOL);
+    }
+
+    s32Len = snprintf(pcResponse, u32ResponseSize,
+                      "HTTP/1.1 101 Switching Protocols\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: %s\r\n"
+                      "%s"
+                      "\r\n",
+                      acAccept,
+                      bProtocol ? "Sec-WebSocket-Protocol: "
+                                  CONFIG_WEBSOCKET_PROTOCOL "\r\n" : "");
+
+    if((s32Len < 0) || ((uint32_t) s32Len >= u32ResponseSize)) {
+        ERRORPRINT("response buffer too small");
+        strcpy(pcResponse, acBadRequest);
+        *pu32ResponseLen = sizeof(acBadRequest) - 1;
+        return (BBB_WS_HANDSHAKE);
+    }
+    *pu32ResponseLen = (uint32_t) s32Len;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    parseWsFrame
+ ******************************************************************************/
+/** \brief        Decodes the frame at the beginning of the buffer.
+ *                <p>
+ *                If the frame is complete, the payload is unmasked in place.
+ *                Client frames must be masked, control frames must not be
+ *                fragmented and their payload must not exceed
+ *                WS_MAX_CONTROL_PAYLOAD bytes.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pu8Buf         received data
+ *  \param[in]    u32Length      number of received bytes
+ *  \param[in]    u32MaxPayload  largest payload the caller can handle
+ *  \param[out]   psFrame        decoded frame header
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        complete frame, payload unmasked
+ *                BBB_WS_INCOMPLETE  frame not yet complete
+ *                BBB_WS_PROTOCOL    protocol violation (close with 1002)
+ *                BBB_WS_TOO_BIG     payload too big (close with 1009)
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError parseWsFrame(uint8_t * pu8Buf,
+                      uint32_t u32Length,
+                      uint32_t u32MaxPayload,
+                      sWsFrame * psFrame) {
+
+    uint64_t  u64PayloadLen;
+    uint32_t  u32HeaderLen = 2;
+    uint8_t * pu8Mask;
+    uint8_t * pu8Payload;
+    uint32_t  i;
+
+    if(u32Length < 2) {
+        return (BBB_WS_INCOMPLETE);
+    }
+
+    psFrame->bFin = ((pu8Buf[0] & 0x80) != 0) ? TRUE : FALSE;
+    psFrame->eOpcode = (eWsOpcode) (pu8Buf[0] & 0x0f);
+
+    /* No extension is negotiated, thus RSV1-3 must be zero. Clients must */
+    /* mask their frames.                                                 */
+    if(((pu8Buf[0] & 0x70) != 0) || ((pu8Buf[1] & 0x80) == 0)) {
+        return (BBB_WS_PROTOCOL);
+    }
+
+    u64PayloadLen = pu8Buf[1] & 0x7f;
+    if(u64PayloadLen == 126) {
+        u32HeaderLen += 2;
+        if(u32Length < u32HeaderLen) {
+            return (BBB_WS_INCOMPLETE);
+        }
+        u64PayloadLen = ((uint64_t) pu8Buf[2] << 8) | pu8Buf[3];
+    } else if(u64PayloadLen == 127) {
+        u32HeaderLen += 8;
+        if(u32Length < u32HeaderLen) {
+            return (BBB_WS_INCOMPLETE);
+        }
+        u64PayloadLen = 0;
+        for(i = 2; i < 10; i++) {
+            u64PayloadLen = (u64PayloadLen << 8) | pu8Buf[i];
+        }
+    }
+
+    if((psFrame->eOpcode & 0x08) != 0) {
+        if((psFrame->bFin == FALSE)
+            || (u64PayloadLen > WS_MAX_CONTROL_PAYLOAD)) {
+            return (BBB_WS_PROTOCOL);
+        }
+    } else if(psFrame->eOpcode > WS_OP_BINARY) {
+        return (BBB_WS_PROTOCOL);
+    }
+
+    if(u64PayloadLen > u32MaxPayload) {
+        return (BBB_WS_TOO_BIG);
+    }
+
+    pu8Mask = &pu8Buf[u32HeaderLen];
+    u32HeaderLen += 4;
+
+    if(u32Length < (u32HeaderLen + u64PayloadLen)) {
+        return (BBB_WS_INCOMPLETE);
+    }
+
+    psFrame->u32HeaderLen = u32HeaderLen;
+    psFrame->u32PayloadLen = (uint32_t) u64PayloadLen;
+
+    pu8Payload = &pu8Buf[u32HeaderLen];
+    for(i = 0; i < psFrame->u32PayloadLen; i++) {
+        pu8Payload[i] ^= pu8Mask[i & 3];
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    composeWsHeader
+ ******************************************************************************/
+/** \brief        Composes the header of an unfragmented, unmasked server
+ *                frame.
+ *
+ *  \type         global
+ *
+ *  \param[out]   pu8Header      buffer of at least WS_MAX_HEADER bytes
+ *  \param[in]    eOpcode        opcode of the frame
+ *  \param[in]    u32PayloadLen  length of the payload (< 64k)
+ *
+ *  \return       length of the header
+ *
+ ******************************************************************************/
+uint32_t composeWsHeader(uint8_t * pu8Header,
+                         eWsOpcode eOpcode,
+                         uint32_t u32PayloadLen) {
+
+    uint32_t u32HeaderLen = 2;
+
+    pu8Header[0] = 0x80 | (uint8_t) eOpcode;
+
+    if(u32PayloadLen < 126) {
+        pu8Header[1] = (uint8_t) u32PayloadLen;
+    } else {
+        pu8Header[1] = 126;
+        pu8Header[2] = (uint8_t) (u32PayloadLen >> 8);
+        pu8Header[3] = (uint8_t) u32PayloadLen;
+        u32HeaderLen += 2;
+    }
+
+    return (u32HeaderLen);
+}
+
+/*******************************************************************************
+ *  function :    findHeaderValue
+ ******************************************************************************/
+static const char * findHeaderValue(const char * pcHeaders,
+                                    const char * pcName,
+                                    uint32_t * pu32Len) {
+
+    const char * pcLine = strstr(pcHeaders, "\r\n");
+    const char * pcValue;
+    const char * pcEol;
+    size_t       nameLen = strlen(pcName);
+
+    while((pcLine != NULL) && (pcLine[2] != '\r')) {
+
+        pcLine += 2;
+        pcEol = strstr(pcLine, "\r\n");
+        if(pcEol == NULL) {
+            break;
+        }
+
+        if((strncasecmp(pcLine, pcName, nameLen) == 0)
+            && (pcLine[nameLen] == ':')) {
+
+            pcValue = &pcLine[nameLen + 1];
+            while((pcValue < pcEol) && ((*pcValue == ' ') || (*pcValue == '\t'))) {
+                pcValue++;
+            }
+            while((pcEol > pcValue)
+                  && ((pcEol[-1] == ' ') || (pcEol[-1] == '\t'))) {
+                pcEol--;
+            }
+            *pu32Len = (uint32_t) (pcEol - pcValue);
+            return (pcValue);
+        }
+        pcLine = pcEol;
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    hasToken
+ ******************************************************************************/
+static boolE hasToken(const char * pcValue, uint32_t u32Len,
+                      const char * pcToken) {
+
+    size_t      tokenLen = strlen(pcToken);
+    const char *pcEnd = pcValue + u32Len;
+    const char *pcStart;
+
+    /* Comma separated list, e.g. "chat, webhuesli-protocol" */
+    while(pcValue < pcEnd) {
+
+        while((pcValue < pcEnd) && ((*pcValue == ' ') || (*pcValue == ','))) {
+            pcValue++;
+        }
+        pcStart = pcValue;
+        while((pcValue < pcEnd) && (*pcValue != ',') && (*pcValue != ' ')) {
+            pcValue++;
+        }
+        if((((size_t) (pcValue - pcStart)) == tokenLen)
+            && (strncasecmp(pcStart, pcToken, tokenLen) == 0)) {
+            return (TRUE);
+        }
+    }
+
+    return (FALSE);
+}
+
+/*******************************************************************************
+ *  function :    sha1
+ ******************************************************************************/
+static void sha1(const uint8_t * pu8Data, uint32_t u32Len, uint8_t * pu8Digest) {
+
+    uint32_t au32State[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE,
+                              0x10325476, 0xC3D2E1F0 };
+    uint8_t  au8Block[64];
+    uint64_t u64Bits = (uint64_t) u32Len * 8;
+    uint32_t u32Rest;
+    uint32_t i;
+
+    while(u32Len >= 64) {
+        sha1Block(au32State, pu8Data);
+        pu8Data += 64;
+        u32Len -= 64;
+    }
+
+    /* Padding: 0x80, zeros and the message length in bits (big endian) */
+    memset(au8Block, 0, sizeof(au8Block));
+    memcpy(au8Block, pu8Data, u32Len);
+    au8Block[u32Len] = 0x80;
+    u32Rest = u32Len + 1;
+    if(u32Rest > 56) {
+        sha1Block(au32State, au8Block);
+        memset(au8Block, 0, sizeof(au8Block));
+    }
+    for(i = 0; i < 8; i++) {
+        au8Block[63 - i] = (uint8_t) (u64Bits >> (8 * i));
+    }
+    sha1Block(au32State, au8Block);
+
+    for(i = 0; i < WS_SHA1_LEN; i++) {
+        pu8Digest[i] = (uint8_t) (au32State[i >> 2] >> (24 - 8 * (i & 3)));
+    }
+}
+
+/*******************************************************************************
+ *  function :    sha1Block
+ ******************************************************************************/
+static void sha1Block(uint32_t * pu32State, const uint8_t * pu8Block) {
+
+    uint32_t au32W[80];
+    uint32_t a, b, c, d, e, f, k, temp;
+    uint32_t i;
+
+    for(i = 0; i < 16; i++) {
+        au32W[i] = ((uint32_t) pu8Block[4 * i] << 24)
+                   | ((uint32_t) pu8Block[4 * i + 1] << 16)
+                   | ((uint32_t) pu8Block[4 * i + 2] << 8)
+                   | ((uint32_t) pu8Block[4 * i + 3]);
+    }
+    for(i = 16; i < 80; i++) {
+        au32W[i] = ROL32(au32W[i - 3] ^ au32W[i - 8]
+                         ^ au32W[i - 14] ^ au32W[i - 16], 1);
+    }
+
+    a = pu32State[0];
+    b = pu32State[1];
+    c = pu32State[2];
+    d = pu32State[3];
+    e = pu32State[4];
+
+    for(i = 0; i < 80; i++) {
+        if(i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if(i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if(i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        temp = ROL32(a, 5) + f + e + k + au32W[i];
+        e = d;
+        d = c;
+        c = ROL32(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    pu32State[0] += a;
+    pu32State[1] += b;
+    pu32State[2] += c;
+    pu32State[3] += d;
+    pu32State[4] += e;
+}
+
+/*******************************************************************************
+ *  function :    base64
+ ******************************************************************************/
+static uint32_t base64(const uint8_t * pu8Data, uint32_t u32Len, char * pcOut) {
+
+    uint32_t u32Out = 0;
+    uint32_t u32Triple;
+    uint32_t i;
+
+    for(i = 0; i < u32Len; i += 3) {
+
+        u32Triple = (uint32_t) pu8Data[i] << 16;
+        if((i + 1) < u32Len) {
+            u32Triple |= (uint32_t) pu8Data[i + 1] << 8;
+        }
+        if((i + 2) < u32Len) {
+            u32Triple |= pu8Data[i + 2];
+        }
+
+        pcOut[u32Out++] = acBase64[(u32Triple >> 18) & 0x3f];
+        pcOut[u32Out++] = acBase64[(u32Triple >> 12) & 0x3f];
+        pcOut[u32Out++] = ((i + 1) < u32Len) ?
+                          acBase64[(u32Triple >> 6) & 0x3f] : '=';
+        pcOut[u32Out++] = ((i + 2) < u32Len) ? acBase64[u32Triple & 0x3f] : '=';
+    }
+
+    return (u32Out);
+}
@@ -0,0 +1,106 @@
+#ifndef WEBSOCKET_H_
+#define WEBSOCKET_H_
+/******************************************************************************/
+/** \file       WebSocket.h
+ *******************************************************************************
+ *
+ *  \brief      WebSocket protocol (RFC 6455) helpers of the beaglebone black
+ *              webhouse.
+ *              <p>
+ *              The module implements the opening handshake (HTTP upgrade
+ *              including subprotocol negotiation), the decoding of client
+ *              frames and the encoding of server frame headers. It works on
+ *              plain buffers only, the socket handling is done by the
+ *              TCPServer module.
+ *              <p>
+ *              Example of decoding all complete frames within a buffer:
+ *              <pre>
+ *              sWsFrame sFrame;
+ *
+ *              while(parseWsFrame(pu8Buf, u32Len, &sFrame) == BBB_SUCCESS) {
+ *                  // payload (already unmasked) starts at
+ *                  // pu8Buf + sFrame.u32HeaderLen
+ *                  pu8Buf += sFrame.u32HeaderLen + sFrame.u32PayloadLen;
+ *                  u32Len -= sFrame.u32HeaderLen + sFrame.u32PayloadLen;
+ *              }
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    isWsHandshake
+ *              parseWsHandshake
+ *              parseWsFrame
+ *              composeWsHeader
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Maximum size of a server frame header (payload length < 64k)              */
+#define WS_MAX_HEADER           ( 4 )
+/** Maximum payload of a control frame (close, ping, pong)                    */
+#define WS_MAX_CONTROL_PAYLOAD  ( 125 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Frame opcodes */
+typedef enum _eWsOpcode {
+
+    WS_OP_CONTINUATION = 0x0,  ///< continuation of a fragmented message
+    WS_OP_TEXT         = 0x1,  ///< text message
+    WS_OP_BINARY       = 0x2,  ///< binary message
+    WS_OP_CLOSE        = 0x8,  ///< close the connection
+    WS_OP_PING         = 0x9,  ///< ping, must be answered with a pong
+    WS_OP_PONG         = 0xA   ///< pong
+
+} eWsOpcode;
+
+/** Status codes of a close frame */
+typedef enum _eWsCloseCode {
+
+    WS_CLOSE_NORMAL      = 1000,  ///< normal closure
+    WS_CLOSE_GOING_AWAY  = 1001,  ///< server shuts down
+    WS_CLOSE_PROTOCOL    = 1002,  ///< protocol error
+    WS_CLOSE_UNSUPPORTED = 1003,  ///< unsupported data
+    WS_CLOSE_TOO_BIG     = 1009   ///< message too big
+
+} eWsCloseCode;
+
+/** Decoded header of a client frame */
+typedef struct _sWsFrame {
+
+    boolE     bFin;           ///< TRUE if this is the final fragment
+    eWsOpcode eOpcode;        ///< opcode of the frame
+    uint32_t  u32HeaderLen;   ///< length of the header (incl. masking key)
+    uint32_t  u32PayloadLen;  ///< length of the payload
+
+} sWsFrame;
+
+//----- Function prototypes ----------------------------------------------------
+extern boolE    isWsHandshake(const char * pcData, uint32_t u32Length);
+
+extern BBBError parseWsHandshake(char * pcRequest,
+                                 uint32_t u32Length,
+                                 uint32_t * pu32RequestLen,
+                                 char * pcResponse,
+                                 uint32_t u32ResponseSize,
+                                 uint32_t * pu32ResponseLen);
+
+extern BBBError parseWsFrame(uint8_t * pu8Buf,
+                             uint32_t u32Length,
+                             uint32_t u32MaxPayload,
+                             sWsFrame * psFrame);
+
+extern uint32_t composeWsHeader(uint8_t * pu8Header,
+                                eWsOpcode eOpcode,
+                                uint32_t u32PayloadLen);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* WEBSOCKET_H_ */
@@ -0,0 +1,446 @@
+/******************************************************************************/
+/** \file       Fade.c
+ *******************************************************************************
+ *
+ *  \brief      Fade engine, ramps dim levels to a target within a given time.
+ *              <p>
+ *              The ramps are kept under mutexFade. The fade thread computes
+ *              the levels of all channels under the lock, but calls the write
+ *              function without it, thus setFadeTarget() never waits for the
+ *              hardware.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              startFade
+ *              stopFade
+ *              setFadeTarget
+ *              getFadeTarget
+ *              isFading
+ *  functions  local:
+ *              getNowNs
+ *              getLevel
+ *              stepRamps
+ *              fadeThread
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <pthread.h>
+#include <time.h>
+
+#include "Fade.h"
+#define LOG_MODULE  HW
+#include "Log.h"
+#include "BBBSignal.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+/** Ramp of a channel */
+typedef struct _sFadeRamp {
+
+    boolE    bActive;     ///< TRUE while the ramp is running
+    int32_t  s32From;     ///< level at the start of the ramp
+    int32_t  s32Target;   ///< level at the end of the ramp
+    int32_t  s32Level;    ///< level last written
+    uint64_t u64StartNs;  ///< start of the ramp (CLOCK_MONOTONIC)
+    uint64_t u64RampNs;   ///< duration of the ramp
+
+} sFadeRamp;
+
+//----- Function prototypes ----------------------------------------------------
+static uint64_t getNowNs(void);
+static int32_t  getLevel(const sFadeRamp * psRamp, uint64_t u64Now);
+static uint32_t stepRamps(uint64_t u64Now,
+                          uint32_t * au32Channel,
+                          int32_t * as32Level);
+static void *   fadeThread(void * pvData);
+
+//----- Data -------------------------------------------------------------------
+static pthread_t       idFade;
+/** TRUE while the fade thread exists                                         */
+static boolE           fadeStarted = FALSE;
+/** Set by stopFade() to end the thread                                       */
+static boolE           bStop = FALSE;
+/** Update period [ns]                                                        */
+static uint64_t        u64PeriodNs = 0;
+static pfFadeWrite     pfFadeWriteLevel = NULL;
+static void *          pvFadeData = NULL;
+/** Number of running ramps                                                   */
+static uint32_t        u32Active = 0;
+static sFadeRamp       asRamp[FADE_MAX_CHANNELS];
+/** Guards all data above, condFade is signaled when a ramp is started        */
+static pthread_mutex_t mutexFade = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  condFade = PTHREAD_COND_INITIALIZER;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    startFade
+ ******************************************************************************/
+/** \brief        Starts the fade thread
+ *                <p>
+ *                All channels start at level 0.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32PeriodMs  update period of the levels [ms]
+ *  \param[in]    pfWrite      writes the level of a channel
+ *  \param[in]    pvData       passed to pfWrite
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_ERR_PARAM      invalid period or write function
+ *                BBB_THREAD_RUNNING the fade thread is already running
+ *                BBB_THREAD_CREATE  the thread could not be created
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError startFade(uint32_t u32PeriodMs, pfFadeWrite pfWrite, void * pvData) {
+
+    uint32_t i;
+
+    if(fadeStarted == TRUE) {
+        return (BBB_THREAD_RUNNING);
+    }
+    if((u32PeriodMs == 0) || (pfWrite == NULL)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexFade);
+    for(i = 0; i < FADE_MAX_CHANNELS; i++) {
+        asRamp[i].bActive = FALSE;
+        asRamp[i].s32From = 0;
+        asRamp[i].s32Target = 0;
+        asRamp[i].s32Level = 0;
+    }
+    u32Active = 0;
+    bStop = FALSE;
+    u64PeriodNs = (uint64_t) u32PeriodMs * 1000000ULL;
+    pfFadeWriteLevel = pfWrite;
+    pvFadeData = pvData;
+    pthread_mutex_unlock(&mutexFade);
+
+    if(pthread_create(&idFade, NULL, fadeThread, NULL) != 0) {
+        ERRORPRINT("can't create thread");
+        return (BBB_THREAD_CREATE);
+    }
+    fadeStarted = TRUE;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    stopFade
+ ******************************************************************************/
+/** \brief        Stops the fade thread
+ *                <p>
+ *                Running ramps are abandoned at the level reached so far. The
+ *                write function is not called anymore after this function
+ *                returned.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_THREAD_RUNNING the fade thread is not running
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError stopFade(void) {
+
+    if(fadeStarted == FALSE) {
+        return (BBB_THREAD_RUNNING);
+    }
+
+    pthread_mutex_lock(&mutexFade);
+    bStop = TRUE;
+    pthread_cond_signal(&condFade);
+    pthread_mutex_unlock(&mutexFade);
+
+    pthread_join(idFade, NULL);
+    fadeStarted = FALSE;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    setFadeTarget
+ ******************************************************************************/
+/** \brief        Ramps a channel to a new level
+ *                <p>
+ *                Returns immediately. The ramp starts at the current level of
+ *                the channel, a running ramp is replaced. With u32RampMs 0 the
+ *                target is written within the next period.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Channel   channel [0,FADE_MAX_CHANNELS[
+ *  \param[in]    s32Target    level at the end of the ramp
+ *  \param[in]    u32RampMs    duration of the ramp [ms]
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_ERR_PARAM      invalid channel
+ *                BBB_THREAD_RUNNING the fade thread is not running
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError setFadeTarget(uint32_t u32Channel,
+                       int32_t s32Target,
+                       uint32_t u32RampMs) {
+
+    sFadeRamp * psRamp;
+    uint64_t    u64Now;
+
+    if(u32Channel >= FADE_MAX_CHANNELS) {
+        return (BBB_ERR_PARAM);
+    }
+    if(fadeStarted == FALSE) {
+        return (BBB_THREAD_RUNNING);
+    }
+
+    u64Now = getNowNs();
+
+    pthread_mutex_lock(&mutexFade);
+    psRamp = &asRamp[u32Channel];
+    /* The slider repeats values, these must not restart the ramp */
+    if(((psRamp->bActive == TRUE) && (psRamp->s32Target != s32Target)) ||
+       ((psRamp->bActive == FALSE) && (psRamp->s32Level != s32Target))) {
+
+        psRamp->s32From = getLevel(psRamp, u64Now);
+        psRamp->s32Target = s32Target;
+        psRamp->u64StartNs = u64Now;
+        psRamp->u64RampNs = (uint64_t) u32RampMs * 1000000ULL;
+        if(psRamp->bActive == FALSE) {
+            psRamp->bActive = TRUE;
+            u32Active++;
+            pthread_cond_signal(&condFade);
+        }
+    }
+    pthread_mutex_unlock(&mutexFade);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    getFadeTarget
+ ******************************************************************************/
+/** \brief        Returns the level a channel is ramped to
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Channel   channel [0,FADE_MAX_CHANNELS[
+ *
+ *  \return       target of the channel, 0 for an invalid channel
+ *
+ ******************************************************************************/
+int32_t getFadeTarget(uint32_t u32Channel) {
+
+    int32_t s32Target;
+
+    if(u32Channel >= FADE_MAX_CHANNELS) {
+        return (0);
+    }
+
+    pthread_mutex_lock(&mutexFade);
+    s32Target = asRamp[u32Channel].s32Target;
+    pthread_mutex_unlock(&mutexFade);
+
+    return (s32Target);
+}
+
+/*******************************************************************************
+ *  function :    isFading
+ ******************************************************************************/
+/** \brief        Returns if the ramp of a channel is still running
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Channel   channel [0,FADE_MAX_CHANNELS[
+ *
+ *  \return       TRUE until the target was written, FALSE otherwise
+ *
+ ******************************************************************************/
+boolE isFading(uint32_t u32Channel) {
+
+    boolE bActive;
+
+    if(u32Channel >= FADE_MAX_CHANNELS) {
+        return (FALSE);
+    }
+
+    pthread_mutex_lock(&mutexFade);
+    bActive = asRamp[u32Channel].bActive;
+    pthread_mutex_unlock(&mutexFade);
+
+    return (bActive);
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return ((uint64_t) sNow.tv_sec * 1000000000ULL + (uint64_t) sNow.tv_nsec);
+}
+
+/*******************************************************************************
+ *  function :    getLevel
+ ******************************************************************************/
+/** \brief        Interpolates the level of a ramp
+ *
+ *  \type         static
+ *
+ *  \param[in]    psRamp   ramp of the channel
+ *  \param[in]    u64Now   point in time (CLOCK_MONOTONIC) [ns]
+ *
+ *  \return       level at u64Now
+ *
+ ******************************************************************************/
+static int32_t getLevel(const sFadeRamp * psRamp, uint64_t u64Now) {
+
+    uint64_t u64Elapsed;
+
+    if(psRamp->bActive == FALSE) {
+        return (psRamp->s32Level);
+    }
+
+    u64Elapsed = u64Now - psRamp->u64StartNs;
+    if(u64Elapsed >= psRamp->u64RampNs) {
+        return (psRamp->s32Target);
+    }
+
+    return (psRamp->s32From +
+            (int32_t) (((int64_t) (psRamp->s32Target - psRamp->s32From) *
+                        (int64_t) u64Elapsed) / (int64_t) psRamp->u64RampNs));
+}
+
+/*******************************************************************************
+ *  function :    stepRamps
+ ******************************************************************************/
+/** \brief        Advances all running ramps, must be called with mutexFade
+ *                locked
+ *
+ *  \type         static
+ *
+ *  \param[in]    u64Now        point in time (CLOCK_MONOTONIC) [ns]
+ *  \param[out]   au32Channel   channels whose level changed
+ *  \param[out]   as32Level     new level of these channels
+ *
+ *  \return       number of changed channels
+ *
+ ******************************************************************************/
+static uint32_t stepRamps(uint64_t u64Now,
+                          uint32_t * au32Channel,
+                          int32_t * as32Level) {
+
+    uint32_t u32Changed = 0;
+    int32_t  s32Level;
+    uint32_t i;
+
+    for(i = 0; i < FADE_MAX_CHANNELS; i++) {
+
+        if(asRamp[i].bActive == FALSE) {
+            continue;
+        }
+
+        s32Level = getLevel(&asRamp[i], u64Now);
+        if(s32Level != asRamp[i].s32Level) {
+            asRamp[i].s32Level = s32Level;
+            au32Channel[u32Changed] = i;
+            as32Level[u32Changed] = s32Level;
+            u32Changed++;
+        }
+        if((u64Now - asRamp[i].u64StartNs) >= asRamp[i].u64RampNs) {
+            asRamp[i].bActive = FALSE;
+            u32Active--;
+        }
+    }
+
+    return (u32Changed);
+}
+
+/*******************************************************************************
+ *  function :    fadeThread
+ ******************************************************************************/
+/** \brief        Writes the levels of all running ramps every period
+ *                <p>
+ *                The thread sleeps until absolute points in time, thus the
+ *                duration of the writes does not add up. A period missed (e.g.
+ *                while idle) is not caught up, the next one starts at the
+ *                time of the writes. Thus a channel is written at most once
+ *                per period. The thread is stopped by stopFade().
+ *
+ *  \type         static
+ *
+ *  \param[in]    pvData  not used
+ *
+ *  \return       not used
+ *
+ ******************************************************************************/
+static void * fadeThread(void * pvData) {
+
+    struct timespec sNext;
+    uint32_t        au32Channel[FADE_MAX_CHANNELS];
+    int32_t         as32Level[FADE_MAX_CHANNELS];
+    uint32_t        u32Changed;
+    uint64_t        u64Now;
+    uint64_t        u64Next;
+    uint32_t        i;
+
+    /* Block all signals for this thread */
+    blockAllSignalForThread();
+
+    u64Next = getNowNs();
+
+    pthread_mutex_lock(&mutexFade);
+    while(bStop == FALSE) {
+
+        if(u32Active == 0) {
+            pthread_cond_wait(&condFade, &mutexFade);
+            continue;
+        }
+        pthread_mutex_unlock(&mutexFade);
+
+        sNext.tv_sec = (time_t) (u64Next / 1000000000ULL);
+        sNext.tv_nsec = (long) (u64Next % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sNext, NULL);
+
+        pthread_mutex_lock(&mutexFade);
+        u64Now = getNowNs();
+        u32Changed = stepRamps(u64Now, au32Channel, as32Level);
+        pthread_mutex_unlock(&mutexFade);
+
+        for(i = 0; i < u32Changed; i++) {
+            if(pfFadeWriteLevel(au32Channel[i], as32Level[i], pvFadeData)
+                    != BBB_SUCCESS) {
+                WARNINGPRINT("fade channel %d: level %d not written",
+                             au32Channel[i], as32Level[i]);
+            }
+        }
+
+        u64Next += u64PeriodNs;
+        if(u64Next <= u64Now) {
+            u64Next = u64Now + u64PeriodNs;
+        }
+
+        pthread_mutex_lock(&mutexFade);
+    }
+    pthread_mutex_unlock(&mutexFade);
+
+    pthread_exit(NULL);
+}
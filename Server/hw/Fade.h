@@ -0,0 +1,68 @@
+#ifndef FADE_H_
+#define FADE_H_
+/******************************************************************************/
+/** \file       Fade.h
+ *******************************************************************************
+ *
+ *  \brief      Fade engine, ramps dim levels to a target within a given time.
+ *              <p>
+ *              setFadeTarget() only stores the target of a channel and returns
+ *              immediately. The fade thread interpolates all running ramps
+ *              every period (absolute CLOCK_MONOTONIC deadlines) and passes
+ *              the new levels to the write function given to startFade(). A
+ *              new target overrides the running ramp of its channel, the new
+ *              ramp starts at the level reached so far. Thus a channel is
+ *              written at most once per period, no matter how often its
+ *              target changes. Without any running ramp the thread sleeps on
+ *              a condition variable.
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              startFade(20, writeLevel, NULL);
+ *              setFadeTarget(0, 100, 500);   // channel 0 to 100 in 500ms
+ *              setFadeTarget(0, 30, 500);    // turns around, from where it is
+ *              stopFade();
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    startFade
+ *              stopFade
+ *              setFadeTarget
+ *              getFadeTarget
+ *              isFading
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of channels                                                        */
+#define FADE_MAX_CHANNELS      ( 8 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Writes the level of a channel, called by the fade thread                  */
+typedef BBBError (*pfFadeWrite)(uint32_t u32Channel,
+                                int32_t s32Level,
+                                void * pvData);
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError startFade(uint32_t u32PeriodMs,
+                          pfFadeWrite pfWrite,
+                          void * pvData);
+extern BBBError stopFade(void);
+extern BBBError setFadeTarget(uint32_t u32Channel,
+                              int32_t s32Target,
+                              uint32_t u32RampMs);
+extern int32_t  getFadeTarget(uint32_t u32Channel);
+extern boolE    isFading(uint32_t u32Channel);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* FADE_H_ */
@@ -9,6 +9,14 @@
  *              of a gpio. If the gpio is an input pin, it can be polled on
  *              any edge event.
  *              <p>
+ *              The value file of a gpio is opened once when the gpio is
+ *              exported and kept open until it is unexported. Setting or
+ *              getting the value is a single pwrite(2)/pread(2) at offset 0.
+ *              <p>
+ *              Exporting a gpio which is already exported (e.g. by a previous
+ *              run) is skipped, as well as setting the direction or edge the
+ *              gpio already has. Thus a warm start only reads sysfs.
+ *              <p>
  *              Almost entirely based on Software by RidgeRun. See copyright
  *              disclaimer.
  *
@@ -18,6 +26,10 @@
  *
  *  \remark     Last Modification
  *               \li wht4, August 2013, Created
+ *               \li wht4, October 2026, Cache of the value file descriptors
+ *               \li wht4, October 2026, Set/get the value of several gpios
+ *               \li wht4, October 2026, Skip export, direction, edge if set
+ *               \li wht4, October 2026, Value files guarded by a mutex
  *
  *  \Copyright
  * Original source from
@@ -61,9 +73,15 @@
  *              setGpioDirection
  *              setGpioValue
  *              getGpioValue
+ *              setGpioValues
+ *              getGpioValues
  *              setGpioEdge
  *              pollGpio
+ *              openGpioValueFd
  *  functions  local:
+ *              isAttributeGpio
+ *              getValueFd
+ *              closeValueFd
  *              openFdGpio
  *              closeFdGpio
  *
@@ -75,18 +93,40 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <pthread.h>
 #include <sys/stat.h>
 
 #include "Gpio.h"
+#define LOG_MODULE  HW
 #include "Log.h"
 
 //----- Macros -----------------------------------------------------------------
+#ifndef GPIO_SYSFS_DIR
+/** Can be set to a stand-in directory (bench/BenchGpio.c)                    */
 #define GPIO_SYSFS_DIR        "/sys/class/gpio"
+#endif
 #define GPIO_MAX_BUF          ( 64 )
+/** Number of gpios of the AM335x (4 banks of 32 pins)                        */
+#define GPIO_MAX_PINS         ( 128 )
 
 //----- Data types -------------------------------------------------------------
 
+/** Cached value file of a gpio */
+typedef struct _sGpioFd {
+
+    boolE bOpen;  ///< TRUE if fd is valid
+    int   fd;     ///< value file, opened read/write
+
+} sGpioFd;
+
 //----- Function prototypes ----------------------------------------------------
+static boolE    isAttributeGpio(uint32_t u32Gpio,
+                                const char * pcAttribute,
+                                const char * pcValue);
+static BBBError getValueFd(uint32_t u32Gpio, int * fd);
+
+static void     closeValueFd(uint32_t u32Gpio);
+
 static BBBError openFdGpio(uint32_t u32Gpio, int *fd);
 
 static BBBError closeFdGpio(int fd);
@@ -99,6 +139,11 @@ static const char * pcEdgeRising  = "rising";
 static const char * pcEdgeFalling = "falling";
 static const char * pcEdgeBoth    = "both";
 
+/** Guards the value files, a gpio may be accessed by several threads       */
+static pthread_mutex_t mutexValueFd = PTHREAD_MUTEX_INITIALIZER;
+/** Value files of the exported gpios (indexed by gpio number)               */
+static sGpioFd         asValueFd[GPIO_MAX_PINS];
+
 //----- Implementation ---------------------------------------------------------
 
 /*******************************************************************************
@@ -107,7 +152,9 @@ static const char * pcEdgeBoth    = "both";
 /** \brief        Export a gpio pin
  *                <p>
  *                Gpio pin will be exported. This will result in a new folder
- *                in /sys/class/gpio/gpio#
+ *                in /sys/class/gpio/gpio#. The value file of the gpio is
+ *                opened and kept open until the gpio is unexported. A gpio
+ *                which is already exported is not exported again.
  *
  *  \type         global
  *
@@ -116,6 +163,7 @@ static const char * pcEdgeBoth    = "both";
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                </pre>
  *
  ******************************************************************************/
@@ -123,17 +171,35 @@ BBBError exportGpio(uint32_t u32Gpio) {
 
     int      fd = -1;
     int      len = 0;
+    ssize_t  written;
     char     cBuf[GPIO_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
+    /* Still exported by a previous run */
+    snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d", u32Gpio);
+    if (access(cBuf, F_OK) == 0) {
+        getValueFd(u32Gpio, &fd);
+        return (BBB_SUCCESS);
+    }
+
     fd = open(GPIO_SYSFS_DIR "/export", O_WRONLY);
     if (fd < 0) {
         ERRORPRINT("export of gpio %d failed", u32Gpio);
         error = BBB_FILE_OPEN;
     } else {
         len = snprintf(cBuf, sizeof(cBuf), "%d", u32Gpio);
-        write(fd, cBuf, len);
+        written = write(fd, cBuf, len);
         error = closeFdGpio(fd);
+        if (written != len) {
+            ERRORPRINT("export of gpio %d failed", u32Gpio);
+            error = BBB_FILE_WRITE;
+        }
+    }
+
+    /* The value file may not be accessible yet (udev), in this case it is */
+    /* opened on the first access.                                        */
+    if(error == BBB_SUCCESS) {
+        getValueFd(u32Gpio, &fd);
     }
 
     return (error);
@@ -145,7 +211,7 @@ BBBError exportGpio(uint32_t u32Gpio) {
 /** \brief        Unexport a gpio pin
  *                <p>
  *                Gpio pin will be exported. Folder in /sys/class/gpio/gpio#
- *                will be removed.
+ *                will be removed. The cached value file is closed.
  *
  *  \type         global
  *
@@ -154,6 +220,7 @@ BBBError exportGpio(uint32_t u32Gpio) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                </pre>
  *
  ******************************************************************************/
@@ -161,17 +228,24 @@ BBBError unexportGpio(uint32_t u32Gpio) {
 
     int      fd;
     int      len;
+    ssize_t  written;
     char     cBuf[GPIO_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
+    closeValueFd(u32Gpio);
+
     fd = open(GPIO_SYSFS_DIR "/unexport", O_WRONLY);
     if (fd < 0) {
         ERRORPRINT("unexport of gpio %d failed", u32Gpio);
         error = BBB_FILE_OPEN;
     } else {
         len = snprintf(cBuf, sizeof(cBuf), "%d", u32Gpio);
-        write(fd, cBuf, len);
+        written = write(fd, cBuf, len);
         error = closeFdGpio(fd);
+        if (written != len) {
+            ERRORPRINT("unexport of gpio %d failed", u32Gpio);
+            error = BBB_FILE_WRITE;
+        }
     }
 
     return (error);
@@ -193,15 +267,32 @@ BBBError unexportGpio(uint32_t u32Gpio) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                BBB_ERR_PARAM    if a parameter error occurred
  *                </pre>
  *
  ******************************************************************************/
 BBBError setGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
 
-    int      fd;
-    char     cBuf[GPIO_MAX_BUF];
-    BBBError error = BBB_SUCCESS;
+    int          fd;
+    ssize_t      written;
+    char         cBuf[GPIO_MAX_BUF];
+    const char * pcDir;
+    BBBError     error = BBB_SUCCESS;
+
+    if(eDir == GPIO_DIR_OUT) {
+        pcDir = pcDirOut;
+    } else if(eDir == GPIO_DIR_IN) {
+        pcDir = pcDirIn;
+    } else {
+        ERRORPRINT("parameter error");
+        return (BBB_ERR_PARAM);
+    }
+
+    /* Writing "out" again would also drive the gpio low */
+    if (isAttributeGpio(u32Gpio, "direction", pcDir) == TRUE) {
+        return (BBB_SUCCESS);
+    }
 
     snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR  "/gpio%d/direction", u32Gpio);
 
@@ -210,22 +301,12 @@ BBBError setGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
         ERRORPRINT("set direction of gpio %d failed", u32Gpio);
         error = BBB_FILE_OPEN;
     } else {
-
-        if(eDir == GPIO_DIR_OUT) {
-
-            write(fd, pcDirOut, strlen(pcDirOut));
-
-        } else if(eDir == GPIO_DIR_IN) {
-
-            write(fd, pcDirIn, strlen(pcDirIn));
-
-        } else {
-
-            error = BBB_ERR_PARAM;
-            ERRORPRINT("parameter error");
+        written = write(fd, pcDir, strlen(pcDir));
+        error = closeFdGpio(fd);
+        if (written != (ssize_t) strlen(pcDir)) {
+            ERRORPRINT("set direction of gpio %d failed", u32Gpio);
+            error = BBB_FILE_WRITE;
         }
-
-        error |= closeFdGpio(fd);
     }
 
     return (error);
@@ -247,6 +328,7 @@ BBBError setGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                BBB_ERR_PARAM    if a parameter error occurred
  *                </pre>
  *
@@ -254,31 +336,23 @@ BBBError setGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
 BBBError setGpioValue(uint32_t u32Gpio, eGpioValue eValue) {
 
     int      fd;
-    char     cBuf[GPIO_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
-    snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d/value", u32Gpio);
-
-    fd = open(cBuf, O_WRONLY);
-    if (fd < 0) {
+    if((error = getValueFd(u32Gpio, &fd)) != BBB_SUCCESS) {
         ERRORPRINT("set value of gpio %d failed", u32Gpio);
-        error = BBB_FILE_OPEN;
     } else {
 
-        if(eValue == GPIO_VALUE_LOW) {
-
-            write(fd, "0", 2);
-
-        } else if(eValue == GPIO_VALUE_HIGH) {
-
-            write(fd, "1", 2);
-
-        } else {
+        if((eValue != GPIO_VALUE_LOW) && (eValue != GPIO_VALUE_HIGH)) {
 
             ERRORPRINT("parameter error");
             error = BBB_ERR_PARAM;
+
+        } else if(pwrite(fd, (eValue == GPIO_VALUE_HIGH) ? "1" : "0", 1, 0)
+                  != 1) {
+
+            ERRORPRINT("set value of gpio %d failed", u32Gpio);
+            error = BBB_FILE_WRITE;
         }
-        error |= closeFdGpio(fd);
     }
 
     return (error);
@@ -300,6 +374,7 @@ BBBError setGpioValue(uint32_t u32Gpio, eGpioValue eValue) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_READ    File could not be read
  *                BBB_ERR_UNKNOWN  If neither '1' nor '0' are written in the
  *                                 value file
  *                </pre>
@@ -308,21 +383,21 @@ BBBError setGpioValue(uint32_t u32Gpio, eGpioValue eValue) {
 BBBError getGpioValue(uint32_t u32Gpio, eGpioValue * peValue) {
 
     int      fd;
-    char     cBuf[GPIO_MAX_BUF];
-    char     ch;
+    char     ch = '\0';
     BBBError error = BBB_SUCCESS;
 
-    snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d/value", u32Gpio);
-
-    fd = open(cBuf, O_RDONLY);
-    if (fd < 0) {
+    if((error = getValueFd(u32Gpio, &fd)) != BBB_SUCCESS) {
         ERRORPRINT("get value of gpio %d failed", u32Gpio);
-        error = BBB_FILE_OPEN;
+        *peValue = GPIO_VALUE_LOW;
     } else {
 
-        read(fd, &ch, 1);
+        if(pread(fd, &ch, 1, 0) != 1) {
+
+            ERRORPRINT("get value of gpio %d failed", u32Gpio);
+            error = BBB_FILE_READ;
+            *peValue = GPIO_VALUE_LOW;
 
-        if(ch == '1') {
+        } else if(ch == '1') {
 
             *peValue = GPIO_VALUE_HIGH;
 
@@ -336,7 +411,81 @@ BBBError getGpioValue(uint32_t u32Gpio, eGpioValue * peValue) {
             error = BBB_ERR_UNKNOWN;
             *peValue = GPIO_VALUE_LOW;
         }
-        error |= closeFdGpio(fd);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    setGpioValues
+ ******************************************************************************/
+/** \brief        Sets the value of several gpios.
+ *                <p>
+ *                Every value file is written on its own. The interface exists
+ *                for backends which can set several lines at once (see
+ *                HwBackend.h). All gpios must be exported.
+ *
+ *  \type         global
+ *
+ *  \param[in]    au32Gpio   gpio pins
+ *  \param[in]    aeValue    value of every gpio
+ *  \param[in]    u32Count   number of gpios
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError setGpioValues(const uint32_t * au32Gpio,
+                       const eGpioValue * aeValue,
+                       uint32_t u32Count) {
+
+    uint32_t i;
+    BBBError error = BBB_SUCCESS;
+
+    for(i = 0; i < u32Count; i++) {
+        error |= setGpioValue(au32Gpio[i], aeValue[i]);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    getGpioValues
+ ******************************************************************************/
+/** \brief        Gets the value of several gpios.
+ *                <p>
+ *                Every value file is read on its own. The interface exists
+ *                for backends which can read several lines at once (see
+ *                HwBackend.h). All gpios must be exported.
+ *
+ *  \type         global
+ *
+ *  \param[in]    au32Gpio   gpio pins
+ *  \param[out]   aeValue    value of every gpio
+ *  \param[in]    u32Count   number of gpios
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_READ    File could not be read
+ *                BBB_ERR_UNKNOWN  If neither '1' nor '0' are written in a
+ *                                 value file
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError getGpioValues(const uint32_t * au32Gpio,
+                       eGpioValue * aeValue,
+                       uint32_t u32Count) {
+
+    uint32_t i;
+    BBBError error = BBB_SUCCESS;
+
+    for(i = 0; i < u32Count; i++) {
+        error |= getGpioValue(au32Gpio[i], &aeValue[i]);
     }
 
     return (error);
@@ -359,15 +508,35 @@ BBBError getGpioValue(uint32_t u32Gpio, eGpioValue * peValue) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                BBB_ERR_PARAM    if a parameter error occurred
  *                </pre>
  *
  ******************************************************************************/
 BBBError setGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge) {
 
-    int  fd;
-    char cBuf[GPIO_MAX_BUF];
-    BBBError error = BBB_SUCCESS;
+    int          fd;
+    ssize_t      written;
+    char         cBuf[GPIO_MAX_BUF];
+    const char * pcEdge;
+    BBBError     error = BBB_SUCCESS;
+
+    if(eEdge == GPIO_EDGE_NONE) {
+        pcEdge = pcEdgeNone;
+    } else if(eEdge == GPIO_EDGE_RISING) {
+        pcEdge = pcEdgeRising;
+    } else if(eEdge == GPIO_EDGE_FALLING) {
+        pcEdge = pcEdgeFalling;
+    } else if(eEdge == GPIO_EDGE_BOTH) {
+        pcEdge = pcEdgeBoth;
+    } else {
+        ERRORPRINT("parameter error");
+        return (BBB_ERR_PARAM);
+    }
+
+    if (isAttributeGpio(u32Gpio, "edge", pcEdge) == TRUE) {
+        return (BBB_SUCCESS);
+    }
 
     snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d/edge", u32Gpio);
 
@@ -376,29 +545,12 @@ BBBError setGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge) {
         ERRORPRINT("set edge of gpio %d failed", u32Gpio);
         error = BBB_FILE_OPEN;
     } else {
-
-        if(eEdge == GPIO_EDGE_NONE) {
-
-            write(fd, pcEdgeNone, strlen(pcEdgeNone));
-
-        } else if(eEdge == GPIO_EDGE_RISING) {
-
-            write(fd, pcEdgeRising, strlen(pcEdgeRising));
-
-        } else if(eEdge == GPIO_EDGE_FALLING) {
-
-            write(fd, pcEdgeFalling, strlen(pcEdgeFalling));
-
-        } else if(eEdge == GPIO_EDGE_BOTH) {
-
-            write(fd, pcEdgeBoth, strlen(pcEdgeBoth));
-
-        } else {
-
-            ERRORPRINT("parameter error");
-            error = BBB_ERR_PARAM;
+        written = write(fd, pcEdge, strlen(pcEdge));
+        error = closeFdGpio(fd);
+        if (written != (ssize_t) strlen(pcEdge)) {
+            ERRORPRINT("set edge of gpio %d failed", u32Gpio);
+            error = BBB_FILE_WRITE;
         }
-        error |= closeFdGpio(fd);
     }
 
     return (error);
@@ -459,6 +611,131 @@ BBBError pollGpio(uint32_t u32Gpio, int32_t s32TimeoutMs) {
     return(error);
 }
 
+/*******************************************************************************
+ *  function :    openGpioValueFd
+ ******************************************************************************/
+/** \brief        Opens the value file of a gpio to wait on its edges.
+ *                <p>
+ *                The file is opened non blocking and read only. It signals
+ *                POLLPRI (and POLLERR) on every edge set by setGpioEdge(),
+ *                until it is read again at offset 0. The caller must close
+ *                the file. The gpio must first be exported before this
+ *                function can be called.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Gpio    gpio pin
+ *  \param[out]   fd         opened value file
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError openGpioValueFd(uint32_t u32Gpio, int * fd) {
+
+    return (openFdGpio(u32Gpio, fd));
+}
+
+/*******************************************************************************
+ *  function :    isAttributeGpio
+ ******************************************************************************/
+/** \brief        Checks if an attribute of a gpio already has a value
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Gpio      gpio pin
+ *  \param[in]    pcAttribute  attribute file (e.g. "direction")
+ *  \param[in]    pcValue      expected value
+ *
+ *  \return       TRUE if the attribute has the value, FALSE otherwise or if
+ *                it could not be read
+ *
+ ******************************************************************************/
+static boolE isAttributeGpio(uint32_t u32Gpio,
+                             const char * pcAttribute,
+                             const char * pcValue) {
+
+    int     fd;
+    ssize_t len;
+    size_t  valueLen = strlen(pcValue);
+    char    cBuf[GPIO_MAX_BUF];
+
+    snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d/%s",
+             u32Gpio, pcAttribute);
+
+    fd = open(cBuf, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return (FALSE);
+    }
+    len = read(fd, cBuf, sizeof(cBuf) - 1);
+    close(fd);
+
+    /* sysfs terminates the value with a newline */
+    if ((len < (ssize_t) valueLen) || (memcmp(cBuf, pcValue, valueLen) != 0) ||
+        ((len > (ssize_t) valueLen) && (cBuf[valueLen] != '\n'))) {
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/*******************************************************************************
+ *  function :    getValueFd
+ ******************************************************************************/
+static BBBError getValueFd(uint32_t u32Gpio, int * fd) {
+
+    char     cBuf[GPIO_MAX_BUF];
+    BBBError error = BBB_SUCCESS;
+
+    if(u32Gpio >= GPIO_MAX_PINS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    /* Opened on export, or now if the gpio was exported by someone else */
+    pthread_mutex_lock(&mutexValueFd);
+    if(asValueFd[u32Gpio].bOpen == FALSE) {
+
+        snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d/value", u32Gpio);
+
+        asValueFd[u32Gpio].fd = open(cBuf, O_RDWR | O_CLOEXEC);
+        if(asValueFd[u32Gpio].fd < 0) {
+            /* Input pins may refuse write access */
+            asValueFd[u32Gpio].fd = open(cBuf, O_RDONLY | O_CLOEXEC);
+        }
+        if(asValueFd[u32Gpio].fd < 0) {
+            ERRORPRINT("open value of gpio %d failed", u32Gpio);
+            error = BBB_FILE_OPEN;
+        } else {
+            asValueFd[u32Gpio].bOpen = TRUE;
+        }
+    }
+
+    *fd = asValueFd[u32Gpio].fd;
+    pthread_mutex_unlock(&mutexValueFd);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    closeValueFd
+ ******************************************************************************/
+static void closeValueFd(uint32_t u32Gpio) {
+
+    if(u32Gpio >= GPIO_MAX_PINS) {
+        return;
+    }
+
+    pthread_mutex_lock(&mutexValueFd);
+    if(asValueFd[u32Gpio].bOpen == TRUE) {
+        closeFdGpio(asValueFd[u32Gpio].fd);
+        asValueFd[u32Gpio].bOpen = FALSE;
+        asValueFd[u32Gpio].fd = -1;
+    }
+    pthread_mutex_unlock(&mutexValueFd);
+}
+
 /*******************************************************************************
  *  function :    openFdGpio
  ******************************************************************************/
@@ -469,7 +746,7 @@ static BBBError openFdGpio(uint32_t u32Gpio, int *fd) {
 
     snprintf(cBuf, sizeof(cBuf), GPIO_SYSFS_DIR "/gpio%d/value", u32Gpio);
 
-    *fd = open(cBuf, O_RDONLY | O_NONBLOCK);
+    *fd = open(cBuf, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
     if (*fd < 0) {
         ERRORPRINT("open FD of gpio %d failed", u32Gpio);
         error = BBB_FILE_OPEN;
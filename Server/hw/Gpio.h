@@ -57,8 +57,11 @@
  *              setGpioDirection
  *              setGpioValue
  *              getGpioValue
+ *              setGpioValues
+ *              getGpioValues
  *              setGpioEdge
  *              pollGpio
+ *              openGpioValueFd
  *
  ******************************************************************************/
 
@@ -109,10 +112,20 @@ extern BBBError setGpioValue(uint32_t u32Gpio, eGpioValue eValue);
 
 extern BBBError getGpioValue(uint32_t u32Gpio, eGpioValue * peValue);
 
+extern BBBError setGpioValues(const uint32_t * au32Gpio,
+                              const eGpioValue * aeValue,
+                              uint32_t u32Count);
+
+extern BBBError getGpioValues(const uint32_t * au32Gpio,
+                              eGpioValue * aeValue,
+                              uint32_t u32Count);
+
 extern BBBError setGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge);
 
 extern BBBError pollGpio(uint32_t u32Gpio, int32_t s32TimeoutMs);
 
+extern BBBError openGpioValueFd(uint32_t u32Gpio, int * fd);
+
 //----- Data -------------------------------------------------------------------
 
 #endif /* GPIO_H_ */
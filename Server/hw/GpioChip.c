@@ -0,0 +1,950 @@
+/******************************************************************************/
+/** \file       GpioChip.c
+ *******************************************************************************
+ *
+ *  \brief      Gpio backend on the gpio character device (/dev/gpiochipN).
+ *              <p>
+ *              The configuration of every exported line is kept in memory.
+ *              The line request of a chip is brought in line with it lazily,
+ *              before the next value is set or read (syncChip): a changed set
+ *              of exported lines needs a new request, a changed direction or
+ *              edge only GPIO_V2_LINE_SET_CONFIG_IOCTL. The output values are
+ *              part of the configuration, thus they survive a new request.
+ *              <p>
+ *              All state is guarded by a single mutex. The event thread reads
+ *              the edges of a chip under the mutex (the request fd is non
+ *              blocking) and calls the handlers after releasing it.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              .
+ *  functions  local:
+ *              findLine
+ *              getLineFlags
+ *              buildConfig
+ *              syncChip
+ *              releaseChip
+ *              chipExportGpio
+ *              chipUnexportGpio
+ *              chipSetGpioDirection
+ *              chipSetGpioEdge
+ *              chipSetGpioValue
+ *              chipGetGpioValue
+ *              chipSetGpioValues
+ *              chipGetGpioValues
+ *              chipInitGpioEvent
+ *              chipFinalizeGpioEvent
+ *              chipAddGpioEvent
+ *              chipEnableGpioEvent
+ *              chipIsGpioEventEnabled
+ *              readEdges
+ *              chipEventThread
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <linux/gpio.h>
+
+#include "GpioChip.h"
+#include "Pwm.h"
+#include "Lm75.h"
+#define LOG_MODULE  HW
+#include "Log.h"
+#include "BBBSignal.h"
+
+//----- Macros -----------------------------------------------------------------
+#define GPIOCHIP_MAX_BUF       ( 64 )
+/** Number of edges read from a request at once                              */
+#define GPIOCHIP_EDGE_BATCH    ( 16 )
+/** Initializer of a chip without open fds                                   */
+#define GPIOCHIP_CLOSED        { -1, -1, FALSE, FALSE, 0, { 0 }, { { 0 } } }
+
+//----- Data types -------------------------------------------------------------
+
+/** Line of a chip */
+typedef struct _sChipLine {
+
+    boolE          bExported;      ///< line is part of the request
+    eGpioDirection eDir;           ///< direction
+    eGpioEdge      eEdge;          ///< edges which are detected when enabled
+    eGpioValue     eValue;         ///< output value
+    boolE          bWatched;       ///< a handler is registered
+    boolE          bEnable;        ///< edges are detected and handled
+    uint64_t       u64DebounceNs;  ///< edges within this time are dropped
+    uint64_t       u64LastNs;      ///< time of the last handled edge
+    pfGpioEvent    pfHandler;      ///< handler of an edge
+    void *         pvData;         ///< user data handed to pfHandler
+
+} sChipLine;
+
+/** Gpio chip (bank) */
+typedef struct _sChip {
+
+    int       chipFd;     ///< /dev/gpiochipN, -1 if closed
+    int       lineFd;     ///< line request, -1 if no line is requested
+    boolE     bDirty;     ///< the exported lines changed, request again
+    boolE     bReconfig;  ///< the configuration of a line changed
+    uint32_t  u32Lines;   ///< number of requested lines
+    uint64_t  au64Bit[GPIOCHIP_LINES];   ///< bit of a line within the request
+    sChipLine asLine[GPIOCHIP_LINES];
+
+} sChip;
+
+/** Edge to be handed to a handler */
+typedef struct _sChipEdge {
+
+    uint32_t    u32Gpio;     ///< gpio number
+    eGpioValue  eValue;      ///< value after the edge
+    uint64_t    u64StampNs;  ///< kernel timestamp (CLOCK_MONOTONIC)
+    pfGpioEvent pfHandler;   ///< handler of the gpio
+    void *      pvData;      ///< user data handed to pfHandler
+
+} sChipEdge;
+
+//----- Function prototypes ----------------------------------------------------
+static BBBError    findLine(uint32_t u32Gpio, sChip ** ppsChip, uint32_t * pu32Line);
+static uint64_t    getLineFlags(const sChipLine * psLine);
+static void        buildConfig(const sChip * psChip,
+                               struct gpio_v2_line_config * psConfig);
+static BBBError    syncChip(uint32_t u32Chip);
+static void        releaseChip(sChip * psChip);
+static BBBError    chipExportGpio(uint32_t u32Gpio);
+static BBBError    chipUnexportGpio(uint32_t u32Gpio);
+static BBBError    chipSetGpioDirection(uint32_t u32Gpio, eGpioDirection eDir);
+static BBBError    chipSetGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge);
+static BBBError    chipSetGpioValue(uint32_t u32Gpio, eGpioValue eValue);
+static BBBError    chipGetGpioValue(uint32_t u32Gpio, eGpioValue * peValue);
+static BBBError    chipSetGpioValues(const uint32_t * au32Gpio,
+                                     const eGpioValue * aeValue,
+                                     uint32_t u32Count);
+static BBBError    chipGetGpioValues(const uint32_t * au32Gpio,
+                                     eGpioValue * aeValue,
+                                     uint32_t u32Count);
+static BBBError    chipInitGpioEvent(void);
+static BBBError    chipFinalizeGpioEvent(void);
+static BBBError    chipAddGpioEvent(uint32_t u32Gpio,
+                                    uint32_t u32DebounceMs,
+                                    pfGpioEvent pfHandler,
+                                    void * pvData);
+static BBBError    chipEnableGpioEvent(uint32_t u32Gpio, boolE bEnable);
+static boolE       chipIsGpioEventEnabled(uint32_t u32Gpio);
+static uint32_t    readEdges(uint32_t u32Chip, sChipEdge * asEdges);
+static void *      chipEventThread(void * pvData);
+
+//----- Data -------------------------------------------------------------------
+/** Gpio character device backend                                             */
+const sHwBackend sHwBackendChip = {
+    "chardev",
+    chipExportGpio,
+    chipUnexportGpio,
+    chipSetGpioDirection,
+    chipSetGpioEdge,
+    chipSetGpioValue,
+    chipGetGpioValue,
+    chipSetGpioValues,
+    chipGetGpioValues,
+    chipInitGpioEvent,
+    chipFinalizeGpioEvent,
+    chipAddGpioEvent,
+    chipEnableGpioEvent,
+    chipIsGpioEventEnabled,
+    setPwmState,
+    setPwmPeriod,
+    setPwmDuty,
+    setPwmDutyPercent,
+    getPwmDuty,
+    finalizePwm,
+    startSamplerLm75,
+    stopSamplerLm75,
+    getSampleLm75
+};
+
+/** Guards all chips                                                          */
+static pthread_mutex_t mutexChip = PTHREAD_MUTEX_INITIALIZER;
+/** Chips, the fds are opened on demand                                       */
+static sChip           asChip[GPIOCHIP_MAX_CHIPS] = {
+    GPIOCHIP_CLOSED, GPIOCHIP_CLOSED, GPIOCHIP_CLOSED, GPIOCHIP_CLOSED
+};
+/** epoll instance of the event thread, -1 if it is not running              */
+static int             epollFd = -1;
+/** Thread wherein all edges are handled                                      */
+static pthread_t       idThread;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    findLine
+ ******************************************************************************/
+static BBBError findLine(uint32_t u32Gpio, sChip ** ppsChip, uint32_t * pu32Line) {
+
+    if(u32Gpio >= (GPIOCHIP_MAX_CHIPS * GPIOCHIP_LINES)) {
+        ERRORPRINT("gpio %d out of range", u32Gpio);
+        return (BBB_ERR_PARAM);
+    }
+
+    *ppsChip = &asChip[u32Gpio / GPIOCHIP_LINES];
+    *pu32Line = u32Gpio % GPIOCHIP_LINES;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    getLineFlags
+ ******************************************************************************/
+static uint64_t getLineFlags(const sChipLine * psLine) {
+
+    uint64_t u64Flags;
+
+    if(psLine->eDir == GPIO_DIR_OUT) {
+        return (GPIO_V2_LINE_FLAG_OUTPUT);
+    }
+
+    u64Flags = GPIO_V2_LINE_FLAG_INPUT;
+    if((psLine->bWatched == TRUE) && (psLine->bEnable == TRUE)) {
+        if(psLine->eEdge & GPIO_EDGE_RISING) {
+            u64Flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+        }
+        if(psLine->eEdge & GPIO_EDGE_FALLING) {
+            u64Flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+        }
+    }
+
+    return (u64Flags);
+}
+
+/*******************************************************************************
+ *  function :    buildConfig
+ ******************************************************************************/
+/** \brief        Builds the configuration of all requested lines of a chip
+ *                <p>
+ *                Lines with the same flags share an attribute, the output
+ *                values of all output lines are a further attribute. A chip
+ *                needs at most five flag combinations (output, input with
+ *                none, rising, falling or both edges), thus the attributes
+ *                never run out.
+ *
+ *  \type         static
+ *
+ *  \param[in]    psChip    chip with its requested lines
+ *  \param[out]   psConfig  line configuration
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void buildConfig(const sChip * psChip,
+                        struct gpio_v2_line_config * psConfig) {
+
+    struct gpio_v2_line_config_attribute * psAttr;
+    uint64_t u64Flags;
+    uint64_t u64OutMask = 0;
+    uint64_t u64OutBits = 0;
+    uint32_t u32Line;
+    uint32_t i;
+
+    memset(psConfig, 0, sizeof(*psConfig));
+    psConfig->flags = GPIO_V2_LINE_FLAG_INPUT;
+
+    for(u32Line = 0; u32Line < GPIOCHIP_LINES; u32Line++) {
+
+        if(psChip->au64Bit[u32Line] == 0) {
+            continue;
+        }
+
+        u64Flags = getLineFlags(&psChip->asLine[u32Line]);
+        for(i = 0; i < psConfig->num_attrs; i++) {
+            if(psConfig->attrs[i].attr.flags == u64Flags) {
+                break;
+            }
+        }
+        psAttr = &psConfig->attrs[i];
+        if(i == psConfig->num_attrs) {
+            psConfig->num_attrs++;
+            psAttr->attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+            psAttr->attr.flags = u64Flags;
+        }
+        psAttr->mask |= psChip->au64Bit[u32Line];
+
+        if(psChip->asLine[u32Line].eDir == GPIO_DIR_OUT) {
+            u64OutMask |= psChip->au64Bit[u32Line];
+            if(psChip->asLine[u32Line].eValue == GPIO_VALUE_HIGH) {
+                u64OutBits |= psChip->au64Bit[u32Line];
+            }
+        }
+    }
+
+    if(u64OutMask != 0) {
+        psAttr = &psConfig->attrs[psConfig->num_attrs++];
+        psAttr->attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        psAttr->attr.values = u64OutBits;
+        psAttr->mask = u64OutMask;
+    }
+}
+
+/*******************************************************************************
+ *  function :    syncChip
+ ******************************************************************************/
+/** \brief        Brings the line request of a chip in line with the
+ *                configuration of its exported lines
+ *                <p>
+ *                Must be called with mutexChip locked.
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Chip  index of the chip
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    the chip could not be opened
+ *                BBB_FILE_IOCTL   the lines could not be requested/configured
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError syncChip(uint32_t u32Chip) {
+
+    sChip *                     psChip = &asChip[u32Chip];
+    struct gpio_v2_line_request sRequest;
+    struct gpio_v2_line_config  sConfig;
+    struct epoll_event          sEvent;
+    char                        acBuf[GPIOCHIP_MAX_BUF];
+    uint32_t                    u32Line;
+
+    if(psChip->bDirty == TRUE) {
+
+        releaseChip(psChip);
+
+        memset(&sRequest, 0, sizeof(sRequest));
+        for(u32Line = 0; u32Line < GPIOCHIP_LINES; u32Line++) {
+            psChip->au64Bit[u32Line] = 0;
+            if(psChip->asLine[u32Line].bExported == TRUE) {
+                psChip->au64Bit[u32Line] = 1uLL << sRequest.num_lines;
+                sRequest.offsets[sRequest.num_lines++] = u32Line;
+            }
+        }
+        psChip->u32Lines = sRequest.num_lines;
+        psChip->bDirty = FALSE;
+        psChip->bReconfig = FALSE;
+
+        if(psChip->u32Lines == 0) {
+            if(psChip->chipFd >= 0) {
+                close(psChip->chipFd);
+                psChip->chipFd = -1;
+            }
+            return (BBB_SUCCESS);
+        }
+
+        if(psChip->chipFd < 0) {
+            snprintf(acBuf, sizeof(acBuf), GPIOCHIP_DEVICE, u32Chip);
+            psChip->chipFd = open(acBuf, O_RDWR | O_CLOEXEC);
+            if(psChip->chipFd < 0) {
+                ERRORPRINT("open %s failed", acBuf);
+                psChip->bDirty = TRUE;
+                return (BBB_FILE_OPEN);
+            }
+        }
+
+        strncpy(sRequest.consumer, GPIOCHIP_CONSUMER,
+                sizeof(sRequest.consumer) - 1);
+        buildConfig(psChip, &sRequest.config);
+
+        if(ioctl(psChip->chipFd, GPIO_V2_GET_LINE_IOCTL, &sRequest) < 0) {
+            ERRORPRINT("request of gpiochip%d failed", u32Chip);
+            psChip->bDirty = TRUE;
+            return (BBB_FILE_IOCTL);
+        }
+        psChip->lineFd = sRequest.fd;
+        fcntl(psChip->lineFd, F_SETFL, O_NONBLOCK);
+
+        if(epollFd >= 0) {
+            sEvent.events = EPOLLIN;
+            sEvent.data.u32 = u32Chip;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, psChip->lineFd, &sEvent);
+        }
+
+    } else if((psChip->bReconfig == TRUE) && (psChip->lineFd >= 0)) {
+
+        buildConfig(psChip, &sConfig);
+        if(ioctl(psChip->lineFd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &sConfig) < 0) {
+            ERRORPRINT("configuration of gpiochip%d failed", u32Chip);
+            return (BBB_FILE_IOCTL);
+        }
+        psChip->bReconfig = FALSE;
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    releaseChip
+ ******************************************************************************/
+static void releaseChip(sChip * psChip) {
+
+    if(psChip->lineFd >= 0) {
+        if(epollFd >= 0) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, psChip->lineFd, NULL);
+        }
+        close(psChip->lineFd);
+        psChip->lineFd = -1;
+    }
+}
+
+/*******************************************************************************
+ *  function :    chipExportGpio
+ ******************************************************************************/
+static BBBError chipExportGpio(uint32_t u32Gpio) {
+
+    sChip *  psChip;
+    uint32_t u32Line;
+
+    if(findLine(u32Gpio, &psChip, &u32Line) != BBB_SUCCESS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexChip);
+    if(psChip->asLine[u32Line].bExported != TRUE) {
+        memset(&psChip->asLine[u32Line], 0, sizeof(sChipLine));
+        psChip->asLine[u32Line].bExported = TRUE;
+        psChip->asLine[u32Line].eDir = GPIO_DIR_IN;
+        psChip->bDirty = TRUE;
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    chipUnexportGpio
+ ******************************************************************************/
+static BBBError chipUnexportGpio(uint32_t u32Gpio) {
+
+    BBBError error = BBB_SUCCESS;
+    sChip *  psChip;
+    uint32_t u32Line;
+
+    if(findLine(u32Gpio, &psChip, &u32Line) != BBB_SUCCESS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexChip);
+    if(psChip->asLine[u32Line].bExported == TRUE) {
+        memset(&psChip->asLine[u32Line], 0, sizeof(sChipLine));
+        psChip->bDirty = TRUE;
+        /* Release the line right away */
+        error = syncChip(u32Gpio / GPIOCHIP_LINES);
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipSetGpioDirection
+ ******************************************************************************/
+static BBBError chipSetGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
+
+    BBBError error = BBB_SUCCESS;
+    sChip *  psChip;
+    uint32_t u32Line;
+
+    if(findLine(u32Gpio, &psChip, &u32Line) != BBB_SUCCESS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexChip);
+    if(psChip->asLine[u32Line].bExported != TRUE) {
+        error = BBB_FILE_OPEN;
+    } else if(psChip->asLine[u32Line].eDir != eDir) {
+        psChip->asLine[u32Line].eDir = eDir;
+        psChip->bReconfig = TRUE;
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipSetGpioEdge
+ ******************************************************************************/
+static BBBError chipSetGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge) {
+
+    BBBError error = BBB_SUCCESS;
+    sChip *  psChip;
+    uint32_t u32Line;
+
+    if(findLine(u32Gpio, &psChip, &u32Line) != BBB_SUCCESS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexChip);
+    if(psChip->asLine[u32Line].bExported != TRUE) {
+        error = BBB_FILE_OPEN;
+    } else if(psChip->asLine[u32Line].eEdge != eEdge) {
+        psChip->asLine[u32Line].eEdge = eEdge;
+        psChip->bReconfig = TRUE;
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipSetGpioValue
+ ******************************************************************************/
+static BBBError chipSetGpioValue(uint32_t u32Gpio, eGpioValue eValue) {
+
+    return (chipSetGpioValues(&u32Gpio, &eValue, 1));
+}
+
+/*******************************************************************************
+ *  function :    chipGetGpioValue
+ ******************************************************************************/
+static BBBError chipGetGpioValue(uint32_t u32Gpio, eGpioValue * peValue) {
+
+    return (chipGetGpioValues(&u32Gpio, peValue, 1));
+}
+
+/*******************************************************************************
+ *  function :    chipSetGpioValues
+ ******************************************************************************/
+/** \brief        Sets the value of several gpios, with a single ioctl per chip
+ *
+ *  \type         static
+ *
+ *  \param[in]    au32Gpio   gpio pins (exported outputs)
+ *  \param[in]    aeValue    value of every gpio
+ *  \param[in]    u32Count   number of gpios
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    a gpio is not exported
+ *                BBB_FILE_IOCTL   the values could not be set
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError chipSetGpioValues(const uint32_t * au32Gpio,
+                                  const eGpioValue * aeValue,
+                                  uint32_t u32Count) {
+
+    struct gpio_v2_line_values asValues[GPIOCHIP_MAX_CHIPS];
+    BBBError error = BBB_SUCCESS;
+    sChip *  psChip;
+    uint32_t u32Line;
+    uint32_t u32Chip;
+    uint32_t i;
+
+    memset(asValues, 0, sizeof(asValues));
+
+    pthread_mutex_lock(&mutexChip);
+
+    /* The configuration holds the output values, update it first */
+    for(i = 0; i < u32Count; i++) {
+        if(findLine(au32Gpio[i], &psChip, &u32Line) != BBB_SUCCESS) {
+            error |= BBB_ERR_PARAM;
+        } else if(psChip->asLine[u32Line].bExported != TRUE) {
+            error |= BBB_FILE_OPEN;
+        } else {
+            psChip->asLine[u32Line].eValue = aeValue[i];
+        }
+    }
+
+    for(u32Chip = 0; u32Chip < GPIOCHIP_MAX_CHIPS; u32Chip++) {
+        error |= syncChip(u32Chip);
+    }
+
+    for(i = 0; i < u32Count; i++) {
+        if((findLine(au32Gpio[i], &psChip, &u32Line) == BBB_SUCCESS) &&
+           (psChip->au64Bit[u32Line] != 0) &&
+           (psChip->asLine[u32Line].eDir == GPIO_DIR_OUT)) {
+            u32Chip = au32Gpio[i] / GPIOCHIP_LINES;
+            asValues[u32Chip].mask |= psChip->au64Bit[u32Line];
+            if(aeValue[i] == GPIO_VALUE_HIGH) {
+                asValues[u32Chip].bits |= psChip->au64Bit[u32Line];
+            }
+        }
+    }
+
+    for(u32Chip = 0; u32Chip < GPIOCHIP_MAX_CHIPS; u32Chip++) {
+        if((asValues[u32Chip].mask != 0) &&
+           (ioctl(asChip[u32Chip].lineFd, GPIO_V2_LINE_SET_VALUES_IOCTL,
+                  &asValues[u32Chip]) < 0)) {
+            ERRORPRINT("set values of gpiochip%d failed", u32Chip);
+            error |= BBB_FILE_IOCTL;
+        }
+    }
+
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipGetGpioValues
+ ******************************************************************************/
+/** \brief        Gets the value of several gpios, with a single ioctl per chip
+ *
+ *  \type         static
+ *
+ *  \param[in]    au32Gpio   gpio pins (exported)
+ *  \param[out]   aeValue    value of every gpio
+ *  \param[in]    u32Count   number of gpios
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    a gpio is not exported
+ *                BBB_FILE_IOCTL   the values could not be read
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError chipGetGpioValues(const uint32_t * au32Gpio,
+                                  eGpioValue * aeValue,
+                                  uint32_t u32Count) {
+
+    struct gpio_v2_line_values asValues[GPIOCHIP_MAX_CHIPS];
+    BBBError error = BBB_SUCCESS;
+    sChip *  psChip;
+    uint32_t u32Line;
+    uint32_t u32Chip;
+    uint32_t i;
+
+    memset(asValues, 0, sizeof(asValues));
+
+    pthread_mutex_lock(&mutexChip);
+
+    for(u32Chip = 0; u32Chip < GPIOCHIP_MAX_CHIPS; u32Chip++) {
+        error |= syncChip(u32Chip);
+    }
+
+    for(i = 0; i < u32Count; i++) {
+        aeValue[i] = GPIO_VALUE_LOW;
+        if(findLine(au32Gpio[i], &psChip, &u32Line) != BBB_SUCCESS) {
+            error |= BBB_ERR_PARAM;
+        } else if(psChip->au64Bit[u32Line] == 0) {
+            error |= BBB_FILE_OPEN;
+        } else {
+            asValues[au32Gpio[i] / GPIOCHIP_LINES].mask |= psChip->au64Bit[u32Line];
+        }
+    }
+
+    for(u32Chip = 0; u32Chip < GPIOCHIP_MAX_CHIPS; u32Chip++) {
+        if((asValues[u32Chip].mask != 0) &&
+           (ioctl(asChip[u32Chip].lineFd, GPIO_V2_LINE_GET_VALUES_IOCTL,
+                  &asValues[u32Chip]) < 0)) {
+            ERRORPRINT("get values of gpiochip%d failed", u32Chip);
+            asValues[u32Chip].bits = 0;
+            error |= BBB_FILE_IOCTL;
+        }
+    }
+
+    for(i = 0; i < u32Count; i++) {
+        if((findLine(au32Gpio[i], &psChip, &u32Line) == BBB_SUCCESS) &&
+           (asValues[au32Gpio[i] / GPIOCHIP_LINES].bits & psChip->au64Bit[u32Line])) {
+            aeValue[i] = GPIO_VALUE_HIGH;
+        }
+    }
+
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipInitGpioEvent
+ ******************************************************************************/
+/** \brief        Creates the epoll instance of all requests and starts the
+ *                event thread
+ *                <p>
+ *                Calling the function again has no effect.
+ *
+ *  \type         static
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_EVENT_CREATE   epoll could not be created
+ *                BBB_THREAD_CREATE  the thread could not be created
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError chipInitGpioEvent(void) {
+
+    BBBError           error = BBB_SUCCESS;
+    struct epoll_event sEvent;
+    uint32_t           u32Chip;
+
+    pthread_mutex_lock(&mutexChip);
+
+    if(epollFd < 0) {
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if(epollFd < 0) {
+            ERRORPRINT("can't create epoll");
+            error = BBB_EVENT_CREATE;
+        } else {
+
+            for(u32Chip = 0; u32Chip < GPIOCHIP_MAX_CHIPS; u32Chip++) {
+                if(asChip[u32Chip].lineFd >= 0) {
+                    sEvent.events = EPOLLIN;
+                    sEvent.data.u32 = u32Chip;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, asChip[u32Chip].lineFd,
+                              &sEvent);
+                }
+            }
+
+            if(pthread_create(&idThread, NULL, chipEventThread, NULL) != 0) {
+                ERRORPRINT("can't create thread");
+                close(epollFd);
+                epollFd = -1;
+                error = BBB_THREAD_CREATE;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipFinalizeGpioEvent
+ ******************************************************************************/
+static BBBError chipFinalizeGpioEvent(void) {
+
+    uint32_t u32Chip;
+    uint32_t u32Line;
+
+    if(epollFd < 0) {
+        return (BBB_SUCCESS);
+    }
+
+    pthread_cancel(idThread);
+    pthread_join(idThread, NULL);
+
+    pthread_mutex_lock(&mutexChip);
+    close(epollFd);
+    epollFd = -1;
+    for(u32Chip = 0; u32Chip < GPIOCHIP_MAX_CHIPS; u32Chip++) {
+        for(u32Line = 0; u32Line < GPIOCHIP_LINES; u32Line++) {
+            if(asChip[u32Chip].asLine[u32Line].bWatched == TRUE) {
+                asChip[u32Chip].asLine[u32Line].bWatched = FALSE;
+                asChip[u32Chip].asLine[u32Line].bEnable = FALSE;
+                asChip[u32Chip].bReconfig = TRUE;
+            }
+        }
+        syncChip(u32Chip);
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    chipAddGpioEvent
+ ******************************************************************************/
+static BBBError chipAddGpioEvent(uint32_t u32Gpio,
+                                 uint32_t u32DebounceMs,
+                                 pfGpioEvent pfHandler,
+                                 void * pvData) {
+
+    BBBError    error = BBB_SUCCESS;
+    sChip *     psChip;
+    sChipLine * psLine;
+    uint32_t    u32Line;
+
+    if((pfHandler == NULL) ||
+       (findLine(u32Gpio, &psChip, &u32Line) != BBB_SUCCESS)) {
+        return (BBB_ERR_PARAM);
+    }
+    psLine = &psChip->asLine[u32Line];
+
+    pthread_mutex_lock(&mutexChip);
+    if((psLine->bExported != TRUE) || (psLine->bWatched == TRUE)) {
+        error = BBB_ERR_PARAM;
+    } else {
+        psLine->bWatched = TRUE;
+        psLine->bEnable = FALSE;
+        psLine->u64DebounceNs = ((uint64_t) u32DebounceMs) * 1000000uLL;
+        psLine->u64LastNs = 0;
+        psLine->pfHandler = pfHandler;
+        psLine->pvData = pvData;
+        error = syncChip(u32Gpio / GPIOCHIP_LINES);
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipEnableGpioEvent
+ ******************************************************************************/
+static BBBError chipEnableGpioEvent(uint32_t u32Gpio, boolE bEnable) {
+
+    BBBError    error = BBB_SUCCESS;
+    sChip *     psChip;
+    sChipLine * psLine;
+    uint32_t    u32Line;
+
+    if(findLine(u32Gpio, &psChip, &u32Line) != BBB_SUCCESS) {
+        return (BBB_ERR_PARAM);
+    }
+    psLine = &psChip->asLine[u32Line];
+
+    pthread_mutex_lock(&mutexChip);
+    if(psLine->bWatched != TRUE) {
+        error = BBB_ERR_PARAM;
+    } else if(psLine->bEnable != bEnable) {
+        psLine->bEnable = bEnable;
+        psLine->u64LastNs = 0;
+        psChip->bReconfig = TRUE;
+        /* Start or stop the edge detection right away */
+        error = syncChip(u32Gpio / GPIOCHIP_LINES);
+    }
+    pthread_mutex_unlock(&mutexChip);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    chipIsGpioEventEnabled
+ ******************************************************************************/
+static boolE chipIsGpioEventEnabled(uint32_t u32Gpio) {
+
+    boolE    bEnable = FALSE;
+    sChip *  psChip;
+    uint32_t u32Line;
+
+    if(findLine(u32Gpio, &psChip, &u32Line) == BBB_SUCCESS) {
+        pthread_mutex_lock(&mutexChip);
+        bEnable = ((psChip->asLine[u32Line].bWatched == TRUE) &&
+                   (psChip->asLine[u32Line].bEnable == TRUE)) ? TRUE : FALSE;
+        pthread_mutex_unlock(&mutexChip);
+    }
+
+    return (bEnable);
+}
+
+/*******************************************************************************
+ *  function :    readEdges
+ ******************************************************************************/
+/** \brief        Reads the pending edges of a chip
+ *                <p>
+ *                Edges of lines which are not enabled or within the debounce
+ *                time are dropped. Must be called with mutexChip locked.
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Chip  index of the chip
+ *  \param[out]   asEdges  edges to hand to the handlers (GPIOCHIP_EDGE_BATCH)
+ *
+ *  \return       number of edges written to asEdges
+ *
+ ******************************************************************************/
+static uint32_t readEdges(uint32_t u32Chip, sChipEdge * asEdges) {
+
+    struct gpio_v2_line_event asEvents[GPIOCHIP_EDGE_BATCH];
+    sChipLine * psLine;
+    ssize_t     n;
+    uint32_t    u32Edges = 0;
+    uint32_t    i;
+
+    if(asChip[u32Chip].lineFd < 0) {
+        return (0);
+    }
+
+    n = read(asChip[u32Chip].lineFd, asEvents, sizeof(asEvents));
+    if(n <= 0) {
+        return (0);
+    }
+
+    for(i = 0; i < (n / sizeof(asEvents[0])); i++) {
+
+        if(asEvents[i].offset >= GPIOCHIP_LINES) {
+            continue;
+        }
+        psLine = &asChip[u32Chip].asLine[asEvents[i].offset];
+
+        if((psLine->bWatched != TRUE) || (psLine->bEnable != TRUE) ||
+           ((psLine->u64LastNs != 0) &&
+            ((asEvents[i].timestamp_ns - psLine->u64LastNs) < psLine->u64DebounceNs))) {
+            continue;
+        }
+        psLine->u64LastNs = asEvents[i].timestamp_ns;
+
+        asEdges[u32Edges].u32Gpio = u32Chip * GPIOCHIP_LINES + asEvents[i].offset;
+        asEdges[u32Edges].eValue = (asEvents[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE) ?
+                                   GPIO_VALUE_HIGH : GPIO_VALUE_LOW;
+        asEdges[u32Edges].u64StampNs = asEvents[i].timestamp_ns;
+        asEdges[u32Edges].pfHandler = psLine->pfHandler;
+        asEdges[u32Edges].pvData = psLine->pvData;
+        u32Edges++;
+    }
+
+    return (u32Edges);
+}
+
+/*******************************************************************************
+ *  function :    chipEventThread
+ ******************************************************************************/
+/** \brief        Waits for edges of the requested lines and calls their
+ *                handlers
+ *                <p>
+ *                Stopped by chipFinalizeGpioEvent() (pthread_cancel), the
+ *                thread can only be cancelled while it is waiting.
+ *
+ *  \type         static
+ *
+ *  \param[in]    pvData  not used
+ *
+ *  \return       NULL
+ *
+ ******************************************************************************/
+static void * chipEventThread(void * pvData) {
+
+    struct epoll_event asEvents[GPIOCHIP_MAX_CHIPS];
+    sChipEdge          asEdges[GPIOCHIP_EDGE_BATCH];
+    uint32_t           u32Edges;
+    uint32_t           j;
+    int                i;
+    int                n;
+    int                oldState;
+
+    /* Block all signals for this thread */
+    blockAllSignalForThread();
+
+    for(;;) {
+
+        n = epoll_wait(epollFd, asEvents, GPIOCHIP_MAX_CHIPS, -1);
+
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+
+        for(i = 0; i < n; i++) {
+
+            pthread_mutex_lock(&mutexChip);
+            u32Edges = readEdges(asEvents[i].data.u32, asEdges);
+            pthread_mutex_unlock(&mutexChip);
+
+            for(j = 0; j < u32Edges; j++) {
+                asEdges[j].pfHandler(asEdges[j].u32Gpio, asEdges[j].eValue,
+                                     asEdges[j].u64StampNs, asEdges[j].pvData);
+            }
+        }
+
+        pthread_setcancelstate(oldState, NULL);
+    }
+
+    return (NULL);
+}
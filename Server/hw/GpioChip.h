@@ -0,0 +1,61 @@
+#ifndef GPIOCHIP_H_
+#define GPIOCHIP_H_
+/******************************************************************************/
+/** \file       GpioChip.h
+ *******************************************************************************
+ *
+ *  \brief      Gpio backend on the gpio character device (/dev/gpiochipN).
+ *              <p>
+ *              The gpio numbers are the same as with sysfs: gpio N is line
+ *              N % 32 of chip N / 32 (e.g. TV 60 is line 28 of gpiochip1,
+ *              PIR 30 is line 30 of gpiochip0). All exported lines of a chip
+ *              are held by a single line request, which is (re)made when a
+ *              line is exported or unexported. Afterwards the values of
+ *              several lines of a chip are set or read with one ioctl
+ *              (setGpioValues/getGpioValues of the backend), a changed
+ *              direction, edge or enable state only reconfigures the request.
+ *              <p>
+ *              Edges of watched input lines are read from the request by a
+ *              single thread, with the timestamp taken by the kernel. Edges of
+ *              disabled lines are not detected at all (the edge flags are
+ *              removed from the line configuration).
+ *              <p>
+ *              The pwms and the lm75 are accessed as with the sysfs backend.
+ *              To run against the gpio-sim kernel module, GPIOCHIP_DEVICE can
+ *              be set to the device names of the simulated chips.
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    .
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+#include "HwBackend.h"
+
+//----- Macros -----------------------------------------------------------------
+#ifndef GPIOCHIP_DEVICE
+/** Device of a gpio chip, %u is the index of the chip                        */
+#define GPIOCHIP_DEVICE        "/dev/gpiochip%u"
+#endif
+/** Consumer name of the line requests (shown by gpioinfo)                   */
+#define GPIOCHIP_CONSUMER      "webhouse"
+/** Number of lines of a chip (bank of the AM335x)                            */
+#define GPIOCHIP_LINES         ( 32 )
+/** Number of chips                                                           */
+#define GPIOCHIP_MAX_CHIPS     ( 4 )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+
+//----- Data -------------------------------------------------------------------
+/** Gpio character device backend                                             */
+extern const sHwBackend sHwBackendChip;
+
+#endif /* GPIOCHIP_H_ */
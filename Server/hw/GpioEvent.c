@@ -0,0 +1,468 @@
+/******************************************************************************/
+/** \file       GpioEvent.c
+ *******************************************************************************
+ *
+ *  \brief      Edge events of all input gpios, served by a single thread.
+ *              <p>
+ *              The thread owns the epoll instance. Only the value files of
+ *              enabled gpios are registered. Changes of the enable state and
+ *              the request to terminate are signaled by an eventfd which is
+ *              registered at the same epoll instance.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              initGpioEvent
+ *              finalizeGpioEvent
+ *              addGpioEvent
+ *              enableGpioEvent
+ *              isGpioEventEnabled
+ *  functions  local:
+ *              findGpioEvent
+ *              applyEnableState
+ *              handleEdge
+ *              getTimeNs
+ *              gpioEventThread
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "GpioEvent.h"
+#define LOG_MODULE  HW
+#include "Log.h"
+#include "BBBSignal.h"
+
+//----- Macros -----------------------------------------------------------------
+/** epoll data of the control eventfd (gpio entries use their index)          */
+#define GPIO_EVENT_CONTROL     ( 0xffffffffu )
+
+//----- Data types -------------------------------------------------------------
+
+/** Watched gpio */
+typedef struct _sGpioEvent {
+
+    boolE       bUsed;          ///< entry in use
+    uint32_t    u32Gpio;        ///< gpio number
+    int         fd;             ///< value file, registered at the epoll
+    uint64_t    u64DebounceNs;  ///< edges within this time are dropped
+    uint64_t    u64LastNs;      ///< time of the last handled edge
+    pfGpioEvent pfHandler;      ///< handler of an edge
+    void *      pvData;         ///< user data handed to pfHandler
+    boolE       bEnable;        ///< requested state (set by any thread)
+    boolE       bArmed;         ///< registered at the epoll (thread only)
+
+} sGpioEvent;
+
+//----- Function prototypes ----------------------------------------------------
+static sGpioEvent * findGpioEvent(uint32_t u32Gpio);
+static void         applyEnableState(void);
+static void         handleEdge(sGpioEvent * psEvent);
+static uint64_t     getTimeNs(void);
+static void *       gpioEventThread(void * pvData);
+
+//----- Data -------------------------------------------------------------------
+/** Thread wherein all edges are handled                                      */
+static pthread_t    idThread;
+/** TRUE after initGpioEvent()                                                */
+static boolE        initialized = FALSE;
+/** epoll instance of the event thread                                        */
+static int          epollFd = -1;
+/** Signals a changed enable state or the termination to the thread          */
+static int          controlFd = -1;
+/** Set to terminate the thread                                               */
+static boolE        terminate = FALSE;
+/** Watched gpios                                                             */
+static sGpioEvent   asEvent[GPIO_EVENT_MAX_PINS];
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    initGpioEvent
+ ******************************************************************************/
+/** \brief        Creates the epoll instance and starts the event thread
+ *                <p>
+ *                Calling the function again has no effect.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_EVENT_CREATE   epoll or eventfd could not be created
+ *                BBB_EVENT_CTL      eventfd could not be registered
+ *                BBB_THREAD_CREATE  the thread could not be created
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError initGpioEvent(void) {
+
+    struct epoll_event sEvent;
+
+    if(initialized == TRUE) {
+        return (BBB_SUCCESS);
+    }
+
+    memset(asEvent, 0, sizeof(asEvent));
+    terminate = FALSE;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    controlFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if((epollFd < 0) || (controlFd < 0)) {
+        ERRORPRINT("creating gpio event loop failed");
+        finalizeGpioEvent();
+        return (BBB_EVENT_CREATE);
+    }
+
+    memset(&sEvent, 0, sizeof(sEvent));
+    sEvent.events = EPOLLIN;
+    sEvent.data.u32 = GPIO_EVENT_CONTROL;
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, controlFd, &sEvent) < 0) {
+        ERRORPRINT("registering gpio event control failed");
+        finalizeGpioEvent();
+        return (BBB_EVENT_CTL);
+    }
+
+    if(pthread_create(&idThread, NULL, gpioEventThread, NULL) != 0) {
+        ERRORPRINT("can't create thread");
+        finalizeGpioEvent();
+        return (BBB_THREAD_CREATE);
+    }
+
+    initialized = TRUE;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    finalizeGpioEvent
+ ******************************************************************************/
+/** \brief        Terminates the event thread and closes all value files
+ *                <p>
+ *                The gpios are not unexported, this is left to their owners.
+ *
+ *  \type         global
+ *
+ *  \return       BBB_SUCCESS
+ *
+ ******************************************************************************/
+BBBError finalizeGpioEvent(void) {
+
+    uint64_t u64One = 1;
+    uint32_t i;
+
+    if(initialized == TRUE) {
+        __atomic_store_n(&terminate, TRUE, __ATOMIC_RELEASE);
+        write(controlFd, &u64One, sizeof(u64One));
+        pthread_join(idThread, NULL);
+        initialized = FALSE;
+    }
+
+    for(i = 0; i < GPIO_EVENT_MAX_PINS; i++) {
+        if(asEvent[i].bUsed == TRUE) {
+            close(asEvent[i].fd);
+            asEvent[i].bUsed = FALSE;
+        }
+    }
+
+    if(controlFd >= 0) {
+        close(controlFd);
+        controlFd = -1;
+    }
+    if(epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    addGpioEvent
+ ******************************************************************************/
+/** \brief        Watches the edges of an input gpio
+ *                <p>
+ *                The gpio must be exported, configured as input and its edge
+ *                must be set (see Gpio.h). The value file is opened and kept
+ *                open. Watching is disabled until enableGpioEvent() is
+ *                called.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Gpio        gpio pin
+ *  \param[in]    u32DebounceMs  edges within this time after a handled edge
+ *                               are dropped
+ *  \param[in]    pfHandler      handler of an edge (called by the thread)
+ *  \param[in]    pvData         user data handed to pfHandler
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    already watched or no free entry
+ *                BBB_FILE_OPEN    value file could not be opened
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError addGpioEvent(uint32_t u32Gpio,
+                      uint32_t u32DebounceMs,
+                      pfGpioEvent pfHandler,
+                      void * pvData) {
+
+    sGpioEvent *       psEvent = NULL;
+    char               cBuf[4];
+    uint32_t           i;
+    BBBError           error = BBB_SUCCESS;
+
+    if((initialized == FALSE) || (findGpioEvent(u32Gpio) != NULL)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    for(i = 0; i < GPIO_EVENT_MAX_PINS; i++) {
+        if(asEvent[i].bUsed == FALSE) {
+            psEvent = &asEvent[i];
+            break;
+        }
+    }
+    if(psEvent == NULL) {
+        ERRORPRINT("no free gpio event for gpio %d", u32Gpio);
+        return (BBB_ERR_PARAM);
+    }
+
+    if((error = openGpioValueFd(u32Gpio, &psEvent->fd)) != BBB_SUCCESS) {
+        return (error);
+    }
+
+    /* A value file signals POLLPRI until it was read once */
+    pread(psEvent->fd, cBuf, sizeof(cBuf), 0);
+
+    psEvent->u32Gpio = u32Gpio;
+    psEvent->u64DebounceNs = ((uint64_t) u32DebounceMs) * 1000000uLL;
+    psEvent->u64LastNs = 0;
+    psEvent->pfHandler = pfHandler;
+    psEvent->pvData = pvData;
+    psEvent->bEnable = FALSE;
+    psEvent->bArmed = FALSE;
+
+    /* The value file is registered at the epoll by enableGpioEvent() */
+    __atomic_store_n(&psEvent->bUsed, TRUE, __ATOMIC_RELEASE);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    enableGpioEvent
+ ******************************************************************************/
+/** \brief        Enables or disables watching a gpio
+ *                <p>
+ *                The change is passed to the event thread. While disabled,
+ *                edges of the gpio do not wake up the thread.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Gpio   gpio pin (see addGpioEvent)
+ *  \param[in]    bEnable   TRUE to enable, FALSE to disable
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    gpio is not watched
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError enableGpioEvent(uint32_t u32Gpio, boolE bEnable) {
+
+    sGpioEvent * psEvent;
+    uint64_t     u64One = 1;
+
+    if((psEvent = findGpioEvent(u32Gpio)) == NULL) {
+        return (BBB_ERR_PARAM);
+    }
+
+    __atomic_store_n(&psEvent->bEnable, bEnable, __ATOMIC_RELEASE);
+    write(controlFd, &u64One, sizeof(u64One));
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    isGpioEventEnabled
+ ******************************************************************************/
+/** \brief        Returns if watching a gpio is enabled
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Gpio   gpio pin (see addGpioEvent)
+ *
+ *  \return       TRUE if enabled, FALSE if disabled or not watched
+ *
+ ******************************************************************************/
+boolE isGpioEventEnabled(uint32_t u32Gpio) {
+
+    sGpioEvent * psEvent;
+
+    if((psEvent = findGpioEvent(u32Gpio)) == NULL) {
+        return (FALSE);
+    }
+
+    return (__atomic_load_n(&psEvent->bEnable, __ATOMIC_ACQUIRE));
+}
+
+/*******************************************************************************
+ *  function :    findGpioEvent
+ ******************************************************************************/
+static sGpioEvent * findGpioEvent(uint32_t u32Gpio) {
+
+    uint32_t i;
+
+    for(i = 0; i < GPIO_EVENT_MAX_PINS; i++) {
+        if((__atomic_load_n(&asEvent[i].bUsed, __ATOMIC_ACQUIRE) == TRUE) &&
+           (asEvent[i].u32Gpio == u32Gpio)) {
+            return (&asEvent[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    applyEnableState
+ ******************************************************************************/
+/** \brief        Registers or removes the value file of every gpio whose
+ *                requested state changed at the epoll (event thread only)
+ *                <p>
+ *                A value file signals EPOLLERR on every edge, even if this
+ *                event is not requested. Thus a disabled gpio must not stay
+ *                registered.
+ *
+ *  \type         static
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void applyEnableState(void) {
+
+    struct epoll_event sEvent;
+    sGpioEvent *       psEvent;
+    char               cBuf[4];
+    boolE              bEnable;
+    uint32_t           i;
+
+    for(i = 0; i < GPIO_EVENT_MAX_PINS; i++) {
+
+        psEvent = &asEvent[i];
+        if(__atomic_load_n(&psEvent->bUsed, __ATOMIC_ACQUIRE) == FALSE) {
+            continue;
+        }
+
+        bEnable = __atomic_load_n(&psEvent->bEnable, __ATOMIC_ACQUIRE);
+        if(bEnable == psEvent->bArmed) {
+            continue;
+        }
+
+        /* Forget edges which occurred while disabled */
+        if(bEnable == TRUE) {
+            pread(psEvent->fd, cBuf, sizeof(cBuf), 0);
+            psEvent->u64LastNs = 0;
+        }
+
+        memset(&sEvent, 0, sizeof(sEvent));
+        sEvent.events = EPOLLPRI;
+        sEvent.data.u32 = i;
+        if(epoll_ctl(epollFd, (bEnable == TRUE) ? EPOLL_CTL_ADD : EPOLL_CTL_DEL,
+                     psEvent->fd, &sEvent) < 0) {
+            ERRORPRINT("arming gpio %d failed", psEvent->u32Gpio);
+        } else {
+            psEvent->bArmed = bEnable;
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    handleEdge
+ ******************************************************************************/
+static void handleEdge(sGpioEvent * psEvent) {
+
+    char       ch = '0';
+    uint64_t   u64Now;
+    eGpioValue eValue;
+
+    /* Reading the value acknowledges the edge */
+    pread(psEvent->fd, &ch, 1, 0);
+    eValue = (ch == '1') ? GPIO_VALUE_HIGH : GPIO_VALUE_LOW;
+
+    u64Now = getTimeNs();
+    if((psEvent->u64LastNs != 0) &&
+       ((u64Now - psEvent->u64LastNs) < psEvent->u64DebounceNs)) {
+        return;
+    }
+    psEvent->u64LastNs = u64Now;
+
+    psEvent->pfHandler(psEvent->u32Gpio, eValue, u64Now, psEvent->pvData);
+}
+
+/*******************************************************************************
+ *  function :    getTimeNs
+ ******************************************************************************/
+static uint64_t getTimeNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000uLL + sNow.tv_nsec);
+}
+
+/*******************************************************************************
+ *  function :    gpioEventThread
+ ******************************************************************************/
+/** \brief        Waits for edges of the watched gpios and calls their
+ *                handlers
+ *                <p>
+ *                The thread only wakes up on an edge of an enabled gpio or a
+ *                control event (enable state changed, termination).
+ *
+ *  \type         static
+ *
+ *  \param[in]    pvData  not used
+ *
+ *  \return       not used
+ *
+ ******************************************************************************/
+static void * gpioEventThread(void * pvData) {
+
+    struct epoll_event asEvents[GPIO_EVENT_MAX_PINS + 1];
+    uint64_t           u64Count;
+    int                i;
+    int                n;
+
+    /* Block all signals for this thread */
+    blockAllSignalForThread();
+
+    while(__atomic_load_n(&terminate, __ATOMIC_ACQUIRE) == FALSE) {
+
+        n = epoll_wait(epollFd, asEvents, GPIO_EVENT_MAX_PINS + 1, -1);
+
+        for(i = 0; i < n; i++) {
+
+            if(asEvents[i].data.u32 == GPIO_EVENT_CONTROL) {
+                read(controlFd, &u64Count, sizeof(u64Count));
+                applyEnableState();
+            } else if((asEvents[i].data.u32 < GPIO_EVENT_MAX_PINS) &&
+                      (asEvent[asEvents[i].data.u32].bArmed == TRUE)) {
+                handleEdge(&asEvent[asEvents[i].data.u32]);
+            }
+        }
+    }
+
+    pthread_exit(NULL);
+}
@@ -0,0 +1,78 @@
+#ifndef GPIOEVENT_H_
+#define GPIOEVENT_H_
+/******************************************************************************/
+/** \file       GpioEvent.h
+ *******************************************************************************
+ *
+ *  \brief      Edge events of all input gpios, served by a single thread.
+ *              <p>
+ *              The value files of all watched gpios are kept open and
+ *              registered at one epoll instance (EPOLLPRI) for their whole
+ *              life. The event thread sleeps in epoll_wait(2) until an edge
+ *              occurs, calls the handler of the gpio and goes back to sleep.
+ *              There are no periodic wakeups while idle.
+ *              <p>
+ *              Every gpio has its own debounce time: an edge within the
+ *              debounce time after the last handled edge is dropped. Watching
+ *              a gpio is enabled/disabled with enableGpioEvent(), the change
+ *              is passed to the thread as an event (eventfd).
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              exportGpio(30);
+ *              setGpioDirection(30, GPIO_DIR_IN);
+ *              setGpioEdge(30, GPIO_EDGE_RISING);
+ *
+ *              initGpioEvent();
+ *              addGpioEvent(30, 2000, onMotion, NULL);
+ *              enableGpioEvent(30, TRUE);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    initGpioEvent
+ *              finalizeGpioEvent
+ *              addGpioEvent
+ *              enableGpioEvent
+ *              isGpioEventEnabled
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+#include "Gpio.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of gpios which can be watched                                      */
+#define GPIO_EVENT_MAX_PINS    ( 8 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Handler of an edge, called within the event thread. u64StampNs is the
+ *  time (CLOCK_MONOTONIC) the edge was read. */
+typedef void (*pfGpioEvent)(uint32_t u32Gpio,
+                            eGpioValue eValue,
+                            uint64_t u64StampNs,
+                            void * pvData);
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError initGpioEvent(void);
+
+extern BBBError finalizeGpioEvent(void);
+
+extern BBBError addGpioEvent(uint32_t u32Gpio,
+                             uint32_t u32DebounceMs,
+                             pfGpioEvent pfHandler,
+                             void * pvData);
+
+extern BBBError enableGpioEvent(uint32_t u32Gpio, boolE bEnable);
+
+extern boolE    isGpioEventEnabled(uint32_t u32Gpio);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* GPIOEVENT_H_ */
@@ -0,0 +1,551 @@
+/******************************************************************************/
+/** \file       GpioMmap.c
+ *******************************************************************************
+ *
+ *  \brief      Gpio backend on the memory mapped gpio registers of the AM335x.
+ *              <p>
+ *              SETDATAOUT and CLEARDATAOUT only change the pins written as 1,
+ *              thus outputs are set without a read-modify-write and without
+ *              a lock. Only the OE register needs one (mutexBank), as well as
+ *              mapping and unmapping a bank.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              setGpioMmapDevice
+ *  functions  local:
+ *              isDevMem
+ *              getRegister
+ *              mapBank
+ *              unmapBank
+ *              mmapExportGpio
+ *              mmapUnexportGpio
+ *              mmapSetGpioDirection
+ *              mmapSetGpioEdge
+ *              mmapSetGpioValue
+ *              mmapGetGpioValue
+ *              mmapSetGpioValues
+ *              mmapGetGpioValues
+ *              mmapInitGpioEvent
+ *              mmapFinalizeGpioEvent
+ *              mmapAddGpioEvent
+ *              mmapEnableGpioEvent
+ *              mmapIsGpioEventEnabled
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "GpioMmap.h"
+#include "BBBConfig.h"
+#include "Pwm.h"
+#include "Lm75.h"
+#define LOG_MODULE  HW
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of pins of a bank                                                  */
+#define GPIOMMAP_PINS          ( 32 )
+#define GPIOMMAP_MAX_BUF       ( 64 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Mapped bank */
+typedef struct _sGpioBank {
+
+    volatile uint32_t * pu32Reg;     ///< register block, NULL if not mapped
+    uint32_t            u32Exported; ///< exported pins (bit mask)
+
+} sGpioBank;
+
+//----- Function prototypes ----------------------------------------------------
+static boolE      isDevMem(void);
+static volatile uint32_t * getRegister(uint32_t u32Gpio, uint32_t u32Offset);
+static BBBError   mapBank(uint32_t u32Bank);
+static void       unmapBank(uint32_t u32Bank);
+static BBBError   mmapExportGpio(uint32_t u32Gpio);
+static BBBError   mmapUnexportGpio(uint32_t u32Gpio);
+static BBBError   mmapSetGpioDirection(uint32_t u32Gpio, eGpioDirection eDir);
+static BBBError   mmapSetGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge);
+static BBBError   mmapSetGpioValue(uint32_t u32Gpio, eGpioValue eValue);
+static BBBError   mmapGetGpioValue(uint32_t u32Gpio, eGpioValue * peValue);
+static BBBError   mmapSetGpioValues(const uint32_t * au32Gpio,
+                                    const eGpioValue * aeValue,
+                                    uint32_t u32Count);
+static BBBError   mmapGetGpioValues(const uint32_t * au32Gpio,
+                                    eGpioValue * aeValue,
+                                    uint32_t u32Count);
+static BBBError   mmapInitGpioEvent(void);
+static BBBError   mmapFinalizeGpioEvent(void);
+static BBBError   mmapAddGpioEvent(uint32_t u32Gpio,
+                                   uint32_t u32DebounceMs,
+                                   pfGpioEvent pfHandler,
+                                   void * pvData);
+static BBBError   mmapEnableGpioEvent(uint32_t u32Gpio, boolE bEnable);
+static boolE      mmapIsGpioEventEnabled(uint32_t u32Gpio);
+
+//----- Data -------------------------------------------------------------------
+/** Memory mapped gpio backend                                                */
+const sHwBackend sHwBackendMmap = {
+    "mmap",
+    mmapExportGpio,
+    mmapUnexportGpio,
+    mmapSetGpioDirection,
+    mmapSetGpioEdge,
+    mmapSetGpioValue,
+    mmapGetGpioValue,
+    mmapSetGpioValues,
+    mmapGetGpioValues,
+    mmapInitGpioEvent,
+    mmapFinalizeGpioEvent,
+    mmapAddGpioEvent,
+    mmapEnableGpioEvent,
+    mmapIsGpioEventEnabled,
+    setPwmState,
+    setPwmPeriod,
+    setPwmDuty,
+    setPwmDutyPercent,
+    getPwmDuty,
+    finalizePwm,
+    startSamplerLm75,
+    stopSamplerLm75,
+    getSampleLm75
+};
+
+/** Physical address of the register block of every bank                     */
+static const off_t     aBankAddr[GPIOMMAP_BANKS] = {
+    0x44E07000, 0x4804C000, 0x481AC000, 0x481AE000
+};
+/** Source of the registers (/dev/mem or a register image)                    */
+static char            acDevice[GPIOMMAP_MAX_BUF] = CONFIG_GPIOMMAP_DEVICE;
+/** Guards the mapping of the banks and the OE registers                      */
+static pthread_mutex_t mutexBank = PTHREAD_MUTEX_INITIALIZER;
+static sGpioBank       asBank[GPIOMMAP_BANKS];
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    setGpioMmapDevice
+ ******************************************************************************/
+/** \brief        Sets the source the registers are mapped from
+ *                <p>
+ *                GPIOMMAP_DEV_MEM maps the registers of the AM335x, any other
+ *                file is taken as a register image (the 4 KiB blocks of the
+ *                four banks one after the other). Must be called before the
+ *                first gpio is exported.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcDevice  path of the source
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    the path is too long
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError setGpioMmapDevice(const char * pcDevice) {
+
+    if(strlen(pcDevice) >= sizeof(acDevice)) {
+        return (BBB_ERR_PARAM);
+    }
+    strcpy(acDevice, pcDevice);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    isDevMem
+ ******************************************************************************/
+static boolE isDevMem(void) {
+
+    return ((strcmp(acDevice, GPIOMMAP_DEV_MEM) == 0) ? TRUE : FALSE);
+}
+
+/*******************************************************************************
+ *  function :    getRegister
+ ******************************************************************************/
+/** \brief        Returns a register of the bank of a gpio
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Gpio    gpio number
+ *  \param[in]    u32Offset  offset of the register within the block
+ *
+ *  \return       the register, NULL if the gpio is not exported
+ *
+ ******************************************************************************/
+static volatile uint32_t * getRegister(uint32_t u32Gpio, uint32_t u32Offset) {
+
+    sGpioBank * psBank;
+
+    if(u32Gpio >= (GPIOMMAP_BANKS * GPIOMMAP_PINS)) {
+        return (NULL);
+    }
+
+    psBank = &asBank[u32Gpio / GPIOMMAP_PINS];
+    if((psBank->pu32Reg == NULL) ||
+       ((psBank->u32Exported & (1u << (u32Gpio % GPIOMMAP_PINS))) == 0)) {
+        return (NULL);
+    }
+
+    return (&psBank->pu32Reg[u32Offset / sizeof(uint32_t)]);
+}
+
+/*******************************************************************************
+ *  function :    mapBank
+ ******************************************************************************/
+/** \brief        Maps the register block of a bank, must be called with
+ *                mutexBank locked
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Bank  index of the bank
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    the source could not be opened or mapped
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError mapBank(uint32_t u32Bank) {
+
+    void * pvReg;
+    off_t  offset;
+    int    fd;
+
+    if(asBank[u32Bank].pu32Reg != NULL) {
+        return (BBB_SUCCESS);
+    }
+
+    fd = open(acDevice, O_RDWR | O_SYNC | O_CLOEXEC);
+    if(fd < 0) {
+        ERRORPRINT("open %s failed", acDevice);
+        return (BBB_FILE_OPEN);
+    }
+
+    offset = (isDevMem() == TRUE) ? aBankAddr[u32Bank] :
+                                    (off_t) (u32Bank * GPIOMMAP_BANK_SIZE);
+    pvReg = mmap(NULL, GPIOMMAP_BANK_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+                 fd, offset);
+    /* The mapping stays valid after the file is closed */
+    close(fd);
+
+    if(pvReg == MAP_FAILED) {
+        ERRORPRINT("mmap of gpio bank %d failed", u32Bank);
+        return (BBB_FILE_OPEN);
+    }
+    asBank[u32Bank].pu32Reg = (volatile uint32_t *) pvReg;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    unmapBank
+ ******************************************************************************/
+static void unmapBank(uint32_t u32Bank) {
+
+    if(asBank[u32Bank].pu32Reg != NULL) {
+        munmap((void *) asBank[u32Bank].pu32Reg, GPIOMMAP_BANK_SIZE);
+        asBank[u32Bank].pu32Reg = NULL;
+    }
+}
+
+/*******************************************************************************
+ *  function :    mmapExportGpio
+ ******************************************************************************/
+static BBBError mmapExportGpio(uint32_t u32Gpio) {
+
+    BBBError error = BBB_SUCCESS;
+    uint32_t u32Bank = u32Gpio / GPIOMMAP_PINS;
+
+    if(u32Bank >= GPIOMMAP_BANKS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    /* Let the kernel claim the pin and enable the clock of the bank */
+    if(isDevMem() == TRUE) {
+        error = exportGpio(u32Gpio);
+    }
+
+    pthread_mutex_lock(&mutexBank);
+    if(error == BBB_SUCCESS) {
+        error = mapBank(u32Bank);
+    }
+    if(error == BBB_SUCCESS) {
+        asBank[u32Bank].u32Exported |= 1u << (u32Gpio % GPIOMMAP_PINS);
+    }
+    pthread_mutex_unlock(&mutexBank);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    mmapUnexportGpio
+ ******************************************************************************/
+static BBBError mmapUnexportGpio(uint32_t u32Gpio) {
+
+    uint32_t u32Bank = u32Gpio / GPIOMMAP_PINS;
+
+    if(u32Bank >= GPIOMMAP_BANKS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexBank);
+    asBank[u32Bank].u32Exported &= ~(1u << (u32Gpio % GPIOMMAP_PINS));
+    if(asBank[u32Bank].u32Exported == 0) {
+        unmapBank(u32Bank);
+    }
+    pthread_mutex_unlock(&mutexBank);
+
+    if(isDevMem() == TRUE) {
+        return (unexportGpio(u32Gpio));
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    mmapSetGpioDirection
+ ******************************************************************************/
+static BBBError mmapSetGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
+
+    volatile uint32_t * pu32Oe;
+    uint32_t            u32Bit = 1u << (u32Gpio % GPIOMMAP_PINS);
+    BBBError            error = BBB_SUCCESS;
+
+    pthread_mutex_lock(&mutexBank);
+    pu32Oe = getRegister(u32Gpio, GPIOMMAP_OE);
+    if(pu32Oe == NULL) {
+        error = BBB_FILE_OPEN;
+    } else if(eDir == GPIO_DIR_OUT) {
+        *pu32Oe &= ~u32Bit;
+    } else {
+        *pu32Oe |= u32Bit;
+    }
+    pthread_mutex_unlock(&mutexBank);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    mmapSetGpioEdge
+ ******************************************************************************/
+static BBBError mmapSetGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge) {
+
+    if(isDevMem() != TRUE) {
+        return (BBB_SUCCESS);
+    }
+
+    return (setGpioEdge(u32Gpio, eEdge));
+}
+
+/*******************************************************************************
+ *  function :    mmapSetGpioValue
+ ******************************************************************************/
+static BBBError mmapSetGpioValue(uint32_t u32Gpio, eGpioValue eValue) {
+
+    volatile uint32_t * pu32Reg;
+
+    pu32Reg = getRegister(u32Gpio, (eValue == GPIO_VALUE_HIGH) ?
+                                   GPIOMMAP_SETDATAOUT : GPIOMMAP_CLEARDATAOUT);
+    if(pu32Reg == NULL) {
+        return (BBB_FILE_OPEN);
+    }
+    *pu32Reg = 1u << (u32Gpio % GPIOMMAP_PINS);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    mmapGetGpioValue
+ ******************************************************************************/
+static BBBError mmapGetGpioValue(uint32_t u32Gpio, eGpioValue * peValue) {
+
+    return (mmapGetGpioValues(&u32Gpio, peValue, 1));
+}
+
+/*******************************************************************************
+ *  function :    mmapSetGpioValues
+ ******************************************************************************/
+/** \brief        Sets the value of several gpios, with one store to
+ *                SETDATAOUT and CLEARDATAOUT per bank
+ *
+ *  \type         static
+ *
+ *  \param[in]    au32Gpio   gpio pins (exported outputs)
+ *  \param[in]    aeValue    value of every gpio
+ *  \param[in]    u32Count   number of gpios
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    a gpio is not exported
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError mmapSetGpioValues(const uint32_t * au32Gpio,
+                                  const eGpioValue * aeValue,
+                                  uint32_t u32Count) {
+
+    uint32_t au32Set[GPIOMMAP_BANKS] = { 0 };
+    uint32_t au32Clear[GPIOMMAP_BANKS] = { 0 };
+    BBBError error = BBB_SUCCESS;
+    uint32_t u32Bank;
+    uint32_t i;
+
+    for(i = 0; i < u32Count; i++) {
+        if(getRegister(au32Gpio[i], GPIOMMAP_SETDATAOUT) == NULL) {
+            error = BBB_FILE_OPEN;
+        } else if(aeValue[i] == GPIO_VALUE_HIGH) {
+            au32Set[au32Gpio[i] / GPIOMMAP_PINS] |= 1u << (au32Gpio[i] % GPIOMMAP_PINS);
+        } else {
+            au32Clear[au32Gpio[i] / GPIOMMAP_PINS] |= 1u << (au32Gpio[i] % GPIOMMAP_PINS);
+        }
+    }
+
+    for(u32Bank = 0; u32Bank < GPIOMMAP_BANKS; u32Bank++) {
+        if(au32Set[u32Bank] != 0) {
+            asBank[u32Bank].pu32Reg[GPIOMMAP_SETDATAOUT / sizeof(uint32_t)] =
+                au32Set[u32Bank];
+        }
+        if(au32Clear[u32Bank] != 0) {
+            asBank[u32Bank].pu32Reg[GPIOMMAP_CLEARDATAOUT / sizeof(uint32_t)] =
+                au32Clear[u32Bank];
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    mmapGetGpioValues
+ ******************************************************************************/
+/** \brief        Gets the value of several gpios
+ *                <p>
+ *                The value of an output is read from DATAOUT, the value of an
+ *                input from DATAIN. Every register is read once per bank.
+ *
+ *  \type         static
+ *
+ *  \param[in]    au32Gpio   gpio pins (exported)
+ *  \param[out]   aeValue    value of every gpio
+ *  \param[in]    u32Count   number of gpios
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    a gpio is not exported
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError mmapGetGpioValues(const uint32_t * au32Gpio,
+                                  eGpioValue * aeValue,
+                                  uint32_t u32Count) {
+
+    uint32_t au32Oe[GPIOMMAP_BANKS];
+    uint32_t au32In[GPIOMMAP_BANKS];
+    uint32_t au32Out[GPIOMMAP_BANKS];
+    BBBError error = BBB_SUCCESS;
+    uint32_t u32Bank;
+    uint32_t u32Bit;
+    uint32_t i;
+
+    for(u32Bank = 0; u32Bank < GPIOMMAP_BANKS; u32Bank++) {
+        if(asBank[u32Bank].pu32Reg != NULL) {
+            au32Oe[u32Bank] = asBank[u32Bank].pu32Reg[GPIOMMAP_OE / sizeof(uint32_t)];
+            au32In[u32Bank] = asBank[u32Bank].pu32Reg[GPIOMMAP_DATAIN / sizeof(uint32_t)];
+            au32Out[u32Bank] = asBank[u32Bank].pu32Reg[GPIOMMAP_DATAOUT / sizeof(uint32_t)];
+        }
+    }
+
+    for(i = 0; i < u32Count; i++) {
+        aeValue[i] = GPIO_VALUE_LOW;
+        if(getRegister(au32Gpio[i], GPIOMMAP_DATAIN) == NULL) {
+            error = BBB_FILE_OPEN;
+        } else {
+            u32Bank = au32Gpio[i] / GPIOMMAP_PINS;
+            u32Bit = 1u << (au32Gpio[i] % GPIOMMAP_PINS);
+            if(((au32Oe[u32Bank] & u32Bit) ? au32In[u32Bank] : au32Out[u32Bank]) & u32Bit) {
+                aeValue[i] = GPIO_VALUE_HIGH;
+            }
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    mmapInitGpioEvent
+ ******************************************************************************/
+static BBBError mmapInitGpioEvent(void) {
+
+    /* Without sysfs there are no edges, but nothing fails */
+    if(isDevMem() != TRUE) {
+        return (BBB_SUCCESS);
+    }
+
+    return (initGpioEvent());
+}
+
+/*******************************************************************************
+ *  function :    mmapFinalizeGpioEvent
+ ******************************************************************************/
+static BBBError mmapFinalizeGpioEvent(void) {
+
+    if(isDevMem() != TRUE) {
+        return (BBB_SUCCESS);
+    }
+
+    return (finalizeGpioEvent());
+}
+
+/*******************************************************************************
+ *  function :    mmapAddGpioEvent
+ ******************************************************************************/
+static BBBError mmapAddGpioEvent(uint32_t u32Gpio,
+                                 uint32_t u32DebounceMs,
+                                 pfGpioEvent pfHandler,
+                                 void * pvData) {
+
+    /* Accepted, so the webhouse also runs on an image, but never reported */
+    if(isDevMem() != TRUE) {
+        return (BBB_SUCCESS);
+    }
+
+    return (addGpioEvent(u32Gpio, u32DebounceMs, pfHandler, pvData));
+}
+
+/*******************************************************************************
+ *  function :    mmapEnableGpioEvent
+ ******************************************************************************/
+static BBBError mmapEnableGpioEvent(uint32_t u32Gpio, boolE bEnable) {
+
+    if(isDevMem() != TRUE) {
+        return (BBB_SUCCESS);
+    }
+
+    return (enableGpioEvent(u32Gpio, bEnable));
+}
+
+/*******************************************************************************
+ *  function :    mmapIsGpioEventEnabled
+ ******************************************************************************/
+static boolE mmapIsGpioEventEnabled(uint32_t u32Gpio) {
+
+    if(isDevMem() != TRUE) {
+        return (FALSE);
+    }
+
+    return (isGpioEventEnabled(u32Gpio));
+}
@@ -0,0 +1,65 @@
+#ifndef GPIOMMAP_H_
+#define GPIOMMAP_H_
+/******************************************************************************/
+/** \file       GpioMmap.h
+ *******************************************************************************
+ *
+ *  \brief      Gpio backend on the memory mapped gpio registers of the AM335x.
+ *              <p>
+ *              The registers of a gpio bank (32 pins) are mapped on the first
+ *              export of one of its pins. Setting an output is a single store
+ *              to SETDATAOUT or CLEARDATAOUT (no system call, no lock), the
+ *              values of several pins of a bank are set with one store to
+ *              each register. The direction is set in the OE register. Gpio
+ *              N is pin N % 32 of bank N / 32, as with sysfs.
+ *              <p>
+ *              The registers are mapped from /dev/mem by default, the gpios
+ *              are also exported through sysfs so the kernel enables the
+ *              clock of the bank and the edges of inputs are handled by the
+ *              gpio event thread (GpioEvent.h). Any other mapping source
+ *              (setGpioMmapDevice, CONFIG_GPIOMMAP_DEVICE or option -m) is
+ *              taken as a register image: a file holding the 4 KiB register
+ *              blocks of the four banks one after the other. Then sysfs is
+ *              not used and edges of inputs are never reported.
+ *              <p>
+ *              The pwms and the lm75 are accessed as with the sysfs backend.
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    setGpioMmapDevice
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+#include "HwBackend.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Physical memory device, the registers are at the bank addresses          */
+#define GPIOMMAP_DEV_MEM       "/dev/mem"
+/** Number of gpio banks of the AM335x                                        */
+#define GPIOMMAP_BANKS         ( 4 )
+/** Size of the register block of a bank                                      */
+#define GPIOMMAP_BANK_SIZE     ( 0x1000 )
+
+/* Register offsets within the block of a bank */
+#define GPIOMMAP_OE            ( 0x134 )  ///< output enable (1: input)
+#define GPIOMMAP_DATAIN        ( 0x138 )  ///< level of the pins
+#define GPIOMMAP_DATAOUT       ( 0x13C )  ///< output value of the pins
+#define GPIOMMAP_CLEARDATAOUT  ( 0x190 )  ///< write 1 to clear an output
+#define GPIOMMAP_SETDATAOUT    ( 0x194 )  ///< write 1 to set an output
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError setGpioMmapDevice(const char * pcDevice);
+
+//----- Data -------------------------------------------------------------------
+/** Memory mapped gpio backend                                                */
+extern const sHwBackend sHwBackendMmap;
+
+#endif /* GPIOMMAP_H_ */
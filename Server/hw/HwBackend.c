@@ -0,0 +1,135 @@
+/******************************************************************************/
+/** \file       HwBackend.c
+ *******************************************************************************
+ *
+ *  \brief      Exchangeable access to the hardware of the webhouse.
+ *              <p>
+ *              Holds the table of all available backends and the selected
+ *              one. The sysfs backend is made of the functions of the gpio,
+ *              gpio event, pwm and lm75 modules.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              selectHwBackend
+ *              getHwBackend
+ *  functions  local:
+ *              .
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+
+#include "HwBackend.h"
+#include "HwSim.h"
+#include "GpioChip.h"
+#include "GpioMmap.h"
+#include "Lm75.h"
+#define LOG_MODULE  HW
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+
+//----- Data -------------------------------------------------------------------
+/** Gpios and pwms through sysfs, lm75 through i2c-dev                        */
+static const sHwBackend sHwBackendSysfs = {
+    "sysfs",
+    exportGpio,
+    unexportGpio,
+    setGpioDirection,
+    setGpioEdge,
+    setGpioValue,
+    getGpioValue,
+    setGpioValues,
+    getGpioValues,
+    initGpioEvent,
+    finalizeGpioEvent,
+    addGpioEvent,
+    enableGpioEvent,
+    isGpioEventEnabled,
+    setPwmState,
+    setPwmPeriod,
+    setPwmDuty,
+    setPwmDutyPercent,
+    getPwmDuty,
+    finalizePwm,
+    startSamplerLm75,
+    stopSamplerLm75,
+    getSampleLm75
+};
+
+/** All available backends, the first one is the default                      */
+static const sHwBackend * const apsBackends[] = {
+    &sHwBackendSysfs,
+    &sHwBackendChip,
+    &sHwBackendMmap,
+    &sHwBackendSim
+};
+
+/** Selected backend                                                          */
+static const sHwBackend * psBackend = &sHwBackendSysfs;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    selectHwBackend
+ ******************************************************************************/
+/** \brief        Selects the backend used to access the hardware
+ *                <p>
+ *                Must be called before initWebhouse(), the backend must not
+ *                be changed afterwards.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcName  name of the backend ("sysfs", "chardev", "mmap"
+ *                        or "sim")
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    unknown backend, the selection is kept
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError selectHwBackend(const char * pcName) {
+
+    uint32_t i;
+
+    for(i = 0; i < (sizeof(apsBackends) / sizeof(apsBackends[0])); i++) {
+        if(strcmp(apsBackends[i]->pcName, pcName) == 0) {
+            psBackend = apsBackends[i];
+            INFOPRINT("hardware backend: %s", psBackend->pcName);
+            return (BBB_SUCCESS);
+        }
+    }
+
+    ERRORPRINT("unknown hardware backend %s", pcName);
+
+    return (BBB_ERR_PARAM);
+}
+
+/*******************************************************************************
+ *  function :    getHwBackend
+ ******************************************************************************/
+/** \brief        Returns the selected backend
+ *
+ *  \type         global
+ *
+ *  \return       operations of the selected backend
+ *
+ ******************************************************************************/
+const sHwBackend * getHwBackend(void) {
+
+    return (psBackend);
+}
@@ -0,0 +1,109 @@
+#ifndef HWBACKEND_H_
+#define HWBACKEND_H_
+/******************************************************************************/
+/** \file       HwBackend.h
+ *******************************************************************************
+ *
+ *  \brief      Exchangeable access to the hardware of the webhouse.
+ *              <p>
+ *              The webhouse and the pir do not call the gpio, pwm and lm75
+ *              modules directly, but the operations of the selected backend.
+ *              The backend is selected once at startup, before initWebhouse()
+ *              is called. The following backends are available:
+ *              <ul>
+ *              <li> sysfs: The gpios and pwms are accessed through sysfs, the
+ *              lm75 through i2c-dev (Gpio.h, Pwm.h, Lm75.h). Default.
+ *              <li> chardev: The gpios are accessed through the gpio character
+ *              device (see GpioChip.h), several lines are set or read with a
+ *              single ioctl. Pwm and lm75 as sysfs.
+ *              <li> mmap: The gpio registers of the AM335x are mapped into the
+ *              process (see GpioMmap.h), outputs are set without a system
+ *              call. Pwm and lm75 as sysfs.
+ *              <li> sim: In-memory simulation of all in- and outputs (see
+ *              HwSim.h), for running the server without a beaglebone.
+ *              </ul>
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              selectHwBackend("sim");
+ *              initWebhouse();
+ *              getHwBackend()->pfSetGpioValue(60, GPIO_VALUE_HIGH);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    selectHwBackend
+ *              getHwBackend
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+#include "Gpio.h"
+#include "GpioEvent.h"
+#include "Pwm.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+/** Operations of a hardware backend, same semantic as the sysfs modules */
+typedef struct _sHwBackend {
+
+    const char * pcName;  ///< name used by selectHwBackend()
+
+    /* Gpio (Gpio.h) */
+    BBBError (*pfExportGpio)(uint32_t u32Gpio);
+    BBBError (*pfUnexportGpio)(uint32_t u32Gpio);
+    BBBError (*pfSetGpioDirection)(uint32_t u32Gpio, eGpioDirection eDir);
+    BBBError (*pfSetGpioEdge)(uint32_t u32Gpio, eGpioEdge eEdge);
+    BBBError (*pfSetGpioValue)(uint32_t u32Gpio, eGpioValue eValue);
+    BBBError (*pfGetGpioValue)(uint32_t u32Gpio, eGpioValue * peValue);
+    BBBError (*pfSetGpioValues)(const uint32_t * au32Gpio,
+                                const eGpioValue * aeValue,
+                                uint32_t u32Count);
+    BBBError (*pfGetGpioValues)(const uint32_t * au32Gpio,
+                                eGpioValue * aeValue,
+                                uint32_t u32Count);
+
+    /* Edges of input gpios (GpioEvent.h) */
+    BBBError (*pfInitGpioEvent)(void);
+    BBBError (*pfFinalizeGpioEvent)(void);
+    BBBError (*pfAddGpioEvent)(uint32_t u32Gpio,
+                               uint32_t u32DebounceMs,
+                               pfGpioEvent pfHandler,
+                               void * pvData);
+    BBBError (*pfEnableGpioEvent)(uint32_t u32Gpio, boolE bEnable);
+    boolE    (*pfIsGpioEventEnabled)(uint32_t u32Gpio);
+
+    /* Pwm (Pwm.h) */
+    BBBError (*pfSetPwmState)(ePwmDevice eDevice, ePwmState eState);
+    BBBError (*pfSetPwmPeriod)(ePwmDevice eDevice, uint32_t u32Period);
+    BBBError (*pfSetPwmDuty)(ePwmDevice eDevice, uint32_t u32Duty);
+    BBBError (*pfSetPwmDutyPercent)(ePwmDevice eDevice, uint8_t u8Percent);
+    BBBError (*pfGetPwmDuty)(ePwmDevice eDevice, uint32_t * pu32Duty);
+    BBBError (*pfFinalizePwm)(void);
+
+    /* Temperature sensors (Lm75.h) */
+    BBBError (*pfStartSamplerTemp)(const uint8_t * pu8Addr,
+                                   uint32_t u32Sensors,
+                                   uint32_t u32PeriodMs);
+    BBBError (*pfStopSamplerTemp)(void);
+    BBBError (*pfGetSampleTemp)(uint32_t u32Sensor,
+                                int32_t * ps32HalfDeg,
+                                uint64_t * pu64StampNs);
+
+} sHwBackend;
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError           selectHwBackend(const char * pcName);
+
+extern const sHwBackend * getHwBackend(void);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* HWBACKEND_H_ */
@@ -0,0 +1,746 @@
+/******************************************************************************/
+/** \file       HwSim.c
+ *******************************************************************************
+ *
+ *  \brief      In-memory simulation of the webhouse hardware.
+ *              <p>
+ *              All state is guarded by a single mutex. The latency of an
+ *              operation is spent before the state is touched and outside
+ *              of the mutex, thus concurrent operations are delayed the
+ *              same way as on the real hardware.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              setSimLatency
+ *              injectSimGpioEdge
+ *              setSimTemp
+ *  functions  local:
+ *              simDelay
+ *              getTimeNs
+ *              findSimEvent
+ *              simExportGpio
+ *              simUnexportGpio
+ *              simSetGpioDirection
+ *              simSetGpioEdge
+ *              simSetGpioValue
+ *              simGetGpioValue
+ *              simSetGpioValues
+ *              simGetGpioValues
+ *              simInitGpioEvent
+ *              simFinalizeGpioEvent
+ *              simAddGpioEvent
+ *              simEnableGpioEvent
+ *              simIsGpioEventEnabled
+ *              simSetPwmState
+ *              simSetPwmPeriod
+ *              simSetPwmDuty
+ *              simSetPwmDutyPercent
+ *              simGetPwmDuty
+ *              simFinalizePwm
+ *              simStartSamplerTemp
+ *              simStopSamplerTemp
+ *              simGetSampleTemp
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "HwSim.h"
+#include "Lm75.h"
+#include "BBBConfig.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of simulated gpios                                                 */
+#define SIM_MAX_GPIOS          ( 128 )
+/** Number of simulated pwm devices                                           */
+#define SIM_MAX_PWMS           ( 3 )
+/** Temperature of every sensor at startup [0.5 degree]                       */
+#define SIM_TEMP_DEFAULT       ( 2 * 30 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Simulated gpio */
+typedef struct _sSimGpio {
+
+    boolE          bExported;  ///< gpio is exported
+    eGpioDirection eDir;       ///< direction
+    eGpioEdge      eEdge;      ///< edges which are reported
+    eGpioValue     eValue;     ///< current value
+
+} sSimGpio;
+
+/** Simulated pwm device */
+typedef struct _sSimPwm {
+
+    ePwmState eState;     ///< running or stopped
+    uint32_t  u32Period;  ///< period [ns]
+    uint32_t  u32Duty;    ///< duty [ns]
+
+} sSimPwm;
+
+/** Watched input gpio */
+typedef struct _sSimEvent {
+
+    boolE       bUsed;          ///< entry in use
+    uint32_t    u32Gpio;        ///< gpio number
+    uint64_t    u64DebounceNs;  ///< edges within this time are dropped
+    uint64_t    u64LastNs;      ///< time of the last handled edge
+    pfGpioEvent pfHandler;      ///< handler of an edge
+    void *      pvData;         ///< user data handed to pfHandler
+    boolE       bEnable;        ///< edges are reported
+
+} sSimEvent;
+
+//----- Function prototypes ----------------------------------------------------
+static void        simDelay(eSimOp eOp);
+static uint64_t    getTimeNs(void);
+static sSimEvent * findSimEvent(uint32_t u32Gpio);
+static BBBError    simExportGpio(uint32_t u32Gpio);
+static BBBError    simUnexportGpio(uint32_t u32Gpio);
+static BBBError    simSetGpioDirection(uint32_t u32Gpio, eGpioDirection eDir);
+static BBBError    simSetGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge);
+static BBBError    simSetGpioValue(uint32_t u32Gpio, eGpioValue eValue);
+static BBBError    simGetGpioValue(uint32_t u32Gpio, eGpioValue * peValue);
+static BBBError    simSetGpioValues(const uint32_t * au32Gpio,
+                                    const eGpioValue * aeValue,
+                                    uint32_t u32Count);
+static BBBError    simGetGpioValues(const uint32_t * au32Gpio,
+                                    eGpioValue * aeValue,
+                                    uint32_t u32Count);
+static BBBError    simInitGpioEvent(void);
+static BBBError    simFinalizeGpioEvent(void);
+static BBBError    simAddGpioEvent(uint32_t u32Gpio,
+                                   uint32_t u32DebounceMs,
+                                   pfGpioEvent pfHandler,
+                                   void * pvData);
+static BBBError    simEnableGpioEvent(uint32_t u32Gpio, boolE bEnable);
+static boolE       simIsGpioEventEnabled(uint32_t u32Gpio);
+static BBBError    simSetPwmState(ePwmDevice eDevice, ePwmState eState);
+static BBBError    simSetPwmPeriod(ePwmDevice eDevice, uint32_t u32Period);
+static BBBError    simSetPwmDuty(ePwmDevice eDevice, uint32_t u32Duty);
+static BBBError    simSetPwmDutyPercent(ePwmDevice eDevice, uint8_t u8Percent);
+static BBBError    simGetPwmDuty(ePwmDevice eDevice, uint32_t * pu32Duty);
+static BBBError    simFinalizePwm(void);
+static BBBError    simStartSamplerTemp(const uint8_t * pu8Addr,
+                                       uint32_t u32Sensors,
+                                       uint32_t u32PeriodMs);
+static BBBError    simStopSamplerTemp(void);
+static BBBError    simGetSampleTemp(uint32_t u32Sensor,
+                                    int32_t * ps32HalfDeg,
+                                    uint64_t * pu64StampNs);
+
+//----- Data -------------------------------------------------------------------
+/** Simulator backend                                                         */
+const sHwBackend sHwBackendSim = {
+    "sim",
+    simExportGpio,
+    simUnexportGpio,
+    simSetGpioDirection,
+    simSetGpioEdge,
+    simSetGpioValue,
+    simGetGpioValue,
+    simSetGpioValues,
+    simGetGpioValues,
+    simInitGpioEvent,
+    simFinalizeGpioEvent,
+    simAddGpioEvent,
+    simEnableGpioEvent,
+    simIsGpioEventEnabled,
+    simSetPwmState,
+    simSetPwmPeriod,
+    simSetPwmDuty,
+    simSetPwmDutyPercent,
+    simGetPwmDuty,
+    simFinalizePwm,
+    simStartSamplerTemp,
+    simStopSamplerTemp,
+    simGetSampleTemp
+};
+
+/** Guards all simulated state                                                */
+static pthread_mutex_t mutexSim = PTHREAD_MUTEX_INITIALIZER;
+/** Latency of every operation group [us]                                     */
+static uint32_t        au32LatencyUs[SIM_OP_COUNT] = {
+    CONFIG_SIM_LATENCY_GPIO_US,
+    CONFIG_SIM_LATENCY_PWM_US,
+    CONFIG_SIM_LATENCY_TEMP_US
+};
+static sSimGpio        asGpio[SIM_MAX_GPIOS];
+static sSimPwm         asPwm[SIM_MAX_PWMS];
+static sSimEvent       asEvent[GPIO_EVENT_MAX_PINS];
+/** Temperature of every sensor [0.5 degree]                                  */
+static int32_t         as32Temp[LM75_MAX_SENSORS] = {
+    SIM_TEMP_DEFAULT, SIM_TEMP_DEFAULT, SIM_TEMP_DEFAULT, SIM_TEMP_DEFAULT,
+    SIM_TEMP_DEFAULT, SIM_TEMP_DEFAULT, SIM_TEMP_DEFAULT, SIM_TEMP_DEFAULT
+};
+/** Number of sensors of the running sampler, 0 if it is stopped              */
+static uint32_t        u32TempSensors = 0;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    setSimLatency
+ ******************************************************************************/
+/** \brief        Sets the latency of a group of simulated operations
+ *
+ *  \type         global
+ *
+ *  \param[in]    eOp           operation group
+ *  \param[in]    u32LatencyUs  latency of every operation of the group [us]
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void setSimLatency(eSimOp eOp, uint32_t u32LatencyUs) {
+
+    if(eOp < SIM_OP_COUNT) {
+        __atomic_store_n(&au32LatencyUs[eOp], u32LatencyUs, __ATOMIC_RELAXED);
+    }
+}
+
+/*******************************************************************************
+ *  function :    injectSimGpioEdge
+ ******************************************************************************/
+/** \brief        Sets the value of a simulated input gpio
+ *                <p>
+ *                If the value changes in the direction of the configured edge
+ *                (setGpioEdge) and the gpio is watched and enabled, its
+ *                handler is called within the calling thread. Edges within the
+ *                debounce time of the gpio are dropped.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Gpio  gpio number
+ *  \param[in]    eValue   new value of the gpio
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    invalid gpio number
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError injectSimGpioEdge(uint32_t u32Gpio, eGpioValue eValue) {
+
+    sSimEvent * psEvent;
+    pfGpioEvent pfHandler = NULL;
+    void *      pvData = NULL;
+    uint64_t    u64Now;
+    boolE       bEdge;
+
+    if(u32Gpio >= SIM_MAX_GPIOS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    u64Now = getTimeNs();
+
+    pthread_mutex_lock(&mutexSim);
+    bEdge = (asGpio[u32Gpio].eValue != eValue) ? TRUE : FALSE;
+    asGpio[u32Gpio].eValue = eValue;
+
+    if((bEdge == TRUE) &&
+       (((eValue == GPIO_VALUE_HIGH) && (asGpio[u32Gpio].eEdge & GPIO_EDGE_RISING)) ||
+        ((eValue == GPIO_VALUE_LOW) && (asGpio[u32Gpio].eEdge & GPIO_EDGE_FALLING)))) {
+
+        psEvent = findSimEvent(u32Gpio);
+        if((psEvent != NULL) && (psEvent->bEnable == TRUE) &&
+           ((psEvent->u64LastNs == 0) ||
+            ((u64Now - psEvent->u64LastNs) >= psEvent->u64DebounceNs))) {
+            psEvent->u64LastNs = u64Now;
+            pfHandler = psEvent->pfHandler;
+            pvData = psEvent->pvData;
+        }
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    if(pfHandler != NULL) {
+        pfHandler(u32Gpio, eValue, u64Now, pvData);
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    setSimTemp
+ ******************************************************************************/
+/** \brief        Sets the temperature of a simulated sensor
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Sensor   index of the sensor
+ *  \param[in]    s32HalfDeg  temperature [0.5 degree]
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    invalid sensor index
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError setSimTemp(uint32_t u32Sensor, int32_t s32HalfDeg) {
+
+    if(u32Sensor >= LM75_MAX_SENSORS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    as32Temp[u32Sensor] = s32HalfDeg;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simDelay
+ ******************************************************************************/
+static void simDelay(eSimOp eOp) {
+
+    struct timespec sDelay;
+    uint32_t        u32Us = __atomic_load_n(&au32LatencyUs[eOp], __ATOMIC_RELAXED);
+
+    if(u32Us != 0) {
+        sDelay.tv_sec = u32Us / 1000000;
+        sDelay.tv_nsec = (u32Us % 1000000) * 1000;
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &sDelay, NULL);
+    }
+}
+
+/*******************************************************************************
+ *  function :    getTimeNs
+ ******************************************************************************/
+static uint64_t getTimeNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t) sNow.tv_sec) * 1000000000uLL + sNow.tv_nsec);
+}
+
+/*******************************************************************************
+ *  function :    findSimEvent
+ ******************************************************************************/
+static sSimEvent * findSimEvent(uint32_t u32Gpio) {
+
+    uint32_t i;
+
+    for(i = 0; i < GPIO_EVENT_MAX_PINS; i++) {
+        if((asEvent[i].bUsed == TRUE) && (asEvent[i].u32Gpio == u32Gpio)) {
+            return (&asEvent[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    simExportGpio
+ ******************************************************************************/
+static BBBError simExportGpio(uint32_t u32Gpio) {
+
+    if(u32Gpio >= SIM_MAX_GPIOS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    asGpio[u32Gpio].bExported = TRUE;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simUnexportGpio
+ ******************************************************************************/
+static BBBError simUnexportGpio(uint32_t u32Gpio) {
+
+    if(u32Gpio >= SIM_MAX_GPIOS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    asGpio[u32Gpio].bExported = FALSE;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetGpioDirection
+ ******************************************************************************/
+static BBBError simSetGpioDirection(uint32_t u32Gpio, eGpioDirection eDir) {
+
+    if((u32Gpio >= SIM_MAX_GPIOS) || (asGpio[u32Gpio].bExported != TRUE)) {
+        return (BBB_FILE_OPEN);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    asGpio[u32Gpio].eDir = eDir;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetGpioEdge
+ ******************************************************************************/
+static BBBError simSetGpioEdge(uint32_t u32Gpio, eGpioEdge eEdge) {
+
+    if((u32Gpio >= SIM_MAX_GPIOS) || (asGpio[u32Gpio].bExported != TRUE)) {
+        return (BBB_FILE_OPEN);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    asGpio[u32Gpio].eEdge = eEdge;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetGpioValue
+ ******************************************************************************/
+static BBBError simSetGpioValue(uint32_t u32Gpio, eGpioValue eValue) {
+
+    if((u32Gpio >= SIM_MAX_GPIOS) || (asGpio[u32Gpio].bExported != TRUE)) {
+        return (BBB_FILE_OPEN);
+    }
+
+    simDelay(SIM_OP_GPIO);
+
+    pthread_mutex_lock(&mutexSim);
+    asGpio[u32Gpio].eValue = eValue;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simGetGpioValue
+ ******************************************************************************/
+static BBBError simGetGpioValue(uint32_t u32Gpio, eGpioValue * peValue) {
+
+    if((u32Gpio >= SIM_MAX_GPIOS) || (asGpio[u32Gpio].bExported != TRUE)) {
+        return (BBB_FILE_OPEN);
+    }
+
+    simDelay(SIM_OP_GPIO);
+
+    pthread_mutex_lock(&mutexSim);
+    *peValue = asGpio[u32Gpio].eValue;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetGpioValues
+ ******************************************************************************/
+static BBBError simSetGpioValues(const uint32_t * au32Gpio,
+                                 const eGpioValue * aeValue,
+                                 uint32_t u32Count) {
+
+    BBBError error = BBB_SUCCESS;
+    uint32_t i;
+
+    simDelay(SIM_OP_GPIO);
+
+    pthread_mutex_lock(&mutexSim);
+    for(i = 0; i < u32Count; i++) {
+        if((au32Gpio[i] >= SIM_MAX_GPIOS) ||
+           (asGpio[au32Gpio[i]].bExported != TRUE)) {
+            error = BBB_FILE_OPEN;
+        } else {
+            asGpio[au32Gpio[i]].eValue = aeValue[i];
+        }
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    simGetGpioValues
+ ******************************************************************************/
+static BBBError simGetGpioValues(const uint32_t * au32Gpio,
+                                 eGpioValue * aeValue,
+                                 uint32_t u32Count) {
+
+    BBBError error = BBB_SUCCESS;
+    uint32_t i;
+
+    simDelay(SIM_OP_GPIO);
+
+    pthread_mutex_lock(&mutexSim);
+    for(i = 0; i < u32Count; i++) {
+        if((au32Gpio[i] >= SIM_MAX_GPIOS) ||
+           (asGpio[au32Gpio[i]].bExported != TRUE)) {
+            aeValue[i] = GPIO_VALUE_LOW;
+            error = BBB_FILE_OPEN;
+        } else {
+            aeValue[i] = asGpio[au32Gpio[i]].eValue;
+        }
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    simInitGpioEvent
+ ******************************************************************************/
+static BBBError simInitGpioEvent(void) {
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simFinalizeGpioEvent
+ ******************************************************************************/
+static BBBError simFinalizeGpioEvent(void) {
+
+    pthread_mutex_lock(&mutexSim);
+    memset(asEvent, 0, sizeof(asEvent));
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simAddGpioEvent
+ ******************************************************************************/
+static BBBError simAddGpioEvent(uint32_t u32Gpio,
+                                uint32_t u32DebounceMs,
+                                pfGpioEvent pfHandler,
+                                void * pvData) {
+
+    BBBError    error = BBB_ERR_PARAM;
+    sSimEvent * psEvent = NULL;
+    uint32_t    i;
+
+    if(pfHandler == NULL) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    if(findSimEvent(u32Gpio) == NULL) {
+        for(i = 0; (i < GPIO_EVENT_MAX_PINS) && (psEvent == NULL); i++) {
+            if(asEvent[i].bUsed != TRUE) {
+                psEvent = &asEvent[i];
+            }
+        }
+    }
+    if(psEvent != NULL) {
+        psEvent->bUsed = TRUE;
+        psEvent->u32Gpio = u32Gpio;
+        psEvent->u64DebounceNs = ((uint64_t) u32DebounceMs) * 1000000uLL;
+        psEvent->u64LastNs = 0;
+        psEvent->pfHandler = pfHandler;
+        psEvent->pvData = pvData;
+        psEvent->bEnable = FALSE;
+        error = BBB_SUCCESS;
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    simEnableGpioEvent
+ ******************************************************************************/
+static BBBError simEnableGpioEvent(uint32_t u32Gpio, boolE bEnable) {
+
+    BBBError    error = BBB_ERR_PARAM;
+    sSimEvent * psEvent;
+
+    pthread_mutex_lock(&mutexSim);
+    psEvent = findSimEvent(u32Gpio);
+    if(psEvent != NULL) {
+        psEvent->bEnable = bEnable;
+        psEvent->u64LastNs = 0;
+        error = BBB_SUCCESS;
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    simIsGpioEventEnabled
+ ******************************************************************************/
+static boolE simIsGpioEventEnabled(uint32_t u32Gpio) {
+
+    boolE       bEnable = FALSE;
+    sSimEvent * psEvent;
+
+    pthread_mutex_lock(&mutexSim);
+    psEvent = findSimEvent(u32Gpio);
+    if(psEvent != NULL) {
+        bEnable = psEvent->bEnable;
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    return (bEnable);
+}
+
+/*******************************************************************************
+ *  function :    simSetPwmState
+ ******************************************************************************/
+static BBBError simSetPwmState(ePwmDevice eDevice, ePwmState eState) {
+
+    if(eDevice >= SIM_MAX_PWMS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    simDelay(SIM_OP_PWM);
+
+    pthread_mutex_lock(&mutexSim);
+    asPwm[eDevice].eState = eState;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetPwmPeriod
+ ******************************************************************************/
+static BBBError simSetPwmPeriod(ePwmDevice eDevice, uint32_t u32Period) {
+
+    if(eDevice >= SIM_MAX_PWMS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    simDelay(SIM_OP_PWM);
+
+    pthread_mutex_lock(&mutexSim);
+    asPwm[eDevice].u32Period = u32Period;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetPwmDuty
+ ******************************************************************************/
+static BBBError simSetPwmDuty(ePwmDevice eDevice, uint32_t u32Duty) {
+
+    if(eDevice >= SIM_MAX_PWMS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    simDelay(SIM_OP_PWM);
+
+    pthread_mutex_lock(&mutexSim);
+    asPwm[eDevice].u32Duty = u32Duty;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simSetPwmDutyPercent
+ ******************************************************************************/
+static BBBError simSetPwmDutyPercent(ePwmDevice eDevice, uint8_t u8Percent) {
+
+    if((eDevice >= SIM_MAX_PWMS) || (u8Percent > 100)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    simDelay(SIM_OP_PWM);
+
+    pthread_mutex_lock(&mutexSim);
+    asPwm[eDevice].u32Duty = (asPwm[eDevice].u32Period / 100) * u8Percent;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simGetPwmDuty
+ ******************************************************************************/
+static BBBError simGetPwmDuty(ePwmDevice eDevice, uint32_t * pu32Duty) {
+
+    if(eDevice >= SIM_MAX_PWMS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    simDelay(SIM_OP_PWM);
+
+    pthread_mutex_lock(&mutexSim);
+    *pu32Duty = asPwm[eDevice].u32Duty;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simFinalizePwm
+ ******************************************************************************/
+static BBBError simFinalizePwm(void) {
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simStartSamplerTemp
+ ******************************************************************************/
+static BBBError simStartSamplerTemp(const uint8_t * pu8Addr,
+                                    uint32_t u32Sensors,
+                                    uint32_t u32PeriodMs) {
+
+    if((u32Sensors == 0) || (u32Sensors > LM75_MAX_SENSORS)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    pthread_mutex_lock(&mutexSim);
+    u32TempSensors = u32Sensors;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simStopSamplerTemp
+ ******************************************************************************/
+static BBBError simStopSamplerTemp(void) {
+
+    pthread_mutex_lock(&mutexSim);
+    u32TempSensors = 0;
+    pthread_mutex_unlock(&mutexSim);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    simGetSampleTemp
+ ******************************************************************************/
+static BBBError simGetSampleTemp(uint32_t u32Sensor,
+                                 int32_t * ps32HalfDeg,
+                                 uint64_t * pu64StampNs) {
+
+    BBBError error = BBB_ERR_PARAM;
+
+    simDelay(SIM_OP_TEMP);
+
+    pthread_mutex_lock(&mutexSim);
+    if(u32Sensor < u32TempSensors) {
+        *ps32HalfDeg = as32Temp[u32Sensor];
+        error = BBB_SUCCESS;
+    }
+    pthread_mutex_unlock(&mutexSim);
+
+    if((error == BBB_SUCCESS) && (pu64StampNs != NULL)) {
+        *pu64StampNs = getTimeNs();
+    }
+
+    return (error);
+}
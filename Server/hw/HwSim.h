@@ -0,0 +1,70 @@
+#ifndef HWSIM_H_
+#define HWSIM_H_
+/******************************************************************************/
+/** \file       HwSim.h
+ *******************************************************************************
+ *
+ *  \brief      In-memory simulation of the webhouse hardware.
+ *              <p>
+ *              The simulator backend (sHwBackendSim, see HwBackend.h) keeps
+ *              the state of all gpios, pwms and temperature sensors in
+ *              memory, thus the server runs on any linux box. Every operation
+ *              can be delayed by a configurable latency to mimic the real
+ *              hardware (setSimLatency, defaults in BBBConfig.h).
+ *              <p>
+ *              Edges of input gpios are injected with injectSimGpioEdge(),
+ *              the handler registered for the gpio is called within the
+ *              injecting thread (with the same debounce and enable rules as
+ *              the gpio event thread). Temperatures are set with setSimTemp().
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              selectHwBackend("sim");
+ *              setSimLatency(SIM_OP_PWM, 200);
+ *              initWebhouse();
+ *              enableAlarm();
+ *              injectSimGpioEdge(30, GPIO_VALUE_HIGH);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    setSimLatency
+ *              injectSimGpioEdge
+ *              setSimTemp
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+#include "HwBackend.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+/** Groups of simulated operations with their own latency */
+typedef enum _eSimOp {
+
+    SIM_OP_GPIO  = 0,  ///< gpio read/write
+    SIM_OP_PWM   = 1,  ///< pwm read/write
+    SIM_OP_TEMP  = 2,  ///< temperature sample
+    SIM_OP_COUNT = 3   ///< number of operation groups
+
+} eSimOp;
+
+//----- Function prototypes ----------------------------------------------------
+extern void     setSimLatency(eSimOp eOp, uint32_t u32LatencyUs);
+
+extern BBBError injectSimGpioEdge(uint32_t u32Gpio, eGpioValue eValue);
+
+extern BBBError setSimTemp(uint32_t u32Sensor, int32_t s32HalfDeg);
+
+//----- Data -------------------------------------------------------------------
+/** Simulator backend                                                         */
+extern const sHwBackend sHwBackendSim;
+
+#endif /* HWSIM_H_ */
@@ -11,6 +11,16 @@
  *              readings with an accuracy of +/-2°C from -25°C to 100°C and
  *              +/-3°C over -55°C to 125°C. The temperature data output of the
  *              LM75 is available at all times via the I2C bus.
+ *              <p>
+ *              The register pointer write and the read of the temperature
+ *              register are combined into one I2C_RDWR transaction (repeated
+ *              start). Several sensors on the same bus are read within one
+ *              single ioctl(2).
+ *              <p>
+ *              The sampler thread keeps the bus open and reads all sensors
+ *              periodically. The last samples and their timestamp are
+ *              published with a sequence lock (SeqLock.h), thus readers never
+ *              wait for the bus.
  *
  *  \author     wht4
  *
@@ -18,13 +28,22 @@
  *
  *  \remark     Last Modification
  *               \li wht4, August 2013, Created
+ *               \li wht4, October 2026, Sampler thread
+ *               \li wht4, October 2026, I2C_RDWR, several sensors
  *
  ******************************************************************************/
 /*
  *  functions  global:
  *              readTempLm75
+ *              startSamplerLm75
+ *              stopSamplerLm75
+ *              getSampleLm75
  *  functions  local:
- *              .
+ *              openLm75
+ *              transferLm75
+ *              decodeTemp
+ *              sampleSensors
+ *              samplerThread
  *
  ******************************************************************************/
 
@@ -34,23 +53,56 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "Lm75.h"
+#define LOG_MODULE  HW
 #include "Log.h"
+#include "SeqLock.h"
+#include "BBBSignal.h"
 
 //----- Macros -----------------------------------------------------------------
 #define LM75_MAX_BUFFER    ( 64 )
+/** Temperature register of the LM75                                          */
+#define LM75_REG_TEMP      ( 0x00 )
 
 //----- Data types -------------------------------------------------------------
 
 //----- Function prototypes ----------------------------------------------------
+static BBBError openLm75(int * fd);
+static BBBError transferLm75(int fd,
+                             const uint8_t * pu8Addr,
+                             uint32_t u32Sensors,
+                             uint8_t au8Buffer[][2]);
+static int32_t  decodeTemp(const uint8_t au8Buffer[2]);
+static BBBError sampleSensors(void);
+static void *   samplerThread(void * pvData);
 
 //----- Data -------------------------------------------------------------------
+/** Thread wherein the sensors are sampled                                    */
+static pthread_t idSampler;
+/** TRUE while the sampler thread exists                                      */
+static boolE     samplerStarted = FALSE;
+/** Sample period [ms]                                                        */
+static uint32_t  u32SamplePeriodMs = 1000;
+/** Bus of the sensors, kept open by the sampler (-1 if closed)               */
+static int       fdSampler = -1;
+/** Addresses of the sampled sensors                                          */
+static uint8_t   au8SensorAddr[LM75_MAX_SENSORS];
+static uint32_t  u32SensorCount = 0;
+
+/** Publication of the last samples, written by the sampler thread only       */
+static sSeqLock  sSampleLock = SEQLOCK_INITIALIZER;
+static int32_t   as32SampleTemp[LM75_MAX_SENSORS];
+static boolE     abSampleValid[LM75_MAX_SENSORS];
+static uint64_t  au64SampleStamp[LM75_MAX_SENSORS];
 
 //----- Implementation ---------------------------------------------------------
 
@@ -71,7 +123,6 @@
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
- *                BBB_FILE_IOCTL   Error in device control
  *                BBB_FILE_READ    Failed to read temperature value
  *                </pre>
  *
@@ -84,56 +135,381 @@
  ******************************************************************************/
 BBBError readTempLm75(int32_t *ps32Temp) {
 
-    int fd;
-    uint8_t u8Buffer[2];
+    int      fd;
+    uint8_t  u8Addr = LM75_ADDR;
+    uint8_t  au8Buffer[1][2];
+    BBBError error = BBB_SUCCESS;
+
+    if ((error = openLm75(&fd)) == BBB_SUCCESS) {
+
+        error = transferLm75(fd, &u8Addr, 1, au8Buffer);
+        if (error == BBB_SUCCESS) {
+            /* Currently we are not interested in half degrees */
+            *ps32Temp = decodeTemp(au8Buffer[0]) >> 1;
+        }
+        close(fd);
+    }
+
+    return(error);
+}
+
+/*******************************************************************************
+ *  function :    startSamplerLm75
+ ******************************************************************************/
+/** \brief        Starts to sample the temperature of several sensors
+ *                periodically
+ *                <p>
+ *                The first sample is taken before this function returns, the
+ *                following ones by the sampler thread every u32PeriodMs. All
+ *                sensors are read within one bus transaction, the bus is kept
+ *                open while the sampler is running.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pu8Addr      I2C addresses of the sensors
+ *  \param[in]    u32Sensors   number of sensors [1,LM75_MAX_SENSORS]
+ *  \param[in]    u32PeriodMs  sample period [ms], at least 300ms (see
+ *                             readTempLm75)
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_ERR_PARAM      invalid number of sensors
+ *                BBB_THREAD_RUNNING the sampler is already running
+ *                BBB_THREAD_CREATE  the thread could not be created
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError startSamplerLm75(const uint8_t * pu8Addr,
+                          uint32_t u32Sensors,
+                          uint32_t u32PeriodMs) {
+
+    if (samplerStarted == TRUE) {
+        return (BBB_THREAD_RUNNING);
+    }
+    if ((u32Sensors == 0) || (u32Sensors > LM75_MAX_SENSORS)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    memcpy(au8SensorAddr, pu8Addr, u32Sensors);
+    u32SensorCount = u32Sensors;
+    u32SamplePeriodMs = u32PeriodMs;
+
+    sampleSensors();
+
+    if (pthread_create(&idSampler, NULL, samplerThread, NULL) != 0) {
+        ERRORPRINT("can't create thread");
+        return (BBB_THREAD_CREATE);
+    }
+    samplerStarted = TRUE;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    stopSamplerLm75
+ ******************************************************************************/
+/** \brief        Stops the sampler thread and closes the bus
+ *                <p>
+ *                The last samples stay available.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_THREAD_RUNNING the sampler is not running
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError stopSamplerLm75(void) {
+
+    if (samplerStarted == FALSE) {
+        return (BBB_THREAD_RUNNING);
+    }
+
+    pthread_cancel(idSampler);
+    pthread_join(idSampler, NULL);
+    samplerStarted = FALSE;
+
+    if (fdSampler >= 0) {
+        close(fdSampler);
+        fdSampler = -1;
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    getSampleLm75
+ ******************************************************************************/
+/** \brief        Get the last sampled temperature of a sensor
+ *                <p>
+ *                Never blocks, neither on the bus nor on the sampler thread.
+ *                A failed read keeps the previous sample, thus the caller
+ *                has to check the age of the sample (pu64StampNs).
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Sensor     index of the sensor (as passed to
+ *                              startSamplerLm75)
+ *  \param[out]   ps32HalfDeg   Temperature in 0.5 degree celsius
+ *  \param[out]   pu64StampNs   Time of the last successful read of the
+ *                              sensor [ns] (CLOCK_MONOTONIC), may be NULL
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_ERR_PARAM    invalid sensor
+ *                BBB_FILE_READ    the sensor could not be read so far
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError getSampleLm75(uint32_t u32Sensor,
+                       int32_t *ps32HalfDeg,
+                       uint64_t *pu64StampNs) {
+
+    uint32_t u32Seq;
+    int32_t  s32Temp;
+    uint64_t u64Stamp;
+    boolE    bValid;
+
+    if (u32Sensor >= LM75_MAX_SENSORS) {
+        return (BBB_ERR_PARAM);
+    }
+
+    do {
+        u32Seq = readSeqLockBegin(&sSampleLock);
+        s32Temp = __atomic_load_n(&as32SampleTemp[u32Sensor], __ATOMIC_RELAXED);
+        bValid = __atomic_load_n(&abSampleValid[u32Sensor], __ATOMIC_RELAXED);
+        u64Stamp = __atomic_load_n(&au64SampleStamp[u32Sensor],
+                                   __ATOMIC_RELAXED);
+    } while (readSeqLockRetry(&sSampleLock, u32Seq) == TRUE);
+
+    if (bValid == FALSE) {
+        return (BBB_FILE_READ);
+    }
+
+    *ps32HalfDeg = s32Temp;
+    if (pu64StampNs != NULL) {
+        *pu64StampNs = u64Stamp;
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    openLm75
+ ******************************************************************************/
+static BBBError openLm75(int * fd) {
+
     BBBError error = BBB_SUCCESS;
 
-    if ((fd = open(LM75_DEVICE, O_RDWR)) < 0) {
+    if ((*fd = open(LM75_DEVICE, O_RDWR | O_CLOEXEC)) < 0) {
         ERRORPRINT("Failed to open the bus " LM75_DEVICE);
         error = BBB_FILE_OPEN;
+    }
 
-    } else {
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    transferLm75
+ ******************************************************************************/
+/** \brief        Reads the temperature register of several sensors within one
+ *                I2C_RDWR transaction
+ *                <p>
+ *                Every sensor gets two messages: the write of the register
+ *                pointer and the read of the 2 byte register. The read
+ *                follows with a repeated start, no other master can change
+ *                the pointer in between.
+ *
+ *  \type         static
+ *
+ *  \param[in]    fd          opened bus
+ *  \param[in]    pu8Addr     addresses of the sensors
+ *  \param[in]    u32Sensors  number of sensors [1,LM75_MAX_SENSORS]
+ *  \param[out]   au8Buffer   raw temperature register of every sensor
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_READ    the transaction failed
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError transferLm75(int fd,
+                             const uint8_t * pu8Addr,
+                             uint32_t u32Sensors,
+                             uint8_t au8Buffer[][2]) {
+
+    static uint8_t             u8Pointer = LM75_REG_TEMP;
+    struct i2c_msg             asMsg[2 * LM75_MAX_SENSORS];
+    struct i2c_rdwr_ioctl_data sData;
+    uint32_t                   i;
+
+    for (i = 0; i < u32Sensors; i++) {
 
-        if (ioctl(fd, I2C_SLAVE, LM75_ADDR) < 0) {
-            ERRORPRINT("Failed to acquire bus access " LM75_DEVICE);
-            error = BBB_FILE_IOCTL;
-        } else {
-
-            /* Set read pointer to address 0x00 */
-            write(fd, (char) 0x00, 1);
-
-            /* Temperature data is represented by a 9-bit, two's complement   */
-            /* word with an LSB (Least Significant Bit) equal to 0.5Grad      */
-            /* Celcius:                                                       */
-            /* +125Grad       0 1111 1010             0FAh                    */
-            /* +25Grad        0 0011 0010             032h                    */
-            /* +0.5Grad       0 0000 0001             001h                    */
-            /* 0Grad          0 0000 0000             000h                    */
-            /* −0.5Grad       1 1111 1111             1FFh                    */
-            /* −25Grad        1 1100 1110             1CEh                    */
-            /* −55Grad        1 1001 0010             192h                    */
-            /* The first data byte is the most significant byte with most     */
-            /* significant bit first                                          */
-            if(read(fd, u8Buffer, 2) == 2) {
-
-                *ps32Temp = 0;
-                if((u8Buffer[0] & 0x80) > 0) {
-                    *ps32Temp = 0xffffff00;
-                }
-                *ps32Temp |= (u8Buffer[0] & 0x7f) << 1;
-                *ps32Temp |= ((u8Buffer[1] >> 7) & 1);
-                /* Currently we are not interested in half degrees */
-                *ps32Temp = *ps32Temp >> 1;
+        asMsg[2 * i].addr = pu8Addr[i];
+        asMsg[2 * i].flags = 0;
+        asMsg[2 * i].len = 1;
+        asMsg[2 * i].buf = &u8Pointer;
 
+        asMsg[2 * i + 1].addr = pu8Addr[i];
+        asMsg[2 * i + 1].flags = I2C_M_RD;
+        asMsg[2 * i + 1].len = 2;
+        asMsg[2 * i + 1].buf = au8Buffer[i];
+    }
+
+    sData.msgs = asMsg;
+    sData.nmsgs = 2 * u32Sensors;
+
+    if (ioctl(fd, I2C_RDWR, &sData) != (int) sData.nmsgs) {
+        return (BBB_FILE_READ);
+    }
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    decodeTemp
+ ******************************************************************************/
+/** \brief        Decodes the temperature register
+ *
+ *  \type         static
+ *
+ *  \param[in]    au8Buffer   raw temperature register (MSB first)
+ *
+ *  \return       Temperature in 0.5 degree celsius
+ *
+ ******************************************************************************/
+static int32_t decodeTemp(const uint8_t au8Buffer[2]) {
+
+    /* Temperature data is represented by a 9-bit, two's complement   */
+    /* word with an LSB (Least Significant Bit) equal to 0.5Grad      */
+    /* Celcius:                                                       */
+    /* +125Grad       0 1111 1010             0FAh                    */
+    /* +25Grad        0 0011 0010             032h                    */
+    /* +0.5Grad       0 0000 0001             001h                    */
+    /* 0Grad          0 0000 0000             000h                    */
+    /* −0.5Grad       1 1111 1111             1FFh                    */
+    /* −25Grad        1 1100 1110             1CEh                    */
+    /* −55Grad        1 1001 0010             192h                    */
+    /* The first data byte is the most significant byte with most     */
+    /* significant bit first, the 9 bits are left aligned.            */
+    return (((int16_t) ((au8Buffer[0] << 8) | au8Buffer[1])) >> 7);
+}
+
+/*******************************************************************************
+ *  function :    sampleSensors
+ ******************************************************************************/
+/** \brief        Reads all sensors and publishes the samples
+ *                <p>
+ *                Normally all sensors are read within one transaction. If
+ *                this fails (e.g. a sensor does not answer), the sensors are
+ *                read one by one, so the others are still sampled. If no
+ *                sensor answers, the bus is closed and opened again for the
+ *                next sample.
+ *
+ *  \type         static
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      at least one sensor was read
+ *                BBB_FILE_OPEN    the bus could not be opened
+ *                BBB_FILE_READ    no sensor could be read
+ *                </pre>
+ *
+ ******************************************************************************/
+static BBBError sampleSensors(void) {
+
+    uint8_t         au8Buffer[LM75_MAX_SENSORS][2];
+    boolE           abValid[LM75_MAX_SENSORS];
+    boolE           bAnyValid = FALSE;
+    struct timespec sNow;
+    uint64_t        u64Now;
+    uint32_t        i;
+
+    if ((fdSampler < 0) && (openLm75(&fdSampler) != BBB_SUCCESS)) {
+        return (BBB_FILE_OPEN);
+    }
+
+    if (transferLm75(fdSampler, au8SensorAddr, u32SensorCount,
+                     au8Buffer) == BBB_SUCCESS) {
+        for (i = 0; i < u32SensorCount; i++) {
+            abValid[i] = TRUE;
+        }
+        bAnyValid = TRUE;
+    } else {
+        for (i = 0; i < u32SensorCount; i++) {
+            abValid[i] = (transferLm75(fdSampler, &au8SensorAddr[i], 1,
+                                       &au8Buffer[i]) == BBB_SUCCESS) ?
+                         TRUE : FALSE;
+            if (abValid[i] == TRUE) {
+                bAnyValid = TRUE;
             } else {
-                ERRORPRINT("Failed to read from LM75 at bus " LM75_DEVICE);
-                error = BBB_FILE_READ;
+                ERRORPRINT("Failed to read from LM75 0x%x at bus "
+                           LM75_DEVICE, au8SensorAddr[i]);
             }
+        }
+    }
 
-            close(fd);
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    u64Now = ((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec;
+
+    /* A failed read keeps the previous sample, only its stamp ages */
+    writeSeqLockBegin(&sSampleLock);
+    for (i = 0; i < u32SensorCount; i++) {
+        if (abValid[i] == TRUE) {
+            __atomic_store_n(&as32SampleTemp[i], decodeTemp(au8Buffer[i]),
+                             __ATOMIC_RELAXED);
+            __atomic_store_n(&au64SampleStamp[i], u64Now, __ATOMIC_RELAXED);
+            __atomic_store_n(&abSampleValid[i], TRUE, __ATOMIC_RELAXED);
         }
     }
+    writeSeqLockEnd(&sSampleLock);
 
-    return(error);
+    if (bAnyValid == FALSE) {
+        close(fdSampler);
+        fdSampler = -1;
+        return (BBB_FILE_READ);
+    }
+
+    return (BBB_SUCCESS);
 }
 
+/*******************************************************************************
+ *  function :    samplerThread
+ ******************************************************************************/
+/** \brief        Samples the sensors every u32SamplePeriodMs
+ *                <p>
+ *                The thread sleeps until absolute points in time, thus the
+ *                duration of the bus access does not add up. The thread is
+ *                stopped by stopSamplerLm75() (pthread_cancel).
+ *
+ *  \type         static
+ *
+ *  \param[in]    pvData  not used
+ *
+ *  \return       not used
+ *
+ ******************************************************************************/
+static void * samplerThread(void * pvData) {
+
+    struct timespec sNext;
+
+    /* Block all signals for this thread */
+    blockAllSignalForThread();
+
+    clock_gettime(CLOCK_MONOTONIC, &sNext);
+
+    while(1) {
+
+        sNext.tv_sec += u32SamplePeriodMs / 1000;
+        sNext.tv_nsec += (u32SamplePeriodMs % 1000) * 1000000L;
+        if (sNext.tv_nsec >= 1000000000L) {
+            sNext.tv_sec++;
+            sNext.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sNext, NULL);
+
+        sampleSensors();
+    }
+
+    pthread_exit(NULL);
+}
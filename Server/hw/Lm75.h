@@ -13,12 +13,21 @@
  *              readings with an accuracy of +/-2°C from -25°C to 100°C and
  *              +/-3°C over -55°C to 125°C. The temperature data output of the
  *              LM75 is available at all times via the I2C bus.
+ *              <p>
+ *              The temperature can either be read directly (readTempLm75)
+ *              or be sampled periodically by a thread (startSamplerLm75).
+ *              The sampler reads up to LM75_MAX_SENSORS sensors on the same
+ *              bus within one transaction. getSampleLm75() returns the last
+ *              sample of a sensor (in 0.5 degree) without blocking.
  *
  *  \author     wht4
  *
  ******************************************************************************/
 /*
  *  function    readTempLm75
+ *              startSamplerLm75
+ *              stopSamplerLm75
+ *              getSampleLm75
  *
  ******************************************************************************/
 
@@ -30,12 +39,24 @@
 //----- Macros -----------------------------------------------------------------
 #define LM75_DEVICE        "/dev/i2c-1"
 #define LM75_ADDR          ( 0x48 )
+/** Number of sensors the sampler can read (address 0x48 to 0x4f)            */
+#define LM75_MAX_SENSORS   ( 8 )
 
 //----- Data types -------------------------------------------------------------
 
 //----- Function prototypes ----------------------------------------------------
 extern BBBError readTempLm75(int32_t *ps32Temp);
 
+extern BBBError startSamplerLm75(const uint8_t * pu8Addr,
+                                 uint32_t u32Sensors,
+                                 uint32_t u32PeriodMs);
+
+extern BBBError stopSamplerLm75(void);
+
+extern BBBError getSampleLm75(uint32_t u32Sensor,
+                              int32_t *ps32HalfDeg,
+                              uint64_t *pu64StampNs);
+
 //----- Data -------------------------------------------------------------------
 
 #endif /* LM75_H_ */
@@ -13,6 +13,11 @@
  *              by calling isPollThreadRunning(). To see if a motion was
  *              detected, isAlarmOn() can be called. To start a new motion
  *              detection resetAlarmPir() must be called.
+ *              <p>
+ *              The edges of the pir are handled by the gpio event thread
+ *              (GpioEvent.h), a motion within PIR_DEBOUNCE_MS after the last
+ *              one is ignored. Every motion is queued with its timestamp in a
+ *              lock-free ring (EventRing.h), read by readEventsPir().
  *
  *  \author     wht4
  *
@@ -20,6 +25,9 @@
  *
  *  \remark     Last Modification
  *               \li wht4, August 2013, Created
+ *               \li wht4, October 2026, Edges handled by the gpio event thread
+ *               \li wht4, October 2026, Motions queued in an event ring
+ *               \li wht4, October 2026, Hardware accessed through a backend
  *
  ******************************************************************************/
 /*
@@ -31,37 +39,41 @@
  *              isPollThreadRunning
  *              isAlarmOn
  *              resetAlarmPir
+ *              readEventsPir
  *  functions  local:
- *              pollPirThread
+ *              onPirEdge
  *
  ******************************************************************************/
 
 //----- Header-Files -----------------------------------------------------------
-#include <pthread.h>
-#include <unistd.h>
-
 #include "Pir.h"
 #include "Gpio.h"
+#include "HwBackend.h"
+#define LOG_MODULE  HW
 #include "Log.h"
-#include "BBBSignal.h"
 
 //----- Macros -----------------------------------------------------------------
 #define GPIO_PIR         ( 30 )
+/** Motions within this time [ms] after the last one are ignored              */
+#define PIR_DEBOUNCE_MS  ( 2000 )
+/** Number of motions discarded at once by resetAlarmPir()                    */
+#define PIR_EVENT_BATCH  ( 8 )
 
 //----- Data types -------------------------------------------------------------
 
 //----- Function prototypes ----------------------------------------------------
-static void * pollPirThread(void * pvData);
+static void onPirEdge(uint32_t u32Gpio,
+                      eGpioValue eValue,
+                      uint64_t u64StampNs,
+                      void * pvData);
 
 //----- Data -------------------------------------------------------------------
-/** Thread wherein the gpio of the pir is polled with the system call poll(2) */
-static pthread_t       idThread = 0;
-/** Mutex to guard access to the mutual resource pirAlarm                     */
-static pthread_mutex_t mutexAlaram = PTHREAD_MUTEX_INITIALIZER;
-/** Set to TRUE if a motion was detected, FALSE otherwise                     */
-static boolE           pirAlarm = FALSE;
-/** Start polling the gpio                                                    */
-static boolE           started = FALSE;
+/** TRUE if the pir is watched by the gpio event thread                       */
+static boolE           initialized = FALSE;
+/** Backend used to access the hardware, set by initPir()                     */
+static const sHwBackend * psHw = NULL;
+/** Detected motions, pushed by the gpio event thread                        */
+static sEventRing      sPirEvents;
 
 //----- Implementation ---------------------------------------------------------
 
@@ -71,7 +83,9 @@ static boolE           started = FALSE;
 /** \brief        Initialize the pir module
  *                <p>
  *                Must be called before any other function of this module.
- *                Initializes the pir gpio pin as input with rising edge.
+ *                Initializes the pir gpio pin as input with rising edge and
+ *                registers it at the gpio event thread (initGpioEvent() must
+ *                be called before).
  *
  *  \type         global
  *
@@ -86,17 +100,20 @@ BBBError initPir(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = exportGpio(GPIO_PIR);
-    error |= setGpioDirection(GPIO_PIR, GPIO_DIR_IN);
-    error |= setGpioEdge(GPIO_PIR, GPIO_EDGE_RISING);
-
-    if(pthread_create(&idThread,
-                      NULL,
-                      pollPirThread,
-                      NULL) != 0) {
+    psHw = getHwBackend();
+    error = psHw->pfExportGpio(GPIO_PIR);
+    error |= psHw->pfSetGpioDirection(GPIO_PIR, GPIO_DIR_IN);
+    error |= psHw->pfSetGpioEdge(GPIO_PIR, GPIO_EDGE_RISING);
 
-    	ERRORPRINT("can't create thread");
-    	error = BBB_THREAD_CREATE;
+    initEventRing(&sPirEvents);
+    if(error == BBB_SUCCESS) {
+        error = psHw->pfAddGpioEvent(GPIO_PIR, PIR_DEBOUNCE_MS,
+                                     onPirEdge, NULL);
+    }
+    if(error == BBB_SUCCESS) {
+        initialized = TRUE;
+    } else {
+        ERRORPRINT("can't watch pir");
     }
 
     return (error);
@@ -108,8 +125,7 @@ BBBError initPir(void) {
 BBBError finalizePir(void) {
 
     stopPollPir();
-    pthread_mutex_destroy(&mutexAlaram);
-    return (unexportGpio(GPIO_PIR));
+    return (psHw->pfUnexportGpio(GPIO_PIR));
 }
 
 /*******************************************************************************
@@ -132,14 +148,9 @@ BBBError finalizePir(void) {
  ******************************************************************************/
 BBBError startPollPir(void) {
 
-    BBBError error = BBB_SUCCESS;
-
     resetAlarmPir();
-    pthread_mutex_lock(&mutexAlaram);
-	started = TRUE;
-	pthread_mutex_unlock(&mutexAlaram);
 
-    return (error);
+    return (psHw->pfEnableGpioEvent(GPIO_PIR, TRUE));
 }
 
 /*******************************************************************************
@@ -160,13 +171,7 @@ BBBError startPollPir(void) {
  ******************************************************************************/
 BBBError stopPollPir(void) {
 
-    BBBError error = BBB_SUCCESS;
-
-    pthread_mutex_lock(&mutexAlaram);
-	started = FALSE;
-	pthread_mutex_unlock(&mutexAlaram);
-
-    return (error);
+    return (psHw->pfEnableGpioEvent(GPIO_PIR, FALSE));
 }
 
 /*******************************************************************************
@@ -184,13 +189,11 @@ BBBError stopPollPir(void) {
  ******************************************************************************/
 boolE isPollThreadRunning(void) {
 
-    boolE running = FALSE;
-
-    pthread_mutex_lock(&mutexAlaram);
-    running = started;
-	pthread_mutex_unlock(&mutexAlaram);
+    if(initialized != TRUE) {
+        return (FALSE);
+    }
 
-    return (running);
+    return (psHw->pfIsGpioEventEnabled(GPIO_PIR));
 }
 
 /*******************************************************************************
@@ -198,10 +201,9 @@ boolE isPollThreadRunning(void) {
  ******************************************************************************/
 /** \brief        Returns TRUE if any movement within the webhouse was detected.
  *                <p>
- *                If a movement was detected, the pir thread will set pirAlarm
- *                to TRUE. With the help of this function, the state of
- *                pirAlarm can be checked. To start a new motion detection, and
- *                thus setting pirAlarm to FALSE can be done with resetAlarmPir().
+ *                Returns TRUE as long as motions are queued which were not
+ *                yet read by readEventsPir() or discarded by resetAlarmPir().
+ *                Must only be called by the thread reading the events.
  *                initPir() must be called before this function can be called.
  *
  *  \type         global
@@ -213,10 +215,8 @@ boolE isAlarmOn(void) {
 
     boolE isAlarm = FALSE;
 
-    if(idThread != 0) {
-        pthread_mutex_lock(&mutexAlaram);
-        isAlarm = pirAlarm;
-        pthread_mutex_unlock(&mutexAlaram);
+    if(initialized == TRUE) {
+        isAlarm = (isEmptyEventRing(&sPirEvents) == TRUE) ? FALSE : TRUE;
     }
 
     return (isAlarm);
@@ -227,10 +227,9 @@ boolE isAlarmOn(void) {
  ******************************************************************************/
 /** \brief        Reset the alarm to start a new motion detection.
  *                <p>
- *                If a movement was detected, the pir thread will set pirAlarm
- *                to TRUE. To start a new motion detection, resetAlarmPir()
- *                can be called. This will set pirAlarm to FALSE.
- *                initPir() must be called before this function can be called.
+ *                Discards all queued motions. Must only be called by the
+ *                thread reading the events. initPir() must be called before
+ *                this function can be called.
  *
  *  \type         global
  *
@@ -239,63 +238,77 @@ boolE isAlarmOn(void) {
  ******************************************************************************/
 void resetAlarmPir(void) {
 
-    if(idThread != 0) {
-        pthread_mutex_lock(&mutexAlaram);
-        pirAlarm = FALSE;
-        pthread_mutex_unlock(&mutexAlaram);
+    sInputEvent asEvents[PIR_EVENT_BATCH];
+    uint32_t    u32Events;
+
+    if(initialized == TRUE) {
+        while(popEventRing(&sPirEvents, asEvents, PIR_EVENT_BATCH,
+                           &u32Events) == BBB_SUCCESS) {
+        }
     }
 }
 
 /*******************************************************************************
- *  function :    pollPirThread
+ *  function :    readEventsPir
  ******************************************************************************/
-/** \brief        Polls the pir gpio and thus waits on any movement within the
- *                webhouse.
+/** \brief        Reads the detected motions in the order they occurred.
  *                <p>
- *                Thread will be started/stopped with a call to
- *                startPollPirThread respectively stopPollPirThread. Sets
- *                pirAlarm to TRUE if any movement was detected. To start a
- *                new motion detection, resetAlarmPir() can be called.
+ *                Every motion is returned once, with its time and a sequence
+ *                number. The sequence numbers are consecutive, motions lost
+ *                because the queue was full are reported as a warning. Must
+ *                only be called by a single thread. initPir() must be called
+ *                before this function can be called.
  *
- *  \type         static
+ *  \type         global
  *
- *  \param[in]    pvData  not used
+ *  \param[out]   asEvents      detected motions
+ *  \param[in]    u32MaxEvents  number of elements of asEvents
  *
- *  \return       not used
+ *  \return       number of motions written to asEvents
  *
  ******************************************************************************/
-static void * pollPirThread(void * pvData) {
+uint32_t readEventsPir(sInputEvent * asEvents, uint32_t u32MaxEvents) {
 
-    BBBError error = BBB_SUCCESS;
-    boolE    run = FALSE;
-
-    /* Block all signals for this thread */
-    blockAllSignalForThread();
-
-    while(1) {
+    uint32_t u32Events = 0;
+    uint64_t u64Dropped;
 
-    	do {
-    		usleep(100000);
-    		pthread_mutex_lock(&mutexAlaram);
-    		run = started;
-    		pthread_mutex_unlock(&mutexAlaram);
-    	} while (run == FALSE);
+    if(initialized == TRUE) {
+        u64Dropped = getDroppedEventRing(&sPirEvents);
+        if(u64Dropped != 0) {
+            WARNINGPRINT("%llu motions lost", (unsigned long long) u64Dropped);
+        }
+        popEventRing(&sPirEvents, asEvents, u32MaxEvents, &u32Events);
+    }
 
-        /* Wait for infinite time for any movement event */
-        error = pollGpio(GPIO_PIR, POLL_TIMEOUT_INF);
+    return (u32Events);
+}
 
-        if(error == BBB_SUCCESS) {
-            pthread_mutex_lock(&mutexAlaram);
-            if(pirAlarm != TRUE) {
-                INFOPRINT("Alarm on");
-                pirAlarm = TRUE;
-            }
-            pthread_mutex_unlock(&mutexAlaram);
+/*******************************************************************************
+ *  function :    onPirEdge
+ ******************************************************************************/
+/** \brief        Handles a rising edge of the pir gpio (a movement within the
+ *                webhouse).
+ *                <p>
+ *                Called by the gpio event thread while the pir is enabled
+ *                with startPollPir(). Queues the motion, without taking a
+ *                lock.
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Gpio     gpio of the pir
+ *  \param[in]    eValue      value of the gpio after the edge
+ *  \param[in]    u64StampNs  time of the edge (CLOCK_MONOTONIC) [ns]
+ *  \param[in]    pvData      not used
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onPirEdge(uint32_t u32Gpio,
+                      eGpioValue eValue,
+                      uint64_t u64StampNs,
+                      void * pvData) {
 
-            /* Sleep some time to avoid bouncing of the pir */
-            sleep(2);
-        }
+    if(pushEventRing(&sPirEvents, u32Gpio, eValue, u64StampNs) == BBB_SUCCESS) {
+        INFOPRINT("Alarm on");
     }
-
-    pthread_exit(NULL);
 }
@@ -14,7 +14,8 @@
  *              stopPollPirThread(). You can check if the poll thread is running
  *              by calling isPollThreadRunning(). To see if a motion was
  *              detected, isAlarmOn() can be called. To start a neew motion
- *              detection resetAlarmPir() must be called.
+ *              detection resetAlarmPir() must be called. Every single motion
+ *              can be read with its timestamp by readEventsPir().
  *
  *  \author     wht4
  *
@@ -27,6 +28,7 @@
  *              isPollThreadRunning
  *              isAlarmOn
  *              resetAlarmPir
+ *              readEventsPir
  *
  ******************************************************************************/
 
@@ -34,6 +36,7 @@
 #include <stdint.h>
 
 #include "BBBTypes.h"
+#include "EventRing.h"
 
 //----- Macros -----------------------------------------------------------------
 
@@ -54,6 +57,8 @@ extern boolE    isAlarmOn(void);
 
 extern void     resetAlarmPir(void);
 
+extern uint32_t readEventsPir(sInputEvent * asEvents, uint32_t u32MaxEvents);
+
 //----- Data -------------------------------------------------------------------
 
 #endif /* PIR_H_ */
@@ -19,6 +19,15 @@
  *              <p>
  *              Every pwm can be turned on/off, the duty cycle can be set and
  *              the period of the pwm.
+ *              <p>
+ *              The attribute files (duty, period, run) are opened on the
+ *              first access and kept open until finalizePwm() is called.
+ *              When the period is set, the duty of each percentage level
+ *              [0,100] is encoded once. Thus setting the duty in percent is a
+ *              single pwrite(2).
+ *              <p>
+ *              The state and the period are only written if the pwm does not
+ *              already have them (e.g. from a previous run).
  *
  *  \author     wht4
  *
@@ -26,6 +35,8 @@
  *
  *  \remark     Last Modification
  *               \li wht4, August 2013, Created
+ *               \li wht4, October 2026, Persistent files, encoded duty levels
+ *               \li wht4, October 2026, Skip state and period if already set
  *
  ******************************************************************************/
 /*
@@ -34,9 +45,14 @@
  *              setPwmPeriod
  *              getPwmDuty
  *              setPwmDuty
+ *              setPwmDutyPercent
  *              getPwmState
  *              setPwmState
+ *              finalizePwm
  *  functions  local:
+ *              getAttributeFd
+ *              readAttribute
+ *              encodeDutyLevels
  *              composeFilename
  *
  ******************************************************************************/
@@ -49,30 +65,83 @@
 #include <fcntl.h>
 
 #include "Pwm.h"
+#define LOG_MODULE  HW
 #include "Log.h"
 
 //----- Macros -----------------------------------------------------------------
+#ifndef PWM_SYSFS_DIR
+/** Can be set to a stand-in directory (bench/BenchStartup.c)                 */
+#define PWM_SYSFS_DIR        "/sys/devices/ocp.2"
+#endif
 #define PWM_MAX_BUF          ( 64 )
+/** Number of attached pwm devices                                            */
+#define PWM_DEVICES          ( 3 )
+/** Number of duty levels [0,100] in percent                                  */
+#define PWM_DUTY_LEVELS      ( 101 )
+/** Longest encoded duty ("4294967295")                                       */
+#define PWM_MAX_DUTY_LEN     ( 10 )
 
 //----- Data types -------------------------------------------------------------
+
+/** Attribute files of a pwm device */
+typedef enum _ePwmAttribute {
+
+    PWM_ATTR_DUTY   = 0,  ///< duty [ns]
+    PWM_ATTR_PERIOD = 1,  ///< period [ns]
+    PWM_ATTR_STATE  = 2,  ///< running or stopped
+    PWM_ATTRIBUTES  = 3   ///< number of attributes
+
+} ePwmAttribute;
+
+/** Open attribute file */
+typedef struct _sPwmFd {
+
+    boolE bOpen;  ///< TRUE if fd is valid
+    int   fd;     ///< attribute file, opened read/write
+
+} sPwmFd;
+
+/** Duty of every percentage level, encoded for the duty file */
+typedef struct _sPwmDutyLevels {
+
+    uint32_t u32Period;                                   ///< 0 if not encoded
+    char     acDuty[PWM_DUTY_LEVELS][PWM_MAX_DUTY_LEN];   ///< not '\0' terminated
+    uint8_t  au8Len[PWM_DUTY_LEVELS];                     ///< length of acDuty[]
+
+} sPwmDutyLevels;
+
 /** Location of the attached pwm's */
 static char * pcPwmDevice[] = {
 
-    "/sys/devices/ocp.2/pwm_test_P9_14.14", ///< pwm on extension header P9.14
-    "/sys/devices/ocp.2/pwm_test_P9_22.15", ///< pwm on extension header P9.22
-    "/sys/devices/ocp.2/pwm_test_P8_19.16"  ///< pwm on extension header P8.19
+    PWM_SYSFS_DIR "/pwm_test_P9_14.14", ///< pwm on extension header P9.14
+    PWM_SYSFS_DIR "/pwm_test_P9_22.15", ///< pwm on extension header P9.22
+    PWM_SYSFS_DIR "/pwm_test_P8_19.16"  ///< pwm on extension header P8.19
 };
 
-static char * pcPwmDuty   = "/duty";
-static char * pcPwmPeriod = "/period";
-static char * pcPwmState  = "/run";
+/** Attribute files, indexed by ePwmAttribute */
+static char * pcPwmAttribute[] = {
+
+    "/duty",
+    "/period",
+    "/run"
+};
 
 //----- Function prototypes ----------------------------------------------------
-static void composeFilename(char * pcBuffer,
-                            ePwmDevice eDevice,
-                            char * pcFilename);
+static BBBError getAttributeFd(ePwmDevice eDevice,
+                               ePwmAttribute eAttribute,
+                               int * fd);
+static BBBError readAttribute(ePwmDevice eDevice,
+                              ePwmAttribute eAttribute,
+                              char * pcBuffer,
+                              uint32_t u32Size);
+static void     encodeDutyLevels(ePwmDevice eDevice, uint32_t u32Period);
+static void     composeFilename(char * pcBuffer,
+                                ePwmDevice eDevice,
+                                char * pcFilename);
 
 //----- Data -------------------------------------------------------------------
+static sPwmFd         asPwmFd[PWM_DEVICES][PWM_ATTRIBUTES];
+static sPwmDutyLevels asDutyLevels[PWM_DEVICES];
 
 //----- Implementation ---------------------------------------------------------
 
@@ -90,26 +159,20 @@ static void composeFilename(char * pcBuffer,
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_READ    File could not be read
  *                </pre>
  *
  ******************************************************************************/
 BBBError getPwmPeriod(ePwmDevice eDevice, uint32_t *u32Period) {
 
-    int      fd = -1;
     char     cBuf[PWM_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
-    composeFilename(cBuf, eDevice, pcPwmPeriod);
-
-    fd = open(cBuf, O_RDONLY);
-    if (fd < 0) {
+    error = readAttribute(eDevice, PWM_ATTR_PERIOD, cBuf, sizeof(cBuf));
+    if (error != BBB_SUCCESS) {
         ERRORPRINT("get Period of device %d failed", eDevice);
-        error = BBB_FILE_OPEN;
     } else {
-
-        read(fd, cBuf, PWM_MAX_BUF);
         *u32Period = strtoul (cBuf, NULL, 10);
-        close(fd);
     }
 
     return(error);
@@ -119,6 +182,9 @@ BBBError getPwmPeriod(ePwmDevice eDevice, uint32_t *u32Period) {
  *  function :    setPwmPeriod
  ******************************************************************************/
 /** \brief        Set the period [ns] of the corresponding pwm
+ *                <p>
+ *                The duty of all percentage levels is encoded for
+ *                setPwmDutyPercent().
  *
  *  \type         global
  *
@@ -128,6 +194,7 @@ BBBError getPwmPeriod(ePwmDevice eDevice, uint32_t *u32Period) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                </pre>
  *
  ******************************************************************************/
@@ -136,19 +203,27 @@ BBBError setPwmPeriod(ePwmDevice eDevice, uint32_t u32Period) {
     int      fd = -1;
     int      len = 0;
     char     cBuf[PWM_MAX_BUF];
+    char     cCurrent[PWM_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
-    composeFilename(cBuf, eDevice, pcPwmPeriod);
-
-    fd = open(cBuf, O_WRONLY);
-    if (fd < 0) {
+    if ((error = getAttributeFd(eDevice, PWM_ATTR_PERIOD, &fd)) != BBB_SUCCESS) {
         ERRORPRINT("set Period of device %d failed", eDevice);
-        error = BBB_FILE_OPEN;
     } else {
 
-        len = snprintf(cBuf, sizeof(cBuf), "%d", u32Period);
-        write(fd, cBuf, len);
-        close(fd);
+        /* The pwm may still have the period of a previous run */
+        if ((readAttribute(eDevice, PWM_ATTR_PERIOD, cCurrent,
+                           sizeof(cCurrent)) != BBB_SUCCESS) ||
+            (strtoul(cCurrent, NULL, 10) != u32Period)) {
+            len = snprintf(cBuf, sizeof(cBuf), "%u", u32Period);
+            if (pwrite(fd, cBuf, len, 0) != len) {
+                ERRORPRINT("set Period of device %d failed", eDevice);
+                error = BBB_FILE_WRITE;
+            }
+        }
+        /* The duty levels are only valid for the period of the pwm */
+        if (error == BBB_SUCCESS) {
+            encodeDutyLevels(eDevice, u32Period);
+        }
     }
 
     return(error);
@@ -167,26 +242,20 @@ BBBError setPwmPeriod(ePwmDevice eDevice, uint32_t u32Period) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_READ    File could not be read
  *                </pre>
  *
  ******************************************************************************/
 BBBError getPwmDuty(ePwmDevice eDevice, uint32_t *u32Duty) {
 
-    int      fd = -1;
     char     cBuf[PWM_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
-    composeFilename(cBuf, eDevice, pcPwmDuty);
-
-    fd = open(cBuf, O_RDONLY);
-    if (fd < 0) {
+    error = readAttribute(eDevice, PWM_ATTR_DUTY, cBuf, sizeof(cBuf));
+    if (error != BBB_SUCCESS) {
         ERRORPRINT("get Duty of device %d failed", eDevice);
-        error = BBB_FILE_OPEN;
     } else {
-
-        read(fd, cBuf, PWM_MAX_BUF);
         *u32Duty = strtoul (cBuf, NULL, 10);
-        close(fd);
     }
 
     return(error);
@@ -205,6 +274,7 @@ BBBError getPwmDuty(ePwmDevice eDevice, uint32_t *u32Duty) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                </pre>
  *
  ******************************************************************************/
@@ -215,17 +285,69 @@ BBBError setPwmDuty(ePwmDevice eDevice, uint32_t u32Duty) {
     char     cBuf[PWM_MAX_BUF];
     BBBError error = BBB_SUCCESS;
 
-    composeFilename(cBuf, eDevice, pcPwmDuty);
-
-    fd = open(cBuf, O_WRONLY);
-    if (fd < 0) {
+    if ((error = getAttributeFd(eDevice, PWM_ATTR_DUTY, &fd)) != BBB_SUCCESS) {
         ERRORPRINT("set Duty of device %d failed", eDevice);
-        error = BBB_FILE_OPEN;
     } else {
 
-        len = snprintf(cBuf, sizeof(cBuf), "%d", u32Duty);
-        write(fd, cBuf, len);
-        close(fd);
+        len = snprintf(cBuf, sizeof(cBuf), "%u", u32Duty);
+        if (pwrite(fd, cBuf, len, 0) != len) {
+            ERRORPRINT("set Duty of device %d failed", eDevice);
+            error = BBB_FILE_WRITE;
+        }
+    }
+
+    return(error);
+}
+
+/*******************************************************************************
+ *  function :    setPwmDutyPercent
+ ******************************************************************************/
+/** \brief        Set the duty of the corresponding pwm in percent of the
+ *                period
+ *                <p>
+ *                The duty level is written as encoded by setPwmPeriod(). If
+ *                the period was not set by this module, it is read once from
+ *                the pwm.
+ *
+ *  \type         global
+ *
+ *  \param[in]    eDevice     pwm device
+ *  \param[in]    u8Percent   duty [0,100] in percent of the period
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError setPwmDutyPercent(ePwmDevice eDevice, uint8_t u8Percent) {
+
+    int              fd = -1;
+    uint32_t         u32Period = 0;
+    sPwmDutyLevels * psLevels;
+    BBBError         error = BBB_SUCCESS;
+
+    if ((eDevice >= PWM_DEVICES) || (u8Percent >= PWM_DUTY_LEVELS)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    psLevels = &asDutyLevels[eDevice];
+    if (psLevels->u32Period == 0) {
+        if ((error = getPwmPeriod(eDevice, &u32Period)) != BBB_SUCCESS) {
+            return (error);
+        }
+        encodeDutyLevels(eDevice, u32Period);
+    }
+
+    if ((error = getAttributeFd(eDevice, PWM_ATTR_DUTY, &fd)) != BBB_SUCCESS) {
+        ERRORPRINT("set Duty of device %d failed", eDevice);
+    } else if (pwrite(fd, psLevels->acDuty[u8Percent],
+                      psLevels->au8Len[u8Percent], 0) !=
+               psLevels->au8Len[u8Percent]) {
+        ERRORPRINT("set Duty of device %d failed", eDevice);
+        error = BBB_FILE_WRITE;
     }
 
     return(error);
@@ -244,26 +366,23 @@ BBBError setPwmDuty(ePwmDevice eDevice, uint32_t u32Duty) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_READ    File could not be read
  *                BBB_ERR_UNKNOWN  pwm in an unknown state
  *                </pre>
  *
  ******************************************************************************/
 BBBError getPwmState(ePwmDevice eDevice, ePwmState *eState) {
 
-    int      fd = -1;
     char     cBuf[PWM_MAX_BUF];
     char     ch;
     BBBError error = BBB_SUCCESS;
 
-    composeFilename(cBuf, eDevice, pcPwmState);
-
-    fd = open(cBuf, O_RDONLY);
-    if (fd < 0) {
+    error = readAttribute(eDevice, PWM_ATTR_STATE, cBuf, sizeof(cBuf));
+    if (error != BBB_SUCCESS) {
         ERRORPRINT("get State of device %d failed", eDevice);
-        error = BBB_FILE_OPEN;
     } else {
 
-        read(fd, &ch, 1);
+        ch = cBuf[0];
         if(ch == '1') {
 
             *eState = PWM_RUN;
@@ -277,7 +396,6 @@ BBBError getPwmState(ePwmDevice eDevice, ePwmState *eState) {
             error = BBB_ERR_UNKNOWN;
             *eState = PWM_STOP;
         }
-        close(fd);
     }
 
     return(error);
@@ -296,42 +414,154 @@ BBBError getPwmState(ePwmDevice eDevice, ePwmState *eState) {
  *  \return       <pre>
  *                BBB_SUCCESS      on success
  *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_FILE_WRITE   File could not be written
  *                BBB_ERR_UNKNOWN  pwm in an unknown state
  *                </pre>
  *
  ******************************************************************************/
 BBBError setPwmState(ePwmDevice eDevice, ePwmState eState) {
 
-    int      fd = -1;
-    char     cBuf[PWM_MAX_BUF];
-    BBBError error = BBB_SUCCESS;
-
-    composeFilename(cBuf, eDevice, pcPwmState);
+    int       fd = -1;
+    ePwmState eCurrent;
+    BBBError  error = BBB_SUCCESS;
 
-    fd = open(cBuf, O_WRONLY);
-    if (fd < 0) {
+    if ((error = getAttributeFd(eDevice, PWM_ATTR_STATE, &fd)) != BBB_SUCCESS) {
         ERRORPRINT("set State of device %d failed", eDevice);
-        error = BBB_FILE_OPEN;
+    } else if ((getPwmState(eDevice, &eCurrent) == BBB_SUCCESS) &&
+               (eCurrent == eState)) {
+        /* Already in this state */
     } else {
 
-        if(eState == PWM_RUN) {
+        if((eState != PWM_RUN) && (eState != PWM_STOP)) {
 
-            write(fd, "1", 2);
+            error = BBB_ERR_PARAM;
 
-        } else if(eState == PWM_STOP) {
+        } else if(pwrite(fd, (eState == PWM_RUN) ? "1" : "0", 1, 0) != 1) {
 
-            write(fd, "0", 2);
+            ERRORPRINT("set State of device %d failed", eDevice);
+            error = BBB_FILE_WRITE;
+        }
+    }
 
-        } else {
+    return(error);
+}
 
-            error = BBB_ERR_PARAM;
+/*******************************************************************************
+ *  function :    finalizePwm
+ ******************************************************************************/
+/** \brief        Closes all attribute files of all pwm devices
+ *                <p>
+ *                The state of the pwm's is not changed. The files are opened
+ *                again on the next access.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_CLOSE   a file could not be closed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError finalizePwm(void) {
+
+    uint32_t i;
+    uint32_t j;
+    BBBError error = BBB_SUCCESS;
+
+    for (i = 0; i < PWM_DEVICES; i++) {
+        for (j = 0; j < PWM_ATTRIBUTES; j++) {
+            if (asPwmFd[i][j].bOpen == TRUE) {
+                if (close(asPwmFd[i][j].fd) < 0) {
+                    error = BBB_FILE_CLOSE;
+                }
+                asPwmFd[i][j].bOpen = FALSE;
+            }
         }
-        close(fd);
+        asDutyLevels[i].u32Period = 0;
     }
 
     return(error);
 }
 
+/*******************************************************************************
+ *  function :    getAttributeFd
+ ******************************************************************************/
+static BBBError getAttributeFd(ePwmDevice eDevice,
+                               ePwmAttribute eAttribute,
+                               int * fd) {
+
+    char     cBuf[PWM_MAX_BUF];
+    sPwmFd * psFd;
+
+    if (eDevice >= PWM_DEVICES) {
+        return (BBB_ERR_PARAM);
+    }
+
+    psFd = &asPwmFd[eDevice][eAttribute];
+    if (psFd->bOpen == FALSE) {
+
+        composeFilename(cBuf, eDevice, pcPwmAttribute[eAttribute]);
+
+        psFd->fd = open(cBuf, O_RDWR | O_CLOEXEC);
+        if (psFd->fd < 0) {
+            return (BBB_FILE_OPEN);
+        }
+        psFd->bOpen = TRUE;
+    }
+
+    *fd = psFd->fd;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    readAttribute
+ ******************************************************************************/
+static BBBError readAttribute(ePwmDevice eDevice,
+                              ePwmAttribute eAttribute,
+                              char * pcBuffer,
+                              uint32_t u32Size) {
+
+    int      fd = -1;
+    ssize_t  len;
+    BBBError error = BBB_SUCCESS;
+
+    if ((error = getAttributeFd(eDevice, eAttribute, &fd)) == BBB_SUCCESS) {
+
+        /* An attribute is never empty */
+        len = pread(fd, pcBuffer, u32Size - 1, 0);
+        if (len <= 0) {
+            len = 0;
+            error = BBB_FILE_READ;
+        }
+        pcBuffer[len] = '\0';
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    encodeDutyLevels
+ ******************************************************************************/
+static void encodeDutyLevels(ePwmDevice eDevice, uint32_t u32Period) {
+
+    uint32_t         i;
+    uint32_t         u32Duty;
+    int              len;
+    char             cBuf[PWM_MAX_BUF];
+    sPwmDutyLevels * psLevels = &asDutyLevels[eDevice];
+
+    for (i = 0; i < PWM_DUTY_LEVELS; i++) {
+
+        u32Duty = (uint32_t) (((uint64_t) u32Period * i) / 100);
+        len = snprintf(cBuf, sizeof(cBuf), "%u", u32Duty);
+        memcpy(psLevels->acDuty[i], cBuf, len);
+        psLevels->au8Len[i] = (uint8_t) len;
+    }
+
+    psLevels->u32Period = u32Period;
+}
+
 /*******************************************************************************
  *  function :    composeFilename
  ******************************************************************************/
@@ -21,6 +21,8 @@
  *              <p>
  *              Every pwm can be turned on/off, the duty cycle can be set and
  *              the period of the pwm.
+ *              <p>
+ *              The attribute files are kept open, finalizePwm() closes them.
  *
  *  \author     wht4
  *
@@ -30,8 +32,10 @@
  *              setPwmPeriod
  *              getPwmDuty
  *              setPwmDuty
+ *              setPwmDutyPercent
  *              getPwmState
  *              setPwmState
+ *              finalizePwm
  *
  ******************************************************************************/
 
@@ -71,10 +75,14 @@ extern BBBError getPwmDuty(ePwmDevice eDevice, uint32_t *u32Duty);
 
 extern BBBError setPwmDuty(ePwmDevice eDevice, uint32_t u32Duty);
 
+extern BBBError setPwmDutyPercent(ePwmDevice eDevice, uint8_t u8Percent);
+
 extern BBBError getPwmState(ePwmDevice eDevice, ePwmState *eState);
 
 extern BBBError setPwmState(ePwmDevice eDevice, ePwmState eState);
 
+extern BBBError finalizePwm(void);
+
 //----- Data -------------------------------------------------------------------
 
 
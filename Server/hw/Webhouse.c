@@ -25,6 +25,30 @@
  *              can be polled, it can be polled if an alarm was triggered by the
  *              pir and the triggered alarm can be reseted.
  *              </ul>
+ *              <p>
+ *              The last written value of every actuator is kept in a shadow
+ *              state. The getters are served from the shadow and writing the
+ *              value the actuator already has is skipped. The hardware is
+ *              only read if the shadow is not yet known.
+ *              syncWebhouseShadow() compares the shadow with the hardware
+ *              and corrects any drift.
+ *              <p>
+ *              The TV, the LED and the heater are not written at once. Only
+ *              the latest value of every actuator is queued, flushWebhouse()
+ *              writes all queued values once per tick (gpios with a single
+ *              call of the backend). Thus the number of hardware writes is
+ *              bounded, no matter how many commands are received.
+ *              <p>
+ *              The devices are initialized concurrently by one thread each.
+ *              startWebhouse() returns at once, the webhouse is ready when
+ *              all devices are initialized. Meanwhile the getters return
+ *              the initial state (everything off) and new values are
+ *              queued. The duration of every device is reported.
+ *              <p>
+ *              The lamps are not dimmed at once, but fade to the new level
+ *              within CONFIG_FADE_RAMP_MS (see Fade.h). dimSLampe() and
+ *              dimDLampe() return immediately, the pwm is written by the
+ *              fade thread.
  *
  *  \author     wht4
  *
@@ -32,11 +56,20 @@
  *
  *  \remark     Last Modification
  *               \li wht4, August 2013, Created
+ *               \li wht4, October 2026, Shadow state of the actuators
+ *               \li wht4, October 2026, Alarms read as timestamped events
+ *               \li wht4, October 2026, Hardware accessed through a backend
+ *               \li wht4, October 2026, Lamps fade to a new dim level
+ *               \li wht4, October 2026, Actuator values queued and flushed
+ *               \li wht4, October 2026, Devices initialized concurrently
  *
  ******************************************************************************/
 /*
  *  functions  global:
  *              initWebhouse
+ *              startWebhouse
+ *              waitWebhouse
+ *              isWebhouseReady
  *              finalizeWebhouse
  *              turnTVOn
  *              turnTVOff
@@ -51,12 +84,29 @@
  *              dimHeizung
  *              getHeizungState
  *              getTempIst
+ *              getTempIstHalfDeg
  *              enableAlarm
  *              disableAlarm
  *              getAlarmState
  *              isAlarmSet
  *              resetAlarm
+ *              readAlarmEvents
+ *              syncWebhouseShadow
+ *              flushWebhouse
  *  functions  local:
+ *              queueActuator
+ *              writeActuator
+ *              writeShadow
+ *              readActuator
+ *              writeHardware
+ *              readHardware
+ *              resetShadow
+ *              onFadeWrite
+ *              getNowNs
+ *              initThread
+ *              initJobThread
+ *              initAlarm
+ *              initTemp
  *              initTV
  *              finalizeTV
  *              initLED
@@ -67,21 +117,24 @@
  *              finalizeDLampe
  *              initHeizung
  *              finalizeHeizung
- *              calcDuration
- *              timespec2nsec
  *
  ******************************************************************************/
 
 //----- Header-Files -----------------------------------------------------------
+#include <pthread.h>
 #include <time.h>
-#include <limits.h>
 
 #include "Webhouse.h"
 #include "Gpio.h"
 #include "Pwm.h"
+#define LOG_MODULE  HW
 #include "Log.h"
 #include "Lm75.h"
 #include "Pir.h"
+#include "HwBackend.h"
+#include "Fade.h"
+#include "BBBConfig.h"
+#include "BBBSignal.h"
 
 //----- Macros -----------------------------------------------------------------
 #define GPIO_TV          ( 60 )
@@ -92,11 +145,63 @@
 #define PWM_PERIOD       ( 10000000 )
 #define PWM_PERIOD_PER   ( PWM_PERIOD / 100 )
 
+/** Number of actuators switched by a gpio (the first ones of eActuator)      */
+#define ACT_GPIO_COUNT   ( 2 )
+
 #define TEMP_OFFSET      ( 10 )
+/** The LM75 must not be read more often than every 300ms                     */
+#define TEMP_SAMPLE_PERIOD_MS ( 1000 )
 
 //----- Data types -------------------------------------------------------------
 
+/** Actuators with a shadow state */
+typedef enum _eActuator {
+
+    ACT_TV      = 0,  ///< TV, 0 or 1
+    ACT_LED     = 1,  ///< LED, 0 or 1
+    ACT_SLAMPE  = 2,  ///< floor lamp, [0,100]
+    ACT_DLAMPE  = 3,  ///< ceiling lamp, [0,100]
+    ACT_HEIZUNG = 4,  ///< heater, [0,100]
+    ACT_COUNT   = 5   ///< number of actuators
+
+} eActuator;
+
+/** Shadow state of an actuator */
+typedef struct _sShadow {
+
+    boolE   bValid;      ///< FALSE if the value must be read from the hardware
+    int32_t s32Value;    ///< last written value
+    boolE   bPending;    ///< TRUE if s32Pending must be written
+    int32_t s32Pending;  ///< latest queued value
+
+} sShadow;
+
+/** Initialization of a device, run by its own thread */
+typedef struct _sInitJob {
+
+    const char * pcName;             ///< name in the timing report
+    BBBError     (*pfInit)(void);    ///< initializes the device
+    eActuator    eAct;               ///< actuator, ACT_COUNT for none
+    pthread_t    idThread;           ///< thread of the job
+    BBBError     error;              ///< result of pfInit
+    uint64_t     u64DurationNs;      ///< duration of pfInit
+
+} sInitJob;
+
 //----- Function prototypes ----------------------------------------------------
+static void     queueActuator(eActuator eAct, int32_t s32Value);
+static BBBError writeActuator(eActuator eAct, int32_t s32Value);
+static BBBError writeShadow(eActuator eAct, int32_t s32Value);
+static int32_t  readActuator(eActuator eAct);
+static BBBError writeHardware(eActuator eAct, int32_t s32Value);
+static BBBError readHardware(eActuator eAct, int32_t * ps32Value);
+static void     resetShadow(boolE bValid);
+static BBBError onFadeWrite(uint32_t u32Channel, int32_t s32Level, void * pvData);
+static uint64_t getNowNs(void);
+static void *   initThread(void * pvData);
+static void *   initJobThread(void * pvData);
+static BBBError initAlarm(void);
+static BBBError initTemp(void);
 static BBBError initTV(void);
 static BBBError finalizeTV(void);
 static BBBError initLED(void);
@@ -107,10 +212,35 @@ static BBBError initDLampe(void);
 static BBBError finalizeDLampe(void);
 static BBBError initHeizung(void);
 static BBBError finalizeHeizung(void);
-static uint64_t calcDuration(uint64_t u64StartTime, uint64_t u64StopTime);
-static uint64_t timespec2nsec(struct timespec * time);
 
 //----- Data -------------------------------------------------------------------
+static sShadow         asShadow[ACT_COUNT];
+/** I2C addresses of the temperature sensors, the first one is TempIst        */
+static const uint8_t   au8TempSensor[] = { LM75_ADDR };
+/** Gpios of the actuators switched by a gpio (indexed by eActuator)          */
+static const uint32_t  au32ActGpio[ACT_GPIO_COUNT] = { GPIO_TV, GPIO_LED };
+static pthread_mutex_t mutexShadow = PTHREAD_MUTEX_INITIALIZER;
+/** Backend used to access the hardware, set by startWebhouse()               */
+static const sHwBackend * psHw = NULL;
+
+/** Independent devices, initialized concurrently                             */
+static sInitJob        asInitJob[] = {
+    { "tv",      initTV,      ACT_TV,      0, BBB_SUCCESS, 0 },
+    { "led",     initLED,     ACT_LED,     0, BBB_SUCCESS, 0 },
+    { "slampe",  initSLampe,  ACT_SLAMPE,  0, BBB_SUCCESS, 0 },
+    { "dlampe",  initDLampe,  ACT_DLAMPE,  0, BBB_SUCCESS, 0 },
+    { "heizung", initHeizung, ACT_HEIZUNG, 0, BBB_SUCCESS, 0 },
+    { "alarm",   initAlarm,   ACT_COUNT,   0, BBB_SUCCESS, 0 },
+    { "temp",    initTemp,    ACT_COUNT,   0, BBB_SUCCESS, 0 }
+};
+/** Thread running all jobs, TRUE in initStarted until it was joined          */
+static pthread_t       idInit;
+static boolE           initStarted = FALSE;
+/** Result of the initialization of all devices                               */
+static BBBError        errorInit = BBB_SUCCESS;
+/** Set when all devices are initialized                                      */
+static boolE           bReady = FALSE;
+static pfWebhouseReady pfReadyHook = NULL;
 
 //----- Implementation ---------------------------------------------------------
 
@@ -120,7 +250,8 @@ static uint64_t timespec2nsec(struct timespec * time);
 /** \brief        Initializes all used hardware within the webhouse.
  *                <p>
  *                Before any other function can be used, the webhouse must be
- *                initialized by calling this function.
+ *                initialized by calling this function. Returns when all
+ *                devices are initialized (see startWebhouse).
  *
  *  \type         global
  *
@@ -135,19 +266,111 @@ BBBError initWebhouse(void) {
 
     BBBError error = BBB_SUCCESS;
 
+    error = startWebhouse(NULL);
+    if(error == BBB_SUCCESS) {
+        error = waitWebhouse();
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    startWebhouse
+ ******************************************************************************/
+/** \brief        Starts to initialize all used hardware within the webhouse.
+ *                <p>
+ *                Returns at once, every device is initialized by its own
+ *                thread. Devices already configured by a previous run are
+ *                not configured again (see Gpio.h, Pwm.h). When all devices
+ *                are done, the duration of each one is reported, the values
+ *                queued meanwhile are written and pfReady is called (by the
+ *                initialization thread).
+ *                <p>
+ *                Until then the webhouse can already be used: the getters
+ *                return the initial state (everything off), new values are
+ *                queued, the alarm can not be enabled yet.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pfReady  called when the webhouse is ready, may be NULL
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS        on success
+ *                BBB_THREAD_RUNNING the webhouse is already initialized
+ *                BBB_THREAD_CREATE  a thread could not be created
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError startWebhouse(pfWebhouseReady pfReady) {
+
+    BBBError error = BBB_SUCCESS;
+
+    if((initStarted == TRUE) || (isWebhouseReady() == TRUE)) {
+        return (BBB_THREAD_RUNNING);
+    }
+
     LOGINIT();
 
-    printf("\nInitialize BBB webhouse");
-    error = initTV();
-    error |= initLED();
-    error |= initSLampe();
-    error |= initDLampe();
-    error |= initHeizung();
-    error |= initPir();
+    INFOPRINT("Initialize BBB webhouse");
+    psHw = getHwBackend();
+    /* Every device is initialized to off */
+    resetShadow(TRUE);
+    pfReadyHook = pfReady;
 
-    return (error);
+    /* The lamps are initialized dark, as the channels of the fade engine */
+    error = startFade(CONFIG_FADE_PERIOD_MS, onFadeWrite, NULL);
+    if(error != BBB_SUCCESS) {
+        return (error);
+    }
+
+    if(pthread_create(&idInit, NULL, initThread, NULL) != 0) {
+        ERRORPRINT("can't create thread");
+        stopFade();
+        return (BBB_THREAD_CREATE);
+    }
+    initStarted = TRUE;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    waitWebhouse
+ ******************************************************************************/
+/** \brief        Waits until all devices are initialized
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError waitWebhouse(void) {
+
+    if(initStarted == TRUE) {
+        pthread_join(idInit, NULL);
+        initStarted = FALSE;
+    }
+
+    return (errorInit);
 }
 
+/*******************************************************************************
+ *  function :    isWebhouseReady
+ ******************************************************************************/
+/** \brief        Returns if all devices are initialized
+ *
+ *  \type         global
+ *
+ *  \return       TRUE if the webhouse is ready, FALSE otherwise
+ *
+ ******************************************************************************/
+boolE isWebhouseReady(void) {
+
+    return (__atomic_load_n(&bReady, __ATOMIC_ACQUIRE));
+}
 
 /*******************************************************************************
  *  function :    finalizeWebhouse
@@ -168,13 +391,21 @@ BBBError finalizeWebhouse(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    printf("\nfinalize BBB webhouse");
-    error = finalizeTV();
+    INFOPRINT("finalize BBB webhouse");
+    waitWebhouse();
+    /* No fade writes the lamps behind our back anymore */
+    error = stopFade();
+    error |= finalizeTV();
     error |= finalizeLED();
     error |= finalizeSLampe();
     error |= finalizeDLampe();
     error |= finalizeHeizung();
     error |= finalizePir();
+    error |= psHw->pfFinalizeGpioEvent();
+    error |= psHw->pfFinalizePwm();
+    psHw->pfStopSamplerTemp();
+    __atomic_store_n(&bReady, FALSE, __ATOMIC_RELEASE);
+    resetShadow(FALSE);
 
     return (error);
 }
@@ -183,6 +414,9 @@ BBBError finalizeWebhouse(void) {
  *  function :    turnTVOn
  ******************************************************************************/
 /** \brief        Turn on the TV
+ *                <p>
+ *                Only the latest value is kept until it is written by
+ *                flushWebhouse().
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -190,21 +424,25 @@ BBBError finalizeWebhouse(void) {
  *  \type         global
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
- *                BBB_ERR_PARAM    if a parameter error occurred
+ *                BBB_SUCCESS      the value is queued, it is written by the
+ *                                 next flushWebhouse()
  *                </pre>
  *
  ******************************************************************************/
 BBBError turnTVOn(void) {
 
-    return (setGpioValue(GPIO_TV, GPIO_VALUE_HIGH));
+    queueActuator(ACT_TV, 1);
+
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
  *  function :    turnTVOff
  ******************************************************************************/
 /** \brief        Turn off the TV
+ *                <p>
+ *                Only the latest value is kept until it is written by
+ *                flushWebhouse().
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -212,15 +450,16 @@ BBBError turnTVOn(void) {
  *  \type         global
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
- *                BBB_ERR_PARAM    if a parameter error occurred
+ *                BBB_SUCCESS      the value is queued, it is written by the
+ *                                 next flushWebhouse()
  *                </pre>
  *
  ******************************************************************************/
 BBBError turnTVOff(void) {
 
-    return (setGpioValue(GPIO_TV, GPIO_VALUE_LOW));
+    queueActuator(ACT_TV, 0);
+
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
@@ -238,17 +477,16 @@ BBBError turnTVOff(void) {
  ******************************************************************************/
 int32_t getTVState(void) {
 
-    eGpioValue eValue = GPIO_VALUE_LOW;
-
-    getGpioValue(GPIO_TV, &eValue);
-
-    return (eValue);
+    return (readActuator(ACT_TV));
 }
 
 /*******************************************************************************
  *  function :    turnLEDOn
  ******************************************************************************/
 /** \brief        Turn on the LED (LED is just used for test purposes)
+ *                <p>
+ *                Only the latest value is kept until it is written by
+ *                flushWebhouse().
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -256,21 +494,25 @@ int32_t getTVState(void) {
  *  \type         global
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
- *                BBB_ERR_PARAM    if a parameter error occurred
+ *                BBB_SUCCESS      the value is queued, it is written by the
+ *                                 next flushWebhouse()
  *                </pre>
  *
  ******************************************************************************/
 BBBError turnLEDOn(void) {
 
-    return (setGpioValue(GPIO_LED, GPIO_VALUE_HIGH));
+    queueActuator(ACT_LED, 1);
+
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
  *  function :    turnLEDOff
  ******************************************************************************/
 /** \brief        Turn off the LED (LED is just used for test purposes)
+ *                <p>
+ *                Only the latest value is kept until it is written by
+ *                flushWebhouse().
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -278,15 +520,16 @@ BBBError turnLEDOn(void) {
  *  \type         global
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
- *                BBB_ERR_PARAM    if a parameter error occurred
+ *                BBB_SUCCESS      the value is queued, it is written by the
+ *                                 next flushWebhouse()
  *                </pre>
  *
  ******************************************************************************/
 BBBError turnLEDOff(void) {
 
-    return (setGpioValue(GPIO_LED, GPIO_VALUE_LOW));
+    queueActuator(ACT_LED, 0);
+
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
@@ -304,17 +547,17 @@ BBBError turnLEDOff(void) {
  ******************************************************************************/
 int32_t getLEDState(void) {
 
-    eGpioValue eValue = GPIO_VALUE_LOW;
-
-    getGpioValue(GPIO_LED, &eValue);
-
-    return (eValue);
+    return (readActuator(ACT_LED));
 }
 
 /*******************************************************************************
  *  function :    dimSLampe
  ******************************************************************************/
 /** \brief        Dim the floor lamp from 0 (dark) to 100 (brightest)
+ *                <p>
+ *                The lamp fades to the new level within CONFIG_FADE_RAMP_MS,
+ *                this function returns immediately. A new level overrides
+ *                the fade in progress.
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -324,28 +567,26 @@ int32_t getLEDState(void) {
  *  \param[in]    u8Duty   Dim level [0,100]
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_SUCCESS        on success
+ *                BBB_THREAD_RUNNING the fade thread is not running
  *                </pre>
  *
  ******************************************************************************/
 BBBError dimSLampe(uint8_t u8Duty) {
 
-    uint32_t u32Duty = 0;
-
     if(u8Duty > 100) {
         u8Duty = 100;
     }
 
-    u32Duty = PWM_PERIOD - (PWM_PERIOD_PER * u8Duty);
-
-    return (setPwmDuty(PWM_P9_22, u32Duty));
+    return (setFadeTarget(ACT_SLAMPE, u8Duty, CONFIG_FADE_RAMP_MS));
 }
 
 /*******************************************************************************
  *  function :    getSLampeState
  ******************************************************************************/
 /** \brief        Get the state of the floor lamp (0 (dark) to 100 (brightest))
+ *                <p>
+ *                While the lamp fades, the level it fades to is returned.
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -357,20 +598,17 @@ BBBError dimSLampe(uint8_t u8Duty) {
  ******************************************************************************/
 int32_t getSLampeState(void) {
 
-    uint32_t u32Duty = 0;
-    int32_t  s32DutyPercentage = 0;
-
-    getPwmDuty(PWM_P9_22, &u32Duty);
-
-    s32DutyPercentage = (PWM_PERIOD - u32Duty) / PWM_PERIOD_PER;
-
-    return (s32DutyPercentage);
+    return (getFadeTarget(ACT_SLAMPE));
 }
 
 /*******************************************************************************
  *  function :    dimDLampe
  ******************************************************************************/
 /** \brief        Dim the ceiling lamp from 0 (dark) to 100 (brightest)
+ *                <p>
+ *                The lamp fades to the new level within CONFIG_FADE_RAMP_MS,
+ *                this function returns immediately. A new level overrides
+ *                the fade in progress.
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -380,28 +618,26 @@ int32_t getSLampeState(void) {
  *  \param[in]    u8Duty   Dim level [0,100]
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_SUCCESS        on success
+ *                BBB_THREAD_RUNNING the fade thread is not running
  *                </pre>
  *
  ******************************************************************************/
 BBBError dimDLampe(uint8_t u8Duty) {
 
-    uint32_t u32Duty = 0;
-
     if(u8Duty > 100) {
         u8Duty = 100;
     }
 
-    u32Duty = PWM_PERIOD - (PWM_PERIOD_PER * u8Duty);
-
-    return (setPwmDuty(PWM_P9_14, u32Duty));
+    return (setFadeTarget(ACT_DLAMPE, u8Duty, CONFIG_FADE_RAMP_MS));
 }
 
 /*******************************************************************************
  *  function :    getDLampeState
  ******************************************************************************/
 /** \brief        Get the state of the ceiling lamp (0 (dark) to 100 (brightest))
+ *                <p>
+ *                While the lamp fades, the level it fades to is returned.
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -413,20 +649,16 @@ BBBError dimDLampe(uint8_t u8Duty) {
  ******************************************************************************/
 int32_t getDLampeState(void) {
 
-    uint32_t u32Duty= 0;
-    int32_t  s32DutyPercentage = 0;
-
-    getPwmDuty(PWM_P9_14, &u32Duty);
-
-    s32DutyPercentage = (PWM_PERIOD - u32Duty) / PWM_PERIOD_PER;
-
-    return (s32DutyPercentage);
+    return (getFadeTarget(ACT_DLAMPE));
 }
 
 /*******************************************************************************
  *  function :    dimHeizung
  ******************************************************************************/
 /** \brief        Dim the heater from 0 (no heating) to 100 (full heating)
+ *                <p>
+ *                Only the latest value is kept until it is written by
+ *                flushWebhouse().
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
@@ -436,22 +668,20 @@ int32_t getDLampeState(void) {
  *  \param[in]    u8Duty   Dim level [0,100]
  *
  *  \return       <pre>
- *                BBB_SUCCESS      on success
- *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_SUCCESS      the value is queued, it is written by the
+ *                                 next flushWebhouse()
  *                </pre>
  *
  ******************************************************************************/
 BBBError dimHeizung(uint8_t u8Duty) {
 
-    uint32_t u32Duty;
-
     if(u8Duty > 100) {
         u8Duty = 100;
     }
 
-    u32Duty = PWM_PERIOD - (PWM_PERIOD_PER * u8Duty);
+    queueActuator(ACT_HEIZUNG, u8Duty);
 
-    return (setPwmDuty(PWM_P8_19, u32Duty));
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
@@ -470,63 +700,96 @@ BBBError dimHeizung(uint8_t u8Duty) {
  ******************************************************************************/
 int32_t getHeizungState(void) {
 
-    uint32_t u32Duty;
-    int32_t  s32DutyPercentage;
+    return (readActuator(ACT_HEIZUNG));
+}
 
-    getPwmDuty(PWM_P8_19, &u32Duty);
+/*******************************************************************************
+ *  function :    getTempIst
+ ******************************************************************************/
+/** \brief        Get the current temperature within the webhouse in whole
+ *                degrees (telemetry)
+ *                <p>
+ *                See getTempIstHalfDeg(), the half degree is truncated.
+ *
+ *  \type         global
+ *
+ *  \param[out]   ps32Temp   current temperature within the webhouse in degree
+ *                           celcius
+ *  \param[out]   pu32AgeMs  age of the sample [ms], may be NULL
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_READ    no valid sample (yet), *ps32Temp unchanged
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError getTempIst(int32_t * ps32Temp, uint32_t * pu32AgeMs) {
 
-    s32DutyPercentage = (PWM_PERIOD - u32Duty) / PWM_PERIOD_PER;
+    int32_t  s32HalfDeg;
+    BBBError error;
 
-    return (s32DutyPercentage);
+    error = getTempIstHalfDeg(&s32HalfDeg, pu32AgeMs);
+    if(error == BBB_SUCCESS) {
+        *ps32Temp = s32HalfDeg >> 1;
+    }
+
+    return (error);
 }
 
 /*******************************************************************************
- *  function :    getTempIst
+ *  function :    getTempIstHalfDeg
  ******************************************************************************/
-/** \brief        Get the current temperature within the webhouse in degree
- *                celcius.
+/** \brief        Get the current temperature within the webhouse in half
+ *                degrees (full resolution of the LM75, heater control)
  *                <p>
- *                Accessing the temperature sensor continuously without waiting
- *                at least one conversion time between communications will prevent
- *                the device from updating the temperature register with a new
- *                temperature conversion result. Thus we limit the access to the
- *                sensor and manage a shadow temperature register within the
- *                function.
+ *                The temperature sensor is sampled by its own thread every
+ *                TEMP_SAMPLE_PERIOD_MS (see startSamplerLm75). This function
+ *                just returns the last sample and thus never waits for the
+ *                I2C bus.
  *                <p>
  *                The webhouse must be initialized (initWebhouse) before this
  *                function can be called.
  *
  *  \type         global
  *
- *  \return       current temperature within the webhouse in degree celcius
+ *  \param[out]   ps32HalfDeg  current temperature within the webhouse
+ *                             [0.5 degree celcius]
+ *  \param[out]   pu32AgeMs    age of the sample [ms], may be NULL
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_READ    no valid sample (yet), *ps32HalfDeg
+ *                                 unchanged
+ *                </pre>
  *
  ******************************************************************************/
-int32_t getTempIst(void) {
-
-    static int32_t s32Temp = 0;
-    static struct timespec stamp = {0,0};
-    struct timespec know;
-    uint64_t u64Diff;
+BBBError getTempIstHalfDeg(int32_t * ps32HalfDeg, uint32_t * pu32AgeMs) {
 
-    if((stamp.tv_nsec == 0) && (stamp.tv_sec == 0) && (s32Temp == 0)) {
+    struct timespec sNow;
+    uint64_t        u64Stamp;
+    uint64_t        u64Now;
+    int32_t         s32HalfDeg;
+    BBBError        error;
 
-        clock_gettime(CLOCK_REALTIME, &stamp);
-        readTempLm75(&s32Temp);
-        s32Temp = s32Temp - TEMP_OFFSET;
-    } else {
-
-        clock_gettime(CLOCK_REALTIME, &know);
-        u64Diff = calcDuration(timespec2nsec(&stamp), timespec2nsec(&know));
+    if(psHw == NULL) {
+        return (BBB_FILE_READ);
+    }
 
-        if(u64Diff >= 1000000000uLL) {
+    error = psHw->pfGetSampleTemp(0, &s32HalfDeg, &u64Stamp);
+    if(error != BBB_SUCCESS) {
+        return (BBB_FILE_READ);
+    }
 
-            readTempLm75(&s32Temp);
-            s32Temp = s32Temp - TEMP_OFFSET;
-            clock_gettime(CLOCK_REALTIME, &stamp);
-        }
+    if(pu32AgeMs != NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &sNow);
+        u64Now = ((uint64_t) sNow.tv_sec) * 1000000000ULL + sNow.tv_nsec;
+        *pu32AgeMs = (u64Now > u64Stamp) ?
+                     (uint32_t) ((u64Now - u64Stamp) / 1000000) : 0;
     }
 
-    return (s32Temp);
+    *ps32HalfDeg = s32HalfDeg - 2 * TEMP_OFFSET;
+
+    return (BBB_SUCCESS);
 }
 
 /*******************************************************************************
@@ -543,11 +806,16 @@ int32_t getTempIst(void) {
  *                BBB_SUCCESS        on success
  *                BBB_THREAD_CREATE  the thread could not be created
  *                BBB_THREAD_RUNNING thread is already running
+ *                BBB_ERR_UNKNOWN    the webhouse is not ready yet
  *                </pre>
  *
  ******************************************************************************/
 BBBError enableAlarm(void) {
 
+    if(isWebhouseReady() == FALSE) {
+        return (BBB_ERR_UNKNOWN);
+    }
+
     return (startPollPir());
 }
 
@@ -564,11 +832,16 @@ BBBError enableAlarm(void) {
  *  \return       <pre>
  *                BBB_SUCCESS        on success
  *                BBB_THREAD_RUNNING thread is not running
+ *                BBB_ERR_UNKNOWN    the webhouse is not ready yet
  *                </pre>
  *
  ******************************************************************************/
 BBBError disableAlarm(void) {
 
+    if(isWebhouseReady() == FALSE) {
+        return (BBB_ERR_UNKNOWN);
+    }
+
     return (stopPollPir());
 }
 
@@ -613,6 +886,10 @@ int32_t getAlarmState(void) {
  ******************************************************************************/
 int32_t isAlarmSet(void) {
 
+    if(isWebhouseReady() == FALSE) {
+        return (0);
+    }
+
     return (isAlarmOn());
 }
 
@@ -635,7 +912,594 @@ int32_t isAlarmSet(void) {
  ******************************************************************************/
 void resetAlarm(void) {
 
-    resetAlarmPir();
+    if(isWebhouseReady() == TRUE) {
+        resetAlarmPir();
+    }
+}
+
+/*******************************************************************************
+ *  function :    readAlarmEvents
+ ******************************************************************************/
+/** \brief        Reads the movements detected by the pir since the last call.
+ *                <p>
+ *                Every movement is returned once, in the order it occurred,
+ *                with its time (CLOCK_MONOTONIC) and a consecutive sequence
+ *                number. Movements are not merged, thus none is lost between
+ *                two calls. Must always be called by the same thread.
+ *                <p>
+ *                The webhouse must be initialized (initWebhouse) before this
+ *                function can be called.
+ *
+ *  \type         global
+ *
+ *  \param[out]   asEvents      detected movements
+ *  \param[in]    u32MaxEvents  number of elements of asEvents
+ *
+ *  \return       number of movements written to asEvents
+ *
+ ******************************************************************************/
+uint32_t readAlarmEvents(sInputEvent * asEvents, uint32_t u32MaxEvents) {
+
+    if(isWebhouseReady() == FALSE) {
+        return (0);
+    }
+
+    return (readEventsPir(asEvents, u32MaxEvents));
+}
+
+/*******************************************************************************
+ *  function :    syncWebhouseShadow
+ ******************************************************************************/
+/** \brief        Compares the shadow state with the hardware.
+ *                <p>
+ *                Every actuator with a known shadow state is read back. If
+ *                the hardware was changed behind the back of the webhouse
+ *                (e.g. by an other process), the shadow value is written
+ *                again. Intended to be called periodically with a low rate.
+ *                <p>
+ *                The hardware is read without holding the shadow lock, an
+ *                actuator which could not be read is not compared. A drifted
+ *                actuator is only corrected if its shadow did not change
+ *                while the hardware was read.
+ *                <p>
+ *                The webhouse must be initialized (initWebhouse) before this
+ *                function can be called.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError syncWebhouseShadow(void) {
+
+    uint32_t   i;
+    int32_t    s32Value;
+    int32_t    as32Shadow[ACT_COUNT];
+    boolE      abCheck[ACT_COUNT];
+    eGpioValue aeGpio[ACT_GPIO_COUNT];
+    BBBError   errorGpio;
+    BBBError   errorWrite;
+    BBBError   error = BBB_SUCCESS;
+
+    if(isWebhouseReady() == FALSE) {
+        return (BBB_SUCCESS);
+    }
+
+    /* Snapshot, the hardware is read without holding the lock */
+    pthread_mutex_lock(&mutexShadow);
+    for(i = 0; i < ACT_COUNT; i++) {
+        /* A queued value is written anyway by the next flush */
+        abCheck[i] = ((asShadow[i].bValid == TRUE) &&
+                      (asShadow[i].bPending == FALSE)) ? TRUE : FALSE;
+        as32Shadow[i] = asShadow[i].s32Value;
+    }
+    pthread_mutex_unlock(&mutexShadow);
+
+    /* All gpio actuators are read at once */
+    errorGpio = psHw->pfGetGpioValues(au32ActGpio, aeGpio, ACT_GPIO_COUNT);
+    if(errorGpio != BBB_SUCCESS) {
+        WARNINGPRINT("gpio actuators not read back (%d)", errorGpio);
+        error |= errorGpio;
+    }
+
+    for(i = 0; i < ACT_COUNT; i++) {
+
+        if(abCheck[i] == FALSE) {
+            continue;
+        }
+        if(i < ACT_GPIO_COUNT) {
+            if(errorGpio != BBB_SUCCESS) {
+                continue;
+            }
+            s32Value = (int32_t) aeGpio[i];
+        } else if(readHardware(i, &s32Value) != BBB_SUCCESS) {
+            continue;
+        }
+        if(s32Value == as32Shadow[i]) {
+            continue;
+        }
+
+        /* Only corrected if no one changed the actuator in the meantime */
+        pthread_mutex_lock(&mutexShadow);
+        if((asShadow[i].bValid == TRUE) && (asShadow[i].bPending == FALSE) &&
+           (asShadow[i].s32Value == as32Shadow[i])) {
+            WARNINGPRINT("actuator %d drifted from %d to %d",
+                         i, as32Shadow[i], s32Value);
+            errorWrite = writeHardware(i, as32Shadow[i]);
+            /* After an error the state of the hardware is unknown */
+            if(errorWrite != BBB_SUCCESS) {
+                asShadow[i].bValid = FALSE;
+                error |= errorWrite;
+            }
+        }
+        pthread_mutex_unlock(&mutexShadow);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    flushWebhouse
+ ******************************************************************************/
+/** \brief        Writes the queued values of all actuators.
+ *                <p>
+ *                The queued gpio actuators are written with a single call of
+ *                the backend, every other actuator with one write. Intended
+ *                to be called once per tick, thus the hardware is written at
+ *                most once per tick and actuator.
+ *                <p>
+ *                The hardware is written without holding the shadow lock. A
+ *                written value is only taken over by the shadow if the
+ *                actuator did not change while the hardware was written,
+ *                otherwise it is read back when needed.
+ *                <p>
+ *                The webhouse must be initialized (initWebhouse) before this
+ *                function can be called.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_FILE_OPEN    File could not be opened
+ *                BBB_ERR_PARAM    if a parameter error occurred
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError flushWebhouse(void) {
+
+    uint32_t   au32Gpio[ACT_GPIO_COUNT];
+    eGpioValue aeGpio[ACT_GPIO_COUNT];
+    int32_t    as32Write[ACT_COUNT];
+    boolE      abWrite[ACT_COUNT];
+    BBBError   aeError[ACT_COUNT];
+    uint32_t   u32GpioCount = 0;
+    BBBError   error = BBB_SUCCESS;
+    BBBError   errorGpio = BBB_SUCCESS;
+    uint32_t   i;
+
+    /* Kept queued until the devices are initialized */
+    if(isWebhouseReady() == FALSE) {
+        return (BBB_SUCCESS);
+    }
+
+    /* Snapshot, the hardware is written without holding the lock */
+    pthread_mutex_lock(&mutexShadow);
+    for(i = 0; i < ACT_COUNT; i++) {
+
+        abWrite[i] = FALSE;
+        if(asShadow[i].bPending == FALSE) {
+            continue;
+        }
+        asShadow[i].bPending = FALSE;
+        if((asShadow[i].bValid == TRUE) &&
+           (asShadow[i].s32Value == asShadow[i].s32Pending)) {
+            continue;
+        }
+
+        /* Unknown while written, a value queued meanwhile is not cancelled */
+        abWrite[i] = TRUE;
+        as32Write[i] = asShadow[i].s32Pending;
+        asShadow[i].bValid = FALSE;
+        asShadow[i].s32Value = as32Write[i];
+
+        if(i < ACT_GPIO_COUNT) {
+            au32Gpio[u32GpioCount] = au32ActGpio[i];
+            aeGpio[u32GpioCount] = as32Write[i] ? GPIO_VALUE_HIGH :
+                                                  GPIO_VALUE_LOW;
+            u32GpioCount++;
+        }
+    }
+    pthread_mutex_unlock(&mutexShadow);
+
+    /* All gpio actuators are written at once */
+    if(u32GpioCount > 0) {
+        errorGpio = psHw->pfSetGpioValues(au32Gpio, aeGpio, u32GpioCount);
+    }
+    for(i = 0; i < ACT_COUNT; i++) {
+        if(abWrite[i] == TRUE) {
+            aeError[i] = (i < ACT_GPIO_COUNT) ? errorGpio :
+                                                writeHardware(i, as32Write[i]);
+            error |= aeError[i];
+        }
+    }
+
+    /* Only taken over if no one changed the actuator in the meantime */
+    pthread_mutex_lock(&mutexShadow);
+    for(i = 0; i < ACT_COUNT; i++) {
+        if(abWrite[i] == FALSE) {
+            continue;
+        }
+        /* After an error or a concurrent write the state is unknown */
+        if((asShadow[i].bValid == FALSE) &&
+           (asShadow[i].s32Value == as32Write[i]) &&
+           (aeError[i] == BBB_SUCCESS)) {
+            asShadow[i].bValid = TRUE;
+        } else {
+            asShadow[i].bValid = FALSE;
+        }
+    }
+    pthread_mutex_unlock(&mutexShadow);
+
+    if(error != BBB_SUCCESS) {
+        WARNINGPRINT("queued actuator values not written (%d)", error);
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    queueActuator
+ ******************************************************************************/
+/** \brief        Queues the value of an actuator, replacing a queued one
+ *
+ *  \type         static
+ *
+ *  \param[in]    eAct      actuator
+ *  \param[in]    s32Value  value
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void queueActuator(eActuator eAct, int32_t s32Value) {
+
+    pthread_mutex_lock(&mutexShadow);
+    /* Going back to the value of the hardware cancels the queued one */
+    if((asShadow[eAct].bValid == TRUE) &&
+       (asShadow[eAct].s32Value == s32Value)) {
+        asShadow[eAct].bPending = FALSE;
+    } else {
+        asShadow[eAct].bPending = TRUE;
+        asShadow[eAct].s32Pending = s32Value;
+    }
+    pthread_mutex_unlock(&mutexShadow);
+}
+
+/*******************************************************************************
+ *  function :    writeActuator
+ ******************************************************************************/
+static BBBError writeActuator(eActuator eAct, int32_t s32Value) {
+
+    BBBError error;
+
+    pthread_mutex_lock(&mutexShadow);
+    error = writeShadow(eAct, s32Value);
+    pthread_mutex_unlock(&mutexShadow);
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    writeShadow
+ ******************************************************************************/
+/** \brief        Writes an actuator unless the shadow already has the value,
+ *                must be called with mutexShadow locked
+ *
+ *  \type         static
+ *
+ *  \param[in]    eAct      actuator
+ *  \param[in]    s32Value  value
+ *
+ *  \return       see writeHardware
+ *
+ ******************************************************************************/
+static BBBError writeShadow(eActuator eAct, int32_t s32Value) {
+
+    BBBError error = BBB_SUCCESS;
+
+    if((asShadow[eAct].bValid == FALSE) ||
+       (asShadow[eAct].s32Value != s32Value)) {
+
+        error = writeHardware(eAct, s32Value);
+
+        /* After an error the state of the hardware is unknown */
+        asShadow[eAct].bValid = (error == BBB_SUCCESS) ? TRUE : FALSE;
+        asShadow[eAct].s32Value = s32Value;
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    readActuator
+ ******************************************************************************/
+static int32_t readActuator(eActuator eAct) {
+
+    int32_t s32Value;
+
+    pthread_mutex_lock(&mutexShadow);
+    if(asShadow[eAct].bPending == TRUE) {
+        s32Value = asShadow[eAct].s32Pending;
+    } else {
+        /* After a failed read the last written value is reported */
+        if((asShadow[eAct].bValid == FALSE) &&
+           (readHardware(eAct, &s32Value) == BBB_SUCCESS)) {
+            asShadow[eAct].s32Value = s32Value;
+            asShadow[eAct].bValid = TRUE;
+        }
+        s32Value = asShadow[eAct].s32Value;
+    }
+    pthread_mutex_unlock(&mutexShadow);
+
+    return (s32Value);
+}
+
+/*******************************************************************************
+ *  function :    writeHardware
+ ******************************************************************************/
+static BBBError writeHardware(eActuator eAct, int32_t s32Value) {
+
+    BBBError error = BBB_SUCCESS;
+
+    switch(eAct) {
+
+        case ACT_TV:
+            error = psHw->pfSetGpioValue(GPIO_TV, s32Value ? GPIO_VALUE_HIGH :
+                                                     GPIO_VALUE_LOW);
+            break;
+
+        case ACT_LED:
+            error = psHw->pfSetGpioValue(GPIO_LED, s32Value ? GPIO_VALUE_HIGH :
+                                                      GPIO_VALUE_LOW);
+            break;
+
+        /* The pwm outputs are inverted */
+        case ACT_SLAMPE:
+            error = psHw->pfSetPwmDutyPercent(PWM_P9_22, 100 - s32Value);
+            break;
+
+        case ACT_DLAMPE:
+            error = psHw->pfSetPwmDutyPercent(PWM_P9_14, 100 - s32Value);
+            break;
+
+        case ACT_HEIZUNG:
+            error = psHw->pfSetPwmDutyPercent(PWM_P8_19, 100 - s32Value);
+            break;
+
+        default:
+            error = BBB_ERR_PARAM;
+            break;
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    readHardware
+ ******************************************************************************/
+static BBBError readHardware(eActuator eAct, int32_t * ps32Value) {
+
+    eGpioValue eValue = GPIO_VALUE_LOW;
+    uint32_t   u32Duty = PWM_PERIOD;
+    BBBError   error = BBB_SUCCESS;
+
+    switch(eAct) {
+
+        case ACT_TV:
+            error = psHw->pfGetGpioValue(GPIO_TV, &eValue);
+            *ps32Value = eValue;
+            return (error);
+
+        case ACT_LED:
+            error = psHw->pfGetGpioValue(GPIO_LED, &eValue);
+            *ps32Value = eValue;
+            return (error);
+
+        case ACT_SLAMPE:
+            error = psHw->pfGetPwmDuty(PWM_P9_22, &u32Duty);
+            break;
+
+        case ACT_DLAMPE:
+            error = psHw->pfGetPwmDuty(PWM_P9_14, &u32Duty);
+            break;
+
+        case ACT_HEIZUNG:
+            error = psHw->pfGetPwmDuty(PWM_P8_19, &u32Duty);
+            break;
+
+        default:
+            error = BBB_ERR_PARAM;
+            break;
+    }
+
+    *ps32Value = (PWM_PERIOD - u32Duty) / PWM_PERIOD_PER;
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    resetShadow
+ ******************************************************************************/
+/** \brief        Sets the shadow of all actuators to off, without any queued
+ *                value
+ *
+ *  \type         static
+ *
+ *  \param[in]    bValid  TRUE if the hardware is off, FALSE if its state is
+ *                        unknown
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void resetShadow(boolE bValid) {
+
+    uint32_t i;
+
+    pthread_mutex_lock(&mutexShadow);
+    for(i = 0; i < ACT_COUNT; i++) {
+        asShadow[i].bValid = bValid;
+        asShadow[i].s32Value = 0;
+        asShadow[i].bPending = FALSE;
+    }
+    pthread_mutex_unlock(&mutexShadow);
+}
+
+/*******************************************************************************
+ *  function :    onFadeWrite
+ ******************************************************************************/
+/** \brief        Writes a lamp level computed by the fade thread
+ *
+ *  \type         static
+ *
+ *  \param[in]    u32Channel  actuator (channels are numbered as eActuator)
+ *  \param[in]    s32Level    dim level [0,100]
+ *  \param[in]    pvData      not used
+ *
+ *  \return       see writeActuator
+ *
+ ******************************************************************************/
+static BBBError onFadeWrite(uint32_t u32Channel, int32_t s32Level, void * pvData) {
+
+    /* Written when the webhouse is ready */
+    if(isWebhouseReady() == FALSE) {
+        queueActuator((eActuator) u32Channel, s32Level);
+        return (BBB_SUCCESS);
+    }
+
+    return (writeActuator((eActuator) u32Channel, s32Level));
+}
+
+/*******************************************************************************
+ *  function :    getNowNs
+ ******************************************************************************/
+static uint64_t getNowNs(void) {
+
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return ((uint64_t) sNow.tv_sec * 1000000000ULL + (uint64_t) sNow.tv_nsec);
+}
+
+/*******************************************************************************
+ *  function :    initThread
+ ******************************************************************************/
+/** \brief        Initializes all devices concurrently and makes the webhouse
+ *                ready
+ *                <p>
+ *                Starts one thread per device and waits for all of them. A
+ *                device whose thread can not be created is initialized by
+ *                this thread.
+ *
+ *  \type         static
+ *
+ *  \param[in]    pvData  not used
+ *
+ *  \return       not used
+ *
+ ******************************************************************************/
+static void * initThread(void * pvData) {
+
+    uint32_t  u32Jobs = sizeof(asInitJob) / sizeof(asInitJob[0]);
+    boolE     abThread[sizeof(asInitJob) / sizeof(asInitJob[0])];
+    uint64_t  u64Start;
+    uint64_t  u64Total;
+    BBBError  error = BBB_SUCCESS;
+    uint32_t  i;
+
+    /* Block all signals for this thread and the ones of the devices */
+    blockAllSignalForThread();
+
+    u64Start = getNowNs();
+    for(i = 0; i < u32Jobs; i++) {
+        abThread[i] = (pthread_create(&asInitJob[i].idThread, NULL,
+                                      initJobThread, &asInitJob[i]) == 0) ?
+                      TRUE : FALSE;
+        if(abThread[i] == FALSE) {
+            initJobThread(&asInitJob[i]);
+        }
+    }
+
+    for(i = 0; i < u32Jobs; i++) {
+        if(abThread[i] == TRUE) {
+            pthread_join(asInitJob[i].idThread, NULL);
+        }
+        error |= asInitJob[i].error;
+
+        /* The state of a device which failed is unknown */
+        if((asInitJob[i].error != BBB_SUCCESS) && (asInitJob[i].eAct < ACT_COUNT)) {
+            pthread_mutex_lock(&mutexShadow);
+            asShadow[asInitJob[i].eAct].bValid = FALSE;
+            pthread_mutex_unlock(&mutexShadow);
+        }
+        INFOPRINT("init %-8s %6llu us %s", asInitJob[i].pcName,
+                  (unsigned long long) (asInitJob[i].u64DurationNs / 1000),
+                  (asInitJob[i].error == BBB_SUCCESS) ? "" : "failed");
+    }
+    u64Total = getNowNs() - u64Start;
+    INFOPRINT("init total    %6llu us", (unsigned long long) (u64Total / 1000));
+
+    errorInit = error;
+    __atomic_store_n(&bReady, TRUE, __ATOMIC_RELEASE);
+
+    /* Values set while the devices were initialized */
+    flushWebhouse();
+
+    if(pfReadyHook != NULL) {
+        pfReadyHook(error);
+    }
+
+    pthread_exit(NULL);
+}
+
+/*******************************************************************************
+ *  function :    initJobThread
+ ******************************************************************************/
+static void * initJobThread(void * pvData) {
+
+    sInitJob * psJob = (sInitJob *) pvData;
+    uint64_t   u64Start = getNowNs();
+
+    psJob->error = psJob->pfInit();
+    psJob->u64DurationNs = getNowNs() - u64Start;
+
+    return (NULL);
+}
+
+/*******************************************************************************
+ *  function :    initAlarm
+ ******************************************************************************/
+static BBBError initAlarm(void) {
+
+    BBBError error = BBB_SUCCESS;
+
+    /* The pir registers its gpio at the event thread */
+    error = psHw->pfInitGpioEvent();
+    error |= initPir();
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    initTemp
+ ******************************************************************************/
+static BBBError initTemp(void) {
+
+    return (psHw->pfStartSamplerTemp(au8TempSensor, sizeof(au8TempSensor),
+                                     TEMP_SAMPLE_PERIOD_MS));
 }
 
 /*******************************************************************************
@@ -645,9 +1509,9 @@ static BBBError initTV(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = exportGpio(GPIO_TV);
-    error |= setGpioDirection(GPIO_TV, GPIO_DIR_OUT);
-    error |= setGpioValue(GPIO_TV, GPIO_VALUE_LOW);
+    error = psHw->pfExportGpio(GPIO_TV);
+    error |= psHw->pfSetGpioDirection(GPIO_TV, GPIO_DIR_OUT);
+    error |= psHw->pfSetGpioValue(GPIO_TV, GPIO_VALUE_LOW);
 
     return (error);
 }
@@ -659,8 +1523,8 @@ static BBBError finalizeTV(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = setGpioValue(GPIO_TV, GPIO_VALUE_LOW);
-    error |= unexportGpio(GPIO_TV);
+    error = psHw->pfSetGpioValue(GPIO_TV, GPIO_VALUE_LOW);
+    error |= psHw->pfUnexportGpio(GPIO_TV);
 
     return (error);
 }
@@ -672,9 +1536,9 @@ static BBBError initLED(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = exportGpio(GPIO_LED);
-    error |= setGpioDirection(GPIO_LED, GPIO_DIR_OUT);
-    error |= setGpioValue(GPIO_LED, GPIO_VALUE_LOW);
+    error = psHw->pfExportGpio(GPIO_LED);
+    error |= psHw->pfSetGpioDirection(GPIO_LED, GPIO_DIR_OUT);
+    error |= psHw->pfSetGpioValue(GPIO_LED, GPIO_VALUE_LOW);
 
     return (error);
 }
@@ -686,8 +1550,8 @@ static BBBError finalizeLED(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = setGpioValue(GPIO_LED, GPIO_VALUE_LOW);
-    error |= unexportGpio(GPIO_LED);
+    error = psHw->pfSetGpioValue(GPIO_LED, GPIO_VALUE_LOW);
+    error |= psHw->pfUnexportGpio(GPIO_LED);
 
     return (error);
 }
@@ -699,9 +1563,9 @@ static BBBError initSLampe(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = setPwmState(PWM_P9_22, PWM_RUN);
-    error |= setPwmPeriod(PWM_P9_22, PWM_PERIOD);
-    error |= setPwmDuty(PWM_P9_22, PWM_PERIOD);
+    error = psHw->pfSetPwmState(PWM_P9_22, PWM_RUN);
+    error |= psHw->pfSetPwmPeriod(PWM_P9_22, PWM_PERIOD);
+    error |= psHw->pfSetPwmDuty(PWM_P9_22, PWM_PERIOD);
 
     return (error);
 }
@@ -711,7 +1575,7 @@ static BBBError initSLampe(void) {
  ******************************************************************************/
 static BBBError finalizeSLampe(void) {
 
-    return (setPwmState(PWM_P9_22, PWM_STOP));
+    return (psHw->pfSetPwmState(PWM_P9_22, PWM_STOP));
 }
 
 /*******************************************************************************
@@ -721,9 +1585,9 @@ static BBBError initDLampe(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = setPwmState(PWM_P9_14, PWM_RUN);
-    error |= setPwmPeriod(PWM_P9_14, PWM_PERIOD);
-    error |= setPwmDuty(PWM_P9_14, PWM_PERIOD);
+    error = psHw->pfSetPwmState(PWM_P9_14, PWM_RUN);
+    error |= psHw->pfSetPwmPeriod(PWM_P9_14, PWM_PERIOD);
+    error |= psHw->pfSetPwmDuty(PWM_P9_14, PWM_PERIOD);
 
     return (error);
 }
@@ -733,7 +1597,7 @@ static BBBError initDLampe(void) {
  ******************************************************************************/
 static BBBError finalizeDLampe(void) {
 
-    return (setPwmState(PWM_P9_14, PWM_STOP));
+    return (psHw->pfSetPwmState(PWM_P9_14, PWM_STOP));
 }
 
 /*******************************************************************************
@@ -743,9 +1607,9 @@ static BBBError initHeizung(void) {
 
     BBBError error = BBB_SUCCESS;
 
-    error = setPwmState(PWM_P8_19, PWM_RUN);
-    error |= setPwmPeriod(PWM_P8_19, PWM_PERIOD);
-    error |= setPwmDuty(PWM_P8_19, PWM_PERIOD);
+    error = psHw->pfSetPwmState(PWM_P8_19, PWM_RUN);
+    error |= psHw->pfSetPwmPeriod(PWM_P8_19, PWM_PERIOD);
+    error |= psHw->pfSetPwmDuty(PWM_P8_19, PWM_PERIOD);
 
     return (error);
 }
@@ -755,37 +1619,5 @@ static BBBError initHeizung(void) {
  ******************************************************************************/
 static BBBError finalizeHeizung(void) {
 
-    return (setPwmState(PWM_P8_19, PWM_STOP));
-}
-
-/*******************************************************************************
- *  function :    calcDuration
- ******************************************************************************/
-static uint64_t calcDuration(uint64_t u64StartTime, uint64_t u64StopTime) {
-
-    uint64_t u64Duration = 0;
-
-    if(u64StartTime > u64StopTime) {
-
-        u64Duration = (UINT64_MAX - u64StartTime) + u64StopTime;
-
-    } else {
-
-        u64Duration = u64StopTime - u64StartTime;
-    }
-
-    return (u64Duration);
-}
-
-/*******************************************************************************
- *  function :    timespec2nsec
- ******************************************************************************/
-static uint64_t timespec2nsec(struct timespec * time) {
-
-    uint64_t u64TimeNsec = 0;
-
-    u64TimeNsec += time->tv_nsec;
-    u64TimeNsec += ((uint64_t) time->tv_sec) * ((uint64_t) 1000000000ULL);
-
-    return (u64TimeNsec);
+    return (psHw->pfSetPwmState(PWM_P8_19, PWM_STOP));
 }
@@ -8,7 +8,9 @@
  *              <p>
  *              Before any other function can be used, the webhouse must be
  *              initialized by calling initWebhouse(). To release all resource,
- *              finalizeWebhouse() can be called.
+ *              finalizeWebhouse() can be called. startWebhouse() initializes
+ *              the devices in the background, the webhouse can be used
+ *              before all of them are done (see isWebhouseReady).
  *              <p>
  *              The following hw can be controlled by this api:
  *              <ul>
@@ -17,22 +19,35 @@
  *              <li> led: The LED (just used for test purposes) can be turned
  *              on/off, and the state can be polled.
  *              <li> sLampe: The floor lamp can be dimmed from 0 (dark) to
- *              100 (brightest) and the dim state can be polled
+ *              100 (brightest) and the dim state can be polled. The lamp fades
+ *              to a new level (see Fade.h).
  *              <li> dlampe: The ceiling lamp can be dimmed from 0 (dark) to
- *              100 (brightest) and the dim state can be polled
+ *              100 (brightest) and the dim state can be polled. The lamp fades
+ *              to a new level.
  *              <li> heizung: The heater can be dimmed from 0 (no heating) to
  *              100 (full heating) and the dim state can be polled
  *              <li> Current Temperature: The current temperature can be polled
  *              <li> Alarm: The alarm can be enabled/disabled, the alarm state
  *              can be polled, it can be polled if an alarm was triggered by the
- *              pir and the triggered alarm can be reseted.
+ *              pir and the triggered alarm can be reseted. Every movement
+ *              can be read with its timestamp (readAlarmEvents).
  *              </ul>
+ *              <p>
+ *              The state of the actuators is kept in memory, the getters do
+ *              not access the hardware and writing an unchanged value is
+ *              skipped. syncWebhouseShadow() detects and corrects changes
+ *              made behind the back of the webhouse. The values of the TV,
+ *              the LED and the heater are queued, only the latest one of
+ *              every actuator is written by flushWebhouse().
  *
  *  \author     wht4
  *
  ******************************************************************************/
 /*
  *  function    initWebhouse
+ *              startWebhouse
+ *              waitWebhouse
+ *              isWebhouseReady
  *              finalizeWebhouse
  *              turnTVOn
  *              turnTVOff
@@ -47,11 +62,15 @@
  *              dimHeizung
  *              getHeizungState
  *              getTempIst
+ *              getTempIstHalfDeg
  *              enableAlarm
  *              disableAlarm
  *              getAlarmState
  *              isAlarmSet
  *              resetAlarm
+ *              readAlarmEvents
+ *              syncWebhouseShadow
+ *              flushWebhouse
  *
  ******************************************************************************/
 
@@ -59,13 +78,20 @@
 #include <stdint.h>
 
 #include "BBBTypes.h"
+#include "EventRing.h"
 
 //----- Macros -----------------------------------------------------------------
 
 //----- Data types -------------------------------------------------------------
 
+/** Called when all devices are initialized, with the result                  */
+typedef void (*pfWebhouseReady)(BBBError error);
+
 //----- Function prototypes ----------------------------------------------------
 extern BBBError initWebhouse(void);
+extern BBBError startWebhouse(pfWebhouseReady pfReady);
+extern BBBError waitWebhouse(void);
+extern boolE    isWebhouseReady(void);
 extern BBBError finalizeWebhouse(void);
 
 extern BBBError turnTVOn(void);
@@ -84,13 +110,18 @@ extern int32_t  getDLampeState(void);
 
 extern BBBError dimHeizung(uint8_t u8Duty);
 extern int32_t  getHeizungState(void);
-extern int32_t  getTempIst(void);
+extern BBBError getTempIst(int32_t * ps32Temp, uint32_t * pu32AgeMs);
+extern BBBError getTempIstHalfDeg(int32_t * ps32HalfDeg, uint32_t * pu32AgeMs);
 
 extern BBBError enableAlarm(void);
 extern BBBError disableAlarm(void);
 extern int32_t  getAlarmState(void);
 extern int32_t  isAlarmSet(void);
 extern void     resetAlarm(void);
+extern uint32_t readAlarmEvents(sInputEvent * asEvents, uint32_t u32MaxEvents);
+
+extern BBBError syncWebhouseShadow(void);
+extern BBBError flushWebhouse(void);
 
 //----- Data -------------------------------------------------------------------
 
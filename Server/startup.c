@@ -5,7 +5,10 @@
  *  \brief      Main application for the beaglebone black webhouse
  *              <p>
  *              The application implements a socket server (ip: localhost,
- *              port:5000) and waits on a connection attempt of the client.
+ *              port:5000) which serves any number of clients concurrently
+ *              out of a single epoll based event loop (see Reactor.h). The
+ *              heater control and the transmission of changed values are
+ *              periodic tasks of the same loop (see Scheduler.h).
  *              <p>
  *              The client can control  different in- and outputs of the
  *              webhouse. The following objects are available:
@@ -20,6 +23,18 @@
  *              <li> alarm: The alarm can be turned on/off
  *              <li> pir: The alarm was triggered by the pir
  *              </ul>
+ *              <p>
+ *              Usage: webhouse [-b backend] [-m file] [-l level]
+ *              <ul>
+ *              <li> -b: hardware backend, "sysfs" (default, see
+ *              CONFIG_HW_BACKEND), "chardev", "mmap" or "sim" to run without
+ *              a beaglebone
+ *              <li> -m: source of the gpio registers of the mmap backend,
+ *              /dev/mem (default, see CONFIG_GPIOMMAP_DEVICE) or a register
+ *              image
+ *              <li> -l: lowest level logged by all modules at runtime, 0
+ *              (debug) to 4 (nothing), default CONFIG_LOG_RUNTIME_LEVEL
+ *              </ul>
  *
  *  \author     wht4
  *
@@ -34,6 +49,13 @@
  *              main
  *  functions  local:
  *              shutdownHook
+ *              onWebhouseReady
+ *              onReceive
+ *              onConnect
+ *              controlTask
+ *              shadowTask
+ *              flushTask
+ *              telemetryTask
  *
  ******************************************************************************/
 
@@ -43,11 +65,6 @@
 #include <unistd.h>
 #include <time.h>
 #include <string.h>
-#include <arpa/inet.h>
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <netdb.h>
 
 #include "Webhouse.h"
 #include "Log.h"
@@ -55,8 +72,11 @@
 #include "BBBSignal.h"
 #include "Json.h"
 #include "RxTxJSON.h"
-
+#include "Reactor.h"
+#include "Scheduler.h"
 #include "TCPServer.h"
+#include "HwBackend.h"
+#include "GpioMmap.h"
 
 //----- Macros -----------------------------------------------------------------
 
@@ -64,145 +84,250 @@
 
 //----- Function prototypes ----------------------------------------------------
 static void shutdownHook(int32_t sig);
+static void onWebhouseReady(BBBError error);
+static void onReceive(sConnection * psConn, char * pcData, uint32_t u32Length);
+static void onConnect(sConnection * psConn);
+static void controlTask(uint64_t u64Expirations, void * pvData);
+static void shadowTask(uint64_t u64Expirations, void * pvData);
+static void flushTask(uint64_t u64Expirations, void * pvData);
+static void telemetryTask(uint64_t u64Expirations, void * pvData);
 
 //----- Data -------------------------------------------------------------------
-enum state {
-	NORMAL, SHUTDOWN, CLOSING
-};
-static volatile int eShutdown = NORMAL;
+static volatile boolE eShutdown = FALSE;
 
 //----- Implementation ---------------------------------------------------------
 
 /*******************************************************************************
  *  function :    main
  ******************************************************************************/
-/** \brief        Starts the socket server (ip: localhost, port:5000) and waits
- *                on a connection attempt of the client.
+/** \brief        Starts the socket server (ip: localhost, port:5000) and serves
+ *                all connected clients out of a single event loop.
  *
  *  \type         global
  *
- *  \return       EXIT_SUCCESS
+ *  \param[in]    argc  number of arguments
+ *  \param[in]    argv  arguments, -b selects the hardware backend, -m the
+ *                      source of the mmap backend, -l the log level of all
+ *                      modules
+ *
+ *  \return       EXIT_SUCCESS, EXIT_FAILURE on an invalid argument
  *
  ******************************************************************************/
 int main(int argc, char **argv) {
 
 	BBBError error = BBB_SUCCESS;
+	const char * backend = CONFIG_HW_BACKEND;
+	uint32_t module;
+	int opt;
 
-	//struct sockaddr_in
-	//{
-	//	uint8_t        sa_len;      // Length
-	//	sa_family_t    sin_family;  // Address family
-	//	in_port_t      sin_port;    // Address port (16bit)
-	//	struct in_addr sin_addr;    // IP (32bit)
-	//	char           sin_zero[8];	// Not used
-	//}
-
-	socklen_t clilen;
-	struct sockaddr_in serv_addr, cli_addr;
-	int n, m;
-
-	/* Initialize the webhouse */
-	error = initWebhouse();
-	enableAlarm();
+	while ((opt = getopt(argc, argv, "b:m:l:")) != -1) {
+		if (opt == 'b') {
+			backend = optarg;
+		} else if ((opt == 'm') && (setGpioMmapDevice(optarg) == BBB_SUCCESS)) {
+			continue;
+		} else if ((opt == 'l') && (optarg[0] >= '0') && (optarg[0] <= '4')
+				&& (optarg[1] == '\0')) {
+			for (module = 0; module < LOG_MODULES; module++) {
+				setLogLevel(module, optarg[0] - '0');
+			}
+		} else {
+			fprintf(stderr, "Usage: %s [-b sysfs|chardev|mmap|sim] [-m file] "
+					"[-l 0..4]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (selectHwBackend(backend) != BBB_SUCCESS) {
+		return EXIT_FAILURE;
+	}
 
-	printf("\nStart of BBB Webhouse with Websocket TCP Server on port 5000");
+	/* Initialize the webhouse in the background, the clients are */
+	/* already served while slow devices are initialized          */
+	error = startWebhouse(onWebhouseReady);
+
+	INFOPRINT("Start of BBB Webhouse with Websocket TCP Server on port %d",
+			CONFIG_SOCKET_PORT);
+	setConnectHandlerTCP(onConnect);
 
 	if ((error == BBB_SUCCESS)
-			&& (registerExitHandler(shutdownHook) == BBB_SUCCESS)) {
-		// ###############################################################
-		// 			start effective TCP WEbsocket Server HERE
-		// ###############################################################
-
-		/* Create Server Socked (SS) */
-		sockfd = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-		//printf("socket created\n");
-
-		/* Bind */
-		//	memset(&server_addr 0, sizeof(server_addr));	// zero the struct before filling the fields
-		bzero((char *) &serv_addr, sizeof(serv_addr));
-		serv_addr.sin_family = AF_INET;
-		serv_addr.sin_addr.s_addr = htonl(INADDR_ANY);
-		serv_addr.sin_port = htons(SERVER_PORT_NBR);
-
-		if (bind(sockfd, (struct sockaddr*) &serv_addr,
-				sizeof(struct sockaddr_in)) < 0) {
-			close(sockfd);
-			INFOPRINT("\nbinding failed!");
-		} else {
-			/* Socket bound to desired port now */
-			//printf("socket bound to desired port\n");
-			/* Listen */
-			if (listen(sockfd, BACKLOG) < 0) {
-				close(sockfd);
-				INFOPRINT("\nlistening failed!");
-			} else {
-				/* Socket placed in listening state now */
-				printf("\nsocket in listening state now\n");
-
-				/* Accept */
-				/* get data length of addr_remote */
-				clilen = sizeof(cli_addr);
-
-				while (eShutdown != SHUTDOWN) {
-					newsockfd = accept(sockfd, (struct sockaddr*) &cli_addr,
-							&clilen);
-
-					if (newsockfd < 0) {
-						close(sockfd);
-					} else {
-						printf("\nconnection established");
-						bzero(rxBuf, RX_BUFFER_SIZE);
-						bzero(txBuf, TX_BUFFER_SIZE);
-
-						while (eShutdown != CLOSING && eShutdown != SHUTDOWN) {
-							/* Connection established now, use newSock_id to communicate with client */
-
-							// SEND (OR CHECK IF SEND MAKES SENSE)
-							/* this has a certain delay in it! */
-							m = controlWebhouseValues(txBuf);
-							if (m != 0) {
-								printf("\nSENT(%d) = \"%s\"", m, txBuf);
-								send(newsockfd, txBuf, m, 0);
-							}
-
-							// todo: senden der anfangszustände des webhueslis
-							n = recv(newsockfd, rxBuf, RX_BUFFER_SIZE,
-							MSG_DONTWAIT);
-
-							if (n > 0) {
-								// RECEIVE
-								rxBuf[n] = '\0';
-								printf("\nRECV = \"%s\"", rxBuf);
-								receiveAndSetValues(rxBuf, n);
-							}
-							if (n == 0) {
-								// CLOSE
-								printf("\nConnection closed by client.");
-								eShutdown = CLOSING;
-							}
-						}
-					}
-					close(newsockfd);
-				}
-				close(sockfd);
-				close(newsockfd);
-			}
+			&& (registerExitHandler(shutdownHook) == BBB_SUCCESS)
+			&& (initReactor() == BBB_SUCCESS)
+			&& (initTCPServer(CONFIG_SOCKET_PORT, onReceive) == BBB_SUCCESS)
+			&& (addSchedulerTask(CONFIG_CONTROL_PERIOD_MS, controlTask, NULL)
+					== BBB_SUCCESS)
+			&& (addSchedulerTask(CONFIG_TELEMETRY_PERIOD_MS, telemetryTask,
+					NULL) == BBB_SUCCESS)
+			&& (addSchedulerTask(CONFIG_ACTUATOR_FLUSH_PERIOD_MS, flushTask,
+					NULL) == BBB_SUCCESS)
+			&& ((CONFIG_SHADOW_SYNC_PERIOD_MS == 0)
+					|| (addSchedulerTask(CONFIG_SHADOW_SYNC_PERIOD_MS,
+							shadowTask, NULL) == BBB_SUCCESS))) {
+
+		/* Sleep until a client or a timer needs attention. A signal */
+		/* interrupts the wait, thus the shutdown flag is checked.   */
+		while (eShutdown == FALSE) {
+			runReactor(REACTOR_TIMEOUT_INF);
 		}
+		INFOPRINT("Ctrl-C pressed....shutdown");
 
-		// ###############################################################
-		// 				END OF TCP SERVER
-		// ###############################################################
+		finalizeTCPServer();
 	} else {
 		ERRORPRINT("Failed to start BBB Webhouse");
 	}
 
+	finalizeScheduler();
+	finalizeReactor();
+
 	/* Detach all resource */
 	finalizeWebhouse();
-	printf("\n\nStop of BBB webhouse \n");
+	INFOPRINT("Stop of BBB webhouse");
 
 	return EXIT_SUCCESS;
 }
 
+/*******************************************************************************
+ *  function :    controlTask
+ ******************************************************************************/
+/** \brief        Periodic task (CONFIG_CONTROL_PERIOD_MS) controlling the
+ *                heater
+ *
+ *  \type         static
+ *
+ *  \param[in]    u64Expirations  number of elapsed periods
+ *  \param[in]    pvData          not used
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void controlTask(uint64_t u64Expirations, void * pvData) {
+
+	/* The temperature is not sampled before the webhouse is ready */
+	if (isWebhouseReady() == TRUE) {
+		/* Missed periods are integrated by the controller as well */
+		controlHeizung(u64Expirations);
+	}
+}
+
+/*******************************************************************************
+ *  function :    shadowTask
+ ******************************************************************************/
+/** \brief        Periodic task (CONFIG_SHADOW_SYNC_PERIOD_MS) correcting
+ *                actuators which drifted from their shadow state
+ *
+ *  \type         static
+ *
+ *  \param[in]    u64Expirations  number of elapsed periods
+ *  \param[in]    pvData          not used
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void shadowTask(uint64_t u64Expirations, void * pvData) {
+
+	syncWebhouseShadow();
+}
+
+/*******************************************************************************
+ *  function :    flushTask
+ ******************************************************************************/
+/** \brief        Periodic task (CONFIG_ACTUATOR_FLUSH_PERIOD_MS) writing the
+ *                latest queued value of every actuator
+ *
+ *  \type         static
+ *
+ *  \param[in]    u64Expirations  number of elapsed periods
+ *  \param[in]    pvData          not used
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void flushTask(uint64_t u64Expirations, void * pvData) {
+
+	flushWebhouse();
+}
+
+/*******************************************************************************
+ *  function :    telemetryTask
+ ******************************************************************************/
+/** \brief        Periodic task (CONFIG_TELEMETRY_PERIOD_MS) sending changed
+ *                values to all clients
+ *                <p>
+ *                While no client receives messages, nothing is consumed: a
+ *                changed value stays pending and an alarm stays latched.
+ *
+ *  \type         static
+ *
+ *  \param[in]    u64Expirations  number of elapsed periods
+ *  \param[in]    pvData          not used
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void telemetryTask(uint64_t u64Expirations, void * pvData) {
+
+	static char txBuf[TX_BUFFER_SIZE];
+	uint32_t keys;
+	int m;
+
+	if (getNumberOfClients() == 0) {
+		latchWebhouseAlarms();
+		return;
+	}
+
+	m = controlWebhouseValues(txBuf, sizeof(txBuf), &keys);
+	if (m != 0) {
+		INFOPRINT("SENT(%d) = \"%.*s\"", m, m, txBuf);
+		/* A slow client gets the latest values instead of a backlog */
+		broadcastLatestTCP(txBuf, m, keys);
+	}
+}
+
+/*******************************************************************************
+ *  function :    onReceive
+ ******************************************************************************/
+/** \brief        Handles a message received from a client
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     connection the data was received on
+ *  \param[in]    pcData     a single received message (not '\0' terminated)
+ *  \param[in]    u32Length  length of the message
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onReceive(sConnection * psConn, char * pcData, uint32_t u32Length) {
+
+	INFOPRINT("RECV(%u) = \"%.*s\"", psConn->u32Id, (int) u32Length, pcData);
+	receiveAndSetValues(pcData, u32Length);
+}
+
+/*******************************************************************************
+ *  function :    onConnect
+ ******************************************************************************/
+/** \brief        Sends the current values (Ist-Temperatur, Heizung and a
+ *                latched alarm) to a client which receives messages from now
+ *                on
+ *
+ *  \type         static
+ *
+ *  \param[in]    psConn     new client
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onConnect(sConnection * psConn) {
+
+	static char txBuf[TX_BUFFER_SIZE];
+	uint32_t keys;
+	int m;
+
+	m = currentWebhouseValues(txBuf, sizeof(txBuf), &keys);
+	if (m != 0) {
+		INFOPRINT("SENT(%u) = \"%.*s\"", psConn->u32Id, m, txBuf);
+		sendLatestTCP(psConn, txBuf, m, keys);
+	}
+}
+
 /*******************************************************************************
  *  function :    shutdownHook
  ******************************************************************************/
@@ -217,7 +342,28 @@ int main(int argc, char **argv) {
  ******************************************************************************/
 static void shutdownHook(int32_t sig) {
 
-	printf("Ctrl-C pressed....shutdown hook in main");
-	eShutdown = SHUTDOWN;
+	/* Nothing is logged here, a signal may interrupt a log message */
+	eShutdown = TRUE;
+}
+
+/*******************************************************************************
+ *  function :    onWebhouseReady
+ ******************************************************************************/
+/** \brief        Called by the initialization thread of the webhouse when
+ *                all devices are initialized, enables the alarm
+ *
+ *  \type         static
+ *
+ *  \param[in]    error    result of the initialization
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onWebhouseReady(BBBError error) {
+
+	if (error != BBB_SUCCESS) {
+		ERRORPRINT("Failed to initialize the webhouse (%d)", error);
+	}
+	enableAlarm();
 }
 
@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include "BBBSignal.h"
+#define LOG_MODULE  SYS
 #include "Log.h"
 
 //----- Macros -----------------------------------------------------------------
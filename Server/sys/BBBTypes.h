@@ -44,6 +44,7 @@ typedef enum _BBBError {
     BBB_FILE_CLOSE        = 11, ///< Could not close file
     BBB_FILE_IOCTL        = 12, ///< Error in device control
     BBB_FILE_READ         = 13, ///< Error on read file
+    BBB_FILE_WRITE        = 14, ///< Error on write file
 
     BBB_GPIO_POLL         = 20, ///< Error on polling a gpio
 
@@ -58,6 +59,7 @@ typedef enum _BBBError {
 
     BBB_JSON_PACK         = 40, ///< We could not pack a new json message
     BBB_JSON_CREATE       = 41, ///< We could not create json message
+    BBB_JSON_UNSUPPORTED  = 42, ///< Message is not a flat object of string or number values
 
     BBB_RINGB_SIZE        = 50, ///< The passed buffer is to small to hold full message content
     BBB_RINGB_FULL        = 51, ///< You try to write into a ringbuffer which is full
@@ -71,7 +73,17 @@ typedef enum _BBBError {
 
     BBB_CMD_INVALID       = 80, ///< An invalid cmd object was received
     BBB_CMD_NO_CMD        = 81, ///< No cmd object is available
-    BBB_CMD_COMPOSE_MSG   = 82  ///< The response could not be composed
+    BBB_CMD_COMPOSE_MSG   = 82, ///< The response could not be composed
+
+    BBB_EVENT_CREATE      = 90, ///< The epoll instance could not be created
+    BBB_EVENT_CTL         = 91, ///< epoll_ctl() failed
+    BBB_EVENT_WAIT        = 92, ///< epoll_wait() failed
+    BBB_TIMER_CREATE      = 93, ///< A timer could not be created or armed
+
+    BBB_WS_INCOMPLETE     = 100,///< WebSocket handshake or frame not yet complete
+    BBB_WS_HANDSHAKE      = 101,///< Invalid WebSocket opening handshake
+    BBB_WS_PROTOCOL       = 102,///< WebSocket protocol violation
+    BBB_WS_TOO_BIG        = 103 ///< WebSocket message exceeds the buffer
 
 } BBBError;
 
@@ -0,0 +1,226 @@
+/******************************************************************************/
+/** \file       EventRing.c
+ *******************************************************************************
+ *
+ *  \brief      Lock-free ring buffer of timestamped input events.
+ *              <p>
+ *              Bounded multi producer / single consumer queue: every slot
+ *              carries the position it is ready for. A producer claims the
+ *              push position with a compare and swap, fills the slot and
+ *              hands it to the consumer by advancing the turn of the slot.
+ *              The consumer hands the slot back to the producers of the next
+ *              round the same way. The position of an event is its sequence
+ *              number.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              initEventRing
+ *              pushEventRing
+ *              popEventRing
+ *              isEmptyEventRing
+ *              getDroppedEventRing
+ *  functions  local:
+ *              .
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <string.h>
+
+#include "EventRing.h"
+
+//----- Macros -----------------------------------------------------------------
+#define EVENT_RING_MASK        ( EVENT_RING_SIZE - 1 )
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+
+//----- Data -------------------------------------------------------------------
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    initEventRing
+ ******************************************************************************/
+/** \brief        Initializes an empty ring
+ *                <p>
+ *                Must be called before any thread uses the ring.
+ *
+ *  \type         global
+ *
+ *  \param[out]   psRing  ring buffer
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void initEventRing(sEventRing * psRing) {
+
+    uint32_t u32Cell;
+
+    memset(psRing, 0, sizeof(*psRing));
+    for(u32Cell = 0; u32Cell < EVENT_RING_SIZE; u32Cell++) {
+        psRing->asCell[u32Cell].u64Turn = u32Cell;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ *  function :    pushEventRing
+ ******************************************************************************/
+/** \brief        Appends an event to the ring
+ *                <p>
+ *                May be called by any thread, never blocks.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psRing      ring buffer
+ *  \param[in]    u32Source   source of the event (e.g. the gpio number)
+ *  \param[in]    s32Value    value of the source after the event
+ *  \param[in]    u64StampNs  time of the event (CLOCK_MONOTONIC) [ns]
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      on success
+ *                BBB_RINGB_FULL   the ring is full, the event was dropped
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError pushEventRing(sEventRing * psRing,
+                       uint32_t u32Source,
+                       int32_t s32Value,
+                       uint64_t u64StampNs) {
+
+    sEventCell * psCell;
+    uint64_t     u64Pos;
+    uint64_t     u64Turn;
+
+    u64Pos = __atomic_load_n(&psRing->u64Head, __ATOMIC_RELAXED);
+    for(;;) {
+        psCell = &psRing->asCell[u64Pos & EVENT_RING_MASK];
+        u64Turn = __atomic_load_n(&psCell->u64Turn, __ATOMIC_ACQUIRE);
+
+        if(u64Turn == u64Pos) {
+            /* Slot is free, claim the position (u64Pos is reloaded on failure) */
+            if(__atomic_compare_exchange_n(&psRing->u64Head, &u64Pos, u64Pos + 1,
+                                           FALSE, __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if(u64Turn < u64Pos) {
+            /* Slot still holds the event of the last round */
+            __atomic_add_fetch(&psRing->u64Dropped, 1, __ATOMIC_RELAXED);
+            return (BBB_RINGB_FULL);
+        } else {
+            /* Another producer claimed the position meanwhile */
+            u64Pos = __atomic_load_n(&psRing->u64Head, __ATOMIC_RELAXED);
+        }
+    }
+
+    psCell->sEvent.u64Seq = u64Pos + 1;
+    psCell->sEvent.u64StampNs = u64StampNs;
+    psCell->sEvent.u32Source = u32Source;
+    psCell->sEvent.s32Value = s32Value;
+    __atomic_store_n(&psCell->u64Turn, u64Pos + 1, __ATOMIC_RELEASE);
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    popEventRing
+ ******************************************************************************/
+/** \brief        Removes up to u32MaxEvents events from the ring
+ *                <p>
+ *                The events are returned in the order of their sequence
+ *                numbers. Must only be called by the consumer thread.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psRing        ring buffer
+ *  \param[out]   asEvents      removed events
+ *  \param[in]    u32MaxEvents  number of elements of asEvents
+ *  \param[out]   pu32Events    number of removed events
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS      at least one event was removed
+ *                BBB_RINGB_EMPTY  the ring is empty
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError popEventRing(sEventRing * psRing,
+                      sInputEvent * asEvents,
+                      uint32_t u32MaxEvents,
+                      uint32_t * pu32Events) {
+
+    sEventCell * psCell;
+    uint64_t     u64Pos = psRing->u64Tail;
+    uint32_t     u32Events = 0;
+
+    while(u32Events < u32MaxEvents) {
+        psCell = &psRing->asCell[u64Pos & EVENT_RING_MASK];
+        if(__atomic_load_n(&psCell->u64Turn, __ATOMIC_ACQUIRE) != (u64Pos + 1)) {
+            break;
+        }
+
+        asEvents[u32Events++] = psCell->sEvent;
+        /* Hand the slot to the producers of the next round */
+        __atomic_store_n(&psCell->u64Turn, u64Pos + EVENT_RING_SIZE,
+                         __ATOMIC_RELEASE);
+        u64Pos++;
+    }
+
+    psRing->u64Tail = u64Pos;
+    *pu32Events = u32Events;
+
+    return ((u32Events > 0) ? BBB_SUCCESS : BBB_RINGB_EMPTY);
+}
+
+/*******************************************************************************
+ *  function :    isEmptyEventRing
+ ******************************************************************************/
+/** \brief        Checks if the ring holds any event
+ *                <p>
+ *                Must only be called by the consumer thread.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psRing  ring buffer
+ *
+ *  \return       TRUE if no event is ready to be popped, FALSE otherwise
+ *
+ ******************************************************************************/
+boolE isEmptyEventRing(sEventRing * psRing) {
+
+    uint64_t u64Pos = psRing->u64Tail;
+
+    if(__atomic_load_n(&psRing->asCell[u64Pos & EVENT_RING_MASK].u64Turn,
+                       __ATOMIC_ACQUIRE) == (u64Pos + 1)) {
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/*******************************************************************************
+ *  function :    getDroppedEventRing
+ ******************************************************************************/
+/** \brief        Returns the number of events dropped since the last call
+ *
+ *  \type         global
+ *
+ *  \param[in]    psRing  ring buffer
+ *
+ *  \return       number of dropped events
+ *
+ ******************************************************************************/
+uint64_t getDroppedEventRing(sEventRing * psRing) {
+
+    return (__atomic_exchange_n(&psRing->u64Dropped, 0, __ATOMIC_RELAXED));
+}
@@ -0,0 +1,100 @@
+#ifndef EVENTRING_H_
+#define EVENTRING_H_
+/******************************************************************************/
+/** \file       EventRing.h
+ *******************************************************************************
+ *
+ *  \brief      Lock-free ring buffer of timestamped input events.
+ *              <p>
+ *              Any number of threads may push events (e.g. the gpio event
+ *              thread), a single thread pops them in batches. Neither side
+ *              takes a lock or makes a system call. Every pushed event gets
+ *              the next sequence number of the ring (1, 2, 3, ...), the
+ *              sequence numbers popped are thus consecutive. If the ring is
+ *              full the event is dropped and counted, the consumer fetches
+ *              the number of dropped events with getDroppedEventRing().
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              static sEventRing sRing;
+ *
+ *              initEventRing(&sRing);
+ *
+ *              // producer (any thread)
+ *              pushEventRing(&sRing, 30, 1, u64StampNs);
+ *
+ *              // consumer (a single thread only)
+ *              popEventRing(&sRing, asEvents, 8, &u32Events);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    initEventRing
+ *              pushEventRing
+ *              popEventRing
+ *              isEmptyEventRing
+ *              getDroppedEventRing
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of events a ring can hold, must be a power of two                  */
+#define EVENT_RING_SIZE        ( 64 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Input event */
+typedef struct _sInputEvent {
+
+    uint64_t u64Seq;      ///< sequence number within the ring (starts with 1)
+    uint64_t u64StampNs;  ///< time of the event (CLOCK_MONOTONIC) [ns]
+    uint32_t u32Source;   ///< source of the event (e.g. the gpio number)
+    int32_t  s32Value;    ///< value of the source after the event
+
+} sInputEvent;
+
+/** Slot of the ring */
+typedef struct _sEventCell {
+
+    uint64_t    u64Turn;  ///< position the slot is ready for (push or pop)
+    sInputEvent sEvent;   ///< stored event
+
+} sEventCell;
+
+/** Ring buffer, all members are private */
+typedef struct _sEventRing {
+
+    uint64_t   u64Head;       ///< next push position (shared by producers)
+    uint64_t   u64Tail;       ///< next pop position (consumer only)
+    uint64_t   u64Dropped;    ///< events dropped because the ring was full
+    sEventCell asCell[EVENT_RING_SIZE];
+
+} sEventRing;
+
+//----- Function prototypes ----------------------------------------------------
+extern void     initEventRing(sEventRing * psRing);
+
+extern BBBError pushEventRing(sEventRing * psRing,
+                              uint32_t u32Source,
+                              int32_t s32Value,
+                              uint64_t u64StampNs);
+
+extern BBBError popEventRing(sEventRing * psRing,
+                             sInputEvent * asEvents,
+                             uint32_t u32MaxEvents,
+                             uint32_t * pu32Events);
+
+extern boolE    isEmptyEventRing(sEventRing * psRing);
+
+extern uint64_t getDroppedEventRing(sEventRing * psRing);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* EVENTRING_H_ */
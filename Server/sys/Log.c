@@ -0,0 +1,116 @@
+/******************************************************************************/
+/** \file       Log.c
+ *******************************************************************************
+ *
+ *  \brief      Runtime log levels of the modules of the beaglebone black
+ *              webhouse.
+ *              <p>
+ *              The levels are kept in the single word u32LogMask, thus the
+ *              log macros test a level with one atomic load and any thread
+ *              may change a level while the others log.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              setLogLevel
+ *              getLogLevel
+ *  functions  local:
+ *              .
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#define LOG_MODULE  SYS
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+
+//----- Data -------------------------------------------------------------------
+/** One bit per module and level, see LOG_BIT                                 */
+uint32_t u32LogMask = LOG_MASK(LOG_MODULE_MAIN, CONFIG_LOG_RUNTIME_LEVEL) |
+                      LOG_MASK(LOG_MODULE_APP,  CONFIG_LOG_RUNTIME_LEVEL) |
+                      LOG_MASK(LOG_MODULE_NET,  CONFIG_LOG_RUNTIME_LEVEL) |
+                      LOG_MASK(LOG_MODULE_JSON, CONFIG_LOG_RUNTIME_LEVEL) |
+                      LOG_MASK(LOG_MODULE_SYS,  CONFIG_LOG_RUNTIME_LEVEL) |
+                      LOG_MASK(LOG_MODULE_HW,   CONFIG_LOG_RUNTIME_LEVEL);
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    setLogLevel
+ ******************************************************************************/
+/** \brief        Sets the lowest level of the messages logged by a module
+ *                <p>
+ *                A level below the level compiled in (CONFIG_LOG_MODULE_*)
+ *                has no effect on the messages removed by the compiler.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Module  LOG_MODULE_MAIN, ...
+ *  \param[in]    u32Level   LOG_LEVEL_DEBUG, ..., LOG_LEVEL_NONE
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS    on success
+ *                BBB_ERR_PARAM  unknown module or level
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError setLogLevel(uint32_t u32Module, uint32_t u32Level) {
+
+    uint32_t u32Mask;
+    uint32_t u32New;
+
+    if((u32Module >= LOG_MODULES) || (u32Level > LOG_LEVEL_NONE)) {
+        return (BBB_ERR_PARAM);
+    }
+
+    u32Mask = __atomic_load_n(&u32LogMask, __ATOMIC_RELAXED);
+    do {
+        u32New = (u32Mask & ~LOG_MASK(u32Module, LOG_LEVEL_DEBUG)) |
+                 LOG_MASK(u32Module, u32Level);
+    } while(!__atomic_compare_exchange_n(&u32LogMask, &u32Mask, u32New, FALSE,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    getLogLevel
+ ******************************************************************************/
+/** \brief        Returns the lowest level of the messages logged by a module
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32Module  LOG_MODULE_MAIN, ...
+ *
+ *  \return       LOG_LEVEL_DEBUG, ..., LOG_LEVEL_NONE if the module logs
+ *                nothing or is unknown
+ *
+ ******************************************************************************/
+uint32_t getLogLevel(uint32_t u32Module) {
+
+    uint32_t u32Mask = __atomic_load_n(&u32LogMask, __ATOMIC_RELAXED);
+    uint32_t u32Level;
+
+    if(u32Module >= LOG_MODULES) {
+        return (LOG_LEVEL_NONE);
+    }
+
+    for(u32Level = LOG_LEVEL_DEBUG; u32Level < LOG_LEVEL_NONE; u32Level++) {
+        if((u32Mask & LOG_BIT(u32Module, u32Level)) != 0) {
+            break;
+        }
+    }
+    return (u32Level);
+}
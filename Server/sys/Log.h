@@ -11,7 +11,9 @@
  *              in four different levels (DEBUG, INFO, WARNING and ERROR).
  *              <p>
  *              The log messages can be bypassed to different acceptors
- *              (console, file, ...).
+ *              (console, async, ...). The console acceptor writes the
+ *              message on the calling thread, the async acceptor leaves the
+ *              writing to a background thread (see LogAsync.h).
  *              <p>
  *              If you like to log a message to the log mechanism, you have
  *              to do the following:
@@ -21,22 +23,48 @@
  *              <li> Warning messages are logged with: WARNINGPRINT("msg");
  *              <li> Error messages are logged with: ERRORPRINT("msg");
  *              </ul>
+ *              <p>
+ *              Every source file belongs to a module (MAIN, APP, NET, JSON,
+ *              SYS or HW) and selects it by defining LOG_MODULE before this
+ *              file is included (MAIN otherwise):
+ *              <pre>
+ *              #define LOG_MODULE  HW
+ *              #include "Log.h"
+ *              </pre>
+ *              Messages below the level CONFIG_LOG_MODULE_&lt;module&gt; are
+ *              removed by the compiler. The remaining messages are filtered
+ *              at runtime by the atomic mask u32LogMask, which holds one bit
+ *              per module and level (see setLogLevel()). A disabled message
+ *              thus costs a single load and branch, its arguments are not
+ *              evaluated.
  *
  *  \author     wht4
  *
  ******************************************************************************/
 /*
- *  function    .
+ *  function    setLogLevel
+ *              getLogLevel
  *
  ******************************************************************************/
 
 //----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
 #include "BBBConfig.h"
+#include "BBBTypes.h"
 
 #if (CONFIG_LOG_CONSOLE == 1)
 #define LOG_CONSOLE
-#include "LogConsole.h"
 #endif // (CONFIG_LOG_CONSOLE == 1)
+#include "LogConsole.h"
+
+#if (CONFIG_LOG_ASYNC == 1)
+#define LOG_ASYNC
+#if (CONFIG_LOG_ASYNC_BINARY == 1)
+#define LOG_ASYNC_BINARY
+#endif // (CONFIG_LOG_ASYNC_BINARY == 1)
+#endif // (CONFIG_LOG_ASYNC == 1)
+#include "LogAsync.h"
 
 //----- Macros -----------------------------------------------------------------
 #if (CONFIG_LOG_LEVEL_DEBUG == 1)
@@ -55,6 +83,49 @@
 #define LOG_ERROR
 #endif // (CONFIG_LOG_LEVEL_ERROR == 1)
 
+/** Levels of the log messages                                                */
+#define LOG_LEVEL_DEBUG        ( 0 )
+#define LOG_LEVEL_INFO         ( 1 )
+#define LOG_LEVEL_WARNING      ( 2 )
+#define LOG_LEVEL_ERROR        ( 3 )
+#define LOG_LEVEL_NONE         ( 4 )
+
+/** Modules with a log level of their own                                     */
+#define LOG_MODULE_MAIN        ( 0 )   ///< startup.c
+#define LOG_MODULE_APP         ( 1 )   ///< RxTxJSON.c
+#define LOG_MODULE_NET         ( 2 )   ///< TCPServer.c, WebSocket.c
+#define LOG_MODULE_JSON        ( 3 )   ///< Json.c
+#define LOG_MODULE_SYS         ( 4 )   ///< sys/
+#define LOG_MODULE_HW          ( 5 )   ///< hw/
+#define LOG_MODULES            ( 6 )
+
+#ifndef LOG_MODULE
+#define LOG_MODULE             MAIN
+#endif // #ifndef LOG_MODULE
+
+/** Bit of u32LogMask of a level of a module                                 */
+#define LOG_BIT(Module, Level) ( 1u << (4 * (Module) + (Level)) )
+/** Bits of u32LogMask of a module with all levels from Level upwards        */
+#define LOG_MASK(Module, Level)                                                \
+	(((0xFu << (Level)) & 0xFu) << (4 * (Module)))
+
+#define LOG_PASTE_(A, B)       A##B
+#define LOG_PASTE(A, B)        LOG_PASTE_(A, B)
+
+/*******************************************************************************
+ *  function :    LOG_ENABLED
+ ******************************************************************************/
+/**
+ * Checks if a message of the module of the source file is logged. The first
+ * part is a constant, the compiler removes a message below the compiled level.
+ * \param[in]   Level   LOG_LEVEL_DEBUG, ...
+ * \return      TRUE if the message is logged
+ */
+#define LOG_ENABLED(Level)                                                     \
+	(((Level) >= LOG_PASTE(CONFIG_LOG_MODULE_, LOG_MODULE)) &&                 \
+	 ((__atomic_load_n(&u32LogMask, __ATOMIC_RELAXED) &                        \
+	   LOG_BIT(LOG_PASTE(LOG_MODULE_, LOG_MODULE), Level)) != 0))
+
 
 /*******************************************************************************
  *  function :    LOGINIT
@@ -65,6 +136,7 @@
  */
 #define LOGINIT() {                                                             \
 		INIT_CONSOLE();                                                         \
+		INIT_ASYNC();                                                           \
 }
 
 
@@ -79,8 +151,11 @@
  * \return      void
  */
 #ifdef LOG_DEBUG
-#define DEBUGPRINT(FormatString, Args...) {                                     \
-	DEBUGPRINT_CONSOLE(FormatString, ##Args)                                    \
+#define DEBUGPRINT(FormatString, Args...) {                                    \
+	if (LOG_ENABLED(LOG_LEVEL_DEBUG)) {                                        \
+		DEBUGPRINT_CONSOLE(FormatString, ##Args)                               \
+		DEBUGPRINT_ASYNC(FormatString, ##Args)                                 \
+	}                                                                          \
 }
 #else
 #define DEBUGPRINT(...)
@@ -99,11 +174,14 @@
  */
 #ifdef LOG_INFO
 #define INFOPRINT(FormatString, Args...) {                                     \
-	INFOPRINT_CONSOLE(FormatString, ##Args)                                    \
+	if (LOG_ENABLED(LOG_LEVEL_INFO)) {                                         \
+		INFOPRINT_CONSOLE(FormatString, ##Args)                                \
+		INFOPRINT_ASYNC(FormatString, ##Args)                                  \
+	}                                                                          \
 }
 #else
 #define INFOPRINT(...)
-#endif // #ifdef LOG_DEBUG
+#endif // #ifdef LOG_INFO
 
 
 /*******************************************************************************
@@ -117,12 +195,15 @@
  * \return      void
  */
 #ifdef LOG_WARNING
-#define WARNINGPRINT(FormatString, Args...) {                                 \
-	WARNINGPRINT_CONSOLE(FormatString, ##Args)                                \
+#define WARNINGPRINT(FormatString, Args...) {                                  \
+	if (LOG_ENABLED(LOG_LEVEL_WARNING)) {                                      \
+		WARNINGPRINT_CONSOLE(FormatString, ##Args)                             \
+		WARNINGPRINT_ASYNC(FormatString, ##Args)                               \
+	}                                                                          \
 }
 #else
-#define WARNINGRINT(...)
-#endif // #ifdef LOG_DEBUG
+#define WARNINGPRINT(...)
+#endif // #ifdef LOG_WARNING
 
 
 /*******************************************************************************
@@ -136,18 +217,24 @@
  * \return      void
  */
 #ifdef LOG_ERROR
-#define ERRORPRINT(FormatString, Args...) {                                   \
-	ERRORPRINT_CONSOLE(FormatString, ##Args)                                  \
+#define ERRORPRINT(FormatString, Args...) {                                    \
+	if (LOG_ENABLED(LOG_LEVEL_ERROR)) {                                        \
+		ERRORPRINT_CONSOLE(FormatString, ##Args)                               \
+		ERRORPRINT_ASYNC(FormatString, ##Args)                                 \
+	}                                                                          \
 }
 #else
 #define ERRORPRINT(...)
-#endif // #ifdef LOG_DEBUG
+#endif // #ifdef LOG_ERROR
 
 //----- Data types -------------------------------------------------------------
 
 //----- Function prototypes ----------------------------------------------------
+extern BBBError setLogLevel(uint32_t u32Module, uint32_t u32Level);
+extern uint32_t getLogLevel(uint32_t u32Module);
 
 //----- Data -------------------------------------------------------------------
+extern uint32_t u32LogMask;
 
 
 #endif /* LOG_H_ */
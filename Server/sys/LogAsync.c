@@ -0,0 +1,926 @@
+/******************************************************************************/
+/** \file       LogAsync.c
+ *******************************************************************************
+ *
+ *  \brief      Acceptor of log messages which logs the messages to the stdout
+ *              in the background.
+ *              <p>
+ *              Every thread gets a single producer / single consumer ring at
+ *              its first message. The rings are linked into a list which only
+ *              grows, the ring of a terminated thread is handed to the next
+ *              new thread once the writer has emptied it. The producer owns
+ *              the head, the writer owns the tail of a ring, both are
+ *              published with release / acquire semantics. Every entry is
+ *              stamped with a global sequence number when it is published,
+ *              the writer merges the rings in the order of these numbers,
+ *              thus the messages of all threads are written in the order
+ *              they were logged. The writer thread is started at the first
+ *              message (or by initLogAsync()) and the rings are flushed once
+ *              more at exit(3).
+ *              <p>
+ *              A binary record consists of the index of the descriptor
+ *              (uint16_t, 0xFFFF reports dropped records), the length of the
+ *              arguments (uint16_t), the time of the call (uint64_t,
+ *              CLOCK_MONOTONIC, ns) and the arguments in host byte order. The
+ *              types of the arguments are given by the signature of the
+ *              descriptor, one character per argument:
+ *              <pre>
+ *              w, W   int, unsigned int              4 bytes
+ *              l, L   long, unsigned long            8 bytes
+ *              q, Q   long long, unsigned long long  8 bytes
+ *              z      size_t                         8 bytes
+ *              f, F   double, long double            8 bytes (double)
+ *              p      pointer                        8 bytes
+ *              s      string                         uint16_t length + text
+ *              S      string with a '*' precision    int + uint16_t + text
+ *              </pre>
+ *              The file starts with the magic "BBBLOG1\n", the byte order
+ *              mark 0x01020304 (uint32_t) and the number of descriptors
+ *              (uint32_t). Every descriptor consists of its index, its level
+ *              (both uint16_t) and the '\0' terminated function, format and
+ *              signature.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              initLogAsync
+ *              printLogAsync
+ *              recordLogAsync
+ *              flushLogAsync
+ *  functions  local:
+ *              startWriter
+ *              parseFormat
+ *              openBinary
+ *              registerRing
+ *              releaseRing
+ *              writeAll
+ *              reportDropped
+ *              oldestRing
+ *              releaseEntries
+ *              writerThread
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+#include "BBBConfig.h"
+#include "BBBTypes.h"
+#include "BBBSignal.h"
+#include "LogAsync.h"
+
+//----- Macros -----------------------------------------------------------------
+#define LOG_ASYNC_MASK         ( CONFIG_LOG_ASYNC_RING_SIZE - 1 )
+/* Number of entries written by a single writev(2)                            */
+#define LOG_ASYNC_IOV          ( 32 )
+#define LOG_ASYNC_DROP_SIZE    ( 96 )
+/* Binary record: index, length of the arguments and time of the call         */
+#define LOG_RECORD_HEADER      ( 12 )
+#define LOG_RECORD_DROPPED     ( 0xFFFF )
+#define LOG_BINARY_MAGIC       "BBBLOG1\n"
+
+/* Any record fits an entry, even if all strings are empty                   */
+#if (CONFIG_LOG_ASYNC_ENTRY_SIZE < (LOG_RECORD_HEADER + 8 * LOG_ASYNC_MAX_ARGS))
+#error "CONFIG_LOG_ASYNC_ENTRY_SIZE too small for a binary record"
+#endif
+
+//----- Data types -------------------------------------------------------------
+
+/** Formatted message */
+typedef struct _sLogEntry {
+
+    uint64_t u64Seq;                             ///< global order of entries
+    uint32_t u32Length;                          ///< length of acText
+    char     acText[CONFIG_LOG_ASYNC_ENTRY_SIZE];
+
+} sLogEntry;
+
+/** Ring of a thread */
+typedef struct _sLogRing {
+
+    uint32_t           u32Head __attribute__ ((aligned (64))); ///< producer
+    uint32_t           u32Tail __attribute__ ((aligned (64))); ///< writer
+    uint32_t           u32Read;    ///< next entry to write (writer)
+    uint32_t           u32Flush;   ///< head at the start of a flush (writer)
+    uint64_t           u64Dropped; ///< messages dropped since the last report
+    boolE              bClosed;    ///< TRUE if the thread has terminated
+    struct _sLogRing * psNext;     ///< next ring of the list
+    sLogEntry          asEntry[CONFIG_LOG_ASYNC_RING_SIZE];
+
+} sLogRing;
+
+//----- Function prototypes ----------------------------------------------------
+static void       startWriter(void);
+static void       parseFormat(sLogFormat * psFormat);
+static void       openBinary(void);
+static sLogRing * registerRing(void);
+static void       releaseRing(void * pvRing);
+static void       writeAll(struct iovec * asIov, int iIov);
+static void       reportDropped(sLogRing * psRing);
+static sLogRing * oldestRing(sLogRing * psFirst);
+static void       releaseEntries(sLogRing * psFirst);
+static void     * writerThread(void * pvArg);
+
+//----- Data -------------------------------------------------------------------
+static pthread_once_t     onceWriter = PTHREAD_ONCE_INIT;
+static pthread_key_t      keyRing;
+static pthread_mutex_t    mutexRings = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t    mutexWriter = PTHREAD_MUTEX_INITIALIZER;
+static sLogRing         * psRings = NULL;
+static uint64_t           u64Sequence = 0;
+static __thread sLogRing * psThreadRing = NULL;
+static int                iLogFd = STDOUT_FILENO;
+
+/* Descriptors of all call sites, provided by the linker                     */
+extern sLogFormat __start_logformat[] __attribute__ ((weak));
+extern sLogFormat __stop_logformat[] __attribute__ ((weak));
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    initLogAsync
+ ******************************************************************************/
+/** \brief        Starts the writer thread if it is not running yet
+ *
+ *  \type         global
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void initLogAsync(void) {
+
+    pthread_once(&onceWriter, startWriter);
+}
+
+/*******************************************************************************
+ *  function :    printLogAsync
+ ******************************************************************************/
+/** \brief        Formats a message into the ring of the calling thread
+ *                <p>
+ *                Never blocks. The message is dropped if the ring is full or
+ *                no ring could be allocated.
+ *
+ *  \type         global
+ *
+ *  \param[in]    pcLevel     prefix of the level (e.g. "\nINFO:   \t")
+ *  \param[in]    pcFunction  name of the logging function
+ *  \param[in]    pcFormat    printf(3) format of the message
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void printLogAsync(const char * pcLevel,
+                   const char * pcFunction,
+                   const char * pcFormat,
+                   ...) {
+
+    sLogRing  * psRing = psThreadRing;
+    sLogEntry * psEntry;
+    uint32_t    u32Head;
+    int         iLength;
+    int         iMessage;
+    va_list     args;
+
+    if(psRing == NULL) {
+        psRing = registerRing();
+        if(psRing == NULL) {
+            return;
+        }
+    }
+
+    u32Head = psRing->u32Head;
+    if((u32Head - __atomic_load_n(&psRing->u32Tail, __ATOMIC_ACQUIRE)) >=
+       CONFIG_LOG_ASYNC_RING_SIZE) {
+        __atomic_add_fetch(&psRing->u64Dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    psEntry = &psRing->asEntry[u32Head & LOG_ASYNC_MASK];
+    iLength = snprintf(psEntry->acText, sizeof(psEntry->acText),
+                       "%s%s;\n\t\t", pcLevel, pcFunction);
+    if(iLength < 0) {
+        iLength = 0;
+    } else if(iLength >= (int) sizeof(psEntry->acText)) {
+        iLength = sizeof(psEntry->acText) - 1;
+    }
+
+    va_start(args, pcFormat);
+    iMessage = vsnprintf(&psEntry->acText[iLength],
+                         sizeof(psEntry->acText) - iLength, pcFormat, args);
+    va_end(args);
+    if(iMessage > 0) {
+        iLength += iMessage;
+        if(iLength >= (int) sizeof(psEntry->acText)) {
+            iLength = sizeof(psEntry->acText) - 1;
+        }
+    }
+    psEntry->u32Length = (uint32_t) iLength;
+    psEntry->u64Seq = __atomic_fetch_add(&u64Sequence, 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&psRing->u32Head, u32Head + 1, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ *  function :    recordLogAsync
+ ******************************************************************************/
+/** \brief        Records the raw arguments of a message into the ring of the
+ *                calling thread (binary mode)
+ *                <p>
+ *                Never blocks. The arguments are read as given by the
+ *                signature of the descriptor. Strings are shortened if the
+ *                record does not fit into an entry. The message is dropped if
+ *                the ring is full or no ring could be allocated.
+ *
+ *  \type         global
+ *
+ *  \param[in]    psFormat  descriptor of the call site (see RECORD_ASYNC)
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void recordLogAsync(sLogFormat * psFormat, ...) {
+
+    sLogRing      * psRing = psThreadRing;
+    sLogEntry     * psEntry;
+    char          * pcRecord;
+    const char    * pcArg;
+    const char    * pcString;
+    struct timespec sNow;
+    uint64_t        u64Value;
+    int64_t         s64Value;
+    int32_t         s32Value;
+    double          dValue;
+    uint32_t        u32Head;
+    uint32_t        u32Pos = LOG_RECORD_HEADER;
+    uint32_t        u32Budget;
+    uint32_t        u32Max;
+    uint16_t        u16Value;
+    va_list         args;
+
+    if(psRing == NULL) {
+        psRing = registerRing();
+        if(psRing == NULL) {
+            return;
+        }
+    }
+
+    u32Head = psRing->u32Head;
+    if((u32Head - __atomic_load_n(&psRing->u32Tail, __ATOMIC_ACQUIRE)) >=
+       CONFIG_LOG_ASYNC_RING_SIZE) {
+        __atomic_add_fetch(&psRing->u64Dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    psEntry = &psRing->asEntry[u32Head & LOG_ASYNC_MASK];
+    pcRecord = psEntry->acText;
+    /* Bytes left for the text of the strings */
+    u32Budget = sizeof(psEntry->acText) - LOG_RECORD_HEADER - psFormat->u16Fixed;
+
+    va_start(args, psFormat);
+    for(pcArg = psFormat->acArgs; *pcArg != '\0'; pcArg++) {
+        switch(*pcArg) {
+        case 'w':
+        case 'W':
+            s32Value = va_arg(args, int);
+            memcpy(&pcRecord[u32Pos], &s32Value, sizeof(s32Value));
+            u32Pos += sizeof(s32Value);
+            break;
+        case 'l':
+            s64Value = va_arg(args, long);
+            memcpy(&pcRecord[u32Pos], &s64Value, sizeof(s64Value));
+            u32Pos += sizeof(s64Value);
+            break;
+        case 'L':
+            u64Value = va_arg(args, unsigned long);
+            memcpy(&pcRecord[u32Pos], &u64Value, sizeof(u64Value));
+            u32Pos += sizeof(u64Value);
+            break;
+        case 'q':
+        case 'Q':
+            u64Value = va_arg(args, unsigned long long);
+            memcpy(&pcRecord[u32Pos], &u64Value, sizeof(u64Value));
+            u32Pos += sizeof(u64Value);
+            break;
+        case 'z':
+            u64Value = va_arg(args, size_t);
+            memcpy(&pcRecord[u32Pos], &u64Value, sizeof(u64Value));
+            u32Pos += sizeof(u64Value);
+            break;
+        case 'f':
+            dValue = va_arg(args, double);
+            memcpy(&pcRecord[u32Pos], &dValue, sizeof(dValue));
+            u32Pos += sizeof(dValue);
+            break;
+        case 'F':
+            dValue = (double) va_arg(args, long double);
+            memcpy(&pcRecord[u32Pos], &dValue, sizeof(dValue));
+            u32Pos += sizeof(dValue);
+            break;
+        case 'p':
+            u64Value = (uintptr_t) va_arg(args, void *);
+            memcpy(&pcRecord[u32Pos], &u64Value, sizeof(u64Value));
+            u32Pos += sizeof(u64Value);
+            break;
+        case 'S':
+        case 's':
+            u32Max = u32Budget;
+            if(*pcArg == 'S') {
+                s32Value = va_arg(args, int);
+                if((s32Value >= 0) && ((uint32_t) s32Value < u32Max)) {
+                    u32Max = s32Value;
+                }
+            }
+            pcString = va_arg(args, const char *);
+            if(pcString == NULL) {
+                pcString = "(null)";
+            }
+            u16Value = (uint16_t) strnlen(pcString, u32Max);
+            u32Budget -= u16Value;
+            if(*pcArg == 'S') {
+                /* The precision is the length of the copied text */
+                s32Value = u16Value;
+                memcpy(&pcRecord[u32Pos], &s32Value, sizeof(s32Value));
+                u32Pos += sizeof(s32Value);
+            }
+            memcpy(&pcRecord[u32Pos], &u16Value, sizeof(u16Value));
+            u32Pos += sizeof(u16Value);
+            memcpy(&pcRecord[u32Pos], pcString, u16Value);
+            u32Pos += u16Value;
+            break;
+        default:
+            break;
+        }
+    }
+    va_end(args);
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    u16Value = (uint16_t) (psFormat - __start_logformat);
+    memcpy(&pcRecord[0], &u16Value, sizeof(u16Value));
+    u16Value = (uint16_t) (u32Pos - LOG_RECORD_HEADER);
+    memcpy(&pcRecord[2], &u16Value, sizeof(u16Value));
+    u64Value = (uint64_t) sNow.tv_sec * 1000000000ULL + sNow.tv_nsec;
+    memcpy(&pcRecord[4], &u64Value, sizeof(u64Value));
+    psEntry->u32Length = u32Pos;
+    psEntry->u64Seq = __atomic_fetch_add(&u64Sequence, 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&psRing->u32Head, u32Head + 1, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ *  function :    flushLogAsync
+ ******************************************************************************/
+/** \brief        Writes all pending messages of all threads to the log
+ *                <p>
+ *                Called periodically by the writer thread and at exit(3).
+ *                The messages published when the flush starts are merged in
+ *                the order of their sequence numbers. A message which is
+ *                being published meanwhile is written by the next flush, even
+ *                if its sequence number is lower than the last one written.
+ *
+ *  \type         global
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void flushLogAsync(void) {
+
+    struct iovec asIov[LOG_ASYNC_IOV];
+    sLogRing   * psFirst;
+    sLogRing   * psRing;
+    sLogEntry  * psEntry;
+    int          iIov = 0;
+
+    pthread_mutex_lock(&mutexWriter);
+    psFirst = __atomic_load_n(&psRings, __ATOMIC_ACQUIRE);
+    for(psRing = psFirst; psRing != NULL; psRing = psRing->psNext) {
+        reportDropped(psRing);
+        psRing->u32Read = psRing->u32Tail;
+        psRing->u32Flush = __atomic_load_n(&psRing->u32Head, __ATOMIC_ACQUIRE);
+    }
+
+    while((psRing = oldestRing(psFirst)) != NULL) {
+        psEntry = &psRing->asEntry[psRing->u32Read & LOG_ASYNC_MASK];
+        asIov[iIov].iov_base = psEntry->acText;
+        asIov[iIov].iov_len = psEntry->u32Length;
+        iIov++;
+        psRing->u32Read++;
+        if(iIov == LOG_ASYNC_IOV) {
+            writeAll(asIov, iIov);
+            iIov = 0;
+            releaseEntries(psFirst);
+        }
+    }
+    if(iIov > 0) {
+        writeAll(asIov, iIov);
+        releaseEntries(psFirst);
+    }
+    pthread_mutex_unlock(&mutexWriter);
+}
+
+/*******************************************************************************
+ *  function :    startWriter
+ ******************************************************************************/
+/** \brief        Creates the key of the thread rings and the writer thread
+ *                <p>
+ *                Called once by pthread_once(3). Without a writer thread the
+ *                messages are written at exit(3) as far as they fit into the
+ *                rings.
+ *
+ *  \type         local
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void startWriter(void) {
+
+    pthread_t      thread;
+    pthread_attr_t sAttr;
+
+    pthread_key_create(&keyRing, releaseRing);
+    if(CONFIG_LOG_ASYNC_BINARY == 1) {
+        openBinary();
+    }
+    atexit(flushLogAsync);
+
+    pthread_attr_init(&sAttr);
+    pthread_attr_setdetachstate(&sAttr, PTHREAD_CREATE_DETACHED);
+    if(pthread_create(&thread, &sAttr, writerThread, NULL) != 0) {
+        fprintf(stderr, "\nERROR:  \t%s;\n\t\tpthread_create() failed",
+                __FUNCTION__);
+    }
+    pthread_attr_destroy(&sAttr);
+}
+
+/*******************************************************************************
+ *  function :    parseFormat
+ ******************************************************************************/
+/** \brief        Computes the signature of a descriptor from its format
+ *                <p>
+ *                A format which can not be recorded (unknown conversion, too
+ *                many arguments) gets an empty signature.
+ *
+ *  \type         local
+ *
+ *  \param[in,out] psFormat  descriptor
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void parseFormat(sLogFormat * psFormat) {
+
+    const char * pcFormat = psFormat->pcFormat;
+    char         acArgs[LOG_ASYNC_MAX_ARGS + 1];
+    uint32_t     u32Args = 0;
+    uint32_t     u32Fixed = 0;
+    uint32_t     u32Long;
+    boolE        bStar;
+    boolE        bLongDouble;
+    boolE        bSize;
+    char         cArg;
+
+    while(*pcFormat != '\0') {
+        if(*pcFormat++ != '%') {
+            continue;
+        }
+        if((*pcFormat == '%') || (*pcFormat == 'm')) {
+            pcFormat++;
+            continue;
+        }
+
+        /* Flags, field width (a '*' is an int argument) and precision */
+        while((*pcFormat != '\0') && (strchr("-+ #0'", *pcFormat) != NULL)) {
+            pcFormat++;
+        }
+        if(*pcFormat == '*') {
+            if(u32Args >= LOG_ASYNC_MAX_ARGS) {
+                break;
+            }
+            acArgs[u32Args++] = 'w';
+            u32Fixed += sizeof(int32_t);
+            pcFormat++;
+        }
+        while((*pcFormat >= '0') && (*pcFormat <= '9')) {
+            pcFormat++;
+        }
+        bStar = FALSE;
+        if(*pcFormat == '.') {
+            pcFormat++;
+            if(*pcFormat == '*') {
+                bStar = TRUE;
+                pcFormat++;
+            }
+            while((*pcFormat >= '0') && (*pcFormat <= '9')) {
+                pcFormat++;
+            }
+        }
+
+        /* Length modifier */
+        u32Long = 0;
+        bLongDouble = FALSE;
+        bSize = FALSE;
+        while((*pcFormat != '\0') && (strchr("hlLqjzt", *pcFormat) != NULL)) {
+            if(*pcFormat == 'l') {
+                u32Long++;
+            } else if((*pcFormat == 'L') || (*pcFormat == 'q') ||
+                      (*pcFormat == 'j')) {
+                u32Long = 2;
+                bLongDouble = (*pcFormat == 'L') ? TRUE : FALSE;
+            } else if((*pcFormat == 'z') || (*pcFormat == 't')) {
+                bSize = TRUE;
+            }
+            pcFormat++;
+        }
+
+        switch(*pcFormat) {
+        case 'd':
+        case 'i':
+        case 'c':
+            cArg = bSize ? 'z' : (u32Long == 0) ? 'w' : (u32Long == 1) ? 'l' : 'q';
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            cArg = bSize ? 'z' : (u32Long == 0) ? 'W' : (u32Long == 1) ? 'L' : 'Q';
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            cArg = bLongDouble ? 'F' : 'f';
+            break;
+        case 's':
+            cArg = bStar ? 'S' : 's';
+            bStar = FALSE;
+            break;
+        case 'p':
+            cArg = 'p';
+            break;
+        default:
+            cArg = '\0';
+            break;
+        }
+        if((cArg == '\0') || ((u32Args + (bStar ? 2 : 1)) > LOG_ASYNC_MAX_ARGS)) {
+            break;
+        }
+        pcFormat++;
+
+        if(bStar) {
+            acArgs[u32Args++] = 'w';
+            u32Fixed += sizeof(int32_t);
+        }
+        acArgs[u32Args++] = cArg;
+        if(cArg == 'S') {
+            u32Fixed += sizeof(int32_t) + sizeof(uint16_t);
+        } else if(cArg == 's') {
+            u32Fixed += sizeof(uint16_t);
+        } else if((cArg == 'w') || (cArg == 'W')) {
+            u32Fixed += sizeof(int32_t);
+        } else {
+            u32Fixed += sizeof(uint64_t);
+        }
+    }
+
+    if(*pcFormat != '\0') {
+        /* Not recordable, logged without arguments */
+        u32Args = 0;
+        u32Fixed = 0;
+    }
+    memcpy(psFormat->acArgs, acArgs, u32Args);
+    psFormat->acArgs[u32Args] = '\0';
+    psFormat->u16Fixed = (uint16_t) u32Fixed;
+}
+
+/*******************************************************************************
+ *  function :    openBinary
+ ******************************************************************************/
+/** \brief        Computes the signatures of all descriptors, creates the file
+ *                CONFIG_LOG_ASYNC_BINARY_FILE and writes the table of all
+ *                descriptors
+ *                <p>
+ *                The records are written to the stdout if the file can not be
+ *                created.
+ *
+ *  \type         local
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void openBinary(void) {
+
+    FILE       * psFile;
+    sLogFormat * psFormat;
+    uint32_t     u32Value;
+    uint16_t     u16Value;
+
+    for(psFormat = __start_logformat; psFormat < __stop_logformat; psFormat++) {
+        parseFormat(psFormat);
+    }
+
+    psFile = fopen(CONFIG_LOG_ASYNC_BINARY_FILE, "w");
+    if(psFile == NULL) {
+        fprintf(stderr, "\nERROR:  \t%s;\n\t\tfopen() %s failed: %s",
+                __FUNCTION__, CONFIG_LOG_ASYNC_BINARY_FILE, strerror(errno));
+        return;
+    }
+
+    fwrite(LOG_BINARY_MAGIC, 1, strlen(LOG_BINARY_MAGIC), psFile);
+    u32Value = 0x01020304;
+    fwrite(&u32Value, sizeof(u32Value), 1, psFile);
+    u32Value = (uint32_t) (__stop_logformat - __start_logformat);
+    fwrite(&u32Value, sizeof(u32Value), 1, psFile);
+
+    for(psFormat = __start_logformat; psFormat < __stop_logformat; psFormat++) {
+        u16Value = (uint16_t) (psFormat - __start_logformat);
+        fwrite(&u16Value, sizeof(u16Value), 1, psFile);
+        fwrite(&psFormat->u16Level, sizeof(psFormat->u16Level), 1, psFile);
+        fwrite(psFormat->pcFunction, 1, strlen(psFormat->pcFunction) + 1, psFile);
+        fwrite(psFormat->pcFormat, 1, strlen(psFormat->pcFormat) + 1, psFile);
+        fwrite(psFormat->acArgs, 1, strlen(psFormat->acArgs) + 1, psFile);
+    }
+
+    /* Records are appended by writev(2), the stream is not used anymore */
+    fflush(psFile);
+    iLogFd = fileno(psFile);
+}
+
+/*******************************************************************************
+ *  function :    registerRing
+ ******************************************************************************/
+/** \brief        Assigns a ring to the calling thread
+ *                <p>
+ *                The ring of a terminated thread is reused once it is empty,
+ *                otherwise a new ring is added to the list.
+ *
+ *  \type         local
+ *
+ *  \return       ring of the calling thread, NULL if out of memory
+ *
+ ******************************************************************************/
+static sLogRing * registerRing(void) {
+
+    sLogRing * psRing;
+
+    initLogAsync();
+
+    pthread_mutex_lock(&mutexRings);
+    for(psRing = psRings; psRing != NULL; psRing = psRing->psNext) {
+        if((__atomic_load_n(&psRing->bClosed, __ATOMIC_ACQUIRE) == TRUE) &&
+           (__atomic_load_n(&psRing->u32Tail, __ATOMIC_ACQUIRE) ==
+            psRing->u32Head)) {
+            psRing->bClosed = FALSE;
+            break;
+        }
+    }
+    if(psRing == NULL) {
+        psRing = calloc(1, sizeof(sLogRing));
+        if(psRing != NULL) {
+            psRing->psNext = psRings;
+            __atomic_store_n(&psRings, psRing, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&mutexRings);
+
+    if(psRing != NULL) {
+        pthread_setspecific(keyRing, psRing);
+        psThreadRing = psRing;
+    }
+    return (psRing);
+}
+
+/*******************************************************************************
+ *  function :    releaseRing
+ ******************************************************************************/
+/** \brief        Marks the ring of a terminating thread as reusable
+ *                <p>
+ *                Destructor of keyRing. The pending messages of the ring are
+ *                still written by the writer thread.
+ *
+ *  \type         local
+ *
+ *  \param[in]    pvRing  ring of the terminating thread
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void releaseRing(void * pvRing) {
+
+    sLogRing * psRing = (sLogRing *) pvRing;
+
+    __atomic_store_n(&psRing->bClosed, TRUE, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ *  function :    writeAll
+ ******************************************************************************/
+/** \brief        Writes the vectors to the log (stdout or the binary file),
+ *                continues partial writes
+ *
+ *  \type         local
+ *
+ *  \param[in]    asIov  vectors, modified
+ *  \param[in]    iIov   number of vectors
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void writeAll(struct iovec * asIov, int iIov) {
+
+    ssize_t sWritten;
+
+    while(iIov > 0) {
+        sWritten = writev(iLogFd, asIov, iIov);
+        if(sWritten < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        while((iIov > 0) && ((size_t) sWritten >= asIov->iov_len)) {
+            sWritten -= asIov->iov_len;
+            asIov++;
+            iIov--;
+        }
+        if(iIov > 0) {
+            asIov->iov_base = (char *) asIov->iov_base + sWritten;
+            asIov->iov_len -= sWritten;
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    reportDropped
+ ******************************************************************************/
+/** \brief        Writes the number of messages of a ring dropped since the
+ *                last flush
+ *                <p>
+ *                Must be called with mutexWriter held.
+ *
+ *  \type         local
+ *
+ *  \param[in]    psRing  ring
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void reportDropped(sLogRing * psRing) {
+
+    struct iovec    sIov;
+    char            acDropped[LOG_ASYNC_DROP_SIZE];
+    struct timespec sNow;
+    uint64_t        u64Dropped;
+    uint64_t        u64Stamp;
+    uint16_t        u16Value;
+    int             iLength;
+
+    u64Dropped = __atomic_exchange_n(&psRing->u64Dropped, 0, __ATOMIC_RELAXED);
+    if(u64Dropped == 0) {
+        return;
+    }
+
+    if(CONFIG_LOG_ASYNC_BINARY == 1) {
+        clock_gettime(CLOCK_MONOTONIC, &sNow);
+        u64Stamp = (uint64_t) sNow.tv_sec * 1000000000ULL + sNow.tv_nsec;
+        u16Value = LOG_RECORD_DROPPED;
+        memcpy(&acDropped[0], &u16Value, sizeof(u16Value));
+        u16Value = sizeof(u64Dropped);
+        memcpy(&acDropped[2], &u16Value, sizeof(u16Value));
+        memcpy(&acDropped[4], &u64Stamp, sizeof(u64Stamp));
+        memcpy(&acDropped[LOG_RECORD_HEADER], &u64Dropped, sizeof(u64Dropped));
+        sIov.iov_base = acDropped;
+        sIov.iov_len = LOG_RECORD_HEADER + sizeof(u64Dropped);
+    } else {
+        iLength = snprintf(acDropped, sizeof(acDropped),
+                           "\nWARNING:\t%s;\n\t\t%llu log messages dropped",
+                           __FUNCTION__, (unsigned long long) u64Dropped);
+        if(iLength <= 0) {
+            return;
+        }
+        sIov.iov_base = acDropped;
+        sIov.iov_len = ((size_t) iLength < sizeof(acDropped)) ?
+                       (size_t) iLength : sizeof(acDropped) - 1;
+    }
+    writeAll(&sIov, 1);
+}
+
+/*******************************************************************************
+ *  function :    oldestRing
+ ******************************************************************************/
+/** \brief        Returns the ring whose next entry to write has the lowest
+ *                sequence number
+ *                <p>
+ *                Only the entries published at the start of the flush
+ *                (u32Flush) are considered. Must be called with mutexWriter
+ *                held.
+ *
+ *  \type         local
+ *
+ *  \param[in]    psFirst  first ring of the list
+ *
+ *  \return       ring, NULL if all rings are written up to u32Flush
+ *
+ ******************************************************************************/
+static sLogRing * oldestRing(sLogRing * psFirst) {
+
+    sLogRing * psOldest = NULL;
+    sLogRing * psRing;
+    uint64_t   u64Oldest = 0;
+    uint64_t   u64Seq;
+
+    for(psRing = psFirst; psRing != NULL; psRing = psRing->psNext) {
+        if(psRing->u32Read != psRing->u32Flush) {
+            u64Seq = psRing->asEntry[psRing->u32Read & LOG_ASYNC_MASK].u64Seq;
+            if((psOldest == NULL) || (u64Seq < u64Oldest)) {
+                psOldest = psRing;
+                u64Oldest = u64Seq;
+            }
+        }
+    }
+
+    return (psOldest);
+}
+
+/*******************************************************************************
+ *  function :    releaseEntries
+ ******************************************************************************/
+/** \brief        Hands the written entries of all rings back to the producers
+ *
+ *  \type         local
+ *
+ *  \param[in]    psFirst  first ring of the list
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void releaseEntries(sLogRing * psFirst) {
+
+    sLogRing * psRing;
+
+    for(psRing = psFirst; psRing != NULL; psRing = psRing->psNext) {
+        if(psRing->u32Tail != psRing->u32Read) {
+            __atomic_store_n(&psRing->u32Tail, psRing->u32Read,
+                             __ATOMIC_RELEASE);
+        }
+    }
+}
+
+/*******************************************************************************
+ *  function :    writerThread
+ ******************************************************************************/
+/** \brief        Flushes the rings every CONFIG_LOG_ASYNC_PERIOD_MS
+ *
+ *  \type         local
+ *
+ *  \param[in]    pvArg  unused
+ *
+ *  \return       never returns
+ *
+ ******************************************************************************/
+static void * writerThread(void * pvArg) {
+
+    struct timespec sNext;
+    struct timespec sNow;
+
+    blockAllSignalForThread();
+
+    clock_gettime(CLOCK_MONOTONIC, &sNext);
+    for(;;) {
+        sNext.tv_nsec += (long) CONFIG_LOG_ASYNC_PERIOD_MS * 1000000L;
+        while(sNext.tv_nsec >= 1000000000L) {
+            sNext.tv_nsec -= 1000000000L;
+            sNext.tv_sec++;
+        }
+        /* A slow stdout must not cause a burst of flushes afterwards */
+        clock_gettime(CLOCK_MONOTONIC, &sNow);
+        if((sNow.tv_sec > sNext.tv_sec) ||
+           ((sNow.tv_sec == sNext.tv_sec) && (sNow.tv_nsec > sNext.tv_nsec))) {
+            sNext = sNow;
+        }
+        while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                              &sNext, NULL) == EINTR) {
+        }
+        flushLogAsync();
+    }
+
+    return (NULL);
+}
@@ -0,0 +1,215 @@
+#ifndef LOGASYNC_H_
+#define LOGASYNC_H_
+/******************************************************************************/
+/** \file       LogAsync.h
+ *******************************************************************************
+ *
+ *  \brief      Acceptor of log messages which logs the messages to the stdout
+ *              in the background.
+ *              <p>
+ *              The log messages are grouped in four different levels
+ *              (DEBUG, INFO, WARNING and ERROR).
+ *              <p>
+ *              The calling thread only formats the message into a ring buffer
+ *              of its own, it neither takes a lock nor makes a system call. A
+ *              writer thread empties the rings of all threads every
+ *              CONFIG_LOG_ASYNC_PERIOD_MS with one writev(2) per batch. If
+ *              the ring of a thread is full the message is dropped, the
+ *              writer reports the number of dropped messages. Messages longer
+ *              than CONFIG_LOG_ASYNC_ENTRY_SIZE are truncated. The output has
+ *              the same format as the console acceptor.
+ *              <p>
+ *              In the binary mode (CONFIG_LOG_ASYNC_BINARY) the message is not
+ *              formatted at all. Every call site owns a static descriptor of
+ *              its level, function and format string, placed in the section
+ *              "logformat". The calling thread records the index of the
+ *              descriptor, a timestamp and the raw arguments (strings are
+ *              copied), the writer appends the records to the file
+ *              CONFIG_LOG_ASYNC_BINARY_FILE. The file starts with a table of
+ *              all descriptors, tools/LogDecode.py renders it to text.
+ *              Conversions the binary mode can not record (%n) are logged
+ *              without arguments.
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    initLogAsync
+ *              printLogAsync
+ *              recordLogAsync
+ *              flushLogAsync
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdio.h>
+#include <stdint.h>
+
+//----- Macros -----------------------------------------------------------------
+/** Levels of a binary record                                                 */
+#define LOG_ASYNC_LEVEL_DEBUG    ( 0 )
+#define LOG_ASYNC_LEVEL_INFO     ( 1 )
+#define LOG_ASYNC_LEVEL_WARNING  ( 2 )
+#define LOG_ASYNC_LEVEL_ERROR    ( 3 )
+/** Highest number of arguments of a binary record                            */
+#define LOG_ASYNC_MAX_ARGS       ( 16 )
+
+/*******************************************************************************
+ *  function :    RECORD_ASYNC
+ ******************************************************************************/
+/**
+ * Record a message with its raw arguments (binary mode). The format is
+ * checked by the compiler with the help of a printf(3) which is never called.
+ * \param[in]   Level          LOG_ASYNC_LEVEL_DEBUG, ...
+ * \param[in]   FormatString   String literal that contains the text to be
+ *                             written
+ * \param[in]   Args           Depending on the format string, the function
+ *                             may expect a sequence of additional arguments
+ * \return      void
+ */
+#define RECORD_ASYNC(Level, FormatString, Args...) {                           \
+	static sLogFormat sLogFormat__                                             \
+		__attribute__ ((section ("logformat"), aligned (8), used)) =           \
+		{ (Level), 0, __FUNCTION__, FormatString, "" };                        \
+	if (0) {                                                                   \
+		printf(FormatString, ##Args);                                          \
+	}                                                                          \
+	recordLogAsync(&sLogFormat__, ##Args);                                     \
+}
+
+/*******************************************************************************
+ *  function :    INIT_ASYNC
+ ******************************************************************************/
+/**
+ * Initialize the log acceptor async (starts the writer thread)
+ * \return      void
+ */
+#ifdef LOG_ASYNC
+#define INIT_ASYNC() {                                                         \
+	initLogAsync();                                                            \
+}
+#else
+#define INIT_ASYNC()
+#endif // #ifdef LOG_ASYNC
+
+
+/*******************************************************************************
+ *  function :    DEBUGPRINT_ASYNC
+ ******************************************************************************/
+/**
+ * Log a debug message to stdout in the background
+ * \param[in]   FormatString   String that contains the text to be written
+ * \param[in]   Args           Depending on the format string, the function
+ *                             may expect a sequence of additional arguments
+ * \return      void
+ */
+#if defined(LOG_ASYNC) && defined(LOG_ASYNC_BINARY)
+#define DEBUGPRINT_ASYNC(FormatString, Args...) {                              \
+	RECORD_ASYNC(LOG_ASYNC_LEVEL_DEBUG, FormatString, ##Args)                  \
+}
+#elif defined(LOG_ASYNC)
+#define DEBUGPRINT_ASYNC(FormatString, Args...) {                              \
+	printLogAsync("\nDEBUG:  \t", __FUNCTION__, FormatString, ##Args);         \
+}
+#else
+#define DEBUGPRINT_ASYNC(...)
+#endif // #ifdef LOG_ASYNC
+
+
+/*******************************************************************************
+ *  function :    INFOPRINT_ASYNC
+ ******************************************************************************/
+/**
+ * Log an info message to stdout in the background
+ * \param[in]   FormatString   String that contains the text to be written
+ * \param[in]   Args           Depending on the format string, the function
+ *                             may expect a sequence of additional arguments
+ * \return      void
+ */
+#if defined(LOG_ASYNC) && defined(LOG_ASYNC_BINARY)
+#define INFOPRINT_ASYNC(FormatString, Args...) {                               \
+	RECORD_ASYNC(LOG_ASYNC_LEVEL_INFO, FormatString, ##Args)                   \
+}
+#elif defined(LOG_ASYNC)
+#define INFOPRINT_ASYNC(FormatString, Args...) {                               \
+	printLogAsync("\nINFO:   \t", __FUNCTION__, FormatString, ##Args);         \
+}
+#else
+#define INFOPRINT_ASYNC(...)
+#endif // #ifdef LOG_ASYNC
+
+
+/*******************************************************************************
+ *  function :    WARNINGPRINT_ASYNC
+ ******************************************************************************/
+/**
+ * Log a warning message to stdout in the background
+ * \param[in]   FormatString   String that contains the text to be written
+ * \param[in]   Args           Depending on the format string, the function
+ *                             may expect a sequence of additional arguments
+ * \return      void
+ */
+#if defined(LOG_ASYNC) && defined(LOG_ASYNC_BINARY)
+#define WARNINGPRINT_ASYNC(FormatString, Args...) {                            \
+	RECORD_ASYNC(LOG_ASYNC_LEVEL_WARNING, FormatString, ##Args)                \
+}
+#elif defined(LOG_ASYNC)
+#define WARNINGPRINT_ASYNC(FormatString, Args...) {                            \
+	printLogAsync("\nWARNING:\t", __FUNCTION__, FormatString, ##Args);         \
+}
+#else
+#define WARNINGPRINT_ASYNC(...)
+#endif // #ifdef LOG_ASYNC
+
+
+/*******************************************************************************
+ *  function :    ERRORPRINT_ASYNC
+ ******************************************************************************/
+/**
+ * Log an error message to stdout in the background
+ * \param[in]   FormatString   String that contains the text to be written
+ * \param[in]   Args           Depending on the format string, the function
+ *                             may expect a sequence of additional arguments
+ * \return      void
+ */
+#if defined(LOG_ASYNC) && defined(LOG_ASYNC_BINARY)
+#define ERRORPRINT_ASYNC(FormatString, Args...) {                              \
+	RECORD_ASYNC(LOG_ASYNC_LEVEL_ERROR, FormatString, ##Args)                  \
+}
+#elif defined(LOG_ASYNC)
+#define ERRORPRINT_ASYNC(FormatString, Args...) {                              \
+	printLogAsync("\nERROR:  \t", __FUNCTION__, FormatString, ##Args);         \
+}
+#else
+#define ERRORPRINT_ASYNC(...)
+#endif // #ifdef LOG_ASYNC
+
+//----- Data types -------------------------------------------------------------
+
+/** Descriptor of a call site (binary mode), see RECORD_ASYNC                 */
+typedef struct _sLogFormat {
+
+    uint16_t     u16Level;     ///< LOG_ASYNC_LEVEL_DEBUG, ...
+    uint16_t     u16Fixed;     ///< bytes of the record without the strings
+    const char * pcFunction;   ///< logging function
+    const char * pcFormat;     ///< printf(3) format of the message
+    char         acArgs[LOG_ASYNC_MAX_ARGS + 1]; ///< argument types
+
+} sLogFormat;
+
+//----- Function prototypes ----------------------------------------------------
+extern void initLogAsync(void);
+
+extern void printLogAsync(const char * pcLevel,
+                          const char * pcFunction,
+                          const char * pcFormat,
+                          ...) __attribute__ ((format (printf, 3, 4)));
+
+extern void recordLogAsync(sLogFormat * psFormat, ...);
+
+extern void flushLogAsync(void);
+
+//----- Data -------------------------------------------------------------------
+
+
+#endif /* LOGASYNC_H_ */
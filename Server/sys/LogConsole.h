@@ -37,6 +37,9 @@
 #define INIT_CONSOLE() {                                                       \
 	setvbuf (stdout, NULL, _IONBF, 0);                                         \
 }
+#else
+#define INIT_CONSOLE()
+#endif // #ifdef LOG_CONSOLE
 
 
 /*******************************************************************************
@@ -49,6 +52,7 @@
  *                             may expect a sequence of additional arguments
  * \return      void
  */
+#ifdef LOG_CONSOLE
 #define DEBUGPRINT_CONSOLE(FormatString, Args...) {                            \
 	flockfile(stdout);                                                         \
 	printf("\nDEBUG:  \t%s;\n\t\t",__FUNCTION__);                              \
@@ -103,7 +107,7 @@
 	funlockfile(stdout);                                                       \
 }
 #else
-#define WARNINGRINT_CONSOLE(...)
+#define WARNINGPRINT_CONSOLE(...)
 #endif // #ifdef LOG_CONSOLE
 
 
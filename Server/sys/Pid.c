@@ -0,0 +1,162 @@
+/******************************************************************************/
+/** \file       Pid.c
+ *******************************************************************************
+ *
+ *  \brief      PID controller in fixed-point arithmetic.
+ *              <p>
+ *              All parts of the output are computed in Q16.16 with 64 bit
+ *              intermediates, no floating point is used at runtime.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              initPid
+ *              resetPid
+ *              stepPid
+ *  functions  local:
+ *              .
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include "Pid.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+//----- Function prototypes ----------------------------------------------------
+
+//----- Data -------------------------------------------------------------------
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    initPid
+ ******************************************************************************/
+/** \brief        Initializes a controller
+ *
+ *  \type         global
+ *
+ *  \param[out]   psPid      controller
+ *  \param[in]    s32Kp      proportional gain (Q16.16, see PID_GAIN)
+ *  \param[in]    s32Ki      integral gain per period (Q16.16)
+ *  \param[in]    s32Kd      derivative gain per period (Q16.16)
+ *  \param[in]    s32OutMin  lower limit of the output
+ *  \param[in]    s32OutMax  upper limit of the output
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void initPid(sPid * psPid,
+             int32_t s32Kp,
+             int32_t s32Ki,
+             int32_t s32Kd,
+             int32_t s32OutMin,
+             int32_t s32OutMax) {
+
+    psPid->s32Kp = s32Kp;
+    psPid->s32Ki = s32Ki;
+    psPid->s32Kd = s32Kd;
+    psPid->s32OutMin = s32OutMin;
+    psPid->s32OutMax = s32OutMax;
+    resetPid(psPid);
+}
+
+/*******************************************************************************
+ *  function :    resetPid
+ ******************************************************************************/
+/** \brief        Clears the integral and the previous measurement
+ *
+ *  \type         global
+ *
+ *  \param[in,out] psPid  controller
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+void resetPid(sPid * psPid) {
+
+    psPid->s64Integral = 0;
+    psPid->s32LastMeasure = 0;
+    psPid->bStarted = FALSE;
+}
+
+/*******************************************************************************
+ *  function :    stepPid
+ ******************************************************************************/
+/** \brief        Computes the output for a new measurement
+ *
+ *  \type         global
+ *
+ *  \param[in,out] psPid       controller
+ *  \param[in]    s32Setpoint  setpoint
+ *  \param[in]    s32Measure   measurement
+ *  \param[in]    u32Periods   periods elapsed since the last step (1 if no
+ *                             step was missed)
+ *
+ *  \return       output, within [s32OutMin,s32OutMax]
+ *
+ ******************************************************************************/
+int32_t stepPid(sPid * psPid,
+                int32_t s32Setpoint,
+                int32_t s32Measure,
+                uint32_t u32Periods) {
+
+    int64_t s64Error = (int64_t) s32Setpoint - s32Measure;
+    int64_t s64Min = (int64_t) psPid->s32OutMin << PID_FRACTION_BITS;
+    int64_t s64Max = (int64_t) psPid->s32OutMax << PID_FRACTION_BITS;
+    int64_t s64Integral;
+    int64_t s64Derivative = 0;
+    int64_t s64Out;
+
+    if(u32Periods == 0) {
+        u32Periods = 1;
+    }
+
+    s64Integral = psPid->s64Integral +
+                  (int64_t) psPid->s32Ki * s64Error * (int64_t) u32Periods;
+    if((psPid->bStarted == TRUE) && (psPid->s32Kd != 0)) {
+        s64Derivative = -((int64_t) psPid->s32Kd *
+                          ((int64_t) s32Measure - psPid->s32LastMeasure)) /
+                        (int64_t) u32Periods;
+    }
+    psPid->s32LastMeasure = s32Measure;
+    psPid->bStarted = TRUE;
+
+    s64Out = (int64_t) psPid->s32Kp * s64Error + s64Integral + s64Derivative;
+
+    /* Anti-windup: the integral is kept if it would only saturate further */
+    if(s64Out > s64Max) {
+        s64Out = s64Max;
+        if(s64Error < 0) {
+            psPid->s64Integral = s64Integral;
+        }
+    } else if(s64Out < s64Min) {
+        s64Out = s64Min;
+        if(s64Error > 0) {
+            psPid->s64Integral = s64Integral;
+        }
+    } else {
+        psPid->s64Integral = s64Integral;
+    }
+
+    /* The integral alone never exceeds the limits of the output */
+    if(psPid->s64Integral > s64Max) {
+        psPid->s64Integral = s64Max;
+    } else if(psPid->s64Integral < s64Min) {
+        psPid->s64Integral = s64Min;
+    }
+
+    /* Rounded to the nearest integer (s64Out - s64Min is not negative) */
+    return (psPid->s32OutMin +
+            (int32_t) ((s64Out - s64Min + (1 << (PID_FRACTION_BITS - 1))) >>
+                       PID_FRACTION_BITS));
+}
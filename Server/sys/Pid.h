@@ -0,0 +1,82 @@
+#ifndef PID_H_
+#define PID_H_
+/******************************************************************************/
+/** \file       Pid.h
+ *******************************************************************************
+ *
+ *  \brief      PID controller in fixed-point arithmetic.
+ *              <p>
+ *              The controller is meant to be stepped with a fixed period, the
+ *              gains are given per period (Q16.16, see PID_GAIN). The
+ *              derivative acts on the measurement, thus a changed setpoint
+ *              does not kick the output. The output is limited to
+ *              [s32OutMin,s32OutMax]. While the output is saturated, the error
+ *              which would drive it further into saturation is not integrated
+ *              (anti-windup), thus the controller leaves the limit as soon as
+ *              the error changes its sign. A PI controller has a Kd of 0.
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              static sPid sHeater = PID_INITIALIZER(PID_GAIN(20.0),
+ *                                                    PID_GAIN(0.5), 0, 0, 100);
+ *
+ *              // every period
+ *              s32Duty = stepPid(&sHeater, s32Setpoint, s32Measure, 1);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    initPid
+ *              resetPid
+ *              stepPid
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Number of fraction bits of the gains and the integral                     */
+#define PID_FRACTION_BITS      ( 16 )
+/** Converts a constant gain to Q16.16 (at compile time)                      */
+#define PID_GAIN(gain)         ( (int32_t) ((gain) * (1 << PID_FRACTION_BITS)) )
+/** Initializer of a controller                                               */
+#define PID_INITIALIZER(kp, ki, kd, outMin, outMax) \
+    { (kp), (ki), (kd), (outMin), (outMax), 0, 0, FALSE }
+
+//----- Data types -------------------------------------------------------------
+
+/** State of a PID controller */
+typedef struct _sPid {
+
+    int32_t s32Kp;          ///< proportional gain (Q16.16)
+    int32_t s32Ki;          ///< integral gain per period (Q16.16)
+    int32_t s32Kd;          ///< derivative gain per period (Q16.16)
+    int32_t s32OutMin;      ///< lower limit of the output
+    int32_t s32OutMax;      ///< upper limit of the output
+    int64_t s64Integral;    ///< integral part of the output (Q16.16)
+    int32_t s32LastMeasure; ///< measurement of the previous step
+    boolE   bStarted;       ///< FALSE until the first step
+
+} sPid;
+
+//----- Function prototypes ----------------------------------------------------
+extern void    initPid(sPid * psPid,
+                       int32_t s32Kp,
+                       int32_t s32Ki,
+                       int32_t s32Kd,
+                       int32_t s32OutMin,
+                       int32_t s32OutMax);
+extern void    resetPid(sPid * psPid);
+extern int32_t stepPid(sPid * psPid,
+                       int32_t s32Setpoint,
+                       int32_t s32Measure,
+                       uint32_t u32Periods);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* PID_H_ */
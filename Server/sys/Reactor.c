@@ -0,0 +1,319 @@
+/******************************************************************************/
+/** \file       Reactor.c
+ *******************************************************************************
+ *
+ *  \brief      Single threaded event demultiplexer of the beaglebone black
+ *              webhouse based on epoll(7).
+ *              <p>
+ *              Every file descriptor the main thread is interested in (the
+ *              listening socket, all client sockets, ...) is registered
+ *              together with a handler. runReactor() waits until at least one
+ *              of the registered file descriptors is ready and dispatches the
+ *              pending events to the corresponding handlers. All registered
+ *              file descriptors should be non-blocking.
+ *              <p>
+ *              The handlers are stored in a table indexed by the file
+ *              descriptor. Every entry carries a generation counter which is
+ *              part of the epoll user data. Thus an event which is still
+ *              pending for an already removed (and maybe reused) file
+ *              descriptor is silently dropped.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              initReactor
+ *              finalizeReactor
+ *              addReactorFd
+ *              modifyReactorFd
+ *              removeReactorFd
+ *              runReactor
+ *  functions  local:
+ *              .
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Reactor.h"
+#include "BBBConfig.h"
+#define LOG_MODULE  SYS
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+#define REACTOR_FD_MASK          ( 0xffffffffuLL )
+#define REACTOR_GEN_SHIFT        ( 32 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Registered handler of a file descriptor */
+typedef struct _sReactorEntry {
+
+    pfReactorHandler pfHandler;   ///< NULL if fd is not registered
+    void *           pvData;      ///< User data handed to pfHandler
+    uint32_t         u32Gen;      ///< Incremented on every registration
+
+} sReactorEntry;
+
+//----- Function prototypes ----------------------------------------------------
+
+//----- Data -------------------------------------------------------------------
+/** epoll instance of the reactor                                             */
+static int                epollFd = -1;
+/** Handler table indexed by the file descriptor                              */
+static sReactorEntry      asEntry[CONFIG_REACTOR_MAX_FD];
+/** Events returned by a single call to epoll_wait(2)                         */
+static struct epoll_event asEvents[CONFIG_REACTOR_MAX_EVENTS];
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    initReactor
+ ******************************************************************************/
+/** \brief        Creates the epoll instance of the reactor.
+ *                <p>
+ *                Must be called before any other function of this module.
+ *
+ *  \type         global
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS       on success
+ *                BBB_EVENT_CREATE  epoll instance could not be created
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError initReactor(void) {
+
+    BBBError error = BBB_SUCCESS;
+
+    memset(asEntry, 0, sizeof(asEntry));
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(epollFd < 0) {
+        ERRORPRINT("epoll_create1() failed: %s", strerror(errno));
+        error = BBB_EVENT_CREATE;
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    finalizeReactor
+ ******************************************************************************/
+BBBError finalizeReactor(void) {
+
+    BBBError error = BBB_SUCCESS;
+
+    if(epollFd >= 0) {
+        if(close(epollFd) < 0) {
+            error = BBB_FILE_CLOSE;
+        }
+        epollFd = -1;
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    addReactorFd
+ ******************************************************************************/
+/** \brief        Registers a file descriptor and its handler at the reactor.
+ *
+ *  \type         global
+ *
+ *  \param[in]    fd         file descriptor (should be non-blocking)
+ *  \param[in]    u32Events  epoll events of interest (EPOLLIN, EPOLLOUT, ...)
+ *  \param[in]    pfHandler  handler called on pending events
+ *  \param[in]    pvData     user data handed to pfHandler
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS       on success
+ *                BBB_ERR_PARAM     invalid fd or handler
+ *                BBB_EVENT_CTL     epoll_ctl(2) failed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError addReactorFd(int fd,
+                      uint32_t u32Events,
+                      pfReactorHandler pfHandler,
+                      void * pvData) {
+
+    BBBError           error = BBB_SUCCESS;
+    struct epoll_event sEvent;
+
+    if((fd < 0) || (fd >= CONFIG_REACTOR_MAX_FD) || (pfHandler == NULL)) {
+        ERRORPRINT("parameter error");
+        error = BBB_ERR_PARAM;
+    } else {
+
+        asEntry[fd].u32Gen++;
+        asEntry[fd].pfHandler = pfHandler;
+        asEntry[fd].pvData = pvData;
+
+        memset(&sEvent, 0, sizeof(sEvent));
+        sEvent.events = u32Events;
+        sEvent.data.u64 = ((uint64_t) asEntry[fd].u32Gen << REACTOR_GEN_SHIFT)
+                          | (uint32_t) fd;
+
+        if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &sEvent) < 0) {
+            ERRORPRINT("epoll_ctl(ADD) of fd %d failed: %s",
+                       fd, strerror(errno));
+            asEntry[fd].pfHandler = NULL;
+            error = BBB_EVENT_CTL;
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    modifyReactorFd
+ ******************************************************************************/
+/** \brief        Changes the events of interest of a registered file
+ *                descriptor.
+ *
+ *  \type         global
+ *
+ *  \param[in]    fd         registered file descriptor
+ *  \param[in]    u32Events  new epoll events of interest
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS       on success
+ *                BBB_ERR_PARAM     fd is not registered
+ *                BBB_EVENT_CTL     epoll_ctl(2) failed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError modifyReactorFd(int fd, uint32_t u32Events) {
+
+    BBBError           error = BBB_SUCCESS;
+    struct epoll_event sEvent;
+
+    if((fd < 0) || (fd >= CONFIG_REACTOR_MAX_FD)
+        || (asEntry[fd].pfHandler == NULL)) {
+        ERRORPRINT("parameter error");
+        error = BBB_ERR_PARAM;
+    } else {
+
+        memset(&sEvent, 0, sizeof(sEvent));
+        sEvent.events = u32Events;
+        sEvent.data.u64 = ((uint64_t) asEntry[fd].u32Gen << REACTOR_GEN_SHIFT)
+                          | (uint32_t) fd;
+
+        if(epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &sEvent) < 0) {
+            ERRORPRINT("epoll_ctl(MOD) of fd %d failed: %s",
+                       fd, strerror(errno));
+            error = BBB_EVENT_CTL;
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    removeReactorFd
+ ******************************************************************************/
+/** \brief        Removes a file descriptor from the reactor.
+ *                <p>
+ *                Must be called before the file descriptor is closed. Events
+ *                which are still pending for fd within the current dispatch
+ *                run are dropped.
+ *
+ *  \type         global
+ *
+ *  \param[in]    fd         registered file descriptor
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS       on success
+ *                BBB_ERR_PARAM     fd is not registered
+ *                BBB_EVENT_CTL     epoll_ctl(2) failed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError removeReactorFd(int fd) {
+
+    BBBError error = BBB_SUCCESS;
+
+    if((fd < 0) || (fd >= CONFIG_REACTOR_MAX_FD)
+        || (asEntry[fd].pfHandler == NULL)) {
+        ERRORPRINT("parameter error");
+        error = BBB_ERR_PARAM;
+    } else {
+
+        asEntry[fd].pfHandler = NULL;
+        asEntry[fd].pvData = NULL;
+
+        if(epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL) < 0) {
+            ERRORPRINT("epoll_ctl(DEL) of fd %d failed: %s",
+                       fd, strerror(errno));
+            error = BBB_EVENT_CTL;
+        }
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    runReactor
+ ******************************************************************************/
+/** \brief        Waits on pending events and dispatches them to the
+ *                registered handlers.
+ *                <p>
+ *                An interrupted wait (e.g. by SIGINT) is not treated as an
+ *                error, thus the caller can check its shutdown condition.
+ *
+ *  \type         global
+ *
+ *  \param[in]    s32TimeoutMs  Maximum time to wait for an event. Set to
+ *                              REACTOR_TIMEOUT_INF for infinite wait time or
+ *                              to zero to return immediately.
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS       on success or timeout
+ *                BBB_EVENT_WAIT    epoll_wait(2) failed
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError runReactor(int32_t s32TimeoutMs) {
+
+    BBBError       error = BBB_SUCCESS;
+    int            nEvents;
+    int            i;
+    int            fd;
+    uint32_t       u32Gen;
+    sReactorEntry *psEntry;
+
+    nEvents = epoll_wait(epollFd, asEvents, CONFIG_REACTOR_MAX_EVENTS,
+                         s32TimeoutMs);
+
+    if(nEvents < 0) {
+        if(errno != EINTR) {
+            ERRORPRINT("epoll_wait() failed: %s", strerror(errno));
+            error = BBB_EVENT_WAIT;
+        }
+    } else {
+
+        for(i = 0; i < nEvents; i++) {
+
+            fd = (int) (asEvents[i].data.u64 & REACTOR_FD_MASK);
+            u32Gen = (uint32_t) (asEvents[i].data.u64 >> REACTOR_GEN_SHIFT);
+            psEntry = &asEntry[fd];
+
+            /* Handler of a former event may have removed this fd */
+            if((psEntry->pfHandler != NULL) && (psEntry->u32Gen == u32Gen)) {
+                psEntry->pfHandler(fd, asEvents[i].events, psEntry->pvData);
+            }
+        }
+    }
+
+    return (error);
+}
@@ -0,0 +1,76 @@
+#ifndef REACTOR_H_
+#define REACTOR_H_
+/******************************************************************************/
+/** \file       Reactor.h
+ *******************************************************************************
+ *
+ *  \brief      Single threaded event demultiplexer of the beaglebone black
+ *              webhouse based on epoll(7).
+ *              <p>
+ *              Every file descriptor the main thread is interested in (the
+ *              listening socket, all client sockets, ...) is registered
+ *              together with a handler. runReactor() waits until at least one
+ *              of the registered file descriptors is ready and dispatches the
+ *              pending events to the corresponding handlers. All registered
+ *              file descriptors should be non-blocking.
+ *              <p>
+ *              Example of registering a socket:
+ *              <pre>
+ *              static void onSocket(int fd, uint32_t u32Events, void * pvData) {
+ *                  // read from fd
+ *              }
+ *
+ *              initReactor();
+ *              addReactorFd(fd, EPOLLIN, onSocket, NULL);
+ *              while(run) {
+ *                  runReactor(REACTOR_TIMEOUT_INF);
+ *              }
+ *              finalizeReactor();
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    initReactor
+ *              finalizeReactor
+ *              addReactorFd
+ *              modifyReactorFd
+ *              removeReactorFd
+ *              runReactor
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+#include <sys/epoll.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+#define REACTOR_TIMEOUT_INF     ( -1 )
+
+//----- Data types -------------------------------------------------------------
+
+/** Handler called by the reactor if an event on fd is pending */
+typedef void (*pfReactorHandler)(int fd, uint32_t u32Events, void * pvData);
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError initReactor(void);
+
+extern BBBError finalizeReactor(void);
+
+extern BBBError addReactorFd(int fd,
+                             uint32_t u32Events,
+                             pfReactorHandler pfHandler,
+                             void * pvData);
+
+extern BBBError modifyReactorFd(int fd, uint32_t u32Events);
+
+extern BBBError removeReactorFd(int fd);
+
+extern BBBError runReactor(int32_t s32TimeoutMs);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* REACTOR_H_ */
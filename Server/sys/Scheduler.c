@@ -0,0 +1,193 @@
+/******************************************************************************/
+/** \file       Scheduler.c
+ *******************************************************************************
+ *
+ *  \brief      Periodic tasks of the beaglebone black webhouse.
+ *              <p>
+ *              Every task owns a timerfd(2) which is registered at the reactor
+ *              (Reactor.h). The timers run on CLOCK_MONOTONIC with absolute
+ *              expiration times, thus the tasks do not drift even if a single
+ *              run is delayed. If runs were missed (e.g. because the main
+ *              thread was busy), the task is called once with the number of
+ *              expirations since its last run.
+ *
+ *  \author     wht4
+ *
+ *  \date       October 2026
+ *
+ *  \remark     Last Modification
+ *               \li wht4, October 2026, Created
+ *
+ ******************************************************************************/
+/*
+ *  functions  global:
+ *              addSchedulerTask
+ *              finalizeScheduler
+ *  functions  local:
+ *              onTimer
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "Scheduler.h"
+#include "Reactor.h"
+#include "BBBConfig.h"
+#define LOG_MODULE  SYS
+#include "Log.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+/** A periodic task */
+typedef struct _sSchedulerTask {
+
+    int             fd;       ///< timerfd of the task, -1 if slot is unused
+    pfSchedulerTask pfTask;   ///< task function
+    void *          pvData;   ///< user data handed to pfTask
+
+} sSchedulerTask;
+
+//----- Function prototypes ----------------------------------------------------
+static void onTimer(int fd, uint32_t u32Events, void * pvData);
+
+//----- Data -------------------------------------------------------------------
+/** All registered tasks                                                      */
+static sSchedulerTask asTask[CONFIG_SCHEDULER_MAX_TASKS];
+/** Number of registered tasks                                                */
+static uint32_t       u32Tasks = 0;
+
+//----- Implementation ---------------------------------------------------------
+
+/*******************************************************************************
+ *  function :    addSchedulerTask
+ ******************************************************************************/
+/** \brief        Adds a new periodic task.
+ *                <p>
+ *                The task is called the first time one period after this
+ *                function was called. initReactor() must be called before
+ *                this function.
+ *
+ *  \type         global
+ *
+ *  \param[in]    u32PeriodMs  period of the task [ms]
+ *  \param[in]    pfTask       task function
+ *  \param[in]    pvData       user data handed to pfTask
+ *
+ *  \return       <pre>
+ *                BBB_SUCCESS       on success
+ *                BBB_ERR_PARAM     parameter error or too many tasks
+ *                BBB_TIMER_CREATE  timer could not be created
+ *                BBB_EVENT_CTL     timer could not be registered
+ *                </pre>
+ *
+ ******************************************************************************/
+BBBError addSchedulerTask(uint32_t u32PeriodMs,
+                          pfSchedulerTask pfTask,
+                          void * pvData) {
+
+    BBBError          error = BBB_SUCCESS;
+    sSchedulerTask *  psTask;
+    struct itimerspec sTimer;
+
+    if((pfTask == NULL) || (u32PeriodMs == 0)
+        || (u32Tasks >= CONFIG_SCHEDULER_MAX_TASKS)) {
+        ERRORPRINT("parameter error");
+        return (BBB_ERR_PARAM);
+    }
+
+    psTask = &asTask[u32Tasks];
+    psTask->pfTask = pfTask;
+    psTask->pvData = pvData;
+    psTask->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if(psTask->fd < 0) {
+        ERRORPRINT("timerfd_create() failed: %s", strerror(errno));
+        return (BBB_TIMER_CREATE);
+    }
+
+    /* First expiration is absolute, the following are multiples of the     */
+    /* period relative to it. Thus late runs do not shift the schedule.      */
+    clock_gettime(CLOCK_MONOTONIC, &sTimer.it_value);
+    sTimer.it_interval.tv_sec = u32PeriodMs / 1000;
+    sTimer.it_interval.tv_nsec = (long) (u32PeriodMs % 1000) * 1000000L;
+    sTimer.it_value.tv_sec += sTimer.it_interval.tv_sec;
+    sTimer.it_value.tv_nsec += sTimer.it_interval.tv_nsec;
+    if(sTimer.it_value.tv_nsec >= 1000000000L) {
+        sTimer.it_value.tv_sec++;
+        sTimer.it_value.tv_nsec -= 1000000000L;
+    }
+
+    if(timerfd_settime(psTask->fd, TFD_TIMER_ABSTIME, &sTimer, NULL) < 0) {
+        ERRORPRINT("timerfd_settime() failed: %s", strerror(errno));
+        error = BBB_TIMER_CREATE;
+    } else {
+        error = addReactorFd(psTask->fd, EPOLLIN, onTimer, psTask);
+    }
+
+    if(error != BBB_SUCCESS) {
+        close(psTask->fd);
+        psTask->fd = -1;
+    } else {
+        u32Tasks++;
+    }
+
+    return (error);
+}
+
+/*******************************************************************************
+ *  function :    finalizeScheduler
+ ******************************************************************************/
+/** \brief        Stops and removes all periodic tasks.
+ *
+ *  \type         global
+ *
+ *  \return       BBB_SUCCESS
+ *
+ ******************************************************************************/
+BBBError finalizeScheduler(void) {
+
+    uint32_t i;
+
+    for(i = 0; i < u32Tasks; i++) {
+        removeReactorFd(asTask[i].fd);
+        close(asTask[i].fd);
+        asTask[i].fd = -1;
+    }
+    u32Tasks = 0;
+
+    return (BBB_SUCCESS);
+}
+
+/*******************************************************************************
+ *  function :    onTimer
+ ******************************************************************************/
+/** \brief        Reads the number of expirations of the timer and runs the
+ *                corresponding task.
+ *
+ *  \type         static
+ *
+ *  \param[in]    fd         timerfd of the task
+ *  \param[in]    u32Events  pending epoll events
+ *  \param[in]    pvData     corresponding task
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static void onTimer(int fd, uint32_t u32Events, void * pvData) {
+
+    sSchedulerTask * psTask = (sSchedulerTask *) pvData;
+    uint64_t         u64Expirations = 0;
+
+    if(read(fd, &u64Expirations, sizeof(u64Expirations))
+        == sizeof(u64Expirations)) {
+
+        psTask->pfTask(u64Expirations, psTask->pvData);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+/******************************************************************************/
+/** \file       Scheduler.h
+ *******************************************************************************
+ *
+ *  \brief      Periodic tasks of the beaglebone black webhouse.
+ *              <p>
+ *              Every task owns a timerfd(2) which is registered at the reactor
+ *              (Reactor.h). The timers run on CLOCK_MONOTONIC with absolute
+ *              expiration times, thus the tasks do not drift even if a single
+ *              run is delayed. If runs were missed (e.g. because the main
+ *              thread was busy), the task is called once with the number of
+ *              expirations since its last run.
+ *              <p>
+ *              initReactor() must be called before a task can be added.
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    addSchedulerTask
+ *              finalizeScheduler
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+
+//----- Data types -------------------------------------------------------------
+
+/** Periodic task, u64Expirations is the number of elapsed periods (>= 1) */
+typedef void (*pfSchedulerTask)(uint64_t u64Expirations, void * pvData);
+
+//----- Function prototypes ----------------------------------------------------
+extern BBBError addSchedulerTask(uint32_t u32PeriodMs,
+                                 pfSchedulerTask pfTask,
+                                 void * pvData);
+
+extern BBBError finalizeScheduler(void);
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* SCHEDULER_H_ */
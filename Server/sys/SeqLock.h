@@ -0,0 +1,137 @@
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+/******************************************************************************/
+/** \file       SeqLock.h
+ *******************************************************************************
+ *
+ *  \brief      Sequence lock to publish small data from a single writer to
+ *              any number of readers without blocking them.
+ *              <p>
+ *              The writer increments the sequence before and after changing
+ *              the data, thus the sequence is odd while a write is in
+ *              progress. A reader copies the data and retries if the sequence
+ *              was odd or changed meanwhile. Readers never block the writer
+ *              and never wait for a lock. The protected data must be
+ *              accessed with (relaxed) atomic loads and stores.
+ *              <p>
+ *              Example:
+ *              <pre>
+ *              // writer (a single thread only)
+ *              writeSeqLockBegin(&sLock);
+ *              __atomic_store_n(&s32Value, s32New, __ATOMIC_RELAXED);
+ *              writeSeqLockEnd(&sLock);
+ *
+ *              // reader
+ *              do {
+ *                  u32Seq = readSeqLockBegin(&sLock);
+ *                  s32Copy = __atomic_load_n(&s32Value, __ATOMIC_RELAXED);
+ *              } while(readSeqLockRetry(&sLock, u32Seq) == TRUE);
+ *              </pre>
+ *
+ *  \author     wht4
+ *
+ ******************************************************************************/
+/*
+ *  function    writeSeqLockBegin
+ *              writeSeqLockEnd
+ *              readSeqLockBegin
+ *              readSeqLockRetry
+ *
+ ******************************************************************************/
+
+//----- Header-Files -----------------------------------------------------------
+#include <stdint.h>
+
+#include "BBBTypes.h"
+
+//----- Macros -----------------------------------------------------------------
+/** Initializer of a sequence lock                                            */
+#define SEQLOCK_INITIALIZER    { 0 }
+
+//----- Data types -------------------------------------------------------------
+
+/** Sequence lock */
+typedef struct _sSeqLock {
+
+    uint32_t u32Seq;  ///< odd while a write is in progress
+
+} sSeqLock;
+
+//----- Function prototypes ----------------------------------------------------
+
+/*******************************************************************************
+ *  function :    writeSeqLockBegin
+ ******************************************************************************/
+/** \brief        Starts to change the protected data (writer only)
+ *
+ *  \param[in]    psLock  sequence lock
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static __inline__ void writeSeqLockBegin(sSeqLock * psLock) {
+
+    __atomic_store_n(&psLock->u32Seq, psLock->u32Seq + 1, __ATOMIC_RELAXED);
+    /* The data must not be written before the sequence is odd */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ *  function :    writeSeqLockEnd
+ ******************************************************************************/
+/** \brief        Publishes the changed data (writer only)
+ *
+ *  \param[in]    psLock  sequence lock
+ *
+ *  \return       void
+ *
+ ******************************************************************************/
+static __inline__ void writeSeqLockEnd(sSeqLock * psLock) {
+
+    __atomic_store_n(&psLock->u32Seq, psLock->u32Seq + 1, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ *  function :    readSeqLockBegin
+ ******************************************************************************/
+/** \brief        Starts to read the protected data
+ *
+ *  \param[in]    psLock  sequence lock
+ *
+ *  \return       sequence to pass to readSeqLockRetry()
+ *
+ ******************************************************************************/
+static __inline__ uint32_t readSeqLockBegin(const sSeqLock * psLock) {
+
+    return (__atomic_load_n(&psLock->u32Seq, __ATOMIC_ACQUIRE));
+}
+
+/*******************************************************************************
+ *  function :    readSeqLockRetry
+ ******************************************************************************/
+/** \brief        Checks if the data read since readSeqLockBegin() is
+ *                consistent
+ *
+ *  \param[in]    psLock  sequence lock
+ *  \param[in]    u32Seq  sequence returned by readSeqLockBegin()
+ *
+ *  \return       TRUE if the data must be read again, FALSE if it is valid
+ *
+ ******************************************************************************/
+static __inline__ boolE readSeqLockRetry(const sSeqLock * psLock,
+                                         uint32_t u32Seq) {
+
+    /* The data must be read before the sequence is checked again */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if(((u32Seq & 1) != 0) ||
+       (__atomic_load_n(&psLock->u32Seq, __ATOMIC_RELAXED) != u32Seq)) {
+        return (TRUE);
+    }
+
+    return (FALSE);
+}
+
+//----- Data -------------------------------------------------------------------
+
+#endif /* SEQLOCK_H_ */
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+##############################################################################
+## \file       LogDecode.py
+##############################################################################
+##
+##  \brief      Renders a binary log of the webhouse (CONFIG_LOG_ASYNC_BINARY)
+##              to the text of the console acceptor.
+##              <p>
+##              Usage: LogDecode.py [-t] [webhouse.blog]
+##              <p>
+##              With -t every message is preceded by the time of the call
+##              (CLOCK_MONOTONIC). The records are printed in the order of
+##              their time, records of the same time in the order of the
+##              file. The layout of the file is described in sys/LogAsync.c.
+##
+##  \author     wht4
+##
+##############################################################################
+
+import re
+import struct
+import sys
+
+MAGIC = b"BBBLOG1\n"
+RECORD_DROPPED = 0xFFFF
+LEVELS = ("DEBUG:  ", "INFO:   ", "WARNING:", "ERROR:  ")
+
+# Size and struct code of the argument types of a signature
+ARGS = {
+    "w": "i", "W": "I",
+    "l": "q", "L": "Q",
+    "q": "q", "Q": "Q",
+    "z": "Q", "p": "Q",
+    "f": "d", "F": "d",
+}
+
+# printf(3) conversion: flags, width, precision, length and conversion
+CONVERSION = re.compile(r"%([-+ #0']*)(\*|\d+)?(?:\.(\*|\d*))?"
+                        r"(hh|h|ll|l|L|q|j|z|t)?(.)")
+
+
+def readString(data, pos):
+    end = data.index(b"\0", pos)
+    return data[pos:end].decode("utf-8", "replace"), end + 1
+
+
+def readArgs(order, signature, data):
+    """Returns the arguments of a record as given by its signature."""
+    args = []
+    pos = 0
+    for arg in signature:
+        if arg in "sS":
+            if arg == "S":
+                args.append(struct.unpack_from(order + "i", data, pos)[0])
+                pos += 4
+            length = struct.unpack_from(order + "H", data, pos)[0]
+            pos += 2
+            args.append(data[pos:pos + length].decode("utf-8", "replace"))
+            pos += length
+        else:
+            code = ARGS[arg]
+            args.append(struct.unpack_from(order + code, data, pos)[0])
+            pos += struct.calcsize(code)
+    return args
+
+
+def render(format, args):
+    """Formats the arguments like printf(3), the format is printed as it is
+    if the arguments do not match."""
+    out = []
+    pos = 0
+    index = 0
+    try:
+        for match in CONVERSION.finditer(format):
+            out.append(format[pos:match.start()])
+            pos = match.end()
+            flags, width, precision, length, conv = match.groups()
+            if conv == "%":
+                out.append("%")
+                continue
+            if conv == "m":
+                out.append("%m")
+                continue
+            spec = "%" + flags.replace("'", "")
+            values = []
+            for part in (width, precision):
+                if part == "*":
+                    values.append(args[index])
+                    index += 1
+            if width:
+                spec += width
+            if precision is not None:
+                spec += "." + (precision or "0")
+            value = args[index]
+            index += 1
+            if conv in "uoxX" and value < 0:
+                value += 1 << (64 if length in ("l", "ll", "L", "q", "j", "z", "t")
+                               else 32)
+            if conv == "u":
+                conv = "d"
+            elif conv == "p":
+                spec, conv = "%#", "x"
+            elif conv in "aA":
+                conv = "g"
+            elif conv == "c":
+                value = chr(value & 0xFF)
+            values.append(value)
+            out.append((spec + conv) % tuple(values))
+        if index != len(args):
+            raise ValueError
+    except (IndexError, TypeError, ValueError):
+        return format
+    out.append(format[pos:])
+    return "".join(out)
+
+
+def decode(file, stamp):
+    data = file.read()
+    if data[:len(MAGIC)] != MAGIC:
+        sys.exit("not a binary webhouse log")
+    pos = len(MAGIC)
+    order = "<" if struct.unpack_from("<I", data, pos)[0] == 0x01020304 else ">"
+    pos += 4
+    count = struct.unpack_from(order + "I", data, pos)[0]
+    pos += 4
+
+    formats = {}
+    for _ in range(count):
+        index, level = struct.unpack_from(order + "HH", data, pos)
+        pos += 4
+        function, pos = readString(data, pos)
+        format, pos = readString(data, pos)
+        signature, pos = readString(data, pos)
+        formats[index] = (level, function, format, signature)
+
+    records = []
+    while pos + 12 <= len(data):
+        index, length, ns = struct.unpack_from(order + "HHQ", data, pos)
+        pos += 12
+        records.append((ns, index, data[pos:pos + length]))
+        pos += length
+    # A flush writes a record after one of a later call if it was published
+    # late, sort() is stable
+    records.sort(key=lambda record: record[0])
+
+    for ns, index, record in records:
+        if stamp:
+            sys.stdout.write("\n[%d.%06d]" % (ns // 1000000000,
+                                              (ns // 1000) % 1000000))
+        if index == RECORD_DROPPED:
+            dropped = struct.unpack_from(order + "Q", record)[0]
+            sys.stdout.write("\nWARNING:\treportDropped;\n\t\t%d log messages "
+                             "dropped" % dropped)
+            continue
+        level, function, format, signature = formats[index]
+        sys.stdout.write("\n%s\t%s;\n\t\t%s" % (
+            LEVELS[level] if level < len(LEVELS) else "?", function,
+            render(format, readArgs(order, signature, record))))
+    sys.stdout.write("\n")
+
+
+def main():
+    args = sys.argv[1:]
+    stamp = "-t" in args
+    args = [arg for arg in args if arg != "-t"]
+    if len(args) > 1:
+        sys.exit("Usage: %s [-t] [webhouse.blog]" % sys.argv[0])
+    with open(args[0] if args else "webhouse.blog", "rb") as file:
+        decode(file, stamp)
+
+
+if __name__ == "__main__":
+    main()